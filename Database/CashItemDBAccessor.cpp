@@ -13,18 +13,16 @@
 
 #include "..\WvsLib\Net\InPacket.h"
 #include "..\WvsLib\Net\OutPacket.h"
-#include "..\WvsLib\Net\SocketBase.h"
 #include "..\WvsCenter\CenterPacketTypes.hpp"
 #include "..\WvsLib\Memory\ZMemory.h"
 
-void CashItemDBAccessor::PostBuyCashItemRequest(SocketBase * pSrv, int uClientSocketSN, int nCharacterID, int nRequestType, void * iPacket_, bool bGift)
+void CashItemDBAccessor::PostBuyCashItemRequest(OutPacket *oPacket, int uClientSocketSN, int nCharacterID, int nRequestType, void * iPacket_, bool bGift)
 {
 	InPacket *iPacket = (InPacket*)iPacket_;
-	OutPacket oPacket;
-	oPacket.Encode2(CenterResultPacketType::CashItemResult);
-	oPacket.Encode4(uClientSocketSN);
-	oPacket.Encode4(nCharacterID);
-	oPacket.Encode2(nRequestType);
+	oPacket->Encode2(CenterResultPacketType::CashItemResult);
+	oPacket->Encode4(uClientSocketSN);
+	oPacket->Encode4(nCharacterID);
+	oPacket->Encode2(nRequestType);
 
 	int nAccountID = iPacket->Decode4(), nReceiverID = 0, nReceiverAccountID = 0;
 	GW_Account account;
@@ -39,8 +37,8 @@ void CashItemDBAccessor::PostBuyCashItemRequest(SocketBase * pSrv, int uClientSo
 		nReceiverAccountID = nReceiverID < 0 ? -1 : CharacterDBAccessor::QueryCharacterAccountID(nReceiverID);
 		if (nReceiverID == -1 || nReceiverAccountID == -1)
 		{
-			oPacket.Encode1(1);
-			goto DELIVER_PACKET;
+			oPacket->Encode1(1);
+			return;
 		}
 		sMemo = iPacket->DecodeStr();
 	}
@@ -53,10 +51,10 @@ void CashItemDBAccessor::PostBuyCashItemRequest(SocketBase * pSrv, int uClientSo
 
 		int nItemCount = iPacket->Decode1();
 		bool bIsPet = false;
-		oPacket.Encode1(0);
-		oPacket.Encode1(nItemCount);
-		oPacket.Encode4(account.QueryCash(1));
-		oPacket.Encode4(account.QueryCash(2));
+		oPacket->Encode1(0);
+		oPacket->Encode1(nItemCount);
+		oPacket->Encode4(account.QueryCash(1));
+		oPacket->Encode4(account.QueryCash(2));
 		for (int i = 0; i < nItemCount; ++i)
 		{
 			nType = iPacket->Decode1();
@@ -103,17 +101,17 @@ void CashItemDBAccessor::PostBuyCashItemRequest(SocketBase * pSrv, int uClientSo
 			aItem.push_back({ pCashItemInfo, pItem });
 			if (bGift)
 			{
-				oPacket.EncodeStr(sReceiver);
-				oPacket.Encode4(pItem->nItemID);
-				oPacket.Encode2(
+				oPacket->EncodeStr(sReceiver);
+				oPacket->Encode4(pItem->nItemID);
+				oPacket->Encode2(
 					nType == GW_ItemSlotBase::GW_ItemSlotType::CASH && !bIsPet ?
 					((GW_ItemSlotBundle*)pItem)->nNumber : 1
 				);
-				oPacket.Encode2(0);
-				oPacket.Encode4(nPrice);
+				oPacket->Encode2(0);
+				oPacket->Encode4(nPrice);
 			}
 			else
-				pCashItemInfo->Encode(&oPacket);
+				pCashItemInfo->Encode(oPacket);
 
 			if (sMemo != "")
 			{
@@ -129,38 +127,34 @@ void CashItemDBAccessor::PostBuyCashItemRequest(SocketBase * pSrv, int uClientSo
 		}
 	}
 	else
-		oPacket.Encode1(1);
+		oPacket->Encode1(1);
 
 	for (auto& prItem : aItem)
 	{
 		prItem.first->Save(true);
 		prItem.second->Save(prItem.second->nCharacterID);
 	}
-
-DELIVER_PACKET:
-	pSrv->SendPacket(&oPacket);
 }
 
 
-void CashItemDBAccessor::PostLoadLockerRequest(SocketBase *pSrv, int uClientSocketSN, int nCharacterID, void *iPacket_)
+void CashItemDBAccessor::PostLoadLockerRequest(OutPacket *oPacket, int uClientSocketSN, int nCharacterID, void *iPacket_)
 {
 	InPacket *iPacket = (InPacket*)iPacket_;
 	int nAccountID = iPacket->Decode4();
 	auto aRes = GW_CashItemInfo::LoadAll(nAccountID);
 	std::vector<GW_ItemSlotPet> aPet;
-	OutPacket oPacket;
-	oPacket.Encode2((short)CenterResultPacketType::CashItemResult);
-	oPacket.Encode4(uClientSocketSN);
-	oPacket.Encode4(nCharacterID);
-	oPacket.Encode2(CenterCashItemRequestType::eLoadCashItemLockerRequest);
-	oPacket.Encode1(0); //FailedReason
-	oPacket.Encode2((short)aRes.size());
+	oPacket->Encode2((short)CenterResultPacketType::CashItemResult);
+	oPacket->Encode4(uClientSocketSN);
+	oPacket->Encode4(nCharacterID);
+	oPacket->Encode2(CenterCashItemRequestType::eLoadCashItemLockerRequest);
+	oPacket->Encode1(0); //FailedReason
+	oPacket->Encode2((short)aRes.size());
 	decltype(aRes) aResWithoutPet;
 	for (auto& info : aRes)
 	{
 		if (info.nGWItemSlotInstanceType != GW_ItemSlotBase::GW_ItemSlotInstanceType::GW_ItemSlotPet_Type)
 			aResWithoutPet.push_back(info);
-		info.Encode(&oPacket);
+		info.Encode(oPacket);
 		if (info.nGWItemSlotInstanceType == GW_ItemSlotBase::GW_ItemSlotInstanceType::GW_ItemSlotPet_Type)
 		{
 			aPet.push_back({});
@@ -170,7 +164,7 @@ void CashItemDBAccessor::PostLoadLockerRequest(SocketBase *pSrv, int uClientSock
 	//oPacket.Encode2(aResWithoutPet.size());
 	//for (auto& info : aResWithoutPet)
 	//	info.Encode(&oPacket);
-	oPacket.Encode4(0);
+	oPacket->Encode4(0);
 	//for (auto& pet : aPet)
 	//	pet.Encode(&oPacket, false);
 
@@ -178,33 +172,28 @@ void CashItemDBAccessor::PostLoadLockerRequest(SocketBase *pSrv, int uClientSock
 	oPacket.Encode2(0);
 	oPacket.Encode2(0);
 	oPacket.Encode2(0);*/
-
-	pSrv->SendPacket(&oPacket);
 }
 
-void CashItemDBAccessor::PostUpdateCashRequest(SocketBase *pSrv, int uClientSocketSN, int nCharacterID, void *iPacket_)
+void CashItemDBAccessor::PostUpdateCashRequest(OutPacket *oPacket, int uClientSocketSN, int nCharacterID, void *iPacket_)
 {
 	InPacket *iPacket = (InPacket*)iPacket_;
 	int nAccountID = iPacket->Decode4();
 	GW_Account account;
 	account.Load(nAccountID);
 
-	OutPacket oPacket;
-	oPacket.Encode2((short)CenterResultPacketType::CashItemResult);
-	oPacket.Encode4(uClientSocketSN);
-	oPacket.Encode4(nCharacterID);
-	oPacket.Encode2(CenterCashItemRequestType::eGetMaplePointRequest);
-
-	oPacket.Encode1(0); //FailedReason
-	oPacket.Encode4(account.nNexonCash);
-	oPacket.Encode4(account.nMaplePoint);
-	oPacket.Encode4(0);
-	oPacket.Encode4(0);
+	oPacket->Encode2((short)CenterResultPacketType::CashItemResult);
+	oPacket->Encode4(uClientSocketSN);
+	oPacket->Encode4(nCharacterID);
+	oPacket->Encode2(CenterCashItemRequestType::eGetMaplePointRequest);
 
-	pSrv->SendPacket(&oPacket);
+	oPacket->Encode1(0); //FailedReason
+	oPacket->Encode4(account.nNexonCash);
+	oPacket->Encode4(account.nMaplePoint);
+	oPacket->Encode4(0);
+	oPacket->Encode4(0);
 }
 
-void CashItemDBAccessor::PostMoveSlotToLockerRequest(SocketBase * pSrv, int uClientSocketSN, int nCharacterID, void * iPacket_)
+void CashItemDBAccessor::PostMoveSlotToLockerRequest(OutPacket *oPacket, int uClientSocketSN, int nCharacterID, void * iPacket_)
 {
 	InPacket *iPacket = (InPacket*)iPacket_;
 	int nAccountID = iPacket->Decode4();
@@ -223,29 +212,26 @@ void CashItemDBAccessor::PostMoveSlotToLockerRequest(SocketBase * pSrv, int uCli
 	pItem->nPOS = GW_ItemSlotBase::LOCK_POS;
 	pItem->Save(nCharacterID);
 
-	OutPacket oPacket;
-	oPacket.Encode2((short)CenterResultPacketType::CashItemResult);
-	oPacket.Encode4(uClientSocketSN);
-	oPacket.Encode4(nCharacterID);
-	oPacket.Encode2(CenterCashItemRequestType::eMoveCashItemStoLRequest);
-	oPacket.Encode1(0); //FailedReason
-	oPacket.Encode8(liCashItemSN);
-	oPacket.Encode1(nType);
-	cashItemInfo.Encode(&oPacket);
-	oPacket.Encode4(0);
-	oPacket.Encode4(0);
-	pSrv->SendPacket(&oPacket);
+	oPacket->Encode2((short)CenterResultPacketType::CashItemResult);
+	oPacket->Encode4(uClientSocketSN);
+	oPacket->Encode4(nCharacterID);
+	oPacket->Encode2(CenterCashItemRequestType::eMoveCashItemStoLRequest);
+	oPacket->Encode1(0); //FailedReason
+	oPacket->Encode8(liCashItemSN);
+	oPacket->Encode1(nType);
+	cashItemInfo.Encode(oPacket);
+	oPacket->Encode4(0);
+	oPacket->Encode4(0);
 }
 
-void CashItemDBAccessor::PostMoveLockerToSlotRequest(SocketBase * pSrv, int uClientSocketSN, int nCharacterID, void * iPacket_)
+void CashItemDBAccessor::PostMoveLockerToSlotRequest(OutPacket *oPacket, int uClientSocketSN, int nCharacterID, void * iPacket_)
 {
 	InPacket *iPacket = (InPacket*)iPacket_;
 	int nAccountID = iPacket->Decode4();
 	long long int liCashItemSN = iPacket->Decode8();
-	OutPacket oPacket;
-	oPacket.Encode2((short)CenterResultPacketType::CashItemResult);
-	oPacket.Encode4(uClientSocketSN);
-	oPacket.Encode4(nCharacterID);
+	oPacket->Encode2((short)CenterResultPacketType::CashItemResult);
+	oPacket->Encode4(uClientSocketSN);
+	oPacket->Encode4(nCharacterID);
 
 	GW_CashItemInfo cashItemInfo;
 	cashItemInfo.Load(liCashItemSN);
@@ -258,11 +244,10 @@ void CashItemDBAccessor::PostMoveLockerToSlotRequest(SocketBase * pSrv, int uCli
 	pItem->bIsCash = true;
 	pItem->Load(liCashItemSN);
 	auto nPOS = characterData.FindEmptySlotPosition((int)pItem->nType);
-	oPacket.Encode2((short)CenterCashItemRequestType::eMoveCashItemLtoSRequest);
+	oPacket->Encode2((short)CenterCashItemRequestType::eMoveCashItemLtoSRequest);
 	if (!nPOS)
 	{
-		oPacket.Encode1(1);
-		pSrv->SendPacket(&oPacket);
+		oPacket->Encode1(1);
 		return;
 	}
 	pItem->nPOS = nPOS;
@@ -270,17 +255,16 @@ void CashItemDBAccessor::PostMoveLockerToSlotRequest(SocketBase * pSrv, int uCli
 	cashItemInfo.bLocked = false;
 	cashItemInfo.Save();
 
-	oPacket.Encode1(0);
-	oPacket.Encode8(pItem->liItemSN);
+	oPacket->Encode1(0);
+	oPacket->Encode8(pItem->liItemSN);
 	//oPacket.Encode1(1);
-	oPacket.Encode2(nPOS);
-	pItem->RawEncode(&oPacket);
-	oPacket.Encode4(0);
-	oPacket.Encode4(0);
-	pSrv->SendPacket(&oPacket);
+	oPacket->Encode2(nPOS);
+	pItem->RawEncode(oPacket);
+	oPacket->Encode4(0);
+	oPacket->Encode4(0);
 }
 
-void CashItemDBAccessor::PostExpireCashItemRequest(SocketBase * pSrv, int uClientSocketSN, int nCharacterID, void * iPacket_)
+void CashItemDBAccessor::PostExpireCashItemRequest(OutPacket *oPacket, int uClientSocketSN, int nCharacterID, void * iPacket_)
 {
 	InPacket *iPacket = (InPacket*)iPacket_;
 	int nSize = iPacket->Decode1(), nTI = 0;
@@ -291,12 +275,11 @@ void CashItemDBAccessor::PostExpireCashItemRequest(SocketBase * pSrv, int uClien
 	gwBundle.nType = GW_ItemSlotBase::CASH;
 	gwEqp.bIsCash = gwBundle.bIsCash = true;
 
-	OutPacket oPacket;
-	oPacket.Encode2(CenterResultPacketType::CashItemResult);
-	oPacket.Encode4(uClientSocketSN);
-	oPacket.Encode4(nCharacterID);
-	oPacket.Encode2(CenterCashItemRequestType::eExpireCashItemRequest);
-	oPacket.Encode1((char)nSize);
+	oPacket->Encode2(CenterResultPacketType::CashItemResult);
+	oPacket->Encode4(uClientSocketSN);
+	oPacket->Encode4(nCharacterID);
+	oPacket->Encode2(CenterCashItemRequestType::eExpireCashItemRequest);
+	oPacket->Encode1((char)nSize);
 
 	for (int i = 0; i < nSize; ++i)
 	{
@@ -307,45 +290,38 @@ void CashItemDBAccessor::PostExpireCashItemRequest(SocketBase * pSrv, int uClien
 
 		pItem->Load(iPacket->Decode8());
 		pItem->Save(nCharacterID, false, true);
-		oPacket.Encode1((char)nTI);
-		oPacket.Encode8(pItem->liCashItemSN);
+		oPacket->Encode1((char)nTI);
+		oPacket->Encode8(pItem->liCashItemSN);
 	}
-
-	pSrv->SendPacket(&oPacket);
 }
 
-void CashItemDBAccessor::PostLoadGiftListRequest(SocketBase * pSrv, int uClientSocketSN, int nCharacterID)
+void CashItemDBAccessor::PostLoadGiftListRequest(OutPacket *oPacket, int uClientSocketSN, int nCharacterID)
 {
 	std::vector<ZUniquePtr<GW_GiftList>> aList = GW_GiftList::Load(nCharacterID);
 
-	OutPacket oPacket;
-	oPacket.Encode2(CenterResultPacketType::CashItemResult);
-	oPacket.Encode4(uClientSocketSN);
-	oPacket.Encode4(nCharacterID);
-	oPacket.Encode2(CenterCashItemRequestType::eLoadGiftListRequest);
-	oPacket.Encode2((int)aList.size());
+	oPacket->Encode2(CenterResultPacketType::CashItemResult);
+	oPacket->Encode4(uClientSocketSN);
+	oPacket->Encode4(nCharacterID);
+	oPacket->Encode2(CenterCashItemRequestType::eLoadGiftListRequest);
+	oPacket->Encode2((int)aList.size());
 	for (auto& pList : aList)
-		pList->Encode(&oPacket);
-
-	pSrv->SendPacket(&oPacket);
+		pList->Encode(oPacket);
 }
 
-void CashItemDBAccessor::PostLoadWishListRequest(SocketBase * pSrv, int uClientSocketSN, int nCharacterID)
+void CashItemDBAccessor::PostLoadWishListRequest(OutPacket *oPacket, int uClientSocketSN, int nCharacterID)
 {
 	auto pWishList = GW_WishList::Load(nCharacterID);
 	if (pWishList)
 	{
-		OutPacket oPacket;
-		oPacket.Encode2(CenterResultPacketType::CashItemResult);
-		oPacket.Encode4(uClientSocketSN);
-		oPacket.Encode4(nCharacterID);
-		oPacket.Encode2(CenterCashItemRequestType::eLoadWishItemRequest);
-		pWishList->Encode(&oPacket);
-		pSrv->SendPacket(&oPacket);
+		oPacket->Encode2(CenterResultPacketType::CashItemResult);
+		oPacket->Encode4(uClientSocketSN);
+		oPacket->Encode4(nCharacterID);
+		oPacket->Encode2(CenterCashItemRequestType::eLoadWishItemRequest);
+		pWishList->Encode(oPacket);
 	}
 }
 
-void CashItemDBAccessor::PostSetWishListRequest(SocketBase * pSrv, int uClientSocketSN, int nCharacterID, void *iPacket_)
+void CashItemDBAccessor::PostSetWishListRequest(OutPacket *oPacket, int uClientSocketSN, int nCharacterID, void *iPacket_)
 {
 	auto iPacket = (InPacket*)iPacket_;
 	GW_WishList WishList;
@@ -1,17 +1,18 @@
 #pragma once
-class SocketBase;
+class OutPacket;
 
+//The results are encoded into oPacket (nothing is encoded if there is no result), the caller sends them.
 class CashItemDBAccessor
 {
 public:
-	static void PostBuyCashItemRequest(SocketBase *pSrv, int uClientSocketSN, int nCharacterID, int nRequestType, void *iPacket, bool bGift = false);
-	static void PostLoadLockerRequest(SocketBase *pSrv, int uClientSocketSN, int nCharacterID, void *iPacket);
-	static void PostUpdateCashRequest(SocketBase *pSrv, int uClientSocketSN, int nCharacterID, void *iPacket);
-	static void PostMoveSlotToLockerRequest(SocketBase *pSrv, int uClientSocketSN, int nCharacterID, void *iPacket);
-	static void PostMoveLockerToSlotRequest(SocketBase *pSrv, int uClientSocketSN, int nCharacterID, void *iPacket);
-	static void PostExpireCashItemRequest(SocketBase *pSrv, int uClientSocketSN, int nCharacterID, void *iPacket);
-	static void PostLoadGiftListRequest(SocketBase *pSrv, int uClientSocketSN, int nCharacterID);
-	static void PostLoadWishListRequest(SocketBase *pSrv, int uClientSocketSN, int nCharacterID);
-	static void PostSetWishListRequest(SocketBase *pSrv, int uClientSocketSN, int nCharacterID, void *iPacket);
+	static void PostBuyCashItemRequest(OutPacket *oPacket, int uClientSocketSN, int nCharacterID, int nRequestType, void *iPacket, bool bGift = false);
+	static void PostLoadLockerRequest(OutPacket *oPacket, int uClientSocketSN, int nCharacterID, void *iPacket);
+	static void PostUpdateCashRequest(OutPacket *oPacket, int uClientSocketSN, int nCharacterID, void *iPacket);
+	static void PostMoveSlotToLockerRequest(OutPacket *oPacket, int uClientSocketSN, int nCharacterID, void *iPacket);
+	static void PostMoveLockerToSlotRequest(OutPacket *oPacket, int uClientSocketSN, int nCharacterID, void *iPacket);
+	static void PostExpireCashItemRequest(OutPacket *oPacket, int uClientSocketSN, int nCharacterID, void *iPacket);
+	static void PostLoadGiftListRequest(OutPacket *oPacket, int uClientSocketSN, int nCharacterID);
+	static void PostLoadWishListRequest(OutPacket *oPacket, int uClientSocketSN, int nCharacterID);
+	static void PostSetWishListRequest(OutPacket *oPacket, int uClientSocketSN, int nCharacterID, void *iPacket);
 };
 
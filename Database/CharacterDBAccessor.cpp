@@ -1,12 +1,12 @@
 #include "CharacterDBAccessor.h"
 #include "WvsUnified.h"
+#include "DBBatchWriter.h"
 #include "GW_ItemSlotEquip.h"
 #include "GW_CharacterStat.h"
 #include "GW_CharacterLevel.h"
 #include "GW_Avatar.hpp"
 #include "GW_Account.h"
 #include "GW_CharacterSlotCount.h"
-#include "GW_CharacterList.hpp"
 #include "GA_Character.hpp"
 #include "GW_FuncKeyMapped.h"
 #include "GW_Memo.h"
@@ -16,26 +16,56 @@
 #include "..\WvsLib\Net\SocketBase.h"
 #include "..\WvsCenter\CenterPacketTypes.hpp"
 #include "..\WvsLib\Memory\ZMemory.h"
+#include "..\WvsLib\Logger\WvsLogger.h"
+#include "..\WvsLib\Memory\MemoryPoolMan.hpp"
+
+#include <atomic>
+#include <chrono>
+
+namespace
+{
+	std::atomic<unsigned long long> liListLoadCount{ 0 }, liListLoadTimeInUs{ 0 }, liMaxListLoadTimeInUs{ 0 };
+	std::atomic<unsigned long long> liDataLoadCount{ 0 }, liDataLoadTimeInUs{ 0 }, liMaxDataLoadTimeInUs{ 0 };
+
+	void AddLoadTime(std::chrono::steady_clock::time_point tStart, std::atomic<unsigned long long>& liCount, std::atomic<unsigned long long>& liTotal, std::atomic<unsigned long long>& liMax)
+	{
+		auto liElapsed = (unsigned long long)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tStart).count();
+		auto liCurrentMax = liMax.load();
+		while (liElapsed > liCurrentMax && !liMax.compare_exchange_weak(liCurrentMax, liElapsed))
+			;
+		liTotal += liElapsed;
+		++liCount;
+	}
+}
 
 std::vector<int> CharacterDBAccessor::PostLoadCharacterListRequest(SocketBase *pSrv, int uLocalSocketSN, int nAccountID, int nWorldID)
 {
 	OutPacket oPacket;
-	GW_CharacterList chrList;
-	chrList.Load(nAccountID, nWorldID);
 	oPacket.Encode2(CenterResultPacketType::CharacterListResponse);
 	oPacket.Encode4(uLocalSocketSN);
+	auto aCharacterList = EncodeCharacterList(&oPacket, nAccountID, nWorldID);
+
+	pSrv->SendPacket(&oPacket);
+	return aCharacterList;
+}
 
-	oPacket.Encode1(chrList.nCount);
-	for (int i = 0; i < chrList.nCount; ++i)
+std::vector<int> CharacterDBAccessor::EncodeCharacterList(OutPacket *oPacket, int nAccountID, int nWorldID, bool bRecordLoadTime)
+{
+	auto tStart = std::chrono::steady_clock::now();
+	std::vector<ZUniquePtr<GA_Character>> aCharacter;
+	GA_Character::LoadAvatarList(nAccountID, nWorldID, aCharacter);
+
+	std::vector<int> aCharacterList;
+	oPacket->Encode1((char)aCharacter.size());
+	for (auto& pCharacter : aCharacter)
 	{
-		GA_Character chrEntry;
-		chrEntry.LoadCharacter(chrList.aCharacterList[i]);
-		chrEntry.EncodeAvatar(&oPacket);
-		oPacket.Encode1(0); //bRanking?
+		aCharacterList.push_back(pCharacter->nCharacterID);
+		pCharacter->EncodeAvatar(oPacket);
+		oPacket->Encode1(0); //bRanking?
 	}
-
-	pSrv->SendPacket(&oPacket);
-	return chrList.aCharacterList;
+	if (bRecordLoadTime)
+		AddLoadTime(tStart, liListLoadCount, liListLoadTimeInUs, liMaxListLoadTimeInUs);
+	return aCharacterList;
 }
 
 void CharacterDBAccessor::PostCheckDuplicatedID(SocketBase *pSrv, int uLocalSocketSN, int nAccountID, const std::string & sCharacterName)
@@ -134,13 +164,23 @@ void CharacterDBAccessor::PostCreateNewCharacterRequest(SocketBase *pSrv, int uL
 				aEquips[i]->nType = GW_ItemSlotBase::GW_ItemSlotType::EQUIP;
 				chrEntry.mItemSlot[1].insert({ aEquips[i]->nPOS, aEquips[i] });
 			}
-		chrEntry.Save(true);
+		bool bSaved = false;
+		{
+			DBBatchWriter writer;
+			chrEntry.Save(true);
 
-		GW_FuncKeyMapped funcKeyMapped(chrEntry.nCharacterID);
-		funcKeyMapped.Save(true);
-		oPacket.Encode1(0);
-		chrEntry.LoadCharacter(chrEntry.nCharacterID);
-		chrEntry.EncodeAvatar(&oPacket);
+			GW_FuncKeyMapped funcKeyMapped(chrEntry.nCharacterID);
+			funcKeyMapped.Save(true);
+			bSaved = writer.Commit();
+		}
+		if (bSaved)
+		{
+			oPacket.Encode1(0);
+			chrEntry.LoadCharacter(chrEntry.nCharacterID);
+			chrEntry.EncodeAvatar(&oPacket);
+		}
+		else
+			oPacket.Encode1(1);
 	}
 	else
 		oPacket.Encode1(1);
@@ -164,22 +204,24 @@ void CharacterDBAccessor::GetDefaultCharacterStat(int *aStat)
 	aStat[eStatData_POS_AP] = 0;
 }
 
-void CharacterDBAccessor::PostCharacterDataRequest(SocketBase *pSrv, int nClientSocketID, int nCharacterID, void *oPacket_)
+void CharacterDBAccessor::PostCharacterDataRequest(SocketBase *pSrv, int nClientSocketID, int nCharacterID, void *oPacket_, bool bRecordLoadTime)
 {
 	OutPacket *oPacket = (OutPacket*)oPacket_;
-	if (QueryCharacterAccountID(nCharacterID) == -1)
+	auto tStart = std::chrono::steady_clock::now();
+	GA_Character chrEntry;
+	if (!chrEntry.Load(nCharacterID))
 	{
 		oPacket->Encode1(0);
 		return;
 	}
 	oPacket->Encode1(1); //Valid
-	GA_Character chrEntry;
-	chrEntry.Load(nCharacterID);
 	oPacket->Encode4(chrEntry.nAccountID);
 	chrEntry.EncodeCharacterData(oPacket, true);
 	GW_FuncKeyMapped funcKeyMapped(chrEntry.nCharacterID);
 	funcKeyMapped.Load();
 	funcKeyMapped.Encode(oPacket);
+	if (bRecordLoadTime)
+		AddLoadTime(tStart, liDataLoadCount, liDataLoadTimeInUs, liMaxDataLoadTimeInUs);
 }
 
 int CharacterDBAccessor::QueryCharacterIDByName(const std::string & strName)
@@ -209,13 +251,61 @@ int CharacterDBAccessor::QueryCharacterAccountID(int nCharacterID)
 	return recordSet.rowCount() == 0 ? -1 : recordSet["AccountID"];
 }
 
-void CharacterDBAccessor::OnCharacterSaveRequest(void *iPacket)
+bool CharacterDBAccessor::OnCharacterSaveRequest(void *iPacket)
 {
 	InPacket *iPacket_ = (InPacket*)iPacket;
 	GA_Character chr;
 	chr.DecodeCharacterData(iPacket_, true);
-	chr.Save(false);
 	GW_FuncKeyMapped keyMapped(chr.nCharacterID);
 	keyMapped.Decode(iPacket_, false);
+
+	DBBatchWriter writer;
+	chr.Save(false);
 	keyMapped.Save(false);
-}
\ No newline at end of file
+	return writer.Commit();
+}
+
+void CharacterDBAccessor::OnCharacterDeltaSaveRequest(SocketBase *pSrv, void *iPacket)
+{
+	InPacket *iPacket_ = (InPacket*)iPacket;
+	GA_Character chr;
+	int nDeltaFlag = chr.DecodeCharacterDataDelta(iPacket_);
+	GW_FuncKeyMapped keyMapped(chr.nCharacterID);
+	keyMapped.Decode(iPacket_, false);
+	if (SaveCharacterData(&chr, nDeltaFlag, &keyMapped))
+		return;
+
+	//The digests of the game server already count the failed data as saved.
+	OutPacket oPacket;
+	oPacket.Encode2(CenterResultPacketType::FlushCharacterDataFailed);
+	oPacket.Encode4(chr.nCharacterID);
+	pSrv->SendPacket(&oPacket);
+}
+
+bool CharacterDBAccessor::SaveCharacterData(GA_Character *pCharacter, int nDeltaFlag, GW_FuncKeyMapped *pFuncKeyMapped)
+{
+	//A statement which throws before Commit leaves the writer uncommitted, it rolls back.
+	try
+	{
+		DBBatchWriter writer;
+		pCharacter->SaveDelta(nDeltaFlag);
+		pFuncKeyMapped->Save(false);
+		return writer.Commit();
+	}
+	catch (std::exception& ex)
+	{
+		WvsLogger::LogSubsystem(WvsLogger::SUB_DB, WvsLogger::SEV_ERROR, "[CharacterDBAccessor::SaveCharacterData]Failed to save the character %d: %s\n", pCharacter->nCharacterID, ex.what());
+	}
+	return false;
+}
+CharacterLoadStat CharacterDBAccessor::GetLoadStat()
+{
+	CharacterLoadStat stat;
+	stat.liListLoadCount = liListLoadCount;
+	stat.liListLoadTimeInUs = liListLoadTimeInUs;
+	stat.liMaxListLoadTimeInUs = liMaxListLoadTimeInUs;
+	stat.liDataLoadCount = liDataLoadCount;
+	stat.liDataLoadTimeInUs = liDataLoadTimeInUs;
+	stat.liMaxDataLoadTimeInUs = liMaxDataLoadTimeInUs;
+	return stat;
+}
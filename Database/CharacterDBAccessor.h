@@ -3,6 +3,15 @@
 #include <string>
 
 class SocketBase;
+class OutPacket;
+struct GA_Character;
+struct GW_FuncKeyMapped;
+
+struct CharacterLoadStat
+{
+	unsigned long long liListLoadCount = 0, liListLoadTimeInUs = 0, liMaxListLoadTimeInUs = 0;
+	unsigned long long liDataLoadCount = 0, liDataLoadTimeInUs = 0, liMaxDataLoadTimeInUs = 0;
+};
 
 class CharacterDBAccessor
 {
@@ -52,13 +61,30 @@ public:
 
 	//Character & Account Data
 	static std::vector<int> PostLoadCharacterListRequest(SocketBase *pSrv, int uLocalSocketSN, int nAccountID, int nWorldID);
+
+	//Encodes the avatars of the characters of the account in nWorldID, returns the IDs of them.
+	//bRecordLoadTime = false keeps the load out of GetLoadStat, e.g. for benches.
+	static std::vector<int> EncodeCharacterList(OutPacket *oPacket, int nAccountID, int nWorldID, bool bRecordLoadTime = true);
 	static void PostCheckDuplicatedID(SocketBase *pSrv, int uLocalSocketSN, int nAccountID, const std::string& sCharacterName);
 	static void PostCreateNewCharacterRequest(SocketBase *pSrv, int uLocalSocketSN, int nAccountID, int nWorldID, const std::string& strName, int nGender, int nFace, int nHair, int nSkin, const int* aBody, const int* aStat);
-	static void PostCharacterDataRequest(SocketBase *pSrv, int uClientSocketSN, int nCharacterID, void *oPacket);
+	static void PostCharacterDataRequest(SocketBase *pSrv, int uClientSocketSN, int nCharacterID, void *oPacket, bool bRecordLoadTime = true);
 	static int QueryCharacterIDByName(const std::string& strName);
 	static int QueryCharacterFriendMax(int nCharacterID);
 	static int QueryCharacterAccountID(int nCharacterID);
-	static void OnCharacterSaveRequest(void *iPacket);
+	static bool OnCharacterSaveRequest(void *iPacket);
+
+	//Saves the records of the character data delta (GA_Character::EncodeCharacterDataDelta) only.
+	//pSrv is told with FlushCharacterDataFailed if the save fails, its next flush sends the whole character.
+	static void OnCharacterDeltaSaveRequest(SocketBase *pSrv, void *iPacket);
+
+	/*
+	Saves the blocks of nDeltaFlag and the records of a decoded character (and its key map) in one transaction.
+	Returns false if the transaction was rolled back, nothing of the character has been written then.
+	*/
+	static bool SaveCharacterData(GA_Character *pCharacter, int nDeltaFlag, GW_FuncKeyMapped *pFuncKeyMapped);
+
+	//Latency of the character list loads and the character data loads (migrations) since the start.
+	static CharacterLoadStat GetLoadStat();
 
 	//Memo
 };
@@ -0,0 +1,241 @@
+#include "DBBatchWriter.h"
+#include "WvsUnified.h"
+#include "Poco\Data\Statement.h"
+#include "Poco\Data\Binding.h"
+#include "..\WvsLib\Logger\WvsLogger.h"
+
+#include <atomic>
+#include <chrono>
+
+namespace
+{
+	std::atomic<unsigned long long> liTransactionCount{ 0 }, liRollbackCount{ 0 }, liStatementCount{ 0 }, liRowCount{ 0 };
+	std::atomic<unsigned long long> liCommitTimeInUs{ 0 }, liMaxCommitTimeInUs{ 0 };
+}
+
+thread_local DBBatchWriter* DBBatchWriter::ms_pCurrent = nullptr;
+
+DBBatchWriter::RowAppender::RowAppender(std::vector<BatchValue>* paValue)
+	: m_paValue(paValue)
+{
+}
+
+DBBatchWriter::RowAppender& DBBatchWriter::RowAppender::operator<<(long long int liValue)
+{
+	m_paValue->emplace_back();
+	m_paValue->back().liValue = liValue;
+	return *this;
+}
+
+DBBatchWriter::RowAppender& DBBatchWriter::RowAppender::operator<<(const std::string& sValue)
+{
+	m_paValue->emplace_back();
+	m_paValue->back().bString = true;
+	m_paValue->back().sValue = sValue;
+	return *this;
+}
+
+DBBatchWriter::DBBatchWriter(bool bTransaction)
+	: m_session(WvsUnified::GetInstance()->GetDBSession())
+{
+	if (ms_pCurrent)
+	{
+		m_pOuter = ms_pCurrent;
+		return;
+	}
+	ms_pCurrent = this;
+	if (bTransaction)
+	{
+		m_session.begin();
+		m_bTransaction = true;
+	}
+}
+
+DBBatchWriter::~DBBatchWriter()
+{
+	if (m_pOuter)
+		return;
+	ms_pCurrent = nullptr;
+	if (m_bTransaction && !m_bCommitted)
+	{
+		try
+		{
+			m_session.rollback();
+		}
+		catch (Poco::Exception& ex)
+		{
+			WvsLogger::LogSubsystem(WvsLogger::SUB_DB, WvsLogger::SEV_ERROR, "DBBatchWriter: Failed to roll back, %s\n", ex.displayText().c_str());
+		}
+		++liRollbackCount;
+	}
+}
+
+DBBatchWriter::Batch& DBBatchWriter::GetBatch(const std::string& sKey)
+{
+	auto findIter = m_mBatchIndex.find(sKey);
+	if (findIter != m_mBatchIndex.end())
+		return m_aBatch[findIter->second];
+	m_mBatchIndex.insert({ sKey, (int)m_aBatch.size() });
+	m_aBatch.emplace_back();
+	return m_aBatch.back();
+}
+
+DBBatchWriter::RowAppender DBBatchWriter::Upsert(const std::string& sTable, const std::string& sColumn, const std::string& sUpdateColumn)
+{
+	if (m_pOuter)
+		return m_pOuter->Upsert(sTable, sColumn, sUpdateColumn);
+
+	auto& batch = GetBatch(sTable + "|" + sColumn + "|" + sUpdateColumn);
+	if (batch.nColumnCount == 0)
+	{
+		batch.sTable = sTable;
+		batch.sColumn = sColumn;
+		batch.sUpdateColumn = sUpdateColumn;
+		batch.nColumnCount = 1;
+		for (char c : sColumn)
+			batch.nColumnCount += (c == ',');
+	}
+	return RowAppender(&batch.aValue);
+}
+
+void DBBatchWriter::Detach(const std::string& sTable, const std::string& sKeyColumn, int nCharacterID, long long int liKey)
+{
+	if (m_pOuter)
+		return m_pOuter->Detach(sTable, sKeyColumn, nCharacterID, liKey);
+
+	auto& batch = GetBatch(sTable + "|" + sKeyColumn + "|" + std::to_string(nCharacterID));
+	if (batch.nColumnCount == 0)
+	{
+		batch.sTable = sTable;
+		batch.sColumn = sKeyColumn;
+		batch.nColumnCount = 1;
+		batch.nCharacterID = nCharacterID;
+		batch.bDetach = true;
+	}
+	RowAppender(&batch.aValue) << liKey;
+}
+
+int DBBatchWriter::ExecuteBatch(Batch& batch)
+{
+	int nRowCount = (int)batch.aValue.size() / batch.nColumnCount, nStatementCount = 0;
+	if ((int)batch.aValue.size() % batch.nColumnCount)
+		throw std::runtime_error("DBBatchWriter: Incomplete row for table " + batch.sTable + ".");
+
+	std::string sPlaceholder = "(?";
+	for (int i = 1; i < batch.nColumnCount; ++i)
+		sPlaceholder += ", ?";
+	sPlaceholder += ")";
+
+	std::string sUpdate;
+	if (!batch.bDetach)
+	{
+		std::string sColumn;
+		for (size_t nPos = 0, nNext = 0; nPos <= batch.sUpdateColumn.size(); nPos = nNext + 1)
+		{
+			nNext = batch.sUpdateColumn.find(',', nPos);
+			if (nNext == std::string::npos)
+				nNext = batch.sUpdateColumn.size();
+			sColumn = batch.sUpdateColumn.substr(nPos, nNext - nPos);
+			sColumn.erase(0, sColumn.find_first_not_of(' '));
+			sColumn.erase(sColumn.find_last_not_of(' ') + 1);
+			if (sColumn.empty())
+				continue;
+			sUpdate += (sUpdate.empty() ? " ON DUPLICATE KEY UPDATE " : ", ") + sColumn + " = VALUES(" + sColumn + ")";
+		}
+	}
+
+	for (int nRow = 0; nRow < nRowCount; nRow += MAX_ROW_PER_STATEMENT)
+	{
+		int nCount = (nRowCount - nRow < MAX_ROW_PER_STATEMENT ? nRowCount - nRow : MAX_ROW_PER_STATEMENT);
+		std::string sQuery;
+		if (batch.bDetach)
+			sQuery = "UPDATE " + batch.sTable + " Set CharacterID = -1 Where CharacterID = ? AND " + batch.sColumn + " IN (?";
+		else
+			sQuery = "INSERT INTO " + batch.sTable + " (" + batch.sColumn + ") VALUES" + sPlaceholder;
+		for (int i = 1; i < nCount; ++i)
+			sQuery += (batch.bDetach ? ", ?" : ", " + sPlaceholder);
+		sQuery += (batch.bDetach ? ")" : sUpdate);
+
+		Poco::Data::Statement queryStatement(m_session);
+		queryStatement << sQuery;
+		if (batch.bDetach)
+			queryStatement, Poco::Data::Keywords::use(batch.nCharacterID);
+		for (int i = nRow * batch.nColumnCount, nEnd = (nRow + nCount) * batch.nColumnCount; i < nEnd; ++i)
+		{
+			auto& value = batch.aValue[i];
+			if (value.bString)
+				queryStatement, Poco::Data::Keywords::use(value.sValue);
+			else
+				queryStatement, Poco::Data::Keywords::use(value.liValue);
+		}
+		try
+		{
+			queryStatement.execute();
+		}
+		catch (Poco::Exception& ex)
+		{
+			WvsLogger::LogSubsystem(WvsLogger::SUB_DB, WvsLogger::SEV_ERROR, "SQL Exception Occurred: %s\nRaw Query = %s\n", ex.displayText().c_str(), sQuery.c_str());
+			throw;
+		}
+		++nStatementCount;
+	}
+	liRowCount += nRowCount;
+	return nStatementCount;
+}
+
+bool DBBatchWriter::Commit()
+{
+	if (m_pOuter || m_bCommitted)
+		return true;
+
+	auto tStart = std::chrono::steady_clock::now();
+	int nStatementCount = 0;
+	try
+	{
+		for (auto& batch : m_aBatch)
+			nStatementCount += ExecuteBatch(batch);
+		if (m_bTransaction)
+			m_session.commit();
+	}
+	catch (std::exception& ex)
+	{
+		//The destructor rolls back.
+		WvsLogger::LogSubsystem(WvsLogger::SUB_DB, WvsLogger::SEV_ERROR, "DBBatchWriter: Failed to commit, %s\n", ex.what());
+		liStatementCount += nStatementCount;
+		return false;
+	}
+	m_bCommitted = true;
+	m_aBatch.clear();
+	m_mBatchIndex.clear();
+
+	auto liElapsed = (unsigned long long)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tStart).count();
+	auto liMax = liMaxCommitTimeInUs.load();
+	while (liElapsed > liMax && !liMaxCommitTimeInUs.compare_exchange_weak(liMax, liElapsed))
+		;
+	liCommitTimeInUs += liElapsed;
+	liStatementCount += nStatementCount;
+	++liTransactionCount;
+	return true;
+}
+
+Poco::Data::Session& DBBatchWriter::GetSession()
+{
+	return m_session;
+}
+
+DBBatchWriter* DBBatchWriter::GetCurrent()
+{
+	return ms_pCurrent;
+}
+
+DBBatchWriterStat DBBatchWriter::GetStat()
+{
+	DBBatchWriterStat stat;
+	stat.liTransactionCount = liTransactionCount;
+	stat.liRollbackCount = liRollbackCount;
+	stat.liStatementCount = liStatementCount;
+	stat.liRowCount = liRowCount;
+	stat.liCommitTimeInUs = liCommitTimeInUs;
+	stat.liMaxCommitTimeInUs = liMaxCommitTimeInUs;
+	return stat;
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <map>
+#include "Poco\Data\Session.h"
+
+struct DBBatchWriterStat
+{
+	unsigned long long liTransactionCount = 0, liRollbackCount = 0, liStatementCount = 0, liRowCount = 0;
+	unsigned long long liCommitTimeInUs = 0, liMaxCommitTimeInUs = 0;
+};
+
+/*
+Gathers the rows written by a save into multi-row statements with bound parameters, and runs them in one
+transaction on one session when Commit is called. The transaction is rolled back if the writer is destroyed
+before committing.
+
+While a writer is alive, GET_DB_SESSION on its thread returns the session of the writer, so the statements
+which aren't batched join the same transaction. A writer created while another one is alive on the same thread
+joins the outer one, its rows are written when the outer one commits.
+*/
+class DBBatchWriter
+{
+	//Rows per statement, keeps the parameters of a statement within the limit of the server.
+	static const int MAX_ROW_PER_STATEMENT = 256;
+
+	struct BatchValue
+	{
+		bool bString = false;
+		long long int liValue = 0;
+		std::string sValue;
+	};
+
+	struct Batch
+	{
+		std::string sTable, sColumn, sUpdateColumn;
+		int nColumnCount = 0, nCharacterID = 0;
+		bool bDetach = false;
+		std::vector<BatchValue> aValue;
+	};
+
+	static thread_local DBBatchWriter* ms_pCurrent;
+
+	Poco::Data::Session m_session;
+	DBBatchWriter *m_pOuter = nullptr;
+	bool m_bTransaction = false, m_bCommitted = false;
+
+	std::vector<Batch> m_aBatch;
+	std::map<std::string, int> m_mBatchIndex;
+
+	Batch& GetBatch(const std::string& sKey);
+	int ExecuteBatch(Batch& batch);
+
+public:
+	class RowAppender
+	{
+		friend class DBBatchWriter;
+		std::vector<BatchValue> *m_paValue;
+
+		RowAppender(std::vector<BatchValue> *paValue);
+	public:
+		RowAppender& operator<<(long long int liValue);
+		RowAppender& operator<<(const std::string& sValue);
+	};
+
+	//bTransaction = false runs the statements autocommitted, for saving a single row.
+	DBBatchWriter(bool bTransaction = true);
+	~DBBatchWriter();
+
+	/*
+	Starts a row of INSERT INTO sTable (sColumn) VALUES (...) ON DUPLICATE KEY UPDATE c = VALUES(c) for each c of
+	sUpdateColumn. The values are appended by the returned RowAppender in the order of sColumn.
+	*/
+	RowAppender Upsert(const std::string& sTable, const std::string& sColumn, const std::string& sUpdateColumn);
+
+	//UPDATE sTable Set CharacterID = -1 Where CharacterID = nCharacterID AND sKeyColumn IN (liKey, ...)
+	void Detach(const std::string& sTable, const std::string& sKeyColumn, int nCharacterID, long long int liKey);
+
+	//Writes the gathered rows and commits. Errors are logged and the transaction is rolled back, returns false then.
+	bool Commit();
+
+	Poco::Data::Session& GetSession();
+
+	//The writer which the statements on this thread are part of, nullptr if none.
+	static DBBatchWriter* GetCurrent();
+	static DBBatchWriterStat GetStat();
+};
@@ -31,39 +31,102 @@ GA_Character::~GA_Character()
 {
 }
 
-void GA_Character::Load(int nCharacterID)
+//The columns decoded by LoadCharacterRow, followed by GW_CharacterStat::LOAD_COLUMN.
+static const char* CHARACTER_COLUMN = "`Character`.CharacterID, `Character`.AccountID, `Character`.WorldID, `Character`.CharacterName, `Character`.FieldID, `Character`.FriendMaxNum, `Character`.GradeCode, `Character`.ActiveEffectItemID, CharacterLevel.Level";
+static const char* CHARACTER_JOIN = " FROM `Character` JOIN CharacterStat ON CharacterStat.CharacterID = `Character`.CharacterID JOIN CharacterLevel ON CharacterLevel.CharacterID = `Character`.CharacterID";
+
+bool GA_Character::Load(int nCharacterID)
 {
-	LoadCharacter(nCharacterID);
-	mMoney->Load(nCharacterID);
-	mSlotCount->Load(nCharacterID);
+	std::string sMapTransferColumn;
+	for (int i = 0; i < MaxMapTransferCount; ++i)
+		sMapTransferColumn += ", MapTransfer.Map" + std::to_string(i);
+	for (int i = 0; i < MaxMapTransferExCount; ++i)
+		sMapTransferColumn += ", MapTransferEx.Map" + std::to_string(i);
+
+	//Every one-row block of the character comes in one row, the records follow with one query per kind.
+	Poco::Data::Statement queryStatement(GET_DB_SESSION);
+	queryStatement << "SELECT " << CHARACTER_COLUMN << ", " << GW_CharacterStat::LOAD_COLUMN << ", CharacterMoney.Money, " << GW_CharacterSlotCount::LOAD_COLUMN << sMapTransferColumn
+		<< CHARACTER_JOIN
+		<< " JOIN CharacterMoney ON CharacterMoney.CharacterID = `Character`.CharacterID"
+		<< " JOIN CharacterSlotCount ON CharacterSlotCount.CharacterID = `Character`.CharacterID"
+		<< " LEFT JOIN MapTransfer ON MapTransfer.CharacterID = `Character`.CharacterID"
+		<< " LEFT JOIN MapTransferEx ON MapTransferEx.CharacterID = `Character`.CharacterID"
+		<< " Where `Character`.CharacterID = " << nCharacterID;
+	queryStatement.execute();
+	Poco::Data::RecordSet recordSet(queryStatement);
+	if (recordSet.rowCount() == 0)
+		return false;
+
+	int nColumn = LoadCharacterRow((void*)&recordSet, 0);
+	mMoney->nMoney = recordSet.value(nColumn++, 0);
+	nColumn = mSlotCount->Load((void*)&recordSet, 0, nColumn);
+	LoadMapTransfer((void*)&recordSet, 0, nColumn);
+
 	LoadItemSlot();
+
+	//The avatar is made of the worn equips just loaded, the equips are placed before the cash equips.
+	for (int nCash = 0; nCash < 2; ++nCash)
+		for (auto& prItem : mItemSlot[GW_ItemSlotBase::EQUIP])
+			if (prItem.first < 0 && prItem.second->bIsCash == (nCash == 1))
+				mAvatarData->SetEquip((short)prItem.first, prItem.second->nItemID, prItem.second->bIsCash);
+
 	LoadSkillRecord();
 	LoadQuestRecord();
+	return true;
 }
 
 void GA_Character::LoadCharacter(int nCharacterID)
 {
-	mAvatarData->Load(nCharacterID);
-	mStat->Load(nCharacterID);
-	mLevel->Load(nCharacterID);
-
 	Poco::Data::Statement queryStatement(GET_DB_SESSION);
-	queryStatement << "SELECT * FROM `Character` Where CharacterID = " << nCharacterID;
+	queryStatement << "SELECT " << CHARACTER_COLUMN << ", " << GW_CharacterStat::LOAD_COLUMN << CHARACTER_JOIN
+		<< " Where `Character`.CharacterID = " << nCharacterID;
+	queryStatement.execute();
 	Poco::Data::RecordSet recordSet(queryStatement);
+	LoadCharacterRow((void*)&recordSet, 0);
+
+	std::map<int, GW_Avatar*> mAvatar = { { nCharacterID, mAvatarData } };
+	GW_Avatar::LoadEquip(mAvatar);
+}
+
+void GA_Character::LoadAvatarList(int nAccountID, int nWorldID, std::vector<ZUniquePtr<GA_Character>>& aCharacter)
+{
+	Poco::Data::Statement queryStatement(GET_DB_SESSION);
+	queryStatement << "SELECT " << CHARACTER_COLUMN << ", " << GW_CharacterStat::LOAD_COLUMN << CHARACTER_JOIN
+		<< " Where `Character`.AccountID = " << nAccountID << " AND `Character`.WorldID = " << nWorldID
+		<< " ORDER BY `Character`.CharacterID";
 	queryStatement.execute();
-	this->nCharacterID = nCharacterID;
-	nAccountID = recordSet["AccountID"];
-	nWorldID = recordSet["WorldID"];
-	strName = recordSet["CharacterName"].toString();
-	//nGuildID = recordSet["GuildID"];
-	//nPartyID = recordSet["PartyID"];
-	nFieldID = recordSet["FieldID"];
-	nFriendMax = recordSet["FriendMaxNum"];
-	nGradeCode = recordSet["GradeCode"];
-	nActiveEffectItemID = recordSet["ActiveEffectItemID"];
-	//nGender = recordSet["Gender"];
+	Poco::Data::RecordSet recordSet(queryStatement);
+
+	std::map<int, GW_Avatar*> mAvatar;
+	for (int i = 0; i < (int)recordSet.rowCount(); ++i)
+	{
+		aCharacter.emplace_back(AllocObj(GA_Character));
+		auto& pCharacter = aCharacter.back();
+		pCharacter->LoadCharacterRow((void*)&recordSet, i);
+		mAvatar[pCharacter->nCharacterID] = pCharacter->mAvatarData;
+	}
+	GW_Avatar::LoadEquip(mAvatar);
+}
 
-	LoadMapTransfer();
+int GA_Character::LoadCharacterRow(void *pRecordSet, int nRow)
+{
+	Poco::Data::RecordSet &recordSet = *((Poco::Data::RecordSet*)pRecordSet);
+	int nColumn = 0;
+	nCharacterID = recordSet.value(nColumn++, nRow);
+	nAccountID = recordSet.value(nColumn++, nRow);
+	nWorldID = recordSet.value(nColumn++, nRow);
+	strName = recordSet.value(nColumn++, nRow).toString();
+	nFieldID = recordSet.value(nColumn++, nRow);
+	nFriendMax = recordSet.value(nColumn++, nRow);
+	nGradeCode = recordSet.value(nColumn++, nRow);
+	nActiveEffectItemID = recordSet.value(nColumn++, nRow);
+	mLevel->nLevel = recordSet.value(nColumn++, nRow);
+	nColumn = mStat->Load(pRecordSet, nRow, nColumn);
+
+	mAvatarData->nHair = mStat->nHair;
+	mAvatarData->nFace = mStat->nFace;
+	mAvatarData->nSkin = mStat->nSkin;
+	return nColumn;
 }
 
 void GA_Character::EncodeAvatar(OutPacket *oPacket)
@@ -165,6 +228,39 @@ void GA_Character::Save(bool bIsNewCharacter)
 		newRecordStatement.reset(GET_DB_SESSION);
 		//newRecordStatement << "SELECT CharacterID FROM Characters"
 	}
+	SaveCharacter();
+	mAvatarData->Save(nCharacterID, bIsNewCharacter);
+	mMoney->Save(nCharacterID, bIsNewCharacter);
+	mLevel->Save(nCharacterID, bIsNewCharacter);
+	mStat->Save(nCharacterID, bIsNewCharacter);
+	mSlotCount->Save(nCharacterID, bIsNewCharacter);
+	SaveMapTransfer();
+	SaveRecord();
+}
+
+/*
+Saves the character decoded by DecodeCharacterDataDelta.
+The record maps only hold the dirty records, the blocks are saved when their flags are present.
+*/
+void GA_Character::SaveDelta(int nDeltaFlag)
+{
+	if (nDeltaFlag & eDelta_Stat)
+	{
+		SaveCharacter();
+		mLevel->Save(nCharacterID);
+		mStat->Save(nCharacterID, false);
+	}
+	if (nDeltaFlag & eDelta_Money)
+		mMoney->Save(nCharacterID);
+	if (nDeltaFlag & eDelta_SlotCount)
+		mSlotCount->Save(nCharacterID);
+	if (nDeltaFlag & eDelta_MapTransfer)
+		SaveMapTransfer();
+	SaveRecord();
+}
+
+void GA_Character::SaveCharacter()
+{
 	Poco::Data::Statement queryStatement(GET_DB_SESSION);
 	queryStatement << "UPDATE `Character` Set "
 		<< "CharacterName = '" << strName << "', "
@@ -172,13 +268,10 @@ void GA_Character::Save(bool bIsNewCharacter)
 		<< "FieldID = " << nFieldID << " WHERE CharacterID = " << nCharacterID;
 
 	queryStatement.execute();
-	mAvatarData->Save(nCharacterID, bIsNewCharacter);
-	mMoney->Save(nCharacterID, bIsNewCharacter);
-	mLevel->Save(nCharacterID, bIsNewCharacter);
-	mStat->Save(nCharacterID, bIsNewCharacter);
-	mSlotCount->Save(nCharacterID, bIsNewCharacter);
-	SaveMapTransfer();
+}
 
+void GA_Character::SaveRecord()
+{
 	for (auto& eqp : mItemSlot[1])
 		((eqp.second))->Save(nCharacterID);
 	for (auto& con : mItemSlot[2])
@@ -502,30 +595,10 @@ void GA_Character::DecodeCharacterData(InPacket *iPacket, bool bForInternal)
 	}
 
 	if (flag & 0x200)
-	{
-		int nStartedQuestSize = iPacket->Decode2();
-		for (int i = 0; i < nStartedQuestSize; ++i)
-		{
-			GW_QuestRecord *pRecord = AllocObj(GW_QuestRecord);
-			pRecord->nCharacterID = nCharacterID;
-			pRecord->nState = 1;
-			pRecord->Decode(iPacket, 1);
-			mQuestRecord.insert({ pRecord->nQuestID, pRecord });
-		}
-	}
+		DecodeQuestRecord(iPacket, 1);
 
 	if (flag & 0x4000)
-	{
-		int nCompletedQuestSize = iPacket->Decode2();
-		for (int i = 0; i < nCompletedQuestSize; ++i)
-		{
-			GW_QuestRecord *pRecord = AllocObj(GW_QuestRecord);
-			pRecord->nCharacterID = nCharacterID;
-			pRecord->nState = 2;
-			pRecord->Decode(iPacket, 2);
-			mQuestComplete.insert({ pRecord->nQuestID, pRecord });
-		}
-	}
+		DecodeQuestRecord(iPacket, 2);
 
 	if (flag & 0x400)
 	{
@@ -704,6 +777,142 @@ void GA_Character::DecodeSkillRecord(InPacket * iPacket)
 	}
 }
 
+void GA_Character::DecodeQuestRecord(InPacket * iPacket, int nState)
+{
+	int nCount = iPacket->Decode2();
+	for (int i = 0; i < nCount; ++i)
+	{
+		GW_QuestRecord *pRecord = AllocObj(GW_QuestRecord);
+		pRecord->nCharacterID = nCharacterID;
+		pRecord->nState = nState;
+		pRecord->Decode(iPacket, nState);
+		(nState == 1 ? mQuestRecord : mQuestComplete).insert({ pRecord->nQuestID, pRecord });
+	}
+}
+
+int GA_Character::DecodeCharacterDataDelta(InPacket * iPacket)
+{
+	nCharacterID = iPacket->Decode4();
+	int nDeltaFlag = iPacket->Decode1();
+	if (nDeltaFlag & eDelta_Stat)
+	{
+		DecodeStat(iPacket);
+		DecodeInternalData(iPacket);
+	}
+	if (nDeltaFlag & eDelta_Money)
+		mMoney->nMoney = iPacket->Decode8();
+	if (nDeltaFlag & eDelta_SlotCount)
+		for (int i = 1; i <= 5; ++i)
+			mSlotCount->aSlotCount[i] = iPacket->Decode1();
+	if (nDeltaFlag & eDelta_MapTransfer)
+	{
+		iPacket->DecodeBuffer((unsigned char*)&anMapTransfer, sizeof(anMapTransfer));
+		iPacket->DecodeBuffer((unsigned char*)&anMapTransferEx, sizeof(anMapTransferEx));
+	}
+
+	DecodeInventoryRemovedRecord(iPacket);
+	for (int nTI = 1; nTI <= 5; ++nTI)
+	{
+		int nCount = iPacket->Decode2();
+		for (int i = 0; i < nCount; ++i)
+		{
+			short nPOS = iPacket->Decode2();
+			GW_ItemSlotBase *pItem = GW_ItemSlotBase::CreateItem(iPacket->Decode1());
+			if (!pItem)
+				throw std::runtime_error("Invalid item instance type in the character data delta.");
+
+			iPacket->Decode1(); //Inventory position, nPOS is sent in full above.
+			pItem->nPOS = nPOS;
+			pItem->nType = (GW_ItemSlotBase::GW_ItemSlotType)nTI;
+			pItem->Decode(iPacket, true);
+			mItemSlot[nTI].insert({ pItem->nPOS, pItem });
+		}
+	}
+	DecodeSkillRecord(iPacket);
+	DecodeQuestRecord(iPacket, 1);
+	DecodeQuestRecord(iPacket, 2);
+	return nDeltaFlag;
+}
+
+int GA_Character::MergeCharacterDataDelta(int nDeltaFlag, GA_Character& newer, int nNewerDeltaFlag)
+{
+	if (nNewerDeltaFlag & eDelta_Stat)
+	{
+		strName = newer.strName;
+		nFieldID = newer.nFieldID;
+		nGradeCode = newer.nGradeCode;
+		nActiveEffectItemID = newer.nActiveEffectItemID;
+		mStat.swap(newer.mStat);
+		mLevel.swap(newer.mLevel);
+	}
+	if (nNewerDeltaFlag & eDelta_Money)
+		mMoney.swap(newer.mMoney);
+	if (nNewerDeltaFlag & eDelta_SlotCount)
+		mSlotCount.swap(newer.mSlotCount);
+	if (nNewerDeltaFlag & eDelta_MapTransfer)
+	{
+		std::copy(newer.anMapTransfer, newer.anMapTransfer + MaxMapTransferCount, anMapTransfer);
+		std::copy(newer.anMapTransferEx, newer.anMapTransferEx + MaxMapTransferExCount, anMapTransferEx);
+	}
+
+	//An item is identified by its SN rather than its position, since it may have been moved between the deltas.
+	auto lmdIsSameItem = [](const ZSharedPtr<GW_ItemSlotBase>& pItem, const std::pair<long long int, bool>& prSN)
+	{
+		return prSN.first == (prSN.second ? pItem->liCashItemSN : pItem->liItemSN);
+	};
+	auto lmdGetSN = [](const ZSharedPtr<GW_ItemSlotBase>& pItem)
+	{
+		return pItem->liItemSN != -1 ? std::make_pair(pItem->liItemSN, false) : std::make_pair(pItem->liCashItemSN, true);
+	};
+	auto lmdEraseItem = [&](int nTI, const std::pair<long long int, bool>& prSN)
+	{
+		for (auto iter = mItemSlot[nTI].begin(); iter != mItemSlot[nTI].end(); )
+			if (lmdIsSameItem(iter->second, prSN))
+				iter = mItemSlot[nTI].erase(iter);
+			else
+				++iter;
+	};
+
+	for (int nTI = 1; nTI <= 5; ++nTI)
+	{
+		for (auto& prSN : newer.mItemRemovedRecord[nTI])
+		{
+			lmdEraseItem(nTI, prSN);
+			mItemRemovedRecord[nTI].insert(prSN);
+		}
+
+		//An item removed by this delta and put back by the newer one is no longer removed.
+		for (auto& prItem : newer.mItemSlot[nTI])
+		{
+			auto prSN = lmdGetSN(prItem.second);
+			if (prSN.first == -1)
+				continue;
+			lmdEraseItem(nTI, prSN);
+			for (auto iter = mItemRemovedRecord[nTI].begin(); iter != mItemRemovedRecord[nTI].end(); )
+				if (lmdIsSameItem(prItem.second, *iter))
+					iter = mItemRemovedRecord[nTI].erase(iter);
+				else
+					++iter;
+		}
+		for (auto& prItem : newer.mItemSlot[nTI])
+			mItemSlot[nTI][prItem.first] = prItem.second;
+	}
+
+	for (auto& prRecord : newer.mSkillRecord)
+		mSkillRecord[prRecord.first].swap(prRecord.second);
+	for (auto& prRecord : newer.mQuestRecord)
+	{
+		mQuestComplete.erase(prRecord.first);
+		mQuestRecord[prRecord.first].swap(prRecord.second);
+	}
+	for (auto& prRecord : newer.mQuestComplete)
+	{
+		mQuestRecord.erase(prRecord.first);
+		mQuestComplete[prRecord.first].swap(prRecord.second);
+	}
+	return nDeltaFlag | nNewerDeltaFlag;
+}
+
 void GA_Character::EncodeCharacterData(OutPacket *oPacket, bool bForInternal)
 {
 	long long int flag = 0xFFFFFFFFFFFFFFFF;
@@ -834,6 +1043,142 @@ void GA_Character::EncodeInventoryRemovedRecord(OutPacket * oPacket)
 	}
 }
 
+void GA_Character::EncodeCharacterDataDelta(OutPacket * oPacket)
+{
+	EncodeDirtyData(oPacket);
+}
+
+void GA_Character::ResetCharacterDataDelta()
+{
+	EncodeDirtyData(nullptr);
+}
+
+void GA_Character::ClearCharacterDataDelta()
+{
+	mFlushedDigest = FlushedDigest();
+}
+
+/*
+Records are compared by the digest of their encoding, so the records which are modified in place (stacking, upgrading, 
+and so on) are caught without touching every caller. The digests of the vacated positions are dropped, an item which 
+is put back after its removal was flushed is then sent again.
+oPacket = nullptr only takes the digests.
+*/
+void GA_Character::EncodeDirtyData(OutPacket * oPacket)
+{
+	OutPacket oRecord, oSection;
+	int nDeltaFlag = 0, nCount = 0;
+
+	//Appends the record to oSection when its digest differs from the flushed one.
+	auto lmdCheckDirty = [&](unsigned int& nFlushed)
+	{
+		unsigned int nDigest = 2166136261U;
+		unsigned char *pBuff = oRecord.GetPacket();
+		for (int i = 0, nSize = oRecord.GetPacketSize(); i < nSize; ++i)
+			nDigest = (nDigest ^ pBuff[i]) * 16777619U;
+
+		bool bDirty = (nDigest != nFlushed);
+		if (bDirty && oPacket)
+		{
+			oSection.EncodeBuffer(oRecord.GetPacket(), oRecord.GetPacketSize());
+			++nCount;
+		}
+		nFlushed = nDigest;
+		oRecord.Reset();
+		return bDirty;
+	};
+
+	//Moves oSection to oPacket, prefixed with the number of records if bCount.
+	auto lmdFlushSection = [&](bool bCount)
+	{
+		if (oPacket)
+		{
+			if (bCount)
+				oPacket->Encode2((short)nCount);
+			oPacket->EncodeBuffer(oSection.GetPacket(), oSection.GetPacketSize());
+		}
+		oSection.Reset();
+		nCount = 0;
+	};
+
+	EncodeStat(&oRecord);
+	EncodeInternalData(&oRecord);
+	if (lmdCheckDirty(mFlushedDigest.nStat))
+		nDeltaFlag |= eDelta_Stat;
+
+	oRecord.Encode8(mMoney->nMoney);
+	if (lmdCheckDirty(mFlushedDigest.nMoney))
+		nDeltaFlag |= eDelta_Money;
+
+	for (int i = 1; i <= 5; ++i)
+		oRecord.Encode1(mSlotCount->aSlotCount[i]);
+	if (lmdCheckDirty(mFlushedDigest.nSlotCount))
+		nDeltaFlag |= eDelta_SlotCount;
+
+	oRecord.EncodeBuffer((unsigned char*)&anMapTransfer, sizeof(anMapTransfer));
+	oRecord.EncodeBuffer((unsigned char*)&anMapTransferEx, sizeof(anMapTransferEx));
+	if (lmdCheckDirty(mFlushedDigest.nMapTransfer))
+		nDeltaFlag |= eDelta_MapTransfer;
+
+	if (oPacket)
+	{
+		oPacket->Encode4(nCharacterID);
+		oPacket->Encode1((char)nDeltaFlag);
+		lmdFlushSection(false);
+		EncodeInventoryRemovedRecord(oPacket);
+		for (int i = 1; i <= 5; ++i)
+			mItemRemovedRecord[i].clear();
+	}
+
+	std::map<int, unsigned int> mDigest;
+	for (int nTI = 1; nTI <= 5; ++nTI)
+	{
+		mDigest.clear();
+		for (auto& prItem : mItemSlot[nTI])
+		{
+			if (!prItem.second)
+				continue;
+			oRecord.Encode2(prItem.second->nPOS);
+			oRecord.Encode1(prItem.second->nInstanceType);
+			prItem.second->Encode(&oRecord, true);
+			unsigned int& nFlushed = mDigest[prItem.first] = mFlushedDigest.mItem[nTI][prItem.first];
+			lmdCheckDirty(nFlushed);
+		}
+		mFlushedDigest.mItem[nTI].swap(mDigest);
+		lmdFlushSection(true);
+	}
+
+	mDigest.clear();
+	for (auto& prRecord : mSkillRecord)
+	{
+		prRecord.second->Encode(&oRecord);
+		unsigned int& nFlushed = mDigest[prRecord.first] = mFlushedDigest.mSkillRecord[prRecord.first];
+		lmdCheckDirty(nFlushed);
+	}
+	mFlushedDigest.mSkillRecord.swap(mDigest);
+	lmdFlushSection(true);
+
+	mDigest.clear();
+	for (auto& prRecord : mQuestRecord)
+	{
+		prRecord.second->Encode(&oRecord);
+		unsigned int& nFlushed = mDigest[prRecord.first] = mFlushedDigest.mQuestRecord[prRecord.first];
+		lmdCheckDirty(nFlushed);
+	}
+	mFlushedDigest.mQuestRecord.swap(mDigest);
+	lmdFlushSection(true);
+
+	mDigest.clear();
+	for (auto& prRecord : mQuestComplete)
+	{
+		prRecord.second->Encode(&oRecord);
+		unsigned int& nFlushed = mDigest[prRecord.first] = mFlushedDigest.mQuestComplete[prRecord.first];
+		lmdCheckDirty(nFlushed);
+	}
+	mFlushedDigest.mQuestComplete.swap(mDigest);
+	lmdFlushSection(true);
+}
+
 GA_Character::ATOMIC_COUNT_TYPE GA_Character::InitCharacterID()
 {
 	Poco::Data::Statement queryStatement(GET_DB_SESSION);
@@ -847,24 +1192,20 @@ GA_Character::ATOMIC_COUNT_TYPE GA_Character::InitCharacterID()
 
 void GA_Character::LoadItemSlot()
 {
-	GW_ItemSlotBase::LoadAll(GW_ItemSlotBase::EQUIP, nCharacterID, mItemSlot[1]);
-	GW_ItemSlotBase::LoadAll(GW_ItemSlotBase::CONSUME, nCharacterID, mItemSlot[2]);
-	GW_ItemSlotBase::LoadAll(GW_ItemSlotBase::INSTALL, nCharacterID, mItemSlot[3]);
-	GW_ItemSlotBase::LoadAll(GW_ItemSlotBase::ETC, nCharacterID, mItemSlot[4]);
-	GW_ItemSlotBase::LoadAll(GW_ItemSlotBase::CASH, nCharacterID, mItemSlot[5]);
+	GW_ItemSlotBase::LoadAll(nCharacterID, mItemSlot);
 }
 
 void GA_Character::LoadSkillRecord()
 {
 	Poco::Data::Statement queryStatement(GET_DB_SESSION);
-	queryStatement << "SELECT * FROM SkillRecord Where CharacterID = " << nCharacterID;
+	queryStatement << "SELECT " << GW_SkillRecord::LOAD_COLUMN << " FROM SkillRecord Where CharacterID = " << nCharacterID;
 	queryStatement.execute();
 	Poco::Data::RecordSet recordSet(queryStatement);
 
-	for (int i = 0; i < recordSet.rowCount(); ++i, recordSet.moveNext())
+	for (int i = 0; i < (int)recordSet.rowCount(); ++i)
 	{
 		GW_SkillRecord* pSkillRecord = AllocObj(GW_SkillRecord);
-		pSkillRecord->Load((void*)&recordSet);
+		pSkillRecord->Load((void*)&recordSet, i);
 		mSkillRecord.insert({ pSkillRecord->nSkillID, pSkillRecord });
 	}
 }
@@ -872,14 +1213,14 @@ void GA_Character::LoadSkillRecord()
 void GA_Character::LoadQuestRecord()
 {
 	Poco::Data::Statement queryStatement(GET_DB_SESSION);
-	queryStatement << "SELECT * FROM QuestRecord Where CharacterID = " << nCharacterID;
+	queryStatement << "SELECT " << GW_QuestRecord::LOAD_COLUMN << " FROM QuestRecord Where CharacterID = " << nCharacterID;
 	queryStatement.execute();
 	Poco::Data::RecordSet recordSet(queryStatement);
 
-	for (int i = 0; i < recordSet.rowCount(); ++i, recordSet.moveNext())
+	for (int i = 0; i < (int)recordSet.rowCount(); ++i)
 	{
 		GW_QuestRecord* pQuestRecord = AllocObj(GW_QuestRecord);
-		pQuestRecord->Load((void*)&recordSet);
+		pQuestRecord->Load((void*)&recordSet, i);
 		if (pQuestRecord->nState == 1)
 			mQuestRecord.insert({ pQuestRecord->nQuestID, pQuestRecord });
 		else
@@ -887,19 +1228,12 @@ void GA_Character::LoadQuestRecord()
 	}
 }
 
-void GA_Character::LoadMapTransfer()
+void GA_Character::LoadMapTransfer(void *pRecordSet, int nRow, int nColumn)
 {
-	Poco::Data::Statement queryStatement(GET_DB_SESSION);
-	queryStatement << "SELECT * FROM MapTransfer Where CharacterID = " << nCharacterID;
-	queryStatement.execute();
-	Poco::Data::RecordSet recordSet(queryStatement);
-	for (int i = 0; i < MaxMapTransferCount; ++i)
-		anMapTransfer[i] = recordSet.rowCount() ? recordSet["Map" + std::to_string(i)] : 999999999;
-
-	queryStatement.reset(GET_DB_SESSION);
-	queryStatement << "SELECT * FROM MapTransferEx Where CharacterID = " << nCharacterID;
-	queryStatement.execute();
-	recordSet.reset(queryStatement);
-	for (int i = 0; i < MaxMapTransferExCount; ++i)
-		anMapTransferEx[i] = recordSet.rowCount() ? recordSet["Map" + std::to_string(i)] : 999999999;
+	//The columns are NULL when the character has no row in MapTransfer (or MapTransferEx).
+	Poco::Data::RecordSet &recordSet = *((Poco::Data::RecordSet*)pRecordSet);
+	for (int i = 0; i < MaxMapTransferCount; ++i, ++nColumn)
+		anMapTransfer[i] = recordSet.isNull(nColumn, nRow) ? 999999999 : (int)recordSet.value(nColumn, nRow);
+	for (int i = 0; i < MaxMapTransferExCount; ++i, ++nColumn)
+		anMapTransferEx[i] = recordSet.isNull(nColumn, nRow) ? 999999999 : (int)recordSet.value(nColumn, nRow);
 }
@@ -3,6 +3,7 @@
 #include <mutex>
 #include <set>
 #include <map>
+#include <vector>
 #include "..\WvsLib\Memory\ZMemory.h"
 
 struct GW_ItemSlotBase;
@@ -33,16 +34,38 @@ private:
 
 	std::mutex mCharacterLock;
 
+	//Digests of the records and blocks last sent by EncodeCharacterDataDelta (or of the data received at migration).
+	//A record is dirty when the digest of its encoding differs from the one here.
+	struct FlushedDigest
+	{
+		unsigned int nStat = 0, nMoney = 0, nSlotCount = 0, nMapTransfer = 0;
+		std::map<int, unsigned int> mItem[6], mSkillRecord, mQuestRecord, mQuestComplete;
+	} mFlushedDigest;
+
+	void EncodeDirtyData(OutPacket *oPacket);
+
 #ifdef DBLIB
+	//Decodes the columns selected by LoadCharacter of the row nRow, returns the column following them.
+	int LoadCharacterRow(void *pRecordSet, int nRow);
 	void LoadItemSlot();
 	void LoadSkillRecord();
 	void LoadQuestRecord();
-	void LoadMapTransfer();
+	void LoadMapTransfer(void *pRecordSet, int nRow, int nColumn);
 #endif
 
 public:
 	const static int MaxMapTransferCount = 5, MaxMapTransferExCount = 10;
 
+	//Blocks which are present in a character data delta.
+	enum CharacterDataDeltaFlag
+	{
+		eDelta_Stat = 0x01,
+		eDelta_Money = 0x02,
+		eDelta_SlotCount = 0x04,
+		eDelta_MapTransfer = 0x08,
+		eDelta_All = eDelta_Stat | eDelta_Money | eDelta_SlotCount | eDelta_MapTransfer
+	};
+
 	bool bOnTrading = false;
 	int nWorldID,
 		nAccountID,
@@ -77,9 +100,19 @@ public:
 	std::set<std::pair<long long int, bool>> mItemRemovedRecord[6];
 
 #ifdef DBLIB
-	void Load(int nCharacterID);
+	//Loads the whole character with six queries, returns false if the character doesn't exist.
+	bool Load(int nCharacterID);
+
+	//Loads what EncodeAvatar encodes.
 	void LoadCharacter(int nCharacterID);
+
+	//Loads what EncodeAvatar encodes of every character of the account in nWorldID, with two queries for all of them.
+	static void LoadAvatarList(int nAccountID, int nWorldID, std::vector<ZUniquePtr<GA_Character>>& aCharacter);
+
 	void Save(bool isNewCharacter = false);
+	void SaveDelta(int nDeltaFlag);
+	void SaveCharacter();
+	void SaveRecord();
 	void SaveInventoryRemovedRecord();
 	void SaveMapTransfer();
 #endif
@@ -91,6 +124,19 @@ public:
 	void DecodeInventoryRemovedRecord(InPacket *iPacket);
 	void DecodeAvatarLook(InPacket* iPacket);
 	void DecodeSkillRecord(InPacket* iPacket);
+	void DecodeQuestRecord(InPacket* iPacket, int nState);
+
+	/*
+	Decodes the delta encoded by EncodeCharacterDataDelta, only the dirty records are inserted.
+	Returns the CharacterDataDeltaFlag of the blocks present.
+	*/
+	int DecodeCharacterDataDelta(InPacket *iPacket);
+
+	/*
+	Merges newer, a delta of the same character decoded after this one, so that saving this one equals saving both
+	in order. The blocks and records of newer are moved out of it. Returns the merged CharacterDataDeltaFlag.
+	*/
+	int MergeCharacterDataDelta(int nDeltaFlag, GA_Character& newer, int nNewerDeltaFlag);
 
 	void EncodeCharacterData(OutPacket *oPacket, bool bForInternal);
 	void EncodeInternalData(OutPacket *oPacket);
@@ -101,6 +147,18 @@ public:
 	void EncodeStat(OutPacket *oPacket);
 	void EncodeSkillRecord(OutPacket *oPacket);
 
+	/*
+	Encodes the blocks and records which have changed since the last call (or since ResetCharacterDataDelta), and
+	the items removed meanwhile. The removed records are cleared once they are encoded.
+	*/
+	void EncodeCharacterDataDelta(OutPacket *oPacket);
+
+	//Takes the current data as what the database holds, used when the character data has just been loaded.
+	void ResetCharacterDataDelta();
+
+	//Forgets the digests, the next EncodeCharacterDataDelta sends every block and record. Used when a delta wasn't saved.
+	void ClearCharacterDataDelta();
+
 	GA_Character();
 	~GA_Character();
 
@@ -3,55 +3,52 @@
 
 #include "..\WvsLib\Net\OutPacket.h"
 
-void GW_Avatar::Load(int nCharacterID)
+void GW_Avatar::SetEquip(short nPOS, int nItemID, bool bCash)
 {
-	//BASIC AVATAR
-	Poco::Data::Statement queryStatement(GET_DB_SESSION);
-	queryStatement << "Select Hair, Face, Skin FROM CharacterStat Where CharacterID = " << nCharacterID;
-	queryStatement.execute();
-	Poco::Data::RecordSet recordSet(queryStatement);
+	short nAbsPOS = nPOS * -1;
+	if (!bCash)
+	{
+		if (nAbsPOS < 100 || nAbsPOS == 111)
+			mEquip.insert({ nPOS, nItemID });
+	}
+	else if (nAbsPOS > 100)
+	{
+		auto iter = mEquip.find(nAbsPOS);
+		if (iter != mEquip.end())
+			mUnseenEquip.insert({ nPOS, iter->second });
 
-	nHair = recordSet["Hair"];
-	nFace = recordSet["Face"];
-	nSkin = recordSet["Skin"];
+		mEquip[nPOS + 100] = nItemID;
+	}
+	else
+		mUnseenEquip.insert({ nPOS, nItemID });
+}
 
-	//ItemSlot_EQP
-	queryStatement.reset(GET_DB_SESSION);
-	queryStatement << "SELECT ItemSN FROM ItemSlot_EQP Where POS < 0 AND CharacterID = " << nCharacterID;
-	queryStatement.execute();
-	recordSet.reset(queryStatement);
+void GW_Avatar::LoadEquip(std::map<int, GW_Avatar*>& mAvatar)
+{
+	if (mAvatar.empty())
+		return;
 
-	short nPOS = 0;
-	GW_ItemSlotEquip eqp;
-	for (int i = 0; i < recordSet.rowCount(); ++i, recordSet.moveNext())
-	{
-		eqp.bIsCash = false;
-		eqp.Load(recordSet["ItemSN"]);
-		nPOS = eqp.nPOS * -1;
-		if (nPOS < 100 || nPOS == 111)
-			mEquip.insert({ eqp.nPOS, eqp.nItemID });
-	}
+	std::string sCharacterID;
+	for (auto& prAvatar : mAvatar)
+		sCharacterID += (sCharacterID.empty() ? "" : ", ") + std::to_string(prAvatar.first);
 
-	//CashItem_EQP
-	queryStatement.reset(GET_DB_SESSION);
-	queryStatement << "SELECT CashItemSN FROM CashItem_EQP Where POS < 0 AND CharacterID = " << nCharacterID;
+	//The equips come before the cash equips, which are placed over them.
+	Poco::Data::Statement queryStatement(GET_DB_SESSION);
+	queryStatement << "SELECT 0, CharacterID, POS, ItemID FROM ItemSlot_EQP Where POS < 0 AND CharacterID IN (" << sCharacterID << ")"
+		<< " UNION ALL SELECT 1, CharacterID, POS, ItemID FROM CashItem_EQP Where POS < 0 AND CharacterID IN (" << sCharacterID << ")"
+		<< " ORDER BY 1";
 	queryStatement.execute();
-	recordSet.reset(queryStatement);
-	for (int i = 0; i < recordSet.rowCount(); ++i, recordSet.moveNext())
+	Poco::Data::RecordSet recordSet(queryStatement);
+
+	for (int i = 0; i < (int)recordSet.rowCount(); ++i)
 	{
-		eqp.bIsCash = true;
-		eqp.Load(recordSet["CashItemSN"]);
-		nPOS = eqp.nPOS * -1; 
-		if (nPOS > 100)
-		{
-			auto iter = mEquip.find(nPOS);
-			if (iter != mEquip.end())
-				mUnseenEquip.insert({ eqp.nPOS, iter->second });
-
-			mEquip[eqp.nPOS + 100] = eqp.nItemID;
-		}
-		else
-			mUnseenEquip.insert({ eqp.nPOS, eqp.nItemID });
+		auto findIter = mAvatar.find((int)recordSet.value(1, i));
+		if (findIter != mAvatar.end())
+			findIter->second->SetEquip(
+				(short)recordSet.value(2, i),
+				(int)recordSet.value(3, i),
+				(int)recordSet.value(0, i) == 1
+			);
 	}
 }
 
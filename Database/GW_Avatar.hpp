@@ -12,8 +12,12 @@ struct GW_Avatar
 	//		nPOS, nItemID
 	std::map<short, int> mEquip, mUnseenEquip, mTotemEquip;
 
+	//Places the worn equip as the avatar shows it, the equips have to be placed before the cash equips.
+	void SetEquip(short nPOS, int nItemID, bool bCash);
+
 #ifdef DBLIB
-	void Load(int nCharacterID);
+	//Loads the worn equips of the avatars (mAvatar[nCharacterID]) in one query.
+	static void LoadEquip(std::map<int, GW_Avatar*>& mAvatar);
 	void Save(int nCharacterID, bool newCharacter = false);
 #endif
 
@@ -1,17 +1,24 @@
 #include "GW_CharacterSlotCount.h"
 #include "WvsUnified.h"
 
+const char* GW_CharacterSlotCount::LOAD_COLUMN =
+	"CharacterSlotCount.EquipSlot, CharacterSlotCount.ConSlot, CharacterSlotCount.InstallSlot, CharacterSlotCount.EtcSlot, CharacterSlotCount.CashSlot";
+
 void GW_CharacterSlotCount::Load(int nCharacterID)
 {
 	Poco::Data::Statement queryStatement(GET_DB_SESSION);
-	queryStatement << "SELECT * FROM CharacterSlotCount Where CharacterID = " << nCharacterID;
+	queryStatement << "SELECT " << LOAD_COLUMN << " FROM CharacterSlotCount Where CharacterID = " << nCharacterID;
 	queryStatement.execute();
 	Poco::Data::RecordSet recordSet(queryStatement);
-	aSlotCount[1] = (int)recordSet["EquipSlot"];
-	aSlotCount[2] = (int)recordSet["ConSlot"];
-	aSlotCount[3] = (int)recordSet["InstallSlot"];
-	aSlotCount[4] = (int)recordSet["EtcSlot"];
-	aSlotCount[5] = (int)recordSet["CashSlot"];
+	Load((void*)&recordSet, 0, 0);
+}
+
+int GW_CharacterSlotCount::Load(void *pRecordSet, int nRow, int nColumn)
+{
+	Poco::Data::RecordSet &recordSet = *((Poco::Data::RecordSet*)pRecordSet);
+	for (int i = 1; i <= 5; ++i)
+		aSlotCount[i] = (int)recordSet.value(nColumn++, nRow);
+	return nColumn;
 }
 
 void GW_CharacterSlotCount::Save(int nCharacterID, bool bIsNewCharacter)
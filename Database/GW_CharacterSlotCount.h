@@ -4,7 +4,13 @@ struct GW_CharacterSlotCount
 	int aSlotCount[6];
 
 #ifdef DBLIB
+	//The columns of CharacterSlotCount decoded by Load(pRecordSet, nRow, nColumn), qualified by the table name for joins.
+	static const char* LOAD_COLUMN;
+
 	void Load(int nCharacterID);
+
+	//Decodes LOAD_COLUMN which start at nColumn of the row nRow, returns the column following them.
+	int Load(void *pRecordSet, int nRow, int nColumn);
 	void Save(int nCharacterID, bool bIsNewCharacter = false);
 #endif
 
@@ -53,42 +53,55 @@ void GW_CharacterStat::DecodeExtendSP(InPacket * iPacket)
 		aSP[0] = iPacket->Decode2();*/
 }
 
+const char* GW_CharacterStat::LOAD_COLUMN =
+	"CharacterStat.HP, CharacterStat.MP, CharacterStat.MaxHP, CharacterStat.MaxMP, CharacterStat.Gender, CharacterStat.Job, CharacterStat.SubJob, "
+	"CharacterStat.Str, CharacterStat.Dex, CharacterStat.Int_, CharacterStat.Luk, CharacterStat.Skin, CharacterStat.Face, CharacterStat.Hair, "
+	"CharacterStat.FaceMark, CharacterStat.SP, CharacterStat.AP, CharacterStat.Exp, CharacterStat.POP, CharacterStat.CharismaEXP, "
+	"CharacterStat.InsightEXP, CharacterStat.WillEXP, CharacterStat.SenseEXP, CharacterStat.CharmEXP";
+
 void GW_CharacterStat::Load(int nCharacterID)
 {
 	Poco::Data::Statement queryStatement(GET_DB_SESSION);
-	queryStatement << "SELECT * FROM CharacterStat Where CharacterID = " << nCharacterID;
+	queryStatement << "SELECT " << LOAD_COLUMN << " FROM CharacterStat Where CharacterID = " << nCharacterID;
 	queryStatement.execute();
 	Poco::Data::RecordSet recordSet(queryStatement);
-	nHP = recordSet["HP"];
-	nMP = recordSet["MP"];
-	nMaxHP = recordSet["MaxHP"];
-	nMaxMP = recordSet["MaxMP"]; 
-	nGender = recordSet["Gender"];
-	nJob = recordSet["Job"];
-	nSubJob = recordSet["SubJob"];
-	nStr = recordSet["Str"];
-	nDex = recordSet["Dex"];
-	nInt = recordSet["Int_"];
-	nLuk = recordSet["Luk"];
-	nSkin = recordSet["Skin"];
-	nFace = recordSet["Face"];
-	nHair = recordSet["Hair"];
-	nFaceMark = recordSet["FaceMark"];
+	Load((void*)&recordSet, 0, 0);
+}
+
+int GW_CharacterStat::Load(void *pRecordSet, int nRow, int nColumn)
+{
+	Poco::Data::RecordSet &recordSet = *((Poco::Data::RecordSet*)pRecordSet);
+	nHP = recordSet.value(nColumn++, nRow);
+	nMP = recordSet.value(nColumn++, nRow);
+	nMaxHP = recordSet.value(nColumn++, nRow);
+	nMaxMP = recordSet.value(nColumn++, nRow);
+	nGender = recordSet.value(nColumn++, nRow);
+	nJob = recordSet.value(nColumn++, nRow);
+	nSubJob = recordSet.value(nColumn++, nRow);
+	nStr = recordSet.value(nColumn++, nRow);
+	nDex = recordSet.value(nColumn++, nRow);
+	nInt = recordSet.value(nColumn++, nRow);
+	nLuk = recordSet.value(nColumn++, nRow);
+	nSkin = recordSet.value(nColumn++, nRow);
+	nFace = recordSet.value(nColumn++, nRow);
+	nHair = recordSet.value(nColumn++, nRow);
+	nFaceMark = recordSet.value(nColumn++, nRow);
 
-	auto strSP = (std::string)recordSet["SP"].toString();
+	auto strSP = (std::string)recordSet.value(nColumn++, nRow).toString();
 	std::vector<std::string> split;
 	StringUtility::Split(strSP, split, ",");
 	for (int i = 0; i < EXTEND_SP_SIZE; ++i)
 		aSP[i] = atoi(split[i].c_str());
 
-	nAP = recordSet["AP"];
-	nExp = recordSet["Exp"];
-	nPOP = recordSet["POP"];
-	nCharismaEXP = recordSet["CharismaEXP"];
-	nInsightEXP = recordSet["InsightEXP"];
-	nWillEXP = recordSet["WillEXP"];
-	nSenseEXP = recordSet["SenseEXP"];
-	nCharmEXP = recordSet["CharmEXP"];
+	nAP = recordSet.value(nColumn++, nRow);
+	nExp = recordSet.value(nColumn++, nRow);
+	nPOP = recordSet.value(nColumn++, nRow);
+	nCharismaEXP = recordSet.value(nColumn++, nRow);
+	nInsightEXP = recordSet.value(nColumn++, nRow);
+	nWillEXP = recordSet.value(nColumn++, nRow);
+	nSenseEXP = recordSet.value(nColumn++, nRow);
+	nCharmEXP = recordSet.value(nColumn++, nRow);
+	return nColumn;
 }
 
 void GW_CharacterStat::Save(int nCharacterID, bool isNewCharacter)
@@ -46,7 +46,13 @@ public:
 	void DecodeExtendSP(InPacket *iPacket);
 
 #ifdef DBLIB
+	//The columns of CharacterStat decoded by Load(pRecordSet, nRow, nColumn), qualified by the table name for joins.
+	static const char* LOAD_COLUMN;
+
 	void Load(int nCharacterID);
+
+	//Decodes LOAD_COLUMN which start at nColumn of the row nRow, returns the column following them.
+	int Load(void *pRecordSet, int nRow, int nColumn);
 	void Save(int nCharacterID, bool isNewCharacter);
 #endif
 
@@ -231,6 +231,13 @@ void GW_ItemSlotBase::LoadAll(int nType, int nCharacterID, std::map<int, ZShared
 	}
 }
 
+void GW_ItemSlotBase::LoadAll(int nCharacterID, std::map<int, ZSharedPtr<GW_ItemSlotBase>> *amRes)
+{
+	GW_ItemSlotEquip::LoadAll(nCharacterID, amRes[GW_ItemSlotType::EQUIP]);
+	GW_ItemSlotBundle::LoadAll(nCharacterID, amRes);
+	GW_ItemSlotPet::LoadAll(nCharacterID, amRes[GW_ItemSlotType::CASH]);
+}
+
 void GW_ItemSlotBase::DecodeInventoryPosition(InPacket * iPacket) 
 {
 	nPOS = iPacket->Decode1();
@@ -92,6 +92,9 @@ public:
 	virtual GW_ItemSlotBase* MakeClone() const = 0;
 
 	static void LoadAll(int nType, int nCharacterID, std::map<int, ZSharedPtr<GW_ItemSlotBase>>& mRes);
+
+	//Loads the inventories amRes[EQUIP] ~ amRes[CASH] of the character with one query per item kind.
+	static void LoadAll(int nCharacterID, std::map<int, ZSharedPtr<GW_ItemSlotBase>> *amRes);
 	virtual void Load(ATOMIC_COUNT_TYPE SN) = 0;
 	virtual void Save(int nCharacterID, bool bRemoveRecord = false, bool bExpired = false) = 0;
 
@@ -1,5 +1,6 @@
 #include "GW_ItemSlotBundle.h"
 #include "WvsUnified.h"
+#include "DBBatchWriter.h"
 #include "Poco\Data\MySQL\MySQLException.h"
 #include "..\WvsLib\Memory\MemoryPoolMan.hpp"
 #include "..\WvsLib\Logger\WvsLogger.h"
@@ -14,23 +15,27 @@ GW_ItemSlotBundle::~GW_ItemSlotBundle()
 {
 }
 
-void ConstructItemFromDBRecordSet(GW_ItemSlotBundle *pItem, int nType, Poco::Data::RecordSet& recordSet)
+//The columns following ItemSN (or CashItemSN) which are decoded by ConstructItemFromDBRecordSet.
+static const char* BUNDLE_COLUMN = "CharacterID, ItemID, ExpireDate, Attribute, Number, POS";
+
+//Decodes the row nRow of the SN column and BUNDLE_COLUMN, which start at nColumn.
+void ConstructItemFromDBRecordSet(GW_ItemSlotBundle *pItem, int nType, Poco::Data::RecordSet& recordSet, int nRow, int nColumn)
 {
 	pItem->nType = (GW_ItemSlotBase::GW_ItemSlotType)nType;
 	if (nType == GW_ItemSlotBase::GW_ItemSlotType::CASH)
 	{
-		pItem->liCashItemSN = recordSet["CashItemSN"];
+		pItem->liCashItemSN = recordSet.value(nColumn++, nRow);
 		pItem->bIsCash = true;
 	}
 	else
-		pItem->liItemSN = recordSet["ItemSN"];
-
-	pItem->nCharacterID = recordSet["CharacterID"];
-	pItem->nItemID = recordSet["ItemID"];
-	pItem->liExpireDate = recordSet["ExpireDate"];
-	pItem->nAttribute = recordSet["Attribute"];
-	pItem->nNumber = recordSet["Number"];
-	pItem->nPOS = recordSet["POS"];
+		pItem->liItemSN = recordSet.value(nColumn++, nRow);
+
+	pItem->nCharacterID = recordSet.value(nColumn++, nRow);
+	pItem->nItemID = recordSet.value(nColumn++, nRow);
+	pItem->liExpireDate = recordSet.value(nColumn++, nRow);
+	pItem->nAttribute = recordSet.value(nColumn++, nRow);
+	pItem->nNumber = recordSet.value(nColumn++, nRow);
+	pItem->nPOS = recordSet.value(nColumn++, nRow);
 }
 
 void GW_ItemSlotBundle::LoadAll(int nType, int nCharacterID, std::map<int, ZSharedPtr<GW_ItemSlotBase>>& mRes)
@@ -49,18 +54,38 @@ void GW_ItemSlotBundle::LoadAll(int nType, int nCharacterID, std::map<int, ZShar
 		throw std::runtime_error("Invalid Item Slot Type.");
 
 	Poco::Data::Statement queryStatement(GET_DB_SESSION);
-	queryStatement << "SELECT * FROM " << strTableName << " Where CharacterID = " << nCharacterID << " AND POS < " << GW_ItemSlotBase::LOCK_POS;
+	queryStatement << "SELECT " << (nType == GW_ItemSlotType::CASH ? "CashItemSN, " : "ItemSN, ") << BUNDLE_COLUMN << " FROM " << strTableName << " Where CharacterID = " << nCharacterID << " AND POS < " << GW_ItemSlotBase::LOCK_POS;
 	queryStatement.execute();
 	Poco::Data::RecordSet recordSet(queryStatement);
 
-	for (int i = 0; i < recordSet.rowCount(); ++i, recordSet.moveNext())
+	for (int i = 0; i < (int)recordSet.rowCount(); ++i)
 	{
 		auto pItem = MakeShared<GW_ItemSlotBundle>();
-		ConstructItemFromDBRecordSet(pItem, nType, recordSet);
+		ConstructItemFromDBRecordSet(pItem, nType, recordSet, i, 0);
 		mRes[pItem->nPOS] = pItem;
 	}
 }
 
+void GW_ItemSlotBundle::LoadAll(int nCharacterID, std::map<int, ZSharedPtr<GW_ItemSlotBase>> *amRes)
+{
+	Poco::Data::Statement queryStatement(GET_DB_SESSION);
+	queryStatement << "SELECT " << GW_ItemSlotType::CONSUME << ", ItemSN, " << BUNDLE_COLUMN << " FROM ItemSlot_CON Where CharacterID = " << nCharacterID << " AND POS < " << GW_ItemSlotBase::LOCK_POS
+		<< " UNION ALL SELECT " << GW_ItemSlotType::INSTALL << ", ItemSN, " << BUNDLE_COLUMN << " FROM ItemSlot_INS Where CharacterID = " << nCharacterID << " AND POS < " << GW_ItemSlotBase::LOCK_POS
+		<< " UNION ALL SELECT " << GW_ItemSlotType::ETC << ", ItemSN, " << BUNDLE_COLUMN << " FROM ItemSlot_ETC Where CharacterID = " << nCharacterID << " AND POS < " << GW_ItemSlotBase::LOCK_POS
+		<< " UNION ALL SELECT " << GW_ItemSlotType::CASH << ", CashItemSN, " << BUNDLE_COLUMN << " FROM CashItem_Bundle Where CharacterID = " << nCharacterID << " AND POS < " << GW_ItemSlotBase::LOCK_POS;
+	queryStatement.execute();
+	Poco::Data::RecordSet recordSet(queryStatement);
+
+	int nType = 0;
+	for (int i = 0; i < (int)recordSet.rowCount(); ++i)
+	{
+		nType = recordSet.value(0, i);
+		auto pItem = MakeShared<GW_ItemSlotBundle>();
+		ConstructItemFromDBRecordSet(pItem, nType, recordSet, i, 1);
+		amRes[nType][pItem->nPOS] = pItem;
+	}
+}
+
 void GW_ItemSlotBundle::Load(ATOMIC_COUNT_TYPE SN)
 {
 	std::string strTableName = "",
@@ -77,11 +102,11 @@ void GW_ItemSlotBundle::Load(ATOMIC_COUNT_TYPE SN)
 	else
 		throw std::runtime_error("Invalid Item Slot Type.");
 	Poco::Data::Statement queryStatement(GET_DB_SESSION);
-	queryStatement << "SELECT * FROM " << strTableName << " Where " + sSNColumnName + " = " << SN;
+	queryStatement << "SELECT " << sSNColumnName << ", " << BUNDLE_COLUMN << " FROM " << strTableName << " Where " + sSNColumnName + " = " << SN;
 	queryStatement.execute();
 
 	Poco::Data::RecordSet recordSet(queryStatement);
-	ConstructItemFromDBRecordSet(this, nType, recordSet);
+	ConstructItemFromDBRecordSet(this, nType, recordSet, 0, 0);
 }
 
 void GW_ItemSlotBundle::Save(int nCharacterID, bool bRemoveRecord, bool bExpired)
@@ -101,50 +126,37 @@ void GW_ItemSlotBundle::Save(int nCharacterID, bool bRemoveRecord, bool bExpired
 		strTableName = "CashItem_Bundle";
 	else
 		throw std::runtime_error("Invalid Item Slot Type.");
-	Poco::Data::Statement queryStatement(GET_DB_SESSION);
-	try 
+
+	//Joins the batch of the character being saved, otherwise the row is written at once.
+	DBBatchWriter writer(false);
+
+	//09/12/2019 modified, for CASH ITEMs (nTI = 5) support.
+	auto pSN = (nType == GW_ItemSlotType::CASH ? &liCashItemSN : &liItemSN);
+	if (*pSN < -1 && bRemoveRecord) //DROPPED or DELETED
 	{
-		//09/12/2019 modified, for CASH ITEMs (nTI = 5) support.
-		auto pSN = (nType == GW_ItemSlotType::CASH ? &liCashItemSN : &liItemSN);
-		if (*pSN < -1 && bRemoveRecord) //DROPPED or DELETED
-		{
-			*pSN *= -1;
-			queryStatement << "UPDATE " << strTableName
-				<< " Set CharacterID = -1 Where CharacterID = " << nCharacterID
-				<< " and " + sSNColumnName + " = " << *pSN;
-			queryStatement.execute();
-			return;
-		}
-		else
-		{
-			if (nType != GW_ItemSlotType::CASH && liItemSN <= 0)
-				liItemSN = IncItemSN(nType);
-			if (nType == GW_ItemSlotType::CASH && liCashItemSN == -1)
-				liCashItemSN = IncItemSN(nType);
-
-			queryStatement << "INSERT INTO " << strTableName << " (" + sSNColumnName + ", ItemID, CharacterID, ExpireDate, Attribute, POS, Number) VALUES("
-				<< (nType == GW_ItemSlotType::CASH ? liCashItemSN : liItemSN) << ", "
-				<< nItemID << ", "
-				<< nCharacterID << ", "
-				<< liExpireDate << ", "
-				<< nAttribute << ", "
-				<< nPOS << ", "
-				<< nNumber << ")";
-			queryStatement << " ON DUPLICATE KEY UPDATE "
-				<< "ItemID = '" << nItemID << "', "
-				<< "CharacterID = '" << nCharacterID << "', "
-				<< "ExpireDate = '" << liExpireDate << "', "
-				<< "Attribute = '" << nAttribute << "', "
-				<< "POS ='" << nPOS << "', "
-				<< "Number = '" << nNumber << "'";
-				//<< "' WHERE " + sSNColumnName + " = " << (nType == GW_ItemSlotType::CASH ? liCashItemSN : liItemSN);
-		}
-		queryStatement.execute();
+		*pSN *= -1;
+		writer.Detach(strTableName, sSNColumnName, nCharacterID, *pSN);
 	}
-	catch (Poco::Data::MySQL::StatementException &se) 
+	else
 	{
-		WvsLogger::LogFormat("SQL Exception Occurred: %s\nRaw Query = %s\n", se.message().c_str(), queryStatement.toString().c_str());
+		if (nType != GW_ItemSlotType::CASH && liItemSN <= 0)
+			liItemSN = IncItemSN(nType);
+		if (nType == GW_ItemSlotType::CASH && liCashItemSN == -1)
+			liCashItemSN = IncItemSN(nType);
+
+		writer.Upsert(
+			strTableName,
+			sSNColumnName + ", ItemID, CharacterID, ExpireDate, Attribute, POS, Number",
+			"ItemID, CharacterID, ExpireDate, Attribute, POS, Number")
+			<< (nType == GW_ItemSlotType::CASH ? liCashItemSN : liItemSN)
+			<< nItemID
+			<< nCharacterID
+			<< liExpireDate
+			<< nAttribute
+			<< nPOS
+			<< nNumber;
 	}
+	writer.Commit();
 }
 
 void GW_ItemSlotBundle::Encode(OutPacket *oPacket, bool bForInternal) const
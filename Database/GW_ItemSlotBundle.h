@@ -11,6 +11,10 @@ public:
 	~GW_ItemSlotBundle();
 
 	static void LoadAll(int nType, int nCharacterID, std::map<int, ZSharedPtr<GW_ItemSlotBase>>& mRes);
+
+	//Loads the bundles of every inventory (amRes[CONSUME] ~ amRes[CASH]) of the character in one query.
+	static void LoadAll(int nCharacterID, std::map<int, ZSharedPtr<GW_ItemSlotBase>> *amRes);
+
 	void Load(ATOMIC_COUNT_TYPE SN);
 	void Save(int nCharacterID, bool bRemoveRecord = false, bool bExpired = false);
 
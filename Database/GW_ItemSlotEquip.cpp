@@ -1,5 +1,6 @@
 #include "GW_ItemSlotEquip.h"
 #include "WvsUnified.h"
+#include "DBBatchWriter.h"
 #include "..\WvsLib\Logger\WvsLogger.h"
 #include "..\WvsLib\DateTime\GameDateTime.h"
 #include "..\WvsLib\Memory\MemoryPoolMan.hpp"
@@ -36,38 +37,41 @@ GW_ItemSlotEquip::~GW_ItemSlotEquip()
 {
 }
 
-void ConstructItemFromDBRecordSet(GW_ItemSlotEquip *pItem, bool bCash, Poco::Data::RecordSet& recordSet)
-{
-	pItem->nCharacterID = recordSet["CharacterID"];
+//The columns following ItemSN (or CashItemSN) which are decoded by ConstructItemFromDBRecordSet.
+static const char* EQUIP_COLUMN = "ItemID, CharacterID, ExpireDate, Attribute, POS, Title, RUC, CUC, Cuttable, I_STR, I_DEX, I_INT, I_LUK, I_MaxHP, I_MaxMP, I_PAD, I_MAD, I_PDD, I_MDD, I_ACC, I_EVA, I_Speed, I_Craft, I_Jump";
 
+//Decodes the row nRow of the SN column and EQUIP_COLUMN, which start at nColumn.
+void ConstructItemFromDBRecordSet(GW_ItemSlotEquip *pItem, bool bCash, Poco::Data::RecordSet& recordSet, int nRow, int nColumn)
+{
 	if (bCash)
-		pItem->liCashItemSN = recordSet["CashItemSN"];
+		pItem->liCashItemSN = recordSet.value(nColumn++, nRow);
 	else
-		pItem->liItemSN = recordSet["ItemSN"];
+		pItem->liItemSN = recordSet.value(nColumn++, nRow);
 
-	pItem->nItemID = recordSet["ItemID"];
-	pItem->liExpireDate = recordSet["ExpireDate"];
-	pItem->nAttribute = recordSet["Attribute"];
-	pItem->nPOS = recordSet["POS"];
-	pItem->sTitle = recordSet["Title"].toString();
-	pItem->nRUC = (unsigned char)(unsigned short)recordSet["RUC"];
-	pItem->nCUC = (unsigned char)(unsigned short)recordSet["CUC"];
-	pItem->nCuttable = recordSet["Cuttable"];
-	pItem->nSTR = recordSet["I_STR"];
-	pItem->nDEX = recordSet["I_DEX"];
-	pItem->nINT = recordSet["I_INT"];
-	pItem->nLUK = recordSet["I_LUK"];
-	pItem->nMaxHP = recordSet["I_MaxHP"];
-	pItem->nMaxMP = recordSet["I_MaxMP"];
-	pItem->nPAD = recordSet["I_PAD"];
-	pItem->nMAD = recordSet["I_MAD"];
-	pItem->nPDD = recordSet["I_PDD"];
-	pItem->nMDD = recordSet["I_MDD"];
-	pItem->nACC = recordSet["I_ACC"];
-	pItem->nEVA = recordSet["I_EVA"];
-	pItem->nSpeed = recordSet["I_Speed"];
-	pItem->nCraft = recordSet["I_Craft"];
-	pItem->nJump = recordSet["I_Jump"];
+	pItem->nItemID = recordSet.value(nColumn++, nRow);
+	pItem->nCharacterID = recordSet.value(nColumn++, nRow);
+	pItem->liExpireDate = recordSet.value(nColumn++, nRow);
+	pItem->nAttribute = recordSet.value(nColumn++, nRow);
+	pItem->nPOS = recordSet.value(nColumn++, nRow);
+	pItem->sTitle = recordSet.value(nColumn++, nRow).toString();
+	pItem->nRUC = (unsigned char)(unsigned short)recordSet.value(nColumn++, nRow);
+	pItem->nCUC = (unsigned char)(unsigned short)recordSet.value(nColumn++, nRow);
+	pItem->nCuttable = recordSet.value(nColumn++, nRow);
+	pItem->nSTR = recordSet.value(nColumn++, nRow);
+	pItem->nDEX = recordSet.value(nColumn++, nRow);
+	pItem->nINT = recordSet.value(nColumn++, nRow);
+	pItem->nLUK = recordSet.value(nColumn++, nRow);
+	pItem->nMaxHP = recordSet.value(nColumn++, nRow);
+	pItem->nMaxMP = recordSet.value(nColumn++, nRow);
+	pItem->nPAD = recordSet.value(nColumn++, nRow);
+	pItem->nMAD = recordSet.value(nColumn++, nRow);
+	pItem->nPDD = recordSet.value(nColumn++, nRow);
+	pItem->nMDD = recordSet.value(nColumn++, nRow);
+	pItem->nACC = recordSet.value(nColumn++, nRow);
+	pItem->nEVA = recordSet.value(nColumn++, nRow);
+	pItem->nSpeed = recordSet.value(nColumn++, nRow);
+	pItem->nCraft = recordSet.value(nColumn++, nRow);
+	pItem->nJump = recordSet.value(nColumn++, nRow);
 	pItem->nType = GW_ItemSlotBase::GW_ItemSlotType::EQUIP;
 
 	pItem->bIsCash = (pItem->liCashItemSN != -1);
@@ -80,13 +84,30 @@ void GW_ItemSlotEquip::LoadAll(int nCharacterID, bool bCash, std::map<int, ZShar
 		sTableName = "CashItem_EQP";
 
 	Poco::Data::Statement queryStatement(GET_DB_SESSION);
-	queryStatement << "SELECT * FROM " << sTableName << " Where CharacterID = " << nCharacterID << " AND POS < " << GW_ItemSlotBase::LOCK_POS;
+	queryStatement << "SELECT " << (bCash ? "CashItemSN, " : "ItemSN, ") << EQUIP_COLUMN << " FROM " << sTableName << " Where CharacterID = " << nCharacterID << " AND POS < " << GW_ItemSlotBase::LOCK_POS;
+	queryStatement.execute();
+	Poco::Data::RecordSet recordSet(queryStatement);
+	for (int i = 0; i < (int)recordSet.rowCount(); ++i)
+	{
+		auto pItem = MakeShared<GW_ItemSlotEquip>();
+		ConstructItemFromDBRecordSet(pItem, bCash, recordSet, i, 0);
+		mRes[pItem->nPOS] = pItem;
+	}
+}
+
+void GW_ItemSlotEquip::LoadAll(int nCharacterID, std::map<int, ZSharedPtr<GW_ItemSlotBase>>& mRes)
+{
+	//The equips come before the cash equips, as if they were loaded by LoadAll(false) then LoadAll(true).
+	Poco::Data::Statement queryStatement(GET_DB_SESSION);
+	queryStatement << "SELECT 0, ItemSN, " << EQUIP_COLUMN << " FROM ItemSlot_EQP Where CharacterID = " << nCharacterID << " AND POS < " << GW_ItemSlotBase::LOCK_POS
+		<< " UNION ALL SELECT 1, CashItemSN, " << EQUIP_COLUMN << " FROM CashItem_EQP Where CharacterID = " << nCharacterID << " AND POS < " << GW_ItemSlotBase::LOCK_POS
+		<< " ORDER BY 1";
 	queryStatement.execute();
 	Poco::Data::RecordSet recordSet(queryStatement);
-	for (int i = 0; i < recordSet.rowCount(); ++i, recordSet.moveNext())
+	for (int i = 0; i < (int)recordSet.rowCount(); ++i)
 	{
 		auto pItem = MakeShared<GW_ItemSlotEquip>();
-		ConstructItemFromDBRecordSet(pItem, bCash, recordSet);
+		ConstructItemFromDBRecordSet(pItem, (int)recordSet.value(0, i) == 1, recordSet, i, 1);
 		mRes[pItem->nPOS] = pItem;
 	}
 }
@@ -100,101 +121,66 @@ void GW_ItemSlotEquip::Load(ATOMIC_COUNT_TYPE SN)
 		sTableName = "CashItem_EQP";
 	}
 	Poco::Data::Statement queryStatement(GET_DB_SESSION);
-	queryStatement << "SELECT * FROM " << sTableName << " Where " + sColumnName + " = " << SN;
+	queryStatement << "SELECT " << sColumnName << ", " << EQUIP_COLUMN << " FROM " << sTableName << " Where " + sColumnName + " = " << SN;
 	queryStatement.execute();
 	Poco::Data::RecordSet recordSet(queryStatement);
-	ConstructItemFromDBRecordSet(this, bIsCash, recordSet);
+	ConstructItemFromDBRecordSet(this, bIsCash, recordSet, 0, 0);
 }
 
 void GW_ItemSlotEquip::Save(int nCharacterID, bool bRemoveRecord, bool bExpired)
 {
 	if (nType != GW_ItemSlotType::EQUIP)
 		throw std::runtime_error("Invalid Equip Type.");
-	Poco::Data::Statement queryStatement(GET_DB_SESSION);
-	std::string sQuery = "";
-
-	try 
-	{
-		std::string sTableName = (bExpired ? "ItemExpired_EQP" : (bIsCash ? "CashItem_EQP" : "ItemSlot_EQP"));
-		std::string sColumnName = (bIsCash ? "CashItemSN" : "ItemSN");
-		auto pSN = (bIsCash ? &liCashItemSN : &liItemSN);
 
-		if (*pSN < -1 && bRemoveRecord) //DROPPED or DELETED
-		{
-			*pSN *= -1;
-			queryStatement << "UPDATE " << sTableName << " Set CharacterID = -1 " <<
-				" Where CharacterID = "	<< nCharacterID << 
-				" AND " << sColumnName << " = " << *pSN;
+	//Joins the batch of the character being saved, otherwise the row is written at once.
+	DBBatchWriter writer(false);
+	std::string sTableName = (bExpired ? "ItemExpired_EQP" : (bIsCash ? "CashItem_EQP" : "ItemSlot_EQP"));
+	std::string sColumnName = (bIsCash ? "CashItemSN" : "ItemSN");
+	auto pSN = (bIsCash ? &liCashItemSN : &liItemSN);
 
-			//WvsLogger::LogFormat(WvsLogger::LEVEL_ERROR, "Del SQL = %s\n", queryStatement.toString().c_str());
-			queryStatement.execute();
-			return;
-		}
-		else
-		{
-			if(liItemSN <= 0)
-				liItemSN = IncItemSN(GW_ItemSlotType::EQUIP);
-			if (bIsCash && liCashItemSN == -1)
-				liCashItemSN = IncItemSN(GW_ItemSlotType::CASH);
-
-			queryStatement << "INSERT INTO " << sTableName << " (" << sColumnName <<", ItemID, CharacterID, ExpireDate, Attribute, POS, RUC, CUC, Cuttable, I_STR, I_DEX, I_INT, I_LUK, I_MaxHP, I_MaxMP, I_PAD, I_MAD, I_PDD, I_MDD, I_ACC, I_EVA, I_Speed, I_Craft, I_Jump) VALUES("
-				<< *pSN << ", "
-				<< nItemID << ", "
-				<< nCharacterID << ", "
-				<< liExpireDate << ", "
-				<< nAttribute << ", "
-				<< nPOS << ", "
-				<< (unsigned short)nRUC << ", "
-				<< (unsigned short)nCUC << ", "
-				<< (unsigned short)nCuttable << ", "
-				<< nSTR << ", "
-				<< nDEX << ", "
-				<< nINT << ", "
-				<< nLUK << ", "
-				<< nMaxHP << ", "
-				<< nMaxMP << ", "
-				<< nPAD << ", "
-				<< nMAD << ", "
-				<< nPDD << ", "
-				<< nMDD << ", "
-				<< nACC << ", "
-				<< nEVA << ", "
-				<< nSpeed << ", "
-				<< nCraft << ", "
-				<< nJump << ")";
-
-			queryStatement << " ON DUPLICATE KEY UPDATE " 
-				<< sColumnName << " = " << *pSN << ", "
-				<< "CharacterID = " << nCharacterID << ", "
-				<< "ExpireDate = '" << liExpireDate << "', "
-				<< "Attribute = " << nAttribute << ", "
-				<< "POS = " << nPOS << ", "
-				<< "Title = '" << sTitle << "', "
-				<< "RUC = '" << (unsigned short)nRUC << "', "
-				<< "CUC = '" << (unsigned short)nCUC << "', "
-				<< "Cuttable = '" << (unsigned short)nCuttable << "', "
-				<< "I_STR = " << nSTR << ", "
-				<< "I_DEX = " << nDEX << ", "
-				<< "I_INT = " << nINT << ", "
-				<< "I_LUK = " << nLUK << ", "
-				<< "I_MaxHP = " << nMaxHP << ", "
-				<< "I_MaxMP = " << nMaxMP << ", "
-				<< "I_PAD = " << nPAD << ", "
-				<< "I_MAD = " << nMAD << ", "
-				<< "I_PDD = " << nPDD << ", "
-				<< "I_MDD = " << nMDD << ", "
-				<< "I_ACC = " << nACC << ", "
-				<< "I_EVA = " << nEVA << ", "
-				<< "I_Speed = " << nSpeed << ", "
-				<< "I_Craft = " << nCraft << ", "
-				<< "I_Jump = '" << nJump << "'";
-		}
-		queryStatement.execute();
+	if (*pSN < -1 && bRemoveRecord) //DROPPED or DELETED
+	{
+		*pSN *= -1;
+		writer.Detach(sTableName, sColumnName, nCharacterID, *pSN);
 	}
-	catch (Poco::Data::MySQL::StatementException & se) 
+	else
 	{
-		WvsLogger::LogFormat("SQL Exception Occurred: %s\nRaw Query = %s\n", se.message(), sQuery.c_str());
+		if(liItemSN <= 0)
+			liItemSN = IncItemSN(GW_ItemSlotType::EQUIP);
+		if (bIsCash && liCashItemSN == -1)
+			liCashItemSN = IncItemSN(GW_ItemSlotType::CASH);
+
+		writer.Upsert(
+			sTableName,
+			sColumnName + ", ItemID, CharacterID, ExpireDate, Attribute, POS, Title, RUC, CUC, Cuttable, I_STR, I_DEX, I_INT, I_LUK, I_MaxHP, I_MaxMP, I_PAD, I_MAD, I_PDD, I_MDD, I_ACC, I_EVA, I_Speed, I_Craft, I_Jump",
+			"CharacterID, ExpireDate, Attribute, POS, Title, RUC, CUC, Cuttable, I_STR, I_DEX, I_INT, I_LUK, I_MaxHP, I_MaxMP, I_PAD, I_MAD, I_PDD, I_MDD, I_ACC, I_EVA, I_Speed, I_Craft, I_Jump")
+			<< *pSN
+			<< nItemID
+			<< nCharacterID
+			<< liExpireDate
+			<< nAttribute
+			<< nPOS
+			<< sTitle
+			<< (unsigned short)nRUC
+			<< (unsigned short)nCUC
+			<< (unsigned short)nCuttable
+			<< nSTR
+			<< nDEX
+			<< nINT
+			<< nLUK
+			<< nMaxHP
+			<< nMaxMP
+			<< nPAD
+			<< nMAD
+			<< nPDD
+			<< nMDD
+			<< nACC
+			<< nEVA
+			<< nSpeed
+			<< nCraft
+			<< nJump;
 	}
+	writer.Commit();
 }
 
 /*
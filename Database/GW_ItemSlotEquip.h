@@ -99,6 +99,10 @@ public:
 	~GW_ItemSlotEquip();
 
 	static void LoadAll(int nCharacterID, bool bCash, std::map<int, ZSharedPtr<GW_ItemSlotBase>>& mRes);
+
+	//Loads the equips and the cash equips of the character in one query.
+	static void LoadAll(int nCharacterID, std::map<int, ZSharedPtr<GW_ItemSlotBase>>& mRes);
+
 	void Load(ATOMIC_COUNT_TYPE SN);
 	void Save(int nCharacterID, bool bRemoveRecord = false, bool bExpired = false);
 
@@ -1,5 +1,6 @@
 #include "GW_ItemSlotPet.h"
 #include "WvsUnified.h"
+#include "DBBatchWriter.h"
 #include "..\WvsLib\Memory\MemoryPoolMan.hpp"
 #include "Poco\Data\MySQL\MySQLException.h"
 #include "..\WvsLib\Logger\WvsLogger.h"
@@ -17,37 +18,41 @@ GW_ItemSlotPet::~GW_ItemSlotPet()
 {
 }
 
-void ConstructItemFromDBRecordSet(GW_ItemSlotPet *pItem, Poco::Data::RecordSet& recordSet)
+//The columns decoded by ConstructItemFromDBRecordSet.
+static const char* PET_COLUMN = "CharacterID, CashItemSN, ItemID, ExpireDate, Attribute, PetAttribute, POS, Level, Repleteness, Tameness, PetSkill, PetName, ActiveState, AutoBuffSkill, PetHue, GiantRate";
+
+void ConstructItemFromDBRecordSet(GW_ItemSlotPet *pItem, Poco::Data::RecordSet& recordSet, int nRow)
 {
-	pItem->nCharacterID = recordSet["CharacterID"];
-	pItem->liCashItemSN = recordSet["CashItemSN"];
-	pItem->nItemID = recordSet["ItemID"];
-	pItem->liExpireDate = recordSet["ExpireDate"];
-	pItem->nAttribute = recordSet["Attribute"];
-	pItem->nPetAttribute = (short)recordSet["PetAttribute"];
-	pItem->nPOS = recordSet["POS"];
-	pItem->nLevel = (unsigned char)(unsigned short)recordSet["Level"];
-	pItem->nRepleteness = (unsigned char)(unsigned short)recordSet["Repleteness"];
-	pItem->nTameness = (short)recordSet["Tameness"];
-	pItem->usPetSkill = (unsigned short)recordSet["PetSkill"];
-	pItem->strPetName = recordSet["PetName"].toString();
-	pItem->nActiveState = (unsigned char)(unsigned short)recordSet["ActiveState"];
-	pItem->nAutoBuffSkill = recordSet["AutoBuffSkill"];
-	pItem->nPetHue = recordSet["PetHue"];
-	pItem->nGiantRate = recordSet["GiantRate"];
+	int nColumn = 0;
+	pItem->nCharacterID = recordSet.value(nColumn++, nRow);
+	pItem->liCashItemSN = recordSet.value(nColumn++, nRow);
+	pItem->nItemID = recordSet.value(nColumn++, nRow);
+	pItem->liExpireDate = recordSet.value(nColumn++, nRow);
+	pItem->nAttribute = recordSet.value(nColumn++, nRow);
+	pItem->nPetAttribute = (short)recordSet.value(nColumn++, nRow);
+	pItem->nPOS = recordSet.value(nColumn++, nRow);
+	pItem->nLevel = (unsigned char)(unsigned short)recordSet.value(nColumn++, nRow);
+	pItem->nRepleteness = (unsigned char)(unsigned short)recordSet.value(nColumn++, nRow);
+	pItem->nTameness = (short)recordSet.value(nColumn++, nRow);
+	pItem->usPetSkill = (unsigned short)recordSet.value(nColumn++, nRow);
+	pItem->strPetName = recordSet.value(nColumn++, nRow).toString();
+	pItem->nActiveState = (unsigned char)(unsigned short)recordSet.value(nColumn++, nRow);
+	pItem->nAutoBuffSkill = recordSet.value(nColumn++, nRow);
+	pItem->nPetHue = recordSet.value(nColumn++, nRow);
+	pItem->nGiantRate = recordSet.value(nColumn++, nRow);
 	pItem->nType = GW_ItemSlotBase::GW_ItemSlotType::CASH;
 }
 
 void GW_ItemSlotPet::LoadAll(int nCharacterID, std::map<int, ZSharedPtr<GW_ItemSlotBase>>& mRes)
 {
 	Poco::Data::Statement queryStatement(GET_DB_SESSION);
-	queryStatement << "SELECT * FROM CashItem_Pet Where CharacterID = " << nCharacterID << " AND POS < " << GW_ItemSlotBase::LOCK_POS;
+	queryStatement << "SELECT " << PET_COLUMN << " FROM CashItem_Pet Where CharacterID = " << nCharacterID << " AND POS < " << GW_ItemSlotBase::LOCK_POS;
 	queryStatement.execute();
 	Poco::Data::RecordSet recordSet(queryStatement);
-	for (int i = 0; i < recordSet.rowCount(); ++i, recordSet.moveNext())
+	for (int i = 0; i < (int)recordSet.rowCount(); ++i)
 	{
 		auto pItem = MakeShared<GW_ItemSlotPet>();
-		ConstructItemFromDBRecordSet(pItem, recordSet);
+		ConstructItemFromDBRecordSet(pItem, recordSet, i);
 		mRes[pItem->nPOS] = pItem;
 	}
 }
@@ -55,11 +60,11 @@ void GW_ItemSlotPet::LoadAll(int nCharacterID, std::map<int, ZSharedPtr<GW_ItemS
 void GW_ItemSlotPet::Load(ATOMIC_COUNT_TYPE SN)
 {
 	Poco::Data::Statement queryStatement(GET_DB_SESSION);
-	queryStatement << "SELECT * FROM CashItem_Pet Where CashItemSN = " << SN;
+	queryStatement << "SELECT " << PET_COLUMN << " FROM CashItem_Pet Where CashItemSN = " << SN;
 	queryStatement.execute();
 
 	Poco::Data::RecordSet recordSet(queryStatement);
-	ConstructItemFromDBRecordSet(this, recordSet);
+	ConstructItemFromDBRecordSet(this, recordSet, 0);
 }
 
 void GW_ItemSlotPet::Save(int nCharacterID, bool bRemoveRecord, bool bExpired)
@@ -67,69 +72,42 @@ void GW_ItemSlotPet::Save(int nCharacterID, bool bRemoveRecord, bool bExpired)
 	if (nType != GW_ItemSlotType::CASH)
 		throw std::runtime_error("Invalid Equip Type.");
 
-	Poco::Data::Statement queryStatement(GET_DB_SESSION);
-	std::string sQuery = "";
-	try 
+	//Joins the batch of the character being saved, otherwise the row is written at once.
+	DBBatchWriter writer(false);
+	if (liItemSN < -1 && bRemoveRecord) //DROPPED or DELETED
 	{
-		if (liItemSN < -1 && bRemoveRecord) //DROPPED or DELETED
-		{
-			liItemSN *= -1;
-			queryStatement << "UPDATE CashItem_Pet "
-				<< " Set CharacterID = -1 Where CharacterID = " << nCharacterID
-				<< " and  CashItemSN = " << liCashItemSN;
-			queryStatement.execute();
-			return;
-		}
-		else
-		{
-			if(liCashItemSN <= 0)
-				liCashItemSN = IncItemSN(GW_ItemSlotBase::CASH);
-			queryStatement << "INSERT INTO CashItem_Pet (CashItemSN, ItemID, CharacterID, ExpireDate, Attribute, PetAttribute, POS, Level, Repleteness, Tameness, PetSkill, PetName, RemainLife, ActiveState, AutoBuffSkill, PetHue, GiantRate) VALUES("
-				<< liCashItemSN << ", "
-				<< nItemID << ", "
-				<< nCharacterID << ", "
-				<< liExpireDate << ", "
-				<< nAttribute << ", "
-				<< nPetAttribute << ", "
-				<< nPOS << ", "
-				<< (int)nLevel << ", "
-				<< (int)nRepleteness << ", "
-				<< nTameness << ", "
-				<< usPetSkill << ", "
-				<< "'" << strPetName << "', "
-				<< nRemainLife << ", "
-				<< (int)nActiveState << ", "
-				<< nAutoBuffSkill << ", "
-				<< nPetHue << ", "
-				<< nGiantRate << ")";
-
-			queryStatement << " ON DUPLICATE KEY UPDATE "
-				<< "ItemID = " << nItemID << ", "
-				<< "CharacterID = " << nCharacterID << ", "
-				<< "ExpireDate = '" << liExpireDate << "', "
-				//<< "Attribute = " << nAttribute << ", "
-				<< "POS = " << nPOS << ", "
-				//<< "Attribute = " << nAttribute << ", "
-				<< "PetAttribute = " << nPetAttribute << ", "
-				<< "Level = " << (int)nLevel << ", "
-				<< "Repleteness = " << (int)nRepleteness << ", "
-				<< "Tameness = " << (int)nTameness << ", "
-				<< "PetSkill = " << (int)usPetSkill << ", "
-				//<< "PetName = '" << strPetName << "', "
-				//<< "RemainLife = " << (int)nRemainLife << ", "
-				<< "ActiveState = " << (int)nActiveState << " "
-				//<< "AutoBuffSkill = " << (int)nAutoBuffSkill << ", "
-				//<< "PetHue = " << (int)nPetHue << ", "
-				//<< "GiantRate = " << (int)nGiantRate << 
-				;
-		}
-		sQuery = queryStatement.toString();
-		queryStatement.execute();
+		liItemSN *= -1;
+		writer.Detach("CashItem_Pet", "CashItemSN", nCharacterID, liCashItemSN);
 	}
-	catch (Poco::Data::MySQL::StatementException &se) 
+	else
 	{
-		WvsLogger::LogFormat("SQL Exception Occurred: %s\nRaw Query = %s\n", se.message().c_str(), sQuery.c_str());
+		if(liCashItemSN <= 0)
+			liCashItemSN = IncItemSN(GW_ItemSlotBase::CASH);
+
+		//PetName, RemainLife, AutoBuffSkill, PetHue and GiantRate are kept as they were inserted.
+		writer.Upsert(
+			"CashItem_Pet",
+			"CashItemSN, ItemID, CharacterID, ExpireDate, Attribute, PetAttribute, POS, Level, Repleteness, Tameness, PetSkill, PetName, RemainLife, ActiveState, AutoBuffSkill, PetHue, GiantRate",
+			"ItemID, CharacterID, ExpireDate, POS, PetAttribute, Level, Repleteness, Tameness, PetSkill, ActiveState")
+			<< liCashItemSN
+			<< nItemID
+			<< nCharacterID
+			<< liExpireDate
+			<< nAttribute
+			<< nPetAttribute
+			<< nPOS
+			<< (int)nLevel
+			<< (int)nRepleteness
+			<< nTameness
+			<< usPetSkill
+			<< strPetName
+			<< nRemainLife
+			<< (int)nActiveState
+			<< nAutoBuffSkill
+			<< nPetHue
+			<< nGiantRate;
 	}
+	writer.Commit();
 }
 
 void GW_ItemSlotPet::Encode(OutPacket * oPacket, bool bForInternal) const
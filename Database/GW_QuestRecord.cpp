@@ -1,34 +1,33 @@
 #include "GW_QuestRecord.h"
 #include "WvsUnified.h"
+#include "DBBatchWriter.h"
 #include "..\WvsLib\Net\InPacket.h"
 #include "..\WvsLib\Net\OutPacket.h"
 #include "..\WvsLib\String\StringUtility.h"
 
-void GW_QuestRecord::Load(void* pRecordSet)
+const char* GW_QuestRecord::LOAD_COLUMN = "QuestID, CharacterID, State, Time, StrRecord";
+
+void GW_QuestRecord::Load(void* pRecordSet, int nRow)
 {
 	Poco::Data::RecordSet &recordSet = *((Poco::Data::RecordSet*)pRecordSet);
-	nQuestID = recordSet["QuestID"];
-	nCharacterID = recordSet["CharacterID"];
-	nState = recordSet["State"];
-	tTime = recordSet["Time"];
-	sStringRecord = recordSet["StrRecord"].toString();
+	nQuestID = recordSet.value(0, nRow);
+	nCharacterID = recordSet.value(1, nRow);
+	nState = recordSet.value(2, nRow);
+	tTime = recordSet.value(3, nRow);
+	sStringRecord = recordSet.value(4, nRow).toString();
 }
 
 void GW_QuestRecord::Save()
 {
-	Poco::Data::Statement queryStatement(GET_DB_SESSION);
-	std::string mobRecord = StringUtility::VectorToString(aMobRecord, ",");
-	queryStatement << "INSERT INTO QuestRecord VALUES("
-		<< nCharacterID << ", "
-		<< nQuestID << ", "
-		<< nState << ", "
-		<< tTime << ", "
-		<< "\'" << sStringRecord << "\') ON DUPLICATE KEY UPDATE "
-		<< "State = " << nState << ", "
-		<< "StrRecord = \'" << sStringRecord << "\', "
-		<< "Time = " << tTime;
-
-	queryStatement.execute();
+	//Joins the batch of the character being saved, otherwise the row is written at once.
+	DBBatchWriter writer(false);
+	writer.Upsert("QuestRecord", "CharacterID, QuestID, State, Time, StrRecord", "State, StrRecord, Time")
+		<< nCharacterID
+		<< nQuestID
+		<< nState
+		<< tTime
+		<< sStringRecord;
+	writer.Commit();
 }
 
 void GW_QuestRecord::Encode(OutPacket * oPacket)
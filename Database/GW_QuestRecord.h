@@ -18,7 +18,10 @@ struct GW_QuestRecord
 	std::string sStringRecord;
 
 #ifdef DBLIB
-	void Load(void* pRecordSet);
+	//The columns of QuestRecord decoded by Load.
+	static const char* LOAD_COLUMN;
+
+	void Load(void* pRecordSet, int nRow);
 	void Save();
 #endif
 
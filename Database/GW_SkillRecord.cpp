@@ -1,5 +1,6 @@
 #include "GW_SkillRecord.h"
 #include "WvsUnified.h"
+#include "DBBatchWriter.h"
 #include "..\WvsLib\Net\InPacket.h"
 #include "..\WvsLib\Net\OutPacket.h"
 #include "..\WvsLib\Logger\WvsLogger.h"
@@ -21,33 +22,28 @@ void GW_SkillRecord::Decode(InPacket * iPacket)
 		nMasterLevel = iPacket->Decode4();
 }
 
-void GW_SkillRecord::Load(void * pRecordSet)
+const char* GW_SkillRecord::LOAD_COLUMN = "CharacterID, SkillID, SLV, MasterLevel, Expired";
+
+void GW_SkillRecord::Load(void * pRecordSet, int nRow)
 {
 	Poco::Data::RecordSet &recordSet = *((Poco::Data::RecordSet*)pRecordSet);
-	nCharacterID = recordSet["CharacterID"];
-	nSkillID = recordSet["SkillID"];
-	nSLV = recordSet["SLV"];
-	nMasterLevel = recordSet["MasterLevel"];
-	tExpired = recordSet["Expired"];
+	nCharacterID = recordSet.value(0, nRow);
+	nSkillID = recordSet.value(1, nRow);
+	nSLV = recordSet.value(2, nRow);
+	nMasterLevel = recordSet.value(3, nRow);
+	tExpired = recordSet.value(4, nRow);
 }
 
 void GW_SkillRecord::Save()
 {
-	Poco::Data::Statement queryStatement(GET_DB_SESSION);
-	//queryStatement << "DELETE FROM SkillRecord Where SkillID = " << nSkillID << " and CharacterID = " << nCharacterID;
-	//queryStatement.execute();
-	
-	//queryStatement.reset(GET_DB_SESSION);
-	queryStatement << "INSERT INTO SkillRecord VALUES("
-		<< nCharacterID << ", "
-		<< nSkillID << ", "
-		<< nSLV << ", "
-		<< nMasterLevel << ", "
-		<< tExpired << ") ON DUPLICATE KEY UPDATE "
-		<< "SLV = " << nSLV << ", "
-		<< "MasterLevel = " << nMasterLevel << ", "
-		<< "Expired = " << tExpired
-		;
-	queryStatement.execute();
+	//Joins the batch of the character being saved, otherwise the row is written at once.
+	DBBatchWriter writer(false);
+	writer.Upsert("SkillRecord", "CharacterID, SkillID, SLV, MasterLevel, Expired", "SLV, MasterLevel, Expired")
+		<< nCharacterID
+		<< nSkillID
+		<< nSLV
+		<< nMasterLevel
+		<< tExpired;
+	writer.Commit();
 }
 
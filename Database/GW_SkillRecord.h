@@ -12,7 +12,10 @@ struct GW_SkillRecord
 	void Decode(InPacket* iPacket);
 
 #ifdef DBLIB
-	void Load(void *pRecordSet);
+	//The columns of SkillRecord decoded by Load.
+	static const char* LOAD_COLUMN;
+
+	void Load(void *pRecordSet, int nRow);
 	void Save();
 #endif
 };
@@ -40,7 +40,7 @@ void GuildDBAccessor::CreateNewGuild(void *pGuild_, int nWorldID)
 	}
 	catch (Poco::Data::MySQL::MySQLException& se) 
 	{
-		WvsLogger::LogFormat("Create Guild Failed : %s\n", se.message());
+		WvsLogger::LogSubsystem(WvsLogger::SUB_DB, WvsLogger::SEV_ERROR, "Create Guild Failed : %s\n", se.message());
 	}
 }
 
@@ -1,4 +1,5 @@
 #include "WvsUnified.h"
+#include "DBBatchWriter.h"
 #include "Poco\Data\Data.h"
 #include "Poco\Data\Statement.h"
 #include "..\WvsLib\Common\ConfigLoader.hpp"
@@ -38,5 +39,9 @@ WvsUnified* WvsUnified::GetInstance()
 
 Poco::Data::Session WvsUnified::GetDBSession()
 {
+	//Statements issued during a batched save join its transaction.
+	auto pWriter = DBBatchWriter::GetCurrent();
+	if (pWriter)
+		return pWriter->GetSession();
 	return (mDBSessionPool.get());
 }
@@ -1,17 +1,27 @@
 #include "CenterApp.h"
 #include <iostream>
 #include <thread>
+#include <chrono>
+#include <algorithm>
 
 #include "LocalServer.h"
 #include "WvsCenter.h"
 #include "WvsWorld.h"
+#include "DBExecutor.h"
+#include "CharacterHandOffCache.h"
 
 #include "..\Database\WvsUnified.h"
 #include "..\Database\GW_ItemSlotBase.h"
+#include "..\Database\DBBatchWriter.h"
+#include "..\Database\CharacterDBAccessor.h"
+#include "..\WvsLib\Net\OutPacket.h"
 #include "..\WvsLib\Wz\WzResMan.hpp"
 #include "..\WvsLib\Common\ConfigLoader.hpp"
 #include "..\WvsLib\Exception\WvsException.h"
 #include "..\WvsLib\String\StringPool.h"
+#include "..\WvsLib\String\StringUtility.h"
+#include "..\WvsLib\Logger\WvsLogger.h"
+#include "..\WvsLib\Task\TimerWheel.h"
 
 void ConnectionAcceptorThread(short nPort)
 {
@@ -31,9 +41,16 @@ void CenterApp::InitializeService(int argc, char **argv)
 		std::cout << "Please run this program with command line, and provide a path of config file." << std::endl;
 		exit(0);
 	}
+	WvsLogger::LoadConfig(pConfigLoader);
+	TimerWheel::GetInstance()->Initialize(pConfigLoader->IntValue("TimerWorkerCount", 0));
 	WzResMan::GetInstance()->Init(pConfigLoader->StrValue("GlobalConfig"));
 	StringPool::Init(pConfigLoader->StrValue("GlobalConfig"));
 	WvsUnified::InitDB(pConfigLoader);
+	DBExecutor::GetInstance()->Initialize(pConfigLoader->IntValue("DBWorkerCount", 4), pConfigLoader->IntValue("DBQueueLimit", 4096));
+	CharacterHandOffCache::GetInstance()->Initialize(
+		pConfigLoader->IntValue("HandOffCacheTTL", 30),
+		(unsigned long long)pConfigLoader->IntValue("HandOffCacheSizeMB", 64) * 1024 * 1024
+	);
 	GW_ItemSlotBase::InitItemSN(pConfigLoader->IntValue("WorldID"));
 	WvsWorld::GetInstance()->SetConfigLoader(pConfigLoader);
 	WvsBase::GetInstance<WvsCenter>()->Init();
@@ -43,17 +60,153 @@ void CenterApp::InitializeService(int argc, char **argv)
 	std::thread thread1(ConnectionAcceptorThread, (pConfigLoader->IntValue("Port")));
 
 	// start the i/o work
-	asio::io_service &io = WvsBase::GetInstance<WvsCenter>()->GetIOService();
-	asio::io_service::work work(io);
+	// the world managers (WvsWorld, PartyMan, GuildMan, ...) and the results posted by DBExecutor assume a single i/o thread
+	if (pConfigLoader->IntValue("IOThreadCount", 1) != 1)
+		WvsLogger::LogFormat(WvsLogger::LEVEL_WARNING, "[CenterApp::InitializeService]IOThreadCount is ignored, WvsCenter runs its I/O service on one thread.\n");
+	WvsBase::GetInstance<WvsCenter>()->RunIOService(1);
 
-	for (;;)
-	{
-		std::error_code ec;
-		io.run(ec);
-	}
+	// the i/o service has been stopped, write out the queued saves before leaving
+	DBExecutor::GetInstance()->Shutdown();
 }
 
 void CenterApp::OnCommandPromptInput(std::string& sInput)
 {
+	std::string sOutput;
+	std::vector<std::string> asTokens;
+	StringUtility::Split(sInput, asTokens, " ");
+	if (asTokens.empty())
+		return;
+	std::string& sCommand = asTokens[0];
+
+	if (sCommand == "GetDBBatchStat")
+	{
+		auto stat = DBBatchWriter::GetStat();
+		sOutput = StringUtility::Format(
+			"Batched Writes = %llu (Rolled Back = %llu), Statements = %llu, Rows = %llu (%.1f rows/statement)\n"
+			"Write Latency = %.2f ms avg, %.2f ms max\n",
+			stat.liTransactionCount,
+			stat.liRollbackCount,
+			stat.liStatementCount,
+			stat.liRowCount,
+			stat.liStatementCount ? (double)stat.liRowCount / stat.liStatementCount : 0.0,
+			stat.liTransactionCount ? stat.liCommitTimeInUs / 1000.0 / stat.liTransactionCount : 0.0,
+			stat.liMaxCommitTimeInUs / 1000.0
+		);
+	}
+	else if (sCommand == "GetDBExecutorStat")
+	{
+		auto stat = DBExecutor::GetInstance()->GetStat();
+		sOutput = StringUtility::Format(
+			"Workers = %d, Queue Depth = %llu (Max = %llu, Limit = %d), Running = %llu\n"
+			"Executed = %llu (Failed = %llu), Coalesced Saves = %llu, Blocked Posts = %llu\n"
+			"Wait Latency = %.2f ms avg, %.2f ms max\n"
+			"Execution Latency = %.2f ms avg, %.2f ms max\n",
+			stat.nWorkerCount,
+			stat.liQueueDepth,
+			stat.liMaxQueueDepth,
+			stat.nQueueLimit,
+			stat.liRunningCount,
+			stat.liExecutedCount,
+			stat.liFailedCount,
+			stat.liCoalescedCount,
+			stat.liBlockedCount,
+			stat.liExecutedCount ? stat.liWaitTimeInUs / 1000.0 / stat.liExecutedCount : 0.0,
+			stat.liMaxWaitTimeInUs / 1000.0,
+			stat.liExecutedCount ? stat.liExecTimeInUs / 1000.0 / stat.liExecutedCount : 0.0,
+			stat.liMaxExecTimeInUs / 1000.0
+		);
+	}
+	else if (sCommand == "GetHandOffCacheStat")
+	{
+		auto stat = CharacterHandOffCache::GetInstance()->GetStat();
+		sOutput = StringUtility::Format(
+			"Entries = %llu, Size = %.2f / %.2f MB, TTL = %d s\n"
+			"Hits = %llu, Misses = %llu (%.1f%% hit), Expired = %llu, Evicted = %llu, Invalidated = %llu\n",
+			stat.liEntryCount,
+			stat.liByteCount / 1048576.0,
+			stat.liMaxByteCount / 1048576.0,
+			stat.nTTLInSec,
+			stat.liHitCount,
+			stat.liMissCount,
+			stat.liHitCount + stat.liMissCount ? stat.liHitCount * 100.0 / (stat.liHitCount + stat.liMissCount) : 0.0,
+			stat.liExpiredCount,
+			stat.liEvictedCount,
+			stat.liInvalidatedCount
+		);
+	}
+	else if (sCommand == "GetCharacterLoadStat")
+	{
+		auto stat = CharacterDBAccessor::GetLoadStat();
+		sOutput = StringUtility::Format(
+			"Character List Loads = %llu, Latency = %.2f ms avg, %.2f ms max\n"
+			"Character Data Loads = %llu, Latency = %.2f ms avg, %.2f ms max\n",
+			stat.liListLoadCount,
+			stat.liListLoadCount ? stat.liListLoadTimeInUs / 1000.0 / stat.liListLoadCount : 0.0,
+			stat.liMaxListLoadTimeInUs / 1000.0,
+			stat.liDataLoadCount,
+			stat.liDataLoadCount ? stat.liDataLoadTimeInUs / 1000.0 / stat.liDataLoadCount : 0.0,
+			stat.liMaxDataLoadTimeInUs / 1000.0
+		);
+	}
+	else if (sCommand == "CharacterLoadBench")
+	{
+		//Replays the DB work between the login and the character being in game: the character list, the
+		//account check on selecting the character, and the account check plus the data load on migrating in.
+		//The loads aren't recorded, GetCharacterLoadStat only reports the real ones.
+		int nCharacterID = asTokens.size() > 1 ? atoi(asTokens[1].c_str()) : 0;
+		int nRound = asTokens.size() > 2 ? (std::max)(1, atoi(asTokens[2].c_str())) : 100;
+		int nAccountID = CharacterDBAccessor::QueryCharacterAccountID(nCharacterID);
+		if (nAccountID == -1)
+			sOutput = "Usage: CharacterLoadBench <int: Character ID> [<int: Rounds>], the character must exist.\n";
+		else
+		{
+			int nWorldID = WvsWorld::GetInstance()->GetWorldInfo().nWorldID;
+			unsigned long long liListTime = 0, liSelectTime = 0, liMigrateTime = 0, liMaxTotalTime = 0;
+			for (int i = 0; i < nRound; ++i)
+			{
+				auto tStart = std::chrono::steady_clock::now();
+				OutPacket oList;
+				CharacterDBAccessor::EncodeCharacterList(&oList, nAccountID, nWorldID, false);
+				auto tList = std::chrono::steady_clock::now();
+				CharacterDBAccessor::QueryCharacterAccountID(nCharacterID);
+				auto tSelect = std::chrono::steady_clock::now();
+				OutPacket oData;
+				CharacterDBAccessor::QueryCharacterAccountID(nCharacterID);
+				CharacterDBAccessor::PostCharacterDataRequest(nullptr, 0, nCharacterID, &oData, false);
+				auto tMigrate = std::chrono::steady_clock::now();
+
+				liListTime += (unsigned long long)std::chrono::duration_cast<std::chrono::microseconds>(tList - tStart).count();
+				liSelectTime += (unsigned long long)std::chrono::duration_cast<std::chrono::microseconds>(tSelect - tList).count();
+				liMigrateTime += (unsigned long long)std::chrono::duration_cast<std::chrono::microseconds>(tMigrate - tSelect).count();
+				liMaxTotalTime = (std::max)(liMaxTotalTime, (unsigned long long)std::chrono::duration_cast<std::chrono::microseconds>(tMigrate - tStart).count());
+			}
+			sOutput = StringUtility::Format(
+				"Character = %d, Rounds = %d\n"
+				"Character List = %.2f ms, Select Character = %.2f ms, Migrate In = %.2f ms (avg)\n"
+				"Login to In Game = %.2f ms avg, %.2f ms max\n",
+				nCharacterID,
+				nRound,
+				liListTime / 1000.0 / nRound,
+				liSelectTime / 1000.0 / nRound,
+				liMigrateTime / 1000.0 / nRound,
+				(liListTime + liSelectTime + liMigrateTime) / 1000.0 / nRound,
+				liMaxTotalTime / 1000.0
+			);
+		}
+	}
+	else if (sCommand == "FlushDB")
+	{
+		DBExecutor::GetInstance()->Flush();
+		sOutput = "All queued DB tasks have been executed.\n";
+	}
+	else if (sCommand == "Shutdown")
+	{
+		//InitializeService flushes the DB executor once the i/o threads have returned.
+		WvsBase::GetInstance<WvsCenter>()->GetIOService().stop();
+		sOutput = "Stopping the i/o service, the queued DB tasks will be flushed.\n";
+	}
+	else
+		sOutput = "Unrecognized command.\n";
+	WvsLogger::LogRaw(("[Command][" + sCommand + "]" + sOutput).c_str());
 }
 
@@ -109,6 +109,7 @@ DEFINE_PACKET_TYPE(CenterResultPacketType)
 	REGISTER_TYPE(MemoResult, 0x5A09);
 	REGISTER_TYPE(ShopScannerResult, 0x5A0A);
 	REGISTER_TYPE(WorldQueryResult, 0x5A0B);
+	REGISTER_TYPE(FlushCharacterDataFailed, 0x5A0C);
 
 	//From WvsCenter
 	REGISTER_TYPE(CheckMigrationStateResult, 0x6A00);
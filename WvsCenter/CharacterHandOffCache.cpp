@@ -0,0 +1,107 @@
+#include "CharacterHandOffCache.h"
+#include "..\WvsLib\Net\OutPacket.h"
+
+CharacterHandOffCache::CharacterHandOffCache()
+{
+	m_stat.nTTLInSec = 30;
+	m_stat.liMaxByteCount = 64 * 1024 * 1024;
+}
+
+CharacterHandOffCache::~CharacterHandOffCache()
+{
+}
+
+CharacterHandOffCache * CharacterHandOffCache::GetInstance()
+{
+	static CharacterHandOffCache* pInstance = new CharacterHandOffCache;
+	return pInstance;
+}
+
+void CharacterHandOffCache::Initialize(int nTTLInSec, unsigned long long liMaxByteCount)
+{
+	std::lock_guard<std::mutex> lock(m_mtxCache);
+	m_stat.nTTLInSec = nTTLInSec;
+	m_stat.liMaxByteCount = liMaxByteCount;
+}
+
+void CharacterHandOffCache::EraseEntry(std::map<int, Entry>::iterator iter)
+{
+	m_stat.liByteCount -= iter->second.sData.size();
+	m_lOrder.erase(iter->second.iterOrder);
+	m_mEntry.erase(iter);
+}
+
+void CharacterHandOffCache::RemoveExpiredEntry()
+{
+	auto tNow = std::chrono::steady_clock::now();
+	while (!m_lOrder.empty())
+	{
+		auto findIter = m_mEntry.find(m_lOrder.front());
+		if (findIter->second.tExpire > tNow)
+			break;
+		EraseEntry(findIter);
+		++m_stat.liExpiredCount;
+	}
+}
+
+void CharacterHandOffCache::Put(int nCharacterID, int nAccountID, OutPacket * oPacket)
+{
+	std::lock_guard<std::mutex> lock(m_mtxCache);
+	RemoveExpiredEntry();
+	auto findIter = m_mEntry.find(nCharacterID);
+	if (findIter != m_mEntry.end())
+		EraseEntry(findIter);
+
+	unsigned long long liSize = (unsigned long long)oPacket->GetPacketSize();
+	if (m_stat.nTTLInSec <= 0 || liSize > m_stat.liMaxByteCount)
+		return;
+	while (m_stat.liByteCount + liSize > m_stat.liMaxByteCount)
+	{
+		EraseEntry(m_mEntry.find(m_lOrder.front()));
+		++m_stat.liEvictedCount;
+	}
+
+	auto& entry = m_mEntry[nCharacterID];
+	entry.nAccountID = nAccountID;
+	entry.sData.assign((const char*)oPacket->GetPacket(), (size_t)liSize);
+	entry.tExpire = std::chrono::steady_clock::now() + std::chrono::seconds(m_stat.nTTLInSec);
+	entry.iterOrder = m_lOrder.insert(m_lOrder.end(), nCharacterID);
+	m_stat.liByteCount += liSize;
+}
+
+bool CharacterHandOffCache::Take(int nCharacterID, int& nAccountID, std::string& sData)
+{
+	std::lock_guard<std::mutex> lock(m_mtxCache);
+	RemoveExpiredEntry();
+	auto findIter = m_mEntry.find(nCharacterID);
+	if (findIter == m_mEntry.end())
+	{
+		++m_stat.liMissCount;
+		return false;
+	}
+	nAccountID = findIter->second.nAccountID;
+	m_stat.liByteCount -= findIter->second.sData.size();
+	sData.swap(findIter->second.sData);
+	m_lOrder.erase(findIter->second.iterOrder);
+	m_mEntry.erase(findIter);
+	++m_stat.liHitCount;
+	return true;
+}
+
+void CharacterHandOffCache::Invalidate(int nCharacterID)
+{
+	std::lock_guard<std::mutex> lock(m_mtxCache);
+	auto findIter = m_mEntry.find(nCharacterID);
+	if (findIter == m_mEntry.end())
+		return;
+	EraseEntry(findIter);
+	++m_stat.liInvalidatedCount;
+}
+
+CharacterHandOffCacheStat CharacterHandOffCache::GetStat()
+{
+	std::lock_guard<std::mutex> lock(m_mtxCache);
+	RemoveExpiredEntry();
+	m_stat.liEntryCount = m_mEntry.size();
+	return m_stat;
+}
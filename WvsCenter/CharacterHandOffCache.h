@@ -0,0 +1,65 @@
+#pragma once
+#include <map>
+#include <list>
+#include <mutex>
+#include <string>
+#include <chrono>
+
+class OutPacket;
+
+struct CharacterHandOffCacheStat
+{
+	int nTTLInSec = 0;
+	unsigned long long liEntryCount = 0, liByteCount = 0, liMaxByteCount = 0;
+	unsigned long long liHitCount = 0, liMissCount = 0, liExpiredCount = 0, liEvictedCount = 0, liInvalidatedCount = 0;
+};
+
+/*
+Keeps the character data of the users who are transferring between channels (or to the shop), encoded as
+CharacterDBAccessor::PostCharacterDataRequest encodes it, so the migration which follows is served without loading the
+character from the database. The saves themselves are still written by DBExecutor.
+
+An entry is taken by the first migration of the character and is dropped when anything else may change the character
+in the database, after nTTLInSec seconds, or when the cache holds more than liMaxByteCount bytes (the oldest first).
+*/
+class CharacterHandOffCache
+{
+	struct Entry
+	{
+		int nAccountID = 0;
+		std::string sData;
+		std::chrono::steady_clock::time_point tExpire;
+		std::list<int>::iterator iterOrder;
+	};
+
+	std::mutex m_mtxCache;
+	std::map<int, Entry> m_mEntry;
+
+	//Character IDs in the order of insertion, which is also the order of expiration.
+	std::list<int> m_lOrder;
+
+	CharacterHandOffCacheStat m_stat;
+
+	CharacterHandOffCache();
+	~CharacterHandOffCache();
+
+	void EraseEntry(std::map<int, Entry>::iterator iter);
+	void RemoveExpiredEntry();
+
+public:
+	static CharacterHandOffCache* GetInstance();
+
+	void Initialize(int nTTLInSec, unsigned long long liMaxByteCount);
+
+	//Caches the character data in oPacket, replacing the earlier one of the character.
+	void Put(int nCharacterID, int nAccountID, OutPacket *oPacket);
+
+	//Moves the cached character data out to sData, returns false if the character isn't cached.
+	bool Take(int nCharacterID, int& nAccountID, std::string& sData);
+
+	//Drops the cached data of the character, called whenever the character is changed by other means.
+	void Invalidate(int nCharacterID);
+
+	CharacterHandOffCacheStat GetStat();
+};
+
@@ -0,0 +1,290 @@
+#include "DBExecutor.h"
+#include "WvsCenter.h"
+#include "WvsWorld.h"
+#include "CenterPacketTypes.hpp"
+
+#include "..\Database\GA_Character.hpp"
+#include "..\Database\GW_Avatar.hpp"
+#include "..\Database\GW_CharacterStat.h"
+#include "..\Database\GW_CharacterLevel.h"
+#include "..\Database\GW_CharacterMoney.h"
+#include "..\Database\GW_CharacterSlotCount.h"
+#include "..\Database\GW_ItemSlotBase.h"
+#include "..\Database\GW_SkillRecord.h"
+#include "..\Database\GW_QuestRecord.h"
+#include "..\Database\GW_FuncKeyMapped.h"
+#include "..\Database\CharacterDBAccessor.h"
+#include "..\WvsLib\Net\InPacket.h"
+#include "..\WvsLib\Net\OutPacket.h"
+#include "..\WvsLib\Memory\MemoryPoolMan.hpp"
+#include "..\WvsLib\Logger\WvsLogger.h"
+
+#include <algorithm>
+
+DBExecutor::DBExecutor()
+{
+}
+
+DBExecutor::~DBExecutor()
+{
+	Shutdown();
+}
+
+DBExecutor * DBExecutor::GetInstance()
+{
+	static DBExecutor* pInstance = new DBExecutor;
+	return pInstance;
+}
+
+void DBExecutor::Initialize(int nWorkerCount, int nQueueLimit)
+{
+	std::call_once(m_flagInit, [&]() {
+		if (nWorkerCount <= 0)
+			nWorkerCount = (std::max)(2, (int)std::thread::hardware_concurrency());
+
+		std::lock_guard<std::mutex> lock(m_mtxQueue);
+		m_bRunning = true;
+		m_nQueueLimit = nQueueLimit > 0 ? nQueueLimit : 0;
+		m_stat.nWorkerCount = nWorkerCount;
+		m_stat.nQueueLimit = m_nQueueLimit;
+		for (int i = 0; i < nWorkerCount; ++i)
+			m_aWorker.push_back(std::thread(&DBExecutor::WorkerThread, this));
+		WvsLogger::LogSubsystem(WvsLogger::SUB_DB, WvsLogger::SEV_INFO, "[DBExecutor::Initialize]DB executor is running with %d worker thread(s), queue limit = %d.\n", nWorkerCount, m_nQueueLimit);
+	});
+}
+
+void DBExecutor::Enqueue(int nKey, QueuedTask& task)
+{
+	auto lmdExecute = [&]()
+	{
+		if (task.pSave)
+			SaveCharacter(task.pSave);
+		else
+			task.fTask();
+	};
+
+	std::unique_lock<std::mutex> lock(m_mtxQueue);
+	if (!m_bRunning)
+	{
+		lock.unlock();
+		lmdExecute();
+		return;
+	}
+
+	auto findIter = m_mKeyQueue.find(nKey);
+	if (task.pSave && findIter != m_mKeyQueue.end() && !findIter->second.aTask.empty() && findIter->second.aTask.back().pSave)
+	{
+		//The newer save is folded into the one which hasn't been started, the merged save keeps the earlier place.
+		MergeCharacterSave(*(findIter->second.aTask.back().pSave), *task.pSave);
+		++m_stat.liCoalescedCount;
+		return;
+	}
+
+	if (m_nQueueLimit && m_stat.liQueueDepth >= (unsigned long long)m_nQueueLimit)
+	{
+		++m_stat.liBlockedCount;
+		m_cvSpace.wait(lock, [&]() { return m_stat.liQueueDepth < (unsigned long long)m_nQueueLimit || !m_bRunning; });
+		if (!m_bRunning)
+		{
+			lock.unlock();
+			lmdExecute();
+			return;
+		}
+	}
+
+	auto& queue = m_mKeyQueue[nKey];
+	if (!queue.bRunning && queue.aTask.empty())
+		m_aReadyKey.push_back(nKey);
+	task.tQueued = std::chrono::steady_clock::now();
+	queue.aTask.push_back(std::move(task));
+	if (++m_stat.liQueueDepth > m_stat.liMaxQueueDepth)
+		m_stat.liMaxQueueDepth = m_stat.liQueueDepth;
+	lock.unlock();
+	m_cvReady.notify_one();
+}
+
+void DBExecutor::WorkerThread()
+{
+	std::unique_lock<std::mutex> lock(m_mtxQueue);
+	while (true)
+	{
+		m_cvReady.wait(lock, [&]() { return !m_aReadyKey.empty() || !m_bRunning; });
+		if (m_aReadyKey.empty())
+			return;
+
+		int nKey = m_aReadyKey.front();
+		m_aReadyKey.pop_front();
+		auto& queue = m_mKeyQueue[nKey];
+		QueuedTask task = std::move(queue.aTask.front());
+		queue.aTask.pop_front();
+		queue.bRunning = true;
+		--m_stat.liQueueDepth;
+		++m_stat.liRunningCount;
+		lock.unlock();
+		m_cvSpace.notify_one();
+
+		auto tStart = std::chrono::steady_clock::now();
+		bool bFailed = false;
+		try
+		{
+			if (task.pSave)
+				bFailed = !SaveCharacter(task.pSave);
+			else
+				task.fTask();
+		}
+		catch (std::exception& ex)
+		{
+			bFailed = true;
+			WvsLogger::LogSubsystem(WvsLogger::SUB_DB, WvsLogger::SEV_ERROR, "[DBExecutor::WorkerThread]An exception occurred while executing the task of key %d: %s\n", nKey, ex.what());
+		}
+		auto tEnd = std::chrono::steady_clock::now();
+		auto liWait = (unsigned long long)std::chrono::duration_cast<std::chrono::microseconds>(tStart - task.tQueued).count();
+		auto liExec = (unsigned long long)std::chrono::duration_cast<std::chrono::microseconds>(tEnd - tStart).count();
+		task.fTask = nullptr;
+		task.pSave.reset(nullptr);
+
+		lock.lock();
+		++m_stat.liExecutedCount;
+		m_stat.liFailedCount += (bFailed ? 1 : 0);
+		m_stat.liWaitTimeInUs += liWait;
+		m_stat.liExecTimeInUs += liExec;
+		m_stat.liMaxWaitTimeInUs = (std::max)(m_stat.liMaxWaitTimeInUs, liWait);
+		m_stat.liMaxExecTimeInUs = (std::max)(m_stat.liMaxExecTimeInUs, liExec);
+		--m_stat.liRunningCount;
+
+		auto findIter = m_mKeyQueue.find(nKey);
+		findIter->second.bRunning = false;
+		if (findIter->second.aTask.empty())
+			m_mKeyQueue.erase(findIter);
+		else
+		{
+			m_aReadyKey.push_back(nKey);
+			m_cvReady.notify_one();
+		}
+		if (m_stat.liQueueDepth == 0 && m_stat.liRunningCount == 0)
+			m_cvIdle.notify_all();
+	}
+}
+
+void DBExecutor::MergeCharacterSave(CharacterSave& save, CharacterSave& newer)
+{
+	save.nDeltaFlag = save.pCharacter->MergeCharacterDataDelta(save.nDeltaFlag, *(newer.pCharacter), newer.nDeltaFlag);
+	for (auto& prKey : newer.pFuncKeyMapped->m_mKeyMapped)
+		save.pFuncKeyMapped->m_mKeyMapped[prKey.first] = prKey.second;
+}
+
+bool DBExecutor::SaveCharacter(ZSharedPtr<CharacterSave> pSave)
+{
+	int nCharacterID = pSave->pCharacter->nCharacterID;
+	{
+		std::lock_guard<std::mutex> lock(m_mtxQueue);
+		auto findIter = m_mFailedSave.find(nCharacterID);
+		if (findIter != m_mFailedSave.end())
+		{
+			MergeCharacterSave(*(findIter->second), *pSave);
+			pSave = findIter->second;
+			m_mFailedSave.erase(findIter);
+		}
+	}
+	if (CharacterDBAccessor::SaveCharacterData(pSave->pCharacter, pSave->nDeltaFlag, pSave->pFuncKeyMapped))
+		return true;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mtxQueue);
+		m_mFailedSave[nCharacterID] = pSave;
+	}
+	WvsLogger::LogSubsystem(WvsLogger::SUB_DB, WvsLogger::SEV_ERROR, "[DBExecutor::SaveCharacter]Failed to save the character %d, the save is kept for the next one.\n", nCharacterID);
+
+	//The digests of the game server already count the failed data as saved.
+	PostResult([nCharacterID]() {
+		auto pwUser = WvsWorld::GetInstance()->GetUser(nCharacterID);
+		if (!pwUser)
+			return;
+		OutPacket oPacket;
+		oPacket.Encode2(CenterResultPacketType::FlushCharacterDataFailed);
+		oPacket.Encode4(nCharacterID);
+		pwUser->SendPacket(&oPacket);
+	});
+	return false;
+}
+
+void DBExecutor::Post(int nKey, const DBTask& fTask)
+{
+	QueuedTask task;
+	task.fTask = fTask;
+	Enqueue(nKey, task);
+}
+
+void DBExecutor::PostResult(const DBTask& fResult)
+{
+	WvsBase::GetInstance<WvsCenter>()->GetIOService().post(fResult);
+}
+
+int DBExecutor::PostCharacterSave(InPacket *iPacket, bool bDelta, OutPacket *oCharacterData)
+{
+	QueuedTask task;
+	task.pSave.reset(AllocObj(CharacterSave));
+	auto& save = *task.pSave;
+	save.pCharacter.reset(AllocObj(GA_Character));
+	if (bDelta)
+		save.nDeltaFlag = save.pCharacter->DecodeCharacterDataDelta(iPacket);
+	else
+	{
+		save.pCharacter->DecodeCharacterData(iPacket, true);
+		save.nDeltaFlag = GA_Character::eDelta_All;
+	}
+
+	int nKeyMappedPos = iPacket->GetReadCount();
+	if (oCharacterData && !bDelta)
+	{
+		//The removed records are detached by this save, the server which loads the data mustn't send them again.
+		std::set<std::pair<long long int, bool>> aItemRemovedRecord[6];
+		for (int i = 0; i < 6; ++i)
+			aItemRemovedRecord[i].swap(save.pCharacter->mItemRemovedRecord[i]);
+		save.pCharacter->EncodeCharacterData(oCharacterData, true);
+		for (int i = 0; i < 6; ++i)
+			aItemRemovedRecord[i].swap(save.pCharacter->mItemRemovedRecord[i]);
+	}
+	save.pFuncKeyMapped.reset(AllocObjCtor(GW_FuncKeyMapped)(save.pCharacter->nCharacterID));
+	save.pFuncKeyMapped->Decode(iPacket, false);
+
+	//The key map is passed on as it was received, the decoded one leaves out the empty keys.
+	if (oCharacterData && !bDelta)
+		oCharacterData->EncodeBuffer(iPacket->GetPacket() + nKeyMappedPos, iPacket->GetReadCount() - nKeyMappedPos);
+
+	int nCharacterID = save.pCharacter->nCharacterID;
+	Enqueue(nCharacterID, task);
+	return nCharacterID;
+}
+
+void DBExecutor::Flush()
+{
+	std::unique_lock<std::mutex> lock(m_mtxQueue);
+	m_cvIdle.wait(lock, [&]() { return m_stat.liQueueDepth == 0 && m_stat.liRunningCount == 0; });
+}
+
+void DBExecutor::Shutdown()
+{
+	{
+		std::unique_lock<std::mutex> lock(m_mtxQueue);
+		if (!m_bRunning)
+			return;
+		WvsLogger::LogSubsystem(WvsLogger::SUB_DB, WvsLogger::SEV_INFO, "[DBExecutor::Shutdown]Flushing %llu queued task(s).\n", m_stat.liQueueDepth + m_stat.liRunningCount);
+		m_cvIdle.wait(lock, [&]() { return m_stat.liQueueDepth == 0 && m_stat.liRunningCount == 0; });
+		m_bRunning = false;
+		if (m_mFailedSave.size())
+			WvsLogger::LogSubsystem(WvsLogger::SUB_DB, WvsLogger::SEV_ERROR, "[DBExecutor::Shutdown]The saves of %d character(s) failed and are discarded.\n", (int)m_mFailedSave.size());
+	}
+	m_cvReady.notify_all();
+	m_cvSpace.notify_all();
+	for (auto& t : m_aWorker)
+		if (t.joinable())
+			t.join();
+	m_aWorker.clear();
+}
+
+DBExecutorStat DBExecutor::GetStat()
+{
+	std::lock_guard<std::mutex> lock(m_mtxQueue);
+	return m_stat;
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <map>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <functional>
+#include <condition_variable>
+#include "..\WvsLib\Memory\ZMemory.h"
+
+class InPacket;
+class OutPacket;
+struct GA_Character;
+struct GW_FuncKeyMapped;
+
+struct DBExecutorStat
+{
+	int nWorkerCount = 0, nQueueLimit = 0;
+	unsigned long long liQueueDepth = 0, liMaxQueueDepth = 0, liRunningCount = 0;
+	unsigned long long liExecutedCount = 0, liFailedCount = 0, liCoalescedCount = 0, liBlockedCount = 0;
+	unsigned long long liWaitTimeInUs = 0, liMaxWaitTimeInUs = 0, liExecTimeInUs = 0, liMaxExecTimeInUs = 0;
+};
+
+/*
+Runs the database work of the center on a fixed set of worker threads, so the I/O threads never wait for MySQL.
+
+Tasks are queued by key (the character ID): the tasks of a key run one at a time in the order they were posted, the
+tasks of different keys run in parallel. A character save still waiting in the queue absorbs the saves of the same
+character posted after it (GA_Character::MergeCharacterDataDelta), so the character is written once with the newest
+data. Results are handed back to the I/O thread by PostResult.
+
+A character save which fails to commit is kept and the next save of the character is merged into it, so the records
+it detached aren't lost. The game server of the character is told to send the whole character with its next flush.
+
+Posting blocks when the queue holds nQueueLimit tasks, until the workers catch up.
+*/
+class DBExecutor
+{
+public:
+	typedef std::function<void()> DBTask;
+
+private:
+	struct CharacterSave
+	{
+		ZUniquePtr<GA_Character> pCharacter;
+		ZUniquePtr<GW_FuncKeyMapped> pFuncKeyMapped;
+		int nDeltaFlag = 0;
+	};
+
+	struct QueuedTask
+	{
+		DBTask fTask;
+		ZSharedPtr<CharacterSave> pSave;
+		std::chrono::steady_clock::time_point tQueued;
+	};
+
+	struct KeyQueue
+	{
+		std::deque<QueuedTask> aTask;
+		bool bRunning = false;
+	};
+
+	std::mutex m_mtxQueue;
+	std::condition_variable m_cvReady, m_cvSpace, m_cvIdle;
+	std::map<int, KeyQueue> m_mKeyQueue;
+	std::deque<int> m_aReadyKey;
+	std::map<int, ZSharedPtr<CharacterSave>> m_mFailedSave;
+	std::vector<std::thread> m_aWorker;
+	std::once_flag m_flagInit;
+	bool m_bRunning = false;
+	int m_nQueueLimit = 0;
+
+	DBExecutorStat m_stat;
+
+	DBExecutor();
+	~DBExecutor();
+
+	void Enqueue(int nKey, QueuedTask& task);
+	void WorkerThread();
+	static void MergeCharacterSave(CharacterSave& save, CharacterSave& newer);
+	bool SaveCharacter(ZSharedPtr<CharacterSave> pSave);
+
+public:
+	static DBExecutor* GetInstance();
+
+	//Starts nWorkerCount worker threads, only the first call takes effect.
+	void Initialize(int nWorkerCount, int nQueueLimit);
+
+	void Post(int nKey, const DBTask& fTask);
+
+	//Runs fResult on the I/O thread of the center.
+	void PostResult(const DBTask& fResult);
+
+	/*
+	Decodes a character save (GA_Character::EncodeCharacterDataDelta if bDelta, the full character data otherwise,
+	followed by the key map) and queues it behind the earlier tasks of the character.
+	For a full save, oCharacterData receives the character data as a migration would load it from the database.
+	Returns the ID of the character.
+	*/
+	int PostCharacterSave(InPacket *iPacket, bool bDelta, OutPacket *oCharacterData = nullptr);
+
+	//Waits until every task posted so far has been executed.
+	void Flush();
+
+	//Flushes and stops the workers, the tasks posted afterwards are executed by the caller.
+	void Shutdown();
+
+	DBExecutorStat GetStat();
+};
+
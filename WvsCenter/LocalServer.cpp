@@ -27,6 +27,8 @@
 #include "EntrustedShopMan.h"
 #include "GuildBBSMan.h"
 #include "ShopScannerMan.h"
+#include "DBExecutor.h"
+#include "CharacterHandOffCache.h"
 
 #include <cmath>
 
@@ -71,6 +73,22 @@ void LocalServer::RemoveConnectedUser(int nUserID)
 	m_sUser.erase(nUserID);
 }
 
+void LocalServer::PostDBRequest(int nCharacterID, InPacket *iPacket, const std::function<void(InPacket*)>& fHandler)
+{
+	//The buffer of iPacket is released once OnPacket returns, the unread part is copied.
+	auto pBuffer = std::make_shared<std::vector<unsigned char>>(
+		iPacket->GetPacket() + iPacket->GetReadCount(),
+		iPacket->GetPacket() + iPacket->GetPacketSize()
+	);
+	auto pSrv = shared_from_this();
+	CharacterHandOffCache::GetInstance()->Invalidate(nCharacterID);
+	DBExecutor::GetInstance()->Post(nCharacterID, [pSrv, pBuffer, fHandler]()
+	{
+		InPacket iPacket(pBuffer->data(), (unsigned short)pBuffer->size());
+		fHandler(&iPacket);
+	});
+}
+
 int ProcessLocalServerPacket(LocalServer* pSrv, InPacket *iPacket)
 {
 	int nType = ((short*)iPacket->GetPacket())[0];
@@ -88,12 +106,11 @@ int ProcessLocalServerPacket(LocalServer* pSrv, InPacket *iPacket)
 
 void LocalServer::OnPacket(InPacket *iPacket)
 {
-	WvsLogger::LogRaw("[WvsCenter][LocalServer::OnPacket]Packet received: ");
-	iPacket->Print();
+	iPacket->Dump("[WvsCenter][LocalServer::OnPacket]Packet received: ");
 	int nResult = ProcessLocalServerPacket(this, iPacket);
 
 	if (nResult != -1)
-		WvsLogger::LogFormat(WvsLogger::LEVEL_ERROR, "Unhandled System-Level Excpetion Has Been Caught: Packet Type = %d\n", nResult);
+		WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_ERROR, "Unhandled System-Level Excpetion Has Been Caught: Packet Type = %d\n", nResult);
 }
 
 void LocalServer::ProcessPacket(InPacket * iPacket)
@@ -151,7 +168,9 @@ void LocalServer::ProcessPacket(InPacket * iPacket)
 			OnTrunkRequest(iPacket);
 			break;
 		case CenterRequestPacketType::FlushCharacterData:
-			CharacterDBAccessor::OnCharacterSaveRequest(iPacket);
+			CharacterHandOffCache::GetInstance()->Invalidate(
+				DBExecutor::GetInstance()->PostCharacterSave(iPacket, true)
+			);
 			break;
 		case CenterRequestPacketType::EntrustedShopRequest:
 			OnEntrustedShopRequest(iPacket);
@@ -192,7 +211,7 @@ void LocalServer::OnRegisterCenterRequest(InPacket *iPacket)
 		(nServerType == ServerConstants::SRV_GAME ? "WvsGame" : "WvsShop")
 	);
 
-	WvsLogger::LogFormat("[WvsCenter][LocalServer::OnRegisterCenterRequest]A connection request is received, instance information: [%s][%d].\n", sInstanceName, nServerType);
+	WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_INFO, "[WvsCenter][LocalServer::OnRegisterCenterRequest]A connection request is received, instance information: [%s][%d].\n", sInstanceName, nServerType);
 	m_nChannelID = WvsWorld::CHANNELID_SHOP;
 
 	if (nServerType == ServerConstants::SRV_GAME)
@@ -246,7 +265,7 @@ void LocalServer::OnRegisterCenterRequest(InPacket *iPacket)
 	if (!bSuccess) 
 	{
 		oPacket.Encode1(0);
-		WvsLogger::LogFormat(WvsLogger::LEVEL_ERROR, "[LocalServer::OnRegisterCenterRequest]A %s LocalServer failed to pass center registration.\n", sInstanceName);
+		WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_ERROR, "[LocalServer::OnRegisterCenterRequest]A %s LocalServer failed to pass center registration.\n", sInstanceName);
 	}
 	SendPacket(&oPacket);
 }
@@ -365,8 +384,9 @@ void LocalServer::OnRequestGameServerInfo(InPacket *iPacket)
 		pAuthEntry //Multiple login on same account.
 		)
 	{
-		WvsLogger::LogFormat(
-			WvsLogger::LEVEL_ERROR, 
+		WvsLogger::LogSubsystem(
+			WvsLogger::SUB_NET,
+			WvsLogger::SEV_ERROR, 
 			"[WvsCenter][LocalServer::OnRequstGameServerInfo]Warning: A client is trying to connect to an inexistent channel server [WvsGame: %02d] or login to an inexistent account [AccountID = %d, CharacterID = %d].\n", 
 			nChannelID,
 			nAccountID,
@@ -421,7 +441,11 @@ void LocalServer::OnRequestMigrateIn(InPacket *iPacket)
 	int nClientSocketID = iPacket->Decode4();
 	int nCharacterID = iPacket->Decode4();
 	int nChannelID = iPacket->Decode4();
-	int nAccountID = CharacterDBAccessor::QueryCharacterAccountID(nCharacterID);
+	int nAccountID = -1;
+	std::string sCharacterData;
+	bool bHandedOff = CharacterHandOffCache::GetInstance()->Take(nCharacterID, nAccountID, sCharacterData);
+	if (!bHandedOff)
+		nAccountID = CharacterDBAccessor::QueryCharacterAccountID(nCharacterID);
 	AuthEntry *pAuthEntry = nullptr;
 
 	InsertConnectedUser(nCharacterID);
@@ -430,7 +454,7 @@ void LocalServer::OnRequestMigrateIn(InPacket *iPacket)
 		)
 	{
 		RemoveConnectedUser(nCharacterID);
-		WvsLogger::LogFormat(WvsLogger::LEVEL_ERROR, "[WvsCenter][LocalServer::OnRequestMigrateIn]Warning: A clienRemoveAuthEntryt is trying to login to an account that has already been issued a migration for other characters. [CharacterID = %d].\n", nCharacterID);
+		WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_ERROR, "[WvsCenter][LocalServer::OnRequestMigrateIn]Warning: A clienRemoveAuthEntryt is trying to login to an account that has already been issued a migration for other characters. [CharacterID = %d].\n", nCharacterID);
 		return;
 	}
 
@@ -442,13 +466,13 @@ void LocalServer::OnRequestMigrateIn(InPacket *iPacket)
 		if(!pAuthEntry)
 		{
 			RemoveConnectedUser(nCharacterID);
-			WvsLogger::LogFormat(WvsLogger::LEVEL_ERROR, "[WvsCenter][LocalServer::OnRequestMigrateIn]Warning: A client is trying to login to a character without authentications. [CharacterID = %d].\n",	nCharacterID);
+			WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_ERROR, "[WvsCenter][LocalServer::OnRequestMigrateIn]Warning: A client is trying to login to a character without authentications. [CharacterID = %d].\n",	nCharacterID);
 			return;
 		}
 
 		if (pMigratedInUser)
 		{
-			WvsLogger::LogFormat(WvsLogger::LEVEL_ERROR, "[WvsCenter][LocalServer::OnRequestMigrateIn]Warning: A client is trying to login to a character that has already logged into the game server. [CharacterID = %d].\n", nCharacterID);
+			WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_ERROR, "[WvsCenter][LocalServer::OnRequestMigrateIn]Warning: A client is trying to login to a character that has already logged into the game server. [CharacterID = %d].\n", nCharacterID);
 			return;
 		}
 
@@ -466,21 +490,47 @@ void LocalServer::OnRequestMigrateIn(InPacket *iPacket)
 		);
 	}
 
-	OutPacket oPacket;
-	oPacket.Encode2(CenterResultPacketType::CenterMigrateInResult);
-	oPacket.Encode4(nClientSocketID);
-	oPacket.Encode4(nCharacterID);
-	CharacterDBAccessor::PostCharacterDataRequest(this, nClientSocketID, nCharacterID, &oPacket); // for WvsGame
-	auto pUserTransferStatus = WvsWorld::GetInstance()->GetUserTransferStatus(nCharacterID);
+	if (bHandedOff)
+	{
+		OutPacket oPacket;
+		oPacket.Encode2(CenterResultPacketType::CenterMigrateInResult);
+		oPacket.Encode4(nClientSocketID);
+		oPacket.Encode4(nCharacterID);
+		oPacket.Encode1(1); //Valid
+		oPacket.Encode4(nAccountID);
+		oPacket.EncodeBuffer((unsigned char*)sCharacterData.data(), (int)sCharacterData.size());
+		SendMigrateInResult(&oPacket, nCharacterID, nChannelID);
+		return;
+	}
+
+	//Queued behind the pending saves of the character, so the data loaded is what it was migrated out with.
+	auto pSrv = std::static_pointer_cast<LocalServer>(shared_from_this());
+	DBExecutor::GetInstance()->Post(nCharacterID, [pSrv, nClientSocketID, nCharacterID, nChannelID]()
+	{
+		auto pPacket = std::make_shared<OutPacket>();
+		pPacket->Encode2(CenterResultPacketType::CenterMigrateInResult);
+		pPacket->Encode4(nClientSocketID);
+		pPacket->Encode4(nCharacterID);
+		CharacterDBAccessor::PostCharacterDataRequest(pSrv.get(), nClientSocketID, nCharacterID, pPacket.get()); // for WvsGame
+
+		DBExecutor::GetInstance()->PostResult([pSrv, pPacket, nCharacterID, nChannelID]()
+		{
+			pSrv->SendMigrateInResult(pPacket.get(), nCharacterID, nChannelID);
+		});
+	});
+}
 
+void LocalServer::SendMigrateInResult(OutPacket *oPacket, int nCharacterID, int nChannelID)
+{
+	auto pUserTransferStatus = WvsWorld::GetInstance()->GetUserTransferStatus(nCharacterID);
 	if (pUserTransferStatus == nullptr)
-		oPacket.Encode1(0);
+		oPacket->Encode1(0);
 	else
 	{
-		oPacket.Encode1(1);
-		pUserTransferStatus->Encode(&oPacket);
+		oPacket->Encode1(1);
+		pUserTransferStatus->Encode(oPacket);
 	}
-	this->SendPacket(&oPacket);
+	SendPacket(oPacket);
 	WvsWorld::GetInstance()->UserMigrateIn(nCharacterID, nChannelID);
 }
 
@@ -491,9 +541,18 @@ void LocalServer::OnRequestMigrateOut(InPacket * iPacket)
 	int nChannelID = iPacket->Decode4();
 
 	RemoveConnectedUser(nCharacterID);
-	CharacterDBAccessor::OnCharacterSaveRequest(iPacket);
+	OutPacket oCharacterData;
+	DBExecutor::GetInstance()->PostCharacterSave(iPacket, false, &oCharacterData);
 	char nGameEndType = iPacket->Decode1();
 
+	//The next server is handed the data just received, while the save is still being written.
+	auto pwUser = WvsWorld::GetInstance()->GetUser(nCharacterID);
+	if (pwUser && (nGameEndType == CenterMigrationType::eMigrateOut_TransferChannelFromGame ||
+		nGameEndType == CenterMigrationType::eMigrateOut_TransferChannelFromShop))
+		CharacterHandOffCache::GetInstance()->Put(nCharacterID, pwUser->m_nAccountID, &oCharacterData);
+	else
+		CharacterHandOffCache::GetInstance()->Invalidate(nCharacterID);
+
 	if (nGameEndType == CenterMigrationType::eMigrateOut_TransferChannelFromGame) //Transfer to another game server or to the shop.
 	{
 		UserTransferStatus* pStatus = AllocObj( UserTransferStatus );
@@ -618,46 +677,58 @@ void LocalServer::OnCashItemRequest(InPacket * iPacket)
 	int nClientSocketID = iPacket->Decode4();
 	int nCharacterID = iPacket->Decode4();
 	int nRequest = iPacket->Decode2();
-	switch (nRequest)
+	auto pSrv = shared_from_this();
+	PostDBRequest(nCharacterID, iPacket, [pSrv, nClientSocketID, nCharacterID, nRequest](InPacket *iPacket)
 	{
-		case CenterCashItemRequestType::eGiftCashPackageRequest:
-		case CenterCashItemRequestType::eBuyCashPackageRequest:
-		case CenterCashItemRequestType::eGiftCashItemRequest:
-		case CenterCashItemRequestType::eBuyCashItemRequest:
-			CashItemDBAccessor::PostBuyCashItemRequest(
-				this, 
-				nClientSocketID, 
-				nCharacterID, 
-				nRequest, 
-				iPacket, 
-				nRequest == CenterCashItemRequestType::eGiftCashItemRequest || nRequest == CenterCashItemRequestType::eGiftCashPackageRequest
-			);
-			break;
-		case CenterCashItemRequestType::eLoadCashItemLockerRequest:
-			CashItemDBAccessor::PostLoadLockerRequest(this, nClientSocketID, nCharacterID, iPacket);
-			break;
-		case CenterCashItemRequestType::eMoveCashItemLtoSRequest:
-			CashItemDBAccessor::PostMoveLockerToSlotRequest(this, nClientSocketID, nCharacterID, iPacket);
-			break;
-		case CenterCashItemRequestType::eMoveCashItemStoLRequest:
-			CashItemDBAccessor::PostMoveSlotToLockerRequest(this, nClientSocketID, nCharacterID, iPacket);
-			break;
-		case CenterCashItemRequestType::eExpireCashItemRequest:
-			CashItemDBAccessor::PostExpireCashItemRequest(this, nClientSocketID, nCharacterID, iPacket);
-			break;
-		case CenterCashItemRequestType::eGetMaplePointRequest:
-			CashItemDBAccessor::PostUpdateCashRequest(this, nClientSocketID, nCharacterID, iPacket);
-			break;
-		case CenterCashItemRequestType::eLoadGiftListRequest:
-			CashItemDBAccessor::PostLoadGiftListRequest(this, nClientSocketID, nCharacterID);
-			break;
-		case CenterCashItemRequestType::eLoadWishItemRequest:
-			CashItemDBAccessor::PostLoadWishListRequest(this, nClientSocketID, nCharacterID);
-			break;
-		case CenterCashItemRequestType::eSetWishItemRequest:
-			CashItemDBAccessor::PostSetWishListRequest(this, nClientSocketID, nCharacterID, iPacket);
-			break;
-	}
+		auto pPacket = std::make_shared<OutPacket>();
+		switch (nRequest)
+		{
+			case CenterCashItemRequestType::eGiftCashPackageRequest:
+			case CenterCashItemRequestType::eBuyCashPackageRequest:
+			case CenterCashItemRequestType::eGiftCashItemRequest:
+			case CenterCashItemRequestType::eBuyCashItemRequest:
+				CashItemDBAccessor::PostBuyCashItemRequest(
+					pPacket.get(), 
+					nClientSocketID, 
+					nCharacterID, 
+					nRequest, 
+					iPacket, 
+					nRequest == CenterCashItemRequestType::eGiftCashItemRequest || nRequest == CenterCashItemRequestType::eGiftCashPackageRequest
+				);
+				break;
+			case CenterCashItemRequestType::eLoadCashItemLockerRequest:
+				CashItemDBAccessor::PostLoadLockerRequest(pPacket.get(), nClientSocketID, nCharacterID, iPacket);
+				break;
+			case CenterCashItemRequestType::eMoveCashItemLtoSRequest:
+				CashItemDBAccessor::PostMoveLockerToSlotRequest(pPacket.get(), nClientSocketID, nCharacterID, iPacket);
+				break;
+			case CenterCashItemRequestType::eMoveCashItemStoLRequest:
+				CashItemDBAccessor::PostMoveSlotToLockerRequest(pPacket.get(), nClientSocketID, nCharacterID, iPacket);
+				break;
+			case CenterCashItemRequestType::eExpireCashItemRequest:
+				CashItemDBAccessor::PostExpireCashItemRequest(pPacket.get(), nClientSocketID, nCharacterID, iPacket);
+				break;
+			case CenterCashItemRequestType::eGetMaplePointRequest:
+				CashItemDBAccessor::PostUpdateCashRequest(pPacket.get(), nClientSocketID, nCharacterID, iPacket);
+				break;
+			case CenterCashItemRequestType::eLoadGiftListRequest:
+				CashItemDBAccessor::PostLoadGiftListRequest(pPacket.get(), nClientSocketID, nCharacterID);
+				break;
+			case CenterCashItemRequestType::eLoadWishItemRequest:
+				CashItemDBAccessor::PostLoadWishListRequest(pPacket.get(), nClientSocketID, nCharacterID);
+				break;
+			case CenterCashItemRequestType::eSetWishItemRequest:
+				CashItemDBAccessor::PostSetWishListRequest(pPacket.get(), nClientSocketID, nCharacterID, iPacket);
+				break;
+		}
+		if (!pPacket->GetPacketSize())
+			return;
+
+		DBExecutor::GetInstance()->PostResult([pSrv, pPacket]()
+		{
+			pSrv->SendPacket(pPacket.get());
+		});
+	});
 }
 
 void LocalServer::OnPartyRequest(InPacket * iPacket)
@@ -901,34 +972,41 @@ void LocalServer::OnTrunkRequest(InPacket * iPacket)
 	int nAccountID = iPacket->Decode4();
 	int nCharacterID = iPacket->Decode4();
 	int nRequest = iPacket->Decode1();
-	auto pTrunk = Trunk::Load(nAccountID);
-	switch (nRequest)
+	PostDBRequest(nCharacterID, iPacket, [nClientSocketID, nAccountID, nCharacterID, nRequest](InPacket *iPacket)
 	{
-		case Trunk::TrunkRequest::rq_Trunk_Load:
+		auto pPacket = std::make_shared<OutPacket>();
+		auto pTrunk = Trunk::Load(nAccountID);
+		switch (nRequest)
+		{
+			case Trunk::TrunkRequest::rq_Trunk_Load:
+				pPacket->Encode2(CenterResultPacketType::TrunkResult);
+				pPacket->Encode4(nClientSocketID);
+				pPacket->Encode4(nCharacterID);
+				pPacket->Encode1(Trunk::TrunkResult::res_Trunk_Load);
+				pTrunk->Encode(0xFFFFFFFF, pPacket.get());
+				break;
+			case Trunk::TrunkRequest::rq_Trunk_MoveSlotToTrunk:
+				pTrunk->MoveSlotToTrunk(nClientSocketID, nAccountID, nCharacterID, iPacket, pPacket.get());
+				break;
+			case Trunk::TrunkRequest::rq_Trunk_MoveTrunkToSlot:
+				pTrunk->MoveTrunkToSlot(nClientSocketID, nAccountID, nCharacterID, iPacket, pPacket.get());
+				break;
+			case Trunk::TrunkRequest::rq_Trunk_WithdrawMoney:
+				pTrunk->WithdrawMoney(nClientSocketID, nAccountID, nCharacterID, iPacket, pPacket.get());
+				break;
+		}
+		FreeObj(pTrunk);
+		if (!pPacket->GetPacketSize())
+			return;
+
+		//The world users belong to the I/O thread, the user may have left while the request was running.
+		DBExecutor::GetInstance()->PostResult([pPacket, nCharacterID]()
 		{
-			OutPacket oPacket;
-			oPacket.Encode2(CenterResultPacketType::TrunkResult);
-			oPacket.Encode4(nClientSocketID);
-			oPacket.Encode4(nCharacterID);
-			oPacket.Encode1(Trunk::TrunkResult::res_Trunk_Load);
-			pTrunk->Encode(0xFFFFFFFF, &oPacket);
 			auto pwUser = WvsWorld::GetInstance()->GetUser(nCharacterID);
 			if (pwUser)
-				pwUser->SendPacket(&oPacket);
-			break;
-		}
-		case Trunk::TrunkRequest::rq_Trunk_MoveSlotToTrunk:
-			pTrunk->MoveSlotToTrunk(nClientSocketID, nAccountID, nCharacterID, iPacket);
-			break;
-		case Trunk::TrunkRequest::rq_Trunk_MoveTrunkToSlot:
-			pTrunk->MoveTrunkToSlot(nClientSocketID, nAccountID, nCharacterID, iPacket);
-			break;
-		case Trunk::TrunkRequest::rq_Trunk_WithdrawMoney:
-			pTrunk->WithdrawMoney(nClientSocketID, nAccountID, nCharacterID, iPacket);
-			break;
-		
-	}
-	FreeObj(pTrunk);
+				pwUser->SendPacket(pPacket.get());
+		});
+	});
 }
 
 void LocalServer::OnEntrustedShopRequest(InPacket *iPacket)
@@ -1,5 +1,6 @@
 #pragma once
 #include <map>
+#include <functional>
 #include "..\WvsLib\Net\SocketBase.h"
 
 //Server ݤ Session
@@ -12,6 +13,10 @@ private:
 
 	void OnClosed();
 	void RemoveConnectedUser(int nUserID);
+	void SendMigrateInResult(OutPacket *oPacket, int nCharacterID, int nChannelID);
+
+	//Runs fHandler with the rest of iPacket on the DB executor, after the earlier DB tasks of nCharacterID.
+	void PostDBRequest(int nCharacterID, InPacket *iPacket, const std::function<void(InPacket*)>& fHandler);
 
 public:
 	LocalServer(asio::io_service& serverService);
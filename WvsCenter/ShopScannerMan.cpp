@@ -23,7 +23,7 @@ void ShopScannerMan::Search(SocketBase * pSrv, int nClientSocketID, int nCharact
 	std::lock_guard<std::recursive_mutex> lock(EntrustedShopMan::GetInstance()->GetLock());
 	int nTI = nItemID / 1000000;
 	auto aRet = EntrustedShopDBAccessor::QueryItemExistence(nWorldID, nItemID);
-	OutPacket oPacket;
+	OutPacket oPacket(32 + (int)aRet.size() * (nTI == 1 ? 160 : 64));
 	oPacket.Encode2(CenterResultPacketType::ShopScannerResult);
 	oPacket.Encode4(nClientSocketID);
 	oPacket.Encode4(nCharacterID);
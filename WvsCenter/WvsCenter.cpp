@@ -19,7 +19,7 @@ WvsCenter::~WvsCenter()
 
 void WvsCenter::OnNotifySocketDisconnected(SocketBase *pSocket)
 {
-	WvsLogger::LogRaw("[WvsCenter][WvsCenter::OnNotifySocketDisconnected]A local server is disconnected, now preparing to notify WvsLogin server.\n");
+	WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_INFO, "[WvsCenter][WvsCenter::OnNotifySocketDisconnected]A local server is disconnected, now preparing to notify WvsLogin server.\n");
 	if (pSocket->GetServerType() == ServerConstants::SRV_GAME)
 	{
 		auto iter = m_mChannel.begin();
@@ -65,6 +65,7 @@ void WvsCenter::Init()
 
 void WvsCenter::NotifyWorldChanged()
 {
+	std::lock_guard<std::mutex> lock(WvsBase::GetInstance<WvsCenter>()->GetSocketListLock());
 	auto& socketList = WvsBase::GetInstance<WvsCenter>()->GetSocketList();
 	for (const auto& socket : socketList)
 	{
@@ -113,7 +114,7 @@ void WvsCenter::RegisterChannel(int nChannelID, std::shared_ptr<SocketBase> &pSe
 	pEntry->SetExternalIP(iPacket->Decode4());
 	pEntry->SetExternalPort(iPacket->Decode2());
 	auto ip = pEntry->GetExternalIP();
-	WvsLogger::LogFormat("[WvsCenter][WvsCenter::RegisterChannel]A WvsGame server is successfully registered. [WvsGame][Channel ID = %d], External IP: %d.%d.%d.%d, External Port: %d\n", nChannelID, (int)((char*)&ip)[0], (int)((char*)&ip)[1], (int)((char*)&ip)[2], (int)((char*)&ip)[3], pEntry->GetExternalPort());
+	WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_INFO, "[WvsCenter][WvsCenter::RegisterChannel]A WvsGame server is successfully registered. [WvsGame][Channel ID = %d], External IP: %d.%d.%d.%d, External Port: %d\n", nChannelID, (int)((char*)&ip)[0], (int)((char*)&ip)[1], (int)((char*)&ip)[2], (int)((char*)&ip)[3], pEntry->GetExternalPort());
 	m_mChannel.insert({ nChannelID, pEntry });
 	RestoreConnectedUser(pServer, nChannelID, iPacket);
 }
@@ -125,7 +126,7 @@ void WvsCenter::RegisterCashShop(std::shared_ptr<SocketBase>& pServer, InPacket
 	pEntry->SetLocalSocket(pServer);
 	pEntry->SetExternalIP(iPacket->Decode4());
 	pEntry->SetExternalPort(iPacket->Decode2());
-	WvsLogger::LogRaw("[WvsCenter][WvsCenter::RegisterCashShop]A WvsShop server is successfully registered.\n");
+	WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_INFO, "[WvsCenter][WvsCenter::RegisterCashShop]A WvsShop server is successfully registered.\n");
 
 	SetShop(pEntry);
 	RestoreConnectedUser(pServer, WvsWorld::CHANNELID_SHOP, iPacket);
@@ -54,12 +54,12 @@ int Center::GetWorldID() const
 
 void Center::OnNotifyCenterDisconnected(SocketBase *pSocket)
 {
-	WvsLogger::LogRaw(WvsLogger::LEVEL_ERROR, "[WvsGame]Disconnected from WvsCenter (closed by remote server).\n");
+	WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_ERROR, "[WvsGame]Disconnected from WvsCenter (closed by remote server).\n");
 }
 
 void Center::OnConnected()
 {
-	WvsLogger::LogRaw("[WvsGame][Center::OnConnect]Successfully connected to center server.\n");
+	WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_INFO, "[WvsGame][Center::OnConnect]Successfully connected to center server.\n");
 
 	//VCenter ServeroeHand Shakeʥ]
 	OutPacket oPacket;
@@ -95,8 +95,7 @@ void Center::OnConnected()
 
 void Center::OnPacket(InPacket *iPacket)
 {
-	WvsLogger::LogRaw("[Center::OnPacket]");
-	iPacket->Print();
+	iPacket->Dump("[Center::OnPacket]");
 	int nType = (unsigned short)iPacket->Decode2();
 	switch (nType)
 	{
@@ -105,7 +104,7 @@ void Center::OnPacket(InPacket *iPacket)
 			auto nResult = iPacket->Decode1();
 			if (!nResult)
 			{
-				WvsLogger::LogRaw(WvsLogger::LEVEL_ERROR, GET_STRING(GameSrv_System_Center_Connection_Rejected));
+				WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_ERROR, "%s", GET_STRING(GameSrv_System_Center_Connection_Rejected));
 				exit(0);
 			}
 			int nWorldID = iPacket->Decode1();
@@ -123,7 +122,7 @@ void Center::OnPacket(InPacket *iPacket)
 
 			for (int i = 1; i <= 5; ++i)
 				GW_ItemSlotBase::SetInitSN(i, iPacket->Decode8());
-			WvsLogger::LogRaw("[Center][RegisterCenterAck]The connection between local server(WvsCenter) has been authenciated by remote server.\n");
+			WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_INFO, "[Center][RegisterCenterAck]The connection between local server(WvsCenter) has been authenciated by remote server.\n");
 			break;
 		}
 		case CenterResultPacketType::CenterMigrateInResult:
@@ -154,6 +153,9 @@ void Center::OnPacket(InPacket *iPacket)
 		case CenterResultPacketType::CheckGivePopularityResult:
 			OnCheckGivePopularityResult(iPacket);
 			break;
+		case CenterResultPacketType::FlushCharacterDataFailed:
+			OnFlushCharacterDataFailed(iPacket);
+			break;
 		default:
 		{
 			int nClientSocketID = iPacket->Decode4();
@@ -171,7 +173,7 @@ void Center::OnClosed()
 
 void Center::OnConnectFailed()
 {
-	WvsLogger::LogRaw(WvsLogger::LEVEL_ERROR, "[Center][RegisterCenterAck]Center has rejected the connection request, WvsGame server may not work properly.\n");
+	WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_ERROR, "[Center][RegisterCenterAck]Center has rejected the connection request, WvsGame server may not work properly.\n");
 	OnDisconnect();
 }
 
@@ -284,6 +286,14 @@ void Center::OnGuildBBSResult(InPacket *iPacket)
 	}
 }
 
+void Center::OnFlushCharacterDataFailed(InPacket *iPacket)
+{
+	int nCharacterID = iPacket->Decode4();
+	auto pUser = User::FindUser(nCharacterID);
+	if (pUser)
+		pUser->OnFlushCharacterDataFailed();
+}
+
 void Center::OnCheckGivePopularityResult(InPacket * iPacket)
 {
 	int nUserID = iPacket->Decode4(), nFailedReason = 0, nInc = 0;
@@ -25,6 +25,7 @@ public:
 	void OnCheckMigrationState(InPacket *iPacket);
 	void OnGuildBBSResult(InPacket *iPacket);
 	void OnCheckGivePopularityResult(InPacket *iPacket);
+	void OnFlushCharacterDataFailed(InPacket *iPacket);
 
 	static void OnNotifyCenterDisconnected(SocketBase *pSocket);
 };
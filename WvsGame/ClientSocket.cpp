@@ -77,13 +77,11 @@ void ClientSocket::OnPacket(InPacket *iPacket)
 			if (nType != UserRecvPacketType::User_OnFuncKeyMappedModified
 				&& nType != NPCRecvPacketTypes::NPC_OnMoveRequest
 				&& nType != UserRecvPacketType::User_OnUserMoveRequest
-				&& nType != MobRecvPacketType::Mob_OnMove) {
-				WvsLogger::LogRaw("[WvsGame][ClientSocket::OnPacket]Received Packet: ");
-				iPacket->Print();
-			}
+				&& nType != MobRecvPacketType::Mob_OnMove)
+				iPacket->Dump("[WvsGame][ClientSocket::OnPacket]Received Packet: ");
 			nType = ProcessUserPacket(m_pUser, iPacket);
 			if(nType != -1)
-				WvsLogger::LogFormat(WvsLogger::LEVEL_ERROR, "Unhandled System-Level Excpetion Has Been Caught: UserID = %d, Packet Type = %d\n", m_pUser->GetUserID(), nType);
+				WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_ERROR, "Unhandled System-Level Excpetion Has Been Caught: UserID = %d, Packet Type = %d\n", m_pUser->GetUserID(), nType);
 		}
 	}
 }
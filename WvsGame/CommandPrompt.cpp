@@ -2,6 +2,31 @@
 #include "WvsGame.h"
 #include "User.h"
 #include "..\WvsLib\String\StringUtility.h"
+#include "..\WvsLib\Crypto\WvsCrypto.hpp"
+#include "..\WvsLib\Memory\MemoryPoolMan.hpp"
+#include "..\WvsLib\Net\OutPacket.h"
+#include "..\WvsLib\Logger\WvsPacketTrace.h"
+#include "..\WvsLib\Task\TimerWheel.h"
+#include "..\WvsLib\Wz\WzResMan.hpp"
+#include "..\WvsLib\Wz\WzStreamCodec.h"
+#include "..\WvsLib\Evaluator\Evaluator.h"
+#include "TimerThread.h"
+#include "FieldMan.h"
+#include "MobTemplate.h"
+#include "NpcTemplate.h"
+#include "ReactorTemplate.h"
+#include "PetTemplate.h"
+#include "ScriptMan.h"
+#include "ItemInfo.h"
+#include "UserPacketTypes.hpp"
+#include "..\Database\GW_ItemSlotBase.h"
+#include "..\WvsLib\Random\Rand32.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <thread>
 
 const std::string& Get(std::vector<std::string>& aInput, int nIdx)
 {
@@ -16,6 +41,118 @@ int GetInt(std::vector<std::string>& aInput, int nIdx)
 	return atoi(Get(aInput, nIdx).c_str());
 }
 
+//Replica of the former std::map based WZ layout (a heap node with its own name and variant per property), only used by WzLayoutBench.
+//ItemInfoBench uses the counting allocator for its replica of the former ItemInfo maps as well.
+static unsigned long long liLegacyLayoutBytes = 0;
+
+template<class T>
+struct LegacyLayoutAllocator
+{
+	typedef T value_type;
+
+	LegacyLayoutAllocator() {}
+	template<class U> LegacyLayoutAllocator(const LegacyLayoutAllocator<U>&) {}
+
+	T* allocate(size_t n)
+	{
+		liLegacyLayoutBytes += n * sizeof(T);
+		return (T*)::operator new(n * sizeof(T));
+	}
+
+	void deallocate(T* p, size_t n)
+	{
+		liLegacyLayoutBytes -= n * sizeof(T);
+		::operator delete(p);
+	}
+
+	template<class U> bool operator==(const LegacyLayoutAllocator<U>&) const { return true; }
+	template<class U> bool operator!=(const LegacyLayoutAllocator<U>&) const { return false; }
+};
+
+typedef std::basic_string<char, std::char_traits<char>, LegacyLayoutAllocator<char>> LegacyLayoutString;
+
+struct LegacyLayoutNode
+{
+	std::map<LegacyLayoutString, LegacyLayoutNode*, std::less<LegacyLayoutString>, LegacyLayoutAllocator<std::pair<const LegacyLayoutString, LegacyLayoutNode*>>> mChild;
+	void *pVTable = nullptr, *pArchive = nullptr;
+	int nNameSpaceType = 0;
+	unsigned int uBeginPos = 0, uRootPropPos = 0;
+	LegacyLayoutString sName;
+	bool bParsed = true;
+	long long int liData = 0;
+	LegacyLayoutString sData;
+	int vType = 0, fType = 0;
+
+	~LegacyLayoutNode()
+	{
+		for (auto& prChild : mChild)
+		{
+			delete prChild.second;
+			liLegacyLayoutBytes -= sizeof(LegacyLayoutNode);
+		}
+	}
+};
+
+//Parses everything under it and builds the replica, every 16th scalar path is kept for the lookup test.
+static void BuildLegacyLayout(WzIterator& it, LegacyLayoutNode* pNode, std::vector<std::string>& aPath, std::vector<std::vector<std::string>>& aaSample, int& nScalar)
+{
+	for (auto& child : it)
+	{
+		auto pChild = new LegacyLayoutNode;
+		liLegacyLayoutBytes += sizeof(LegacyLayoutNode);
+		pChild->sName = child.GetName().c_str();
+		pChild->vType = child.GetValueType();
+		if (pChild->vType == WzDelayedVariant::vt_String)
+			pChild->sData = ((const std::string&)child).c_str();
+		else
+			pChild->liData = (long long int)(unsigned long long)child;
+		pNode->mChild.insert({ pChild->sName, pChild });
+
+		aPath.push_back(child.GetName());
+		if (pChild->vType != WzDelayedVariant::vt_None && (nScalar++ % 16) == 0 && aaSample.size() < 200000)
+			aaSample.push_back(aPath);
+		BuildLegacyLayout(child, pChild, aPath, aaSample, nScalar);
+		aPath.pop_back();
+	}
+}
+
+//Loopback connections of FanOutBench, the packets are sent by a real SocketBase and discarded by the peer.
+class FanOutBenchSocket : public SocketBase
+{
+public:
+	FanOutBenchSocket(asio::io_service& io)
+		: SocketBase(io)
+	{
+		SetSocketDisconnectedCallBack([](SocketBase*) {});
+	}
+
+	void OnClosed() {}
+	void OnPacket(InPacket *iPacket) {}
+};
+
+struct FanOutBenchPeer
+{
+	asio::ip::tcp::socket socket;
+	unsigned char aBuffer[0x4000];
+
+	FanOutBenchPeer(asio::io_service& io) : socket(io) {}
+};
+
+static std::atomic<unsigned long long> liFanOutReceivedBytes{ 0 };
+
+//The peers share one strand, so their reads and the final close never run concurrently.
+static void DrainFanOutPeer(std::shared_ptr<FanOutBenchPeer> pPeer, std::shared_ptr<asio::io_service::strand> pStrand)
+{
+	pPeer->socket.async_read_some(
+		asio::buffer(pPeer->aBuffer, sizeof(pPeer->aBuffer)),
+		pStrand->wrap([pPeer, pStrand](const std::error_code& ec, std::size_t nRead)
+		{
+			liFanOutReceivedBytes += nRead;
+			if (!ec)
+				DrainFanOutPeer(pPeer, pStrand);
+		}));
+}
+
 void GameApp::OnCommandPromptInput(std::string& sInput)
 {
 	std::string sOutput;
@@ -36,6 +173,491 @@ void GameApp::OnCommandPromptInput(std::string& sInput)
 
 			sOutput += StringUtility::Format("Total User Count: %d\n", (int)aUser.size());
 		}
+		else if (sCommand == "GetIOStat")
+		{
+			//Packets/sec since the last query, compare it under different "IOThreadCount" settings.
+			static auto tLastQuery = std::chrono::steady_clock::now();
+			static unsigned long long liLastCount = 0;
+			auto tNow = std::chrono::steady_clock::now();
+			auto liCount = SocketBase::GetProcessedPacketCount();
+			auto liElapsed = std::chrono::duration_cast<std::chrono::milliseconds>(tNow - tLastQuery).count();
+			sOutput = StringUtility::Format(
+				"I/O Threads: %d, Processed Packets: %llu, Throughput: %.2f packets/sec\n",
+				WvsBase::GetInstance<WvsGame>()->GetIOThreadCount(),
+				liCount,
+				liElapsed > 0 ? (double)(liCount - liLastCount) * 1000.0 / (double)liElapsed : 0.0
+			);
+			tLastQuery = tNow;
+			liLastCount = liCount;
+		}
+		else if (sCommand == "CryptoBench")
+		{
+			sUsage = "Usage: CryptoBench <int: Iterations>";
+			int nIteration = asTokens.size() > 1 ? GetInt(asTokens, 1) : 100000;
+			unsigned char aBuffer[200] = { 0 }, aIV[16] = { 0x01, 0x02, 0x03, 0x04 };
+			sOutput = StringUtility::Format("AES-NI: %s\n", WvsCrypto::IsAESNIEnabled() ? "Enabled" : "Disabled");
+			for (int nSize : { 20, 50, 100, 200 })
+			{
+				auto tStart = std::chrono::steady_clock::now();
+				for (int i = 0; i < nIteration; ++i)
+				{
+					WvsCrypto::Encrypt(aBuffer, aIV, nSize);
+					WvsCrypto::Decrypt(aBuffer, aIV, nSize);
+				}
+				double dElapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+				sOutput += StringUtility::Format(
+					"Packet Size = %d bytes, Encrypt/Decrypt Throughput = %.2f MB/s\n",
+					nSize,
+					dElapsed > 0 ? (double)nSize * nIteration * 2 / dElapsed / (1024 * 1024) : 0.0
+				);
+			}
+		}
+		else if (sCommand == "FanOutBench")
+		{
+			//Broadcasts a remote move packet to 10, 100 and 500 loopback sockets as User::Broadcast does.
+			//Send is the time spent by the broadcasting thread, delivered lasts until every peer has received the packet.
+			sUsage = "Usage: FanOutBench <int: Iterations>";
+			int nIteration = asTokens.size() > 1 ? GetInt(asTokens, 1) : 100;
+			auto& io = WvsBase::GetInstance<WvsGame>()->GetIOService();
+			auto pStrand = std::make_shared<asio::io_service::strand>(io);
+			asio::ip::tcp::acceptor acceptor(io, asio::ip::tcp::endpoint(asio::ip::address_v4::loopback(), 0));
+			std::vector<std::shared_ptr<FanOutBenchSocket>> apSocket;
+			std::vector<std::shared_ptr<FanOutBenchPeer>> apPeer;
+
+			OutPacket oPacket;
+			oPacket.Encode2(UserSendPacketType::UserRemote_OnMove);
+			oPacket.Encode4(0);
+			oPacket.EncodeBuffer(nullptr, 64);
+			unsigned long long liPacketBytes = (unsigned long long)oPacket.GetPacketSize() + OutPacket::HEADER_OFFSET;
+
+			for (int nRecipient : { 10, 100, 500 })
+			{
+				while ((int)apSocket.size() < nRecipient)
+				{
+					auto pSocket = std::make_shared<FanOutBenchSocket>(io);
+					auto pPeer = std::make_shared<FanOutBenchPeer>(io);
+					pSocket->GetSocket().connect(acceptor.local_endpoint());
+					acceptor.accept(pPeer->socket);
+					pStrand->post([pPeer, pStrand]() { DrainFanOutPeer(pPeer, pStrand); });
+					apSocket.push_back(pSocket);
+					apPeer.push_back(pPeer);
+				}
+
+				liFanOutReceivedBytes = 0;
+				double dSendElapsed = 0, dDeliveredElapsed = 0, dMaxDeliveredElapsed = 0;
+				int nDone = 0;
+				for (; nDone < nIteration; ++nDone)
+				{
+					auto tStart = std::chrono::steady_clock::now();
+					for (int i = 0; i < nRecipient; ++i)
+						apSocket[i]->SendPacket(&oPacket);
+					auto tSent = std::chrono::steady_clock::now();
+
+					auto liTarget = (unsigned long long)(nDone + 1) * nRecipient * liPacketBytes;
+					while (liFanOutReceivedBytes < liTarget && std::chrono::steady_clock::now() - tSent < std::chrono::seconds(5))
+						std::this_thread::yield();
+					if (liFanOutReceivedBytes < liTarget)
+						break;
+
+					double dDelivered = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+					dSendElapsed += std::chrono::duration<double>(tSent - tStart).count();
+					dDeliveredElapsed += dDelivered;
+					dMaxDeliveredElapsed = (std::max)(dMaxDeliveredElapsed, dDelivered);
+				}
+				sOutput += StringUtility::Format(
+					"Recipients = %d, Send = %.1f us, Delivered = %.1f us (max %.1f us), %d/%d broadcast(s)%s\n",
+					nRecipient,
+					nDone ? dSendElapsed * 1e6 / nDone : 0.0,
+					nDone ? dDeliveredElapsed * 1e6 / nDone : 0.0,
+					dMaxDeliveredElapsed * 1e6,
+					nDone,
+					nIteration,
+					nDone < nIteration ? ", timed out waiting for the peers" : ""
+				);
+				if (nDone < nIteration)
+					break;
+			}
+
+			for (auto& pSocket : apSocket)
+				pSocket->GetStrand().post([pSocket]() { pSocket->OnDisconnect(); });
+			for (auto& pPeer : apPeer)
+				pStrand->post([pPeer]() { pPeer->socket.close(); });
+			acceptor.close();
+		}
+		else if (sCommand == "GetMemoryStat")
+		{
+			sOutput = "Memory Pool Statistics: \n";
+			for (auto& stat : MemoryPoolMan::GetInstance()->GetPoolStat())
+				sOutput += StringUtility::Format(
+					"Pool [%s][Unit Size = %d] Live = %llu bytes, Peak = %llu bytes, Cache Hit Rate = %.2f%%\n",
+					stat.bArray ? "Array" : "Object",
+					(int)stat.nUnitSize,
+					stat.liLiveBytes,
+					stat.liPeakBytes,
+					(stat.liCacheHit + stat.liCacheMiss) ? stat.liCacheHit * 100.0 / (stat.liCacheHit + stat.liCacheMiss) : 0.0
+				);
+		}
+		else if (sCommand == "MemoryBench")
+		{
+			//Allocate and free packet-sized arrays from 1 ~ 32 threads to measure the contention of the pools.
+			sOutput = "Memory Pool Contention Benchmark: \n";
+			for (int nThread = 1; nThread <= 32; nThread *= 2)
+			{
+				std::vector<std::thread> aThread;
+				auto tStart = std::chrono::steady_clock::now();
+				for (int i = 0; i < nThread; ++i)
+					aThread.push_back(std::thread([]() {
+						unsigned char* apBuffer[64];
+						for (int nRound = 0; nRound < 10000; ++nRound)
+						{
+							for (int j = 0; j < 64; ++j)
+								apBuffer[j] = AllocArray(unsigned char, 16 + (j * 37) % 2048);
+							for (int j = 0; j < 64; ++j)
+								FreeArray(apBuffer[j]);
+						}
+					}));
+				for (auto& thread : aThread)
+					thread.join();
+				double dElapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+				sOutput += StringUtility::Format(
+					"Threads = %d, %.2f M alloc+free/sec\n",
+					nThread,
+					dElapsed > 0 ? nThread * 10000.0 * 64 / dElapsed / 1000000.0 : 0.0
+				);
+			}
+		}
+		else if (sCommand == "GetPacketStat")
+		{
+			sOutput = "OutPacket Statistics: \n";
+			for (auto& stat : OutPacket::GetOpcodeStat())
+				sOutput += StringUtility::Format(
+					"Opcode = 0x%03X, Packets = %u, Extends = %u, Predicted Size = %u\n",
+					stat.nOpcode,
+					stat.nPacketCount,
+					stat.nExtendCount,
+					stat.nPredictedSize
+				);
+		}
+		else if (sCommand == "SetLogLevel")
+		{
+			sUsage = "Usage: SetLogLevel <std::string: Subsystem> <int: Level(0 = Debug, 1 = Info, 2 = Warning, 3 = Error, 4 = None)> [<int: Packet Sample Rate> <int: Packet Dumps/sec>]";
+			int nSubsystem = WvsLogger::GetSubsystemByName(Get(asTokens, 1));
+			if (nSubsystem == -1)
+				throw std::exception("Unknown subsystem.");
+			WvsLogger::SetLogLevel(nSubsystem, GetInt(asTokens, 2));
+			if (asTokens.size() > 4)
+				WvsLogger::SetPacketDumpPolicy(GetInt(asTokens, 3), GetInt(asTokens, 4));
+			sOutput = StringUtility::Format("Log level of %s is set to %d.\n", WvsLogger::GetSubsystemName(nSubsystem), WvsLogger::GetLogLevel(nSubsystem));
+		}
+		else if (sCommand == "GetLogStat")
+		{
+			sOutput = "Log Levels: \n";
+			for (int i = 0; i < WvsLogger::SUB_COUNT; ++i)
+				sOutput += StringUtility::Format("%s = %d\n", WvsLogger::GetSubsystemName(i), WvsLogger::GetLogLevel(i));
+			sOutput += StringUtility::Format(
+				"Suppressed Packet Dumps: %llu, Packet Trace: %s (%llu bytes)\n",
+				WvsLogger::GetSuppressedPacketDumpCount(),
+				WvsPacketTrace::IsEnabled() ? "On" : "Off",
+				WvsPacketTrace::GetTracedSize()
+			);
+		}
+		else if (sCommand == "GetTimerStat")
+		{
+			auto stat = TimerWheel::GetInstance()->GetStat();
+			sOutput = StringUtility::Format(
+				"Timer Workers: %d, Pending Tasks: %llu, Fired Tasks: %llu, Current Tick: %llu, Late Ticks: %llu\n",
+				stat.nWorkerCount,
+				stat.liPendingCount,
+				stat.liFiredCount,
+				stat.liCurrentTick,
+				stat.liLateTick
+			);
+		}
+		else if (sCommand == "GetFieldTickStat")
+		{
+			sUsage = "Usage: GetFieldTickStat <int: Top N Fields>";
+			int nTop = asTokens.size() > 1 ? GetInt(asTokens, 1) : 10;
+			auto aStat = TimerThread::GetFieldTickStat();
+			std::sort(aStat.begin(), aStat.end(), [](const TimerThread::FieldTickStat& lhs, const TimerThread::FieldTickStat& rhs) {
+				return lhs.liAvgCost > rhs.liAvgCost;
+			});
+			int nHibernating = (int)std::count_if(aStat.begin(), aStat.end(), [](const TimerThread::FieldTickStat& stat) { return stat.bHibernating; });
+			sOutput = StringUtility::Format("Field Tick Statistics (%d fields, %d hibernating, %llu prefetched, histogram buckets are < 16us, < 32us, ...): \n", (int)aStat.size(), nHibernating, FieldMan::GetInstance()->GetPrefetchCount());
+			for (int i = 0; i < nTop && i < (int)aStat.size(); ++i)
+			{
+				auto& stat = aStat[i];
+				sOutput += StringUtility::Format(
+					"Field = %d, Users = %d, Hibernating = %d, Timer = %d, Ticks = %llu, Avg = %llu us, Max = %llu us, Histogram =",
+					stat.nFieldID,
+					stat.nUserCount,
+					(int)stat.bHibernating,
+					stat.nOwner,
+					stat.liTickCount,
+					stat.liAvgCost,
+					stat.liMaxCost
+				);
+				for (auto& liCount : stat.aHistogram)
+					sOutput += StringUtility::Format(" %llu", liCount);
+				sOutput += "\n";
+			}
+		}
+		else if (sCommand == "WzLayoutBench")
+		{
+			//Loads the whole Map.wz, then compares the memory and lookup latency of the current layout with the former std::map based one.
+			auto pResMan = WzResMan::GetInstance();
+			if (pResMan->GetMemoryUsage(Wz::Map) == 0)
+				throw std::exception("Map.wz is served by the WzSnapshot, disable it to run this benchmark.");
+
+			auto itRoot = pResMan->GetWz(Wz::Map);
+			std::vector<std::string> aPath;
+			std::vector<std::vector<std::string>> aaSample;
+			int nScalar = 0;
+			liLegacyLayoutBytes = 0;
+
+			auto tStart = std::chrono::steady_clock::now();
+			std::unique_ptr<LegacyLayoutNode> pLegacyRoot(new LegacyLayoutNode);
+			BuildLegacyLayout(itRoot, pLegacyRoot.get(), aPath, aaSample, nScalar);
+			double dLoadElapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+			//Taken after the replica is built, which has parsed the whole archive.
+			auto liUsage = pResMan->GetMemoryUsage(Wz::Map);
+
+			long long liCheckSum = 0;
+			tStart = std::chrono::steady_clock::now();
+			for (auto& aSample : aaSample)
+			{
+				auto it = itRoot;
+				for (auto& sName : aSample)
+					it = it[sName];
+				liCheckSum += (int)it;
+			}
+			double dElapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+			long long liLegacyCheckSum = 0;
+			tStart = std::chrono::steady_clock::now();
+			for (auto& aSample : aaSample)
+			{
+				auto pNode = pLegacyRoot.get();
+				for (auto& sName : aSample)
+				{
+					auto findIter = pNode->mChild.find(LegacyLayoutString(sName.c_str()));
+					if (findIter == pNode->mChild.end())
+						break;
+					pNode = findIter->second;
+				}
+				liLegacyCheckSum += pNode->vType == WzDelayedVariant::vt_String ? atoi(pNode->sData.c_str()) : (int)pNode->liData;
+			}
+			double dLegacyElapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+			sOutput = StringUtility::Format(
+				"Map.wz parsed and replicated in %.2f sec, %d scalars, %d sampled paths (checksum %s)\n"
+				"Current layout: %.2f MB, %.1f ns/lookup\n"
+				"std::map layout: %.2f MB, %.1f ns/lookup\n",
+				dLoadElapsed,
+				nScalar,
+				(int)aaSample.size(),
+				liCheckSum == liLegacyCheckSum ? "matched" : "MISMATCHED",
+				liUsage / (1024.0 * 1024.0),
+				aaSample.size() ? dElapsed * 1e9 / aaSample.size() : 0.0,
+				(liLegacyLayoutBytes + sizeof(LegacyLayoutNode)) / (1024.0 * 1024.0),
+				aaSample.size() ? dLegacyElapsed * 1e9 / aaSample.size() : 0.0
+			);
+		}
+		else if (sCommand == "ItemInfoBench")
+		{
+			//Compares the dense ItemInfo tables with a replica of the former std::map ones (same IDs and strings).
+			sUsage = "Usage: ItemInfoBench <int: Lookup Count>";
+			int nLookup = asTokens.size() > 1 ? GetInt(asTokens, 1) : 1000000;
+			auto pItemInfo = ItemInfo::GetInstance();
+			typedef std::map<int, void*, std::less<int>, LegacyLayoutAllocator<std::pair<const int, void*>>> LegacyItemMap;
+			typedef std::map<LegacyLayoutString, LegacyLayoutString, std::less<LegacyLayoutString>, LegacyLayoutAllocator<std::pair<const LegacyLayoutString, LegacyLayoutString>>> LegacyStringMap;
+			typedef std::map<int, LegacyStringMap, std::less<int>, LegacyLayoutAllocator<std::pair<const int, LegacyStringMap>>> LegacyStringTable;
+			liLegacyLayoutBytes = 0;
+
+			std::vector<LegacyItemMap> amLegacyItem;
+			for (auto& prTable : pItemInfo->GetTableItemIDList())
+			{
+				amLegacyItem.push_back({});
+				for (int nItemID : *prTable.second)
+					amLegacyItem.back().insert({ nItemID, nullptr });
+			}
+			for (int nItemID : *pItemInfo->GetTableItemIDList()[0].second)
+				amLegacyItem[0][nItemID] = pItemInfo->GetEquipItem(nItemID);
+			for (int nItemID : *pItemInfo->GetTableItemIDList()[1].second)
+				amLegacyItem[1][nItemID] = pItemInfo->GetBundleItem(nItemID);
+
+			LegacyStringTable mLegacyItemString, mLegacyMapString;
+			pItemInfo->GetItemStringTable().ForEach([&](int nID, const std::string& sKey, const char* sValue) {
+				mLegacyItemString[nID][LegacyLayoutString(sKey.c_str())] = sValue;
+			});
+			pItemInfo->GetMapStringTable().ForEach([&](int nID, const std::string& sKey, const char* sValue) {
+				mLegacyMapString[nID][LegacyLayoutString(sKey.c_str())] = sValue;
+			});
+			auto liLegacyBytes = liLegacyLayoutBytes;
+
+			//Existing equips and bundles mixed with IDs which are not registered at all.
+			std::vector<int> anSample;
+			auto& anEquipID = *pItemInfo->GetTableItemIDList()[0].second;
+			auto& anBundleID = *pItemInfo->GetTableItemIDList()[1].second;
+			if (anEquipID.empty() || anBundleID.empty())
+				throw std::exception("ItemInfo is not initialized.");
+			for (int i = 0; i < 65536; ++i)
+			{
+				unsigned int nRand = (unsigned int)Rand32::GetInstance()->Random();
+				anSample.push_back(i % 8 == 7 ? (int)(nRand % 6000000) : (i % 2 ? anEquipID[nRand % anEquipID.size()] : anBundleID[nRand % anBundleID.size()]));
+			}
+
+			long long liCheckSum = 0, liLegacyCheckSum = 0;
+			auto tStart = std::chrono::steady_clock::now();
+			for (int i = 0; i < nLookup; ++i)
+			{
+				int nItemID = anSample[i & 0xFFFF];
+				liCheckSum += (pItemInfo->GetEquipItem(nItemID) != nullptr) + (pItemInfo->GetBundleItem(nItemID) != nullptr) + pItemInfo->IsTradeBlockItem(nItemID);
+			}
+			double dElapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+			tStart = std::chrono::steady_clock::now();
+			for (int i = 0; i < nLookup; ++i)
+			{
+				int nItemID = anSample[i & 0xFFFF];
+				auto itEquip = amLegacyItem[0].find(nItemID);
+				auto itBundle = amLegacyItem[1].find(nItemID);
+				liLegacyCheckSum += (itEquip != amLegacyItem[0].end()) + (itBundle != amLegacyItem[1].end());
+				int nTI = nItemID / 1000000, nAttribute = 0;
+				if (nTI == 1 && itEquip != amLegacyItem[0].end())
+					nAttribute = ((EquipItem*)itEquip->second)->abilityStat.nAttribute;
+				else if (nTI != 1 && nTI != 5 && itBundle != amLegacyItem[1].end())
+					nAttribute = ((BundleItem*)itBundle->second)->abilityStat.nAttribute;
+				liLegacyCheckSum += (nAttribute & GW_ItemSlotBase::ItemAttribute::eItemAttr_TradeBlock) != 0;
+			}
+			double dLegacyElapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+			tStart = std::chrono::steady_clock::now();
+			for (int i = 0; i < nLookup; ++i)
+				liCheckSum += pItemInfo->GetItemName(anSample[i & 0xFFFF]).size();
+			double dNameElapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+			LegacyLayoutString sNameKey("name");
+			tStart = std::chrono::steady_clock::now();
+			for (int i = 0; i < nLookup; ++i)
+			{
+				auto itItem = mLegacyItemString.find(anSample[i & 0xFFFF]);
+				if (itItem == mLegacyItemString.end())
+					continue;
+				auto itName = itItem->second.find(sNameKey);
+				if (itName != itItem->second.end())
+					liLegacyCheckSum += std::string(itName->second.c_str()).size();
+			}
+			double dLegacyNameElapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+			auto liUsage = pItemInfo->GetTableMemoryUsage();
+			sOutput = StringUtility::Format(
+				"%d lookups (checksum %s)\n"
+				"Dense tables: %.2f MB, %.1f ns/item lookup (equip + bundle + trade block), %.1f ns/name\n"
+				"std::map tables: %.2f MB, %.1f ns/item lookup (equip + bundle + trade block), %.1f ns/name\n"
+				"Saved: %.2f MB\n",
+				nLookup,
+				liCheckSum == liLegacyCheckSum ? "matched" : "MISMATCHED",
+				liUsage / (1024.0 * 1024.0),
+				nLookup ? dElapsed * 1e9 / nLookup : 0.0,
+				nLookup ? dNameElapsed * 1e9 / nLookup : 0.0,
+				liLegacyBytes / (1024.0 * 1024.0),
+				nLookup ? dLegacyElapsed * 1e9 / nLookup : 0.0,
+				nLookup ? dLegacyNameElapsed * 1e9 / nLookup : 0.0,
+				((double)liLegacyBytes - (double)liUsage) / (1024.0 * 1024.0)
+			);
+		}
+		else if (sCommand == "GetWzStringStat")
+		{
+			auto stat = WzStringCache::GetStat();
+			sOutput = StringUtility::Format(
+				"WZ String Cache: Hits = %llu, Misses = %llu, Hit Rate = %.2f%%, Decoding Saved = %.2f KB\n",
+				stat.liHit,
+				stat.liMiss,
+				(stat.liHit + stat.liMiss) ? stat.liHit * 100.0 / (stat.liHit + stat.liMiss) : 0.0,
+				stat.liBytesSaved / 1024.0
+			);
+		}
+		else if (sCommand == "GetTemplateStat")
+		{
+			std::pair<const char*, TemplateRegistryStat> aStat[] = {
+				{ "Mob", MobTemplate::GetRegistryStat() },
+				{ "Npc", NpcTemplate::GetRegistryStat() },
+				{ "Reactor", ReactorTemplate::GetRegistryStat() },
+				{ "Pet", PetTemplate::GetRegistryStat() },
+			};
+			sOutput = "Template Registries: \n";
+			for (auto& prStat : aStat)
+				sOutput += StringUtility::Format(
+					"%s: IDs = %d, Loaded = %d, Loads = %llu (%llu prewarmed), Waits = %llu\n",
+					prStat.first,
+					prStat.second.nCount,
+					prStat.second.nLoadedCount,
+					prStat.second.liLoadCount,
+					prStat.second.liPrewarmCount,
+					prStat.second.liWaitCount
+				);
+		}
+		else if (sCommand == "GetScriptStat")
+		{
+			auto stat = ScriptMan::GetInstance()->GetStat();
+			sOutput = StringUtility::Format(
+				"Script Functions = %d, Reloaded Scripts = %llu (changes detected by %s)\n"
+				"Bytecode Chunks = %d (%llu KB), Compiled Loads = %llu (%.1f us/load), Cached Loads = %llu (%.1f us/load)\n",
+				stat.nFuncCount,
+				stat.liReloadCount,
+				stat.sMonitor,
+				stat.nChunkCount,
+				stat.liChunkBytes >> 10,
+				stat.liChunkCompile,
+				stat.liChunkCompile ? stat.liCompileTimeInNs / 1000.0 / stat.liChunkCompile : 0.0,
+				stat.liChunkHit,
+				stat.liChunkHit ? stat.liHitTimeInNs / 1000.0 / stat.liChunkHit : 0.0
+			);
+		}
+		else if (sCommand == "GetWzResidentStat")
+		{
+			auto pResMan = WzResMan::GetInstance();
+			sOutput = "WZ Archives (mapped / resident): \n";
+			for (int i = 0; i <= (int)Wz::UI; ++i)
+				if (pResMan->GetMappedSize((Wz)i))
+					sOutput += StringUtility::Format(
+						"%s: %llu KB / %llu KB\n",
+						pResMan->GetArchiveName((Wz)i),
+						pResMan->GetMappedSize((Wz)i) >> 10,
+						pResMan->GetResidentSize((Wz)i) >> 10
+					);
+		}
+		else if (sCommand == "FormulaBench")
+		{
+			sUsage = "Usage: FormulaBench <int: Iterations>";
+			int nIteration = asTokens.size() > 1 ? GetInt(asTokens, 1) : 1000;
+			const std::vector<std::string> asFormula = { "u(x/2)", "d(x/3)", "10+x", "5+2*x", "u(x/4)*10", "100" };
+			double dCheckSum = 0, dCachedCheckSum = 0;
+
+			auto tStart = std::chrono::steady_clock::now();
+			for (int i = 0; i < nIteration; ++i)
+				dCheckSum += Evaluator::EvalUncached(asFormula[i % asFormula.size()], i % 30 + 1);
+			double dElapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+			tStart = std::chrono::steady_clock::now();
+			for (int i = 0; i < nIteration; ++i)
+				dCachedCheckSum += Evaluator::Eval(asFormula[i % asFormula.size()], i % 30 + 1);
+			double dCachedElapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - tStart).count();
+
+			auto stat = Evaluator::GetStat();
+			sOutput = StringUtility::Format(
+				"Compile per call: %.0f ns/eval, Cached: %.0f ns/eval, Results %s\n"
+				"Cached formulas = %llu, Compiles = %llu, Hits = %llu, Literals = %llu\n",
+				dElapsed * 1e9 / (std::max)(1, nIteration),
+				dCachedElapsed * 1e9 / (std::max)(1, nIteration),
+				dCheckSum == dCachedCheckSum ? "match" : "MISMATCH",
+				stat.liFormulaCount,
+				stat.liCompileCount,
+				stat.liHitCount,
+				stat.liLiteralCount
+			);
+		}
 		else if (sCommand == "GetUserInfo")
 		{
 			sUsage = "Usage: GetUserInfo <std::string: User Name>";
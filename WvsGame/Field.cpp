@@ -18,6 +18,7 @@
 #include "QWUser.h"
 #include "SecondaryStat.h"
 #include "ItemInfo.h"
+#include "FieldMan.h"
 
 #include "..\WvsGame\UserPacketTypes.hpp"
 #include "..\WvsGame\ReactorPacketTypes.hpp"
@@ -39,6 +40,8 @@
 #undef min
 #undef max
 
+unsigned int Field::ms_tHibernateDelay = 0;
+
 Field::Field(void *pData, int nFieldID)
 	: m_pLifePool(AllocObj(LifePool)),
 	  m_pPortalMap(AllocObj(PortalMap)),
@@ -103,7 +106,6 @@ Field::~Field()
 void Field::BroadcastPacket(OutPacket * oPacket)
 {
 	std::lock_guard<std::recursive_mutex> userGuard(m_mtxFieldLock);
-	oPacket->GetSharedPacket()->ToggleBroadcasting();
 
 	if (m_mUser.size() == 0)
 		return;
@@ -114,7 +116,6 @@ void Field::BroadcastPacket(OutPacket * oPacket)
 void Field::BroadcastPacket(OutPacket* oPacket, std::vector<int>& anCharacterID)
 {
 	std::lock_guard<std::recursive_mutex> userGuard(m_mtxFieldLock);
-	oPacket->GetSharedPacket()->ToggleBroadcasting();
 	for (auto& nID : anCharacterID)
 	{
 		auto iter = m_mUser.find(nID);
@@ -128,7 +129,6 @@ void Field::BroadcastPacket(OutPacket* oPacket, std::vector<int>& anCharacterID)
 void Field::RegisterFieldObj(FieldObj *pNew, OutPacket *oPacketEnter)
 {
 	std::lock_guard<std::recursive_mutex> userGuard(m_mtxFieldLock);
-	oPacketEnter->GetSharedPacket()->ToggleBroadcasting();
 
 	for (auto& user : m_mUser)
 		if(pNew->IsShowTo(user.second))
@@ -338,7 +338,9 @@ void Field::OnEnter(User *pUser)
 	std::lock_guard<std::recursive_mutex> userGuard(m_mtxFieldLock);
 	//if (!m_asyncUpdateTimer->IsStarted())
 	//	m_asyncUpdateTimer->Start();
+	WakeUp();
 	m_mUser.insert({ pUser->GetUserID(), pUser });
+	m_nUserCount = (int)m_mUser.size();
 	m_pLifePool->OnEnter(pUser);
 	m_pDropPool->OnEnter(pUser);
 	m_pReactorPool->OnEnter(pUser);
@@ -393,12 +395,18 @@ void Field::OnEnter(User *pUser)
 		oPacket.Encode1(tm.tm_sec);
 		pUser->SendPacket(&oPacket);
 	}
+
+	//The user is likely to take one of the portals here next, get those fields ready in the background.
+	FieldMan::GetInstance()->PrefetchNeighbour(this);
 }
 
 void Field::OnLeave(User *pUser)
 {
 	std::lock_guard<std::recursive_mutex> userGuard(m_mtxFieldLock);
 	m_mUser.erase(pUser->GetUserID());
+	m_nUserCount = (int)m_mUser.size();
+	if (m_mUser.size() == 0)
+		m_tEmptySince = GameDateTime::GetTime();
 	m_pLifePool->RemoveController(pUser);
 
 	OutPacket oPacketForBroadcasting;
@@ -410,7 +418,6 @@ void Field::OnLeave(User *pUser)
 void Field::SplitSendPacket(OutPacket *oPacket, User *pExcept)
 {
 	std::lock_guard<std::recursive_mutex> userGuard(m_mtxFieldLock);
-	oPacket->GetSharedPacket()->ToggleBroadcasting();
 
 	for (auto& user : m_mUser)
 	{
@@ -487,6 +494,11 @@ const std::map<int, User*>& Field::GetUsers()
 	return m_mUser;
 }
 
+int Field::GetUserCount() const
+{
+	return m_nUserCount;
+}
+
 void Field::OnMobMove(User * pCtrl, Mob * pMob, InPacket * iPacket)
 {
 	//_ZtlSecureTear_m_nMobCtrlSN
@@ -866,3 +878,52 @@ void Field::Update()
 		BroadcastPacket(&oPacket);
 	}
 }
+
+void Field::SetHibernateDelay(unsigned int tDelay)
+{
+	ms_tHibernateDelay = tDelay;
+}
+
+bool Field::TryHibernate(unsigned int tCur)
+{
+	std::lock_guard<std::recursive_mutex> lock(m_mtxFieldLock);
+
+	//Fields of a FieldSet are driven by its timer and scripts, keep them ticking.
+	if (!ms_tHibernateDelay || m_mUser.size() || m_pParentFieldSet || m_bHibernating)
+		return false;
+
+	if (!m_tEmptySince)
+		m_tEmptySince = tCur;
+	if (tCur - m_tEmptySince < ms_tHibernateDelay)
+		return false;
+
+	m_tHibernateBegin = tCur;
+	m_bHibernating = true;
+	return true;
+}
+
+bool Field::IsHibernating() const
+{
+	return m_bHibernating;
+}
+
+void Field::WakeUp()
+{
+	std::lock_guard<std::recursive_mutex> lock(m_mtxFieldLock);
+	if (!m_bHibernating)
+		return;
+
+	m_bHibernating = false;
+	m_tEmptySince = 0;
+
+	//Every pool works with timestamps (regen time, drop creation time, reactor state end...), so a single update
+	//before the user is inserted brings the field to the state it would have reached by ticking.
+	Update();
+	WvsLogger::LogSubsystem(
+		WvsLogger::SUB_GENERAL,
+		WvsLogger::SEV_DEBUG,
+		"[Field::WakeUp]Field %d woke up after %u ms of hibernation.\n",
+		m_nFieldID,
+		GameDateTime::GetTime() - m_tHibernateBegin
+	);
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include <map>
 #include <mutex>
+#include <atomic>
 #include <vector>
 #include <functional>
 #include "FieldPoint.h"
@@ -55,6 +56,7 @@ protected:
 	std::vector<std::pair<FieldPoint, bool>> m_aSeat;
 	std::map<int, int> m_mUserSeat;
 	int m_nFieldID = 0;
+	std::atomic<int> m_nUserCount{ 0 };
 	LifePool *m_pLifePool;
 	PortalMap *m_pPortalMap;
 	DropPool *m_pDropPool;
@@ -92,6 +94,14 @@ protected:
 
 	unsigned int m_tLastStatChangeByField = 0;
 
+	//Hibernation, empty fields stop being updated after ms_tHibernateDelay ms and catch up on the next OnEnter.
+	static unsigned int ms_tHibernateDelay;
+	std::atomic<bool> m_bHibernating{ false };
+	unsigned int m_tEmptySince = 0, 
+		m_tHibernateBegin = 0;
+
+	void WakeUp();
+
 	std::string m_strFirstUserEnter, 
 				m_strUserEnter;
 
@@ -179,6 +189,7 @@ public:
 	void OnMobMove(User* pCtrl, Mob* pMob, InPacket* iPacket);
 	void OnUserMove(User* pUser, InPacket *iPacket);
 	const std::map<int, User*>& GetUsers();
+	int GetUserCount() const;
 	void TransferAll(int nFieldID, const std::string& sPortal);
 
 	//Party Quest Helpers
@@ -211,5 +222,10 @@ public:
 	virtual void Reset(bool bShuffleReactor);
 	virtual void OnStatChangeByField(unsigned int tCur);
 	virtual void Update();
+
+	//Hibernation
+	static void SetHibernateDelay(unsigned int tDelay);
+	bool TryHibernate(unsigned int tCur);
+	bool IsHibernating() const;
 };
 
@@ -1,5 +1,6 @@
 #include "FieldMan.h"
 #include "..\WvsLib\Wz\WzResMan.hpp"
+#include "..\WvsLib\Wz\WzStreamCodec.h"
 #include "..\WvsLib\Memory\MemoryPoolMan.hpp"
 #include "..\WvsLib\Logger\WvsLogger.h"
 #include "TimerThread.h"
@@ -15,6 +16,7 @@
 #include <filesystem>
 #include <fstream>
 #include <streambuf>
+#include <thread>
 
 namespace fs = std::experimental::filesystem;
 
@@ -32,12 +34,38 @@ FieldMan * FieldMan::GetInstance()
 	return sPtrFieldMan;
 }
 
-void FieldMan::RegisterField(int nFieldID)
+void FieldMan::LoadFieldIndex()
 {
-	FieldFactory(nFieldID);
+	for (int i = 0; i <= 9; ++i)
+		for (auto& mapWz : WzResMan::GetInstance()->GetWz(Wz::Map)["Map"]["Map" + std::to_string(i)])
+		{
+			int nFieldID = atoi(mapWz.GetName().c_str());
+			if (m_mField.find(nFieldID) == m_mField.end())
+				m_mField.insert({ nFieldID, AllocObj(FieldEntry) });
+		}
+}
+
+FieldMan::FieldEntry* FieldMan::GetFieldEntry(int nFieldID)
+{
+	std::call_once(m_flagFieldIndex, [this]() { LoadFieldIndex(); });
+	auto findIter = m_mField.find(nFieldID);
+	return findIter == m_mField.end() ? nullptr : findIter->second;
+}
+
+Field* FieldMan::RegisterField(int nFieldID)
+{
+	auto pEntry = GetFieldEntry(nFieldID);
+	if (!pEntry)
+		return nullptr;
+
+	//Callers of the same field wait here until it is built, the others are not blocked.
+	std::call_once(pEntry->flagInit, [this, pEntry, nFieldID]() {
+		pEntry->pField = FieldFactory(nFieldID);
+	});
+	return pEntry->pField;
 }
 
-void FieldMan::FieldFactory(int nFieldID)
+Field* FieldMan::FieldFactory(int nFieldID)
 {
 	/*if (mField[nFieldID]->GetFieldID() != 0)
 		return;*/
@@ -61,7 +89,7 @@ void FieldMan::FieldFactory(int nFieldID)
 		sField = "0" + sField;
 	auto& mapWz = WzResMan::GetInstance()->GetWz(Wz::Map)["Map"]["Map" + std::to_string(nFieldID / 100000000)][sField];
 	if (mapWz == mapWz.end())
-		return;
+		return nullptr;
 
 	auto& infoData = mapWz["info"];
 	int nFieldType = infoData["fieldType"];
@@ -82,8 +110,8 @@ void FieldMan::FieldFactory(int nFieldID)
 
 	RestoreFoothold(pField, &(mapWz["foothold"]), nullptr, &infoData);
 	pField->InitLifePool();
-	m_mField[nFieldID] = pField;
 	TimerThread::RegisterField(pField);
+	return pField;
 }
 
 void FieldMan::LoadAreaCode()
@@ -116,24 +144,27 @@ void FieldMan::LoadFieldSet()
 		pFieldSet->Init(std::string{ wStr.begin(), wStr.end() });
 		m_mFieldSet[pFieldSet->GetFieldSetName()] = pFieldSet;
 	}
-	WzResMan::GetInstance()->RemountAll();
 }
 
 void FieldMan::RegisterAllField()
 {
-	for (int i = 1; i <= 9; ++i)
-		for (auto& mapWz : WzResMan::GetInstance()->GetWz(Wz::Map)["Map"]["Map" + std::to_string(i)])
-			RegisterField(atoi(mapWz.GetName().c_str()));
+	auto cacheStat = WzStringCache::GetStat();
+	std::call_once(m_flagFieldIndex, [this]() { LoadFieldIndex(); });
+	//Map0 fields are only registered on demand.
+	for (auto& prField : m_mField)
+		if (prField.first >= 100000000)
+			RegisterField(prField.first);
+	WzStringCache::LogStat("FieldMan::RegisterAllField", cacheStat);
 }
 
 Field* FieldMan::GetField(int nFieldID)
 {
-	std::lock_guard<std::mutex> lock(m_mtxFieldMan);
+	auto pEntry = GetFieldEntry(nFieldID);
+	if (!pEntry)
+		return nullptr;
 
-	auto fieldResult = m_mField.find(nFieldID);
-	if (fieldResult == m_mField.end())
-		RegisterField(nFieldID);
-	return m_mField[nFieldID];
+	Field *pField = pEntry->pField;
+	return pField ? pField : RegisterField(nFieldID);
 }
 
 FieldSet * FieldMan::GetFieldSet(const std::string & sFieldSetName)
@@ -165,3 +196,67 @@ void FieldMan::RestoreFoothold(Field * pField, void * pPropFoothold, void * pLad
 		pField->GetSpace2D()->GetRect().bottom - pField->GetSpace2D()->GetRect().top
 	);
 }
+
+void FieldMan::StartPrefetch(int nWorkerCount)
+{
+	if (nWorkerCount <= 0 || m_bPrefetchEnabled.exchange(true))
+		return;
+	for (int i = 0; i < nWorkerCount; ++i)
+		std::thread(&FieldMan::PrefetchThread, this).detach();
+	WvsLogger::LogFormat("FieldMan prefetches the fields behind portals with %d thread(s).\n", nWorkerCount);
+}
+
+void FieldMan::PrefetchNeighbour(Field *pField)
+{
+	if (!m_bPrefetchEnabled)
+		return;
+
+	std::vector<int> anTargetFieldID;
+	pField->GetPortalMap()->GetTargetFieldID(anTargetFieldID);
+
+	bool bQueued = false;
+	{
+		std::lock_guard<std::mutex> lock(m_mtxPrefetch);
+		for (int nFieldID : anTargetFieldID)
+		{
+			if ((int)m_qPrefetch.size() >= MAX_PREFETCH_QUEUE)
+				break;
+			auto pEntry = nFieldID == pField->GetFieldID() ? nullptr : GetFieldEntry(nFieldID);
+			if (!pEntry || pEntry->pField || pEntry->bPrefetchQueued.exchange(true))
+				continue;
+			m_qPrefetch.push_back(nFieldID);
+			bQueued = true;
+		}
+	}
+	if (bQueued)
+		m_cvPrefetch.notify_all();
+}
+
+void FieldMan::PrefetchThread()
+{
+	while (true)
+	{
+		int nFieldID = 0;
+		{
+			std::unique_lock<std::mutex> lock(m_mtxPrefetch);
+			m_cvPrefetch.wait(lock, [this]() { return !m_qPrefetch.empty(); });
+			nFieldID = m_qPrefetch.front();
+			m_qPrefetch.pop_front();
+		}
+		try
+		{
+			auto pEntry = GetFieldEntry(nFieldID);
+			if (!pEntry->pField && RegisterField(nFieldID))
+				++m_liPrefetchCount;
+		}
+		catch (std::exception& ex)
+		{
+			WvsLogger::LogFormat(WvsLogger::LEVEL_ERROR, "FieldMan failed to prefetch field %d: %s\n", nFieldID, ex.what());
+		}
+	}
+}
+
+unsigned long long FieldMan::GetPrefetchCount() const
+{
+	return m_liPrefetchCount;
+}
@@ -1,27 +1,56 @@
 #pragma once
 #include <string>
 #include <map>
+#include <unordered_map>
+#include <vector>
+#include <deque>
 #include <mutex>
+#include <atomic>
+#include <condition_variable>
 
 class FieldSet;
 class Field;
 
+/*
+Fields are instantiated on first use.
+The set of field IDs is read from Map.wz once and never changes afterwards, so looking up a field takes no lock.
+Each field is built under its own once_flag, different fields can be loaded concurrently.
+*/
 class FieldMan
 {
-private:
-	std::mutex m_mtxFieldMan;
+	struct FieldEntry
+	{
+		std::atomic<Field*> pField{ nullptr };
+		std::once_flag flagInit;
+		std::atomic<bool> bPrefetchQueued{ false };
+	};
+
+public:
+	static const int MAX_PREFETCH_QUEUE = 64;
 
-	std::map<int, Field*> m_mField;
+private:
+	std::once_flag m_flagFieldIndex;
+	std::unordered_map<int, FieldEntry*> m_mField;
 	std::map<int, int> m_mAreaCode;
 	std::map<std::string, FieldSet*> m_mFieldSet;
 
+	//Prefetch of the fields reachable through portals, disabled unless StartPrefetch is called.
+	std::mutex m_mtxPrefetch;
+	std::condition_variable m_cvPrefetch;
+	std::deque<int> m_qPrefetch;
+	std::atomic<bool> m_bPrefetchEnabled{ false };
+	std::atomic<unsigned long long> m_liPrefetchCount{ 0 };
+
 	FieldMan();
+	void LoadFieldIndex();
+	FieldEntry* GetFieldEntry(int nFieldID);
+	void PrefetchThread();
 
 public:
 
 	static FieldMan *GetInstance();
-	void RegisterField(int nFieldID);
-	void FieldFactory(int nFieldID);
+	Field* RegisterField(int nFieldID);
+	Field* FieldFactory(int nFieldID);
 	void LoadAreaCode();
 	bool IsConnected(int nFrom, int nTo);
 	void LoadFieldSet();
@@ -29,6 +58,10 @@ public:
 	Field* GetField(int nFieldID);
 	FieldSet* GetFieldSet(const std::string& sFieldSetName);
 	void RestoreFoothold(Field* pField, void *pPropFoothold, void *pLadderOrRope, void *pInfo);
+
+	void StartPrefetch(int nWorkerCount);
+	void PrefetchNeighbour(Field *pField);
+	unsigned long long GetPrefetchCount() const;
 	~FieldMan();
 };
 
@@ -366,7 +366,6 @@ void FieldSet::DestroyClock()
 {
 	OutPacket oPacket;
 	oPacket.Encode2(FieldSendPacketType::Field_OnDestroyClock);
-	oPacket.GetSharedPacket()->ToggleBroadcasting();
 
 	std::lock_guard<std::recursive_mutex> lock(m_mtxFieldSetLock);
 	for (auto& prUser : m_mUser)
@@ -383,7 +382,6 @@ void FieldSet::ResetTimeLimit(int nTimeLimit, bool bResetTimeTick)
 
 	OutPacket oPacket;
 	MakeClockPacket(oPacket);
-	oPacket.GetSharedPacket()->ToggleBroadcasting();
 
 	for (auto& prUser : m_mUser)
 		if (prUser.second)
@@ -2,6 +2,7 @@
 #include <iostream>
 #include <thread>
 #include <functional>
+#include <algorithm>
 
 #include "QuestMan.h"
 #include "ClientSocket.h"
@@ -9,6 +10,7 @@
 #include "ItemInfo.h"
 #include "SkillInfo.h"
 #include "FieldMan.h"
+#include "Field.h"
 #include "TimerThread.h"
 #include "NpcTemplate.h"
 #include "ReactorTemplate.h"
@@ -17,11 +19,14 @@
 #include "CalcDamage.h"
 #include "ScriptMan.h"
 #include "PetTemplate.h"
+#include "TemplateRegistry.h"
 
 #include "..\WvsLib\Wz\WzResMan.hpp"
 #include "..\WvsLib\DateTime\GameDateTime.h"
 #include "..\WvsLib\Common\ConfigLoader.hpp"
 #include "..\WvsLib\Task\AsyncScheduler.h"
+#include "..\WvsLib\Task\TimerWheel.h"
+#include "..\WvsLib\Task\StartupTaskGraph.h"
 #include "..\WvsLib\Logger\WvsLogger.h"
 #include "..\WvsLib\Net\InPacket.h"
 #include "..\WvsLib\Net\OutPacket.h"
@@ -66,31 +71,68 @@ void GameApp::InitializeService(int argc, char** argv)
 		WvsLogger::LogRaw("Please run this program with command line, and provide the path of the config file.\n");
 		exit(0);
 	}
+	WvsLogger::LoadConfig(pCfgLoader);
+	TimerWheel::GetInstance()->Initialize(pCfgLoader->IntValue("TimerWorkerCount", 0));
 	
+	//WvsGame <config> -CompileWzSnapshot writes the snapshot specified as WzSnapshot in the global config and exits.
+	if (argc > 2 && std::string(argv[2]) == "-CompileWzSnapshot")
+	{
+		WzResMan::GetInstance()->Init(pCfgLoader->StrValue("GlobalConfig"), false);
+		bool bResult = WzResMan::GetInstance()->CompileSnapshot();
+		WvsLogger::LogFormat("Compiling WzSnapshot %s.\n", bResult ? "succeeded" : "failed");
+		exit(bResult ? 0 : 1);
+	}
+
 	auto tInitStart = std::chrono::high_resolution_clock::now();
 	WzResMan::GetInstance()->Init(pCfgLoader->StrValue("GlobalConfig"));
 	StringPool::Init(pCfgLoader->StrValue("GlobalConfig"));
 	WvsException::RegisterUnhandledExceptionFilter("WvsGame", UnhandledExcpetionHandler);
 	SetConsoleCtrlHandler((PHANDLER_ROUTINE)ConsoleHandler, TRUE);
 	TimerThread::RegisterTimerPool(50, 1000);
-	QuestMan::GetInstance()->Initialize();
-	ItemInfo::GetInstance()->Initialize();
-	Reward::LoadReward();
-	ReactorTemplate::Load();
-	NpcTemplate::GetInstance()->Load();
-	FieldMan::GetInstance()->LoadAreaCode();
-	FieldMan::GetInstance()->LoadFieldSet();
-	ContinentMan::GetInstance()->Init();
-	CalcDamage::LoadStandardPDD();
-	PetTemplate::Load();
+	Field::SetHibernateDelay((unsigned int)pCfgLoader->IntValue("FieldHibernateDelay", 60 * 1000));
+
+	TemplateLoader::GetInstance()->Start(pCfgLoader->IntValue("TemplateLoaderWorkerCount", 2));
+
+	//Independent loaders run in parallel, a loader starts once the ones it reads from are done.
+	int nStartupWorkerCount = pCfgLoader->IntValue("StartupWorkerCount", 0);
+	StartupTaskGraph startupGraph;
+	int nQuest = startupGraph.AddStage("QuestMan", []() { QuestMan::GetInstance()->Initialize(false); });
+	int nItem = startupGraph.AddStage("ItemInfo", []() { ItemInfo::GetInstance()->Initialize(); });
+	//SkillInfo is the largest loader, it is split into one stage per graph worker which all take skill roots from the same queue.
+	//A worker which is done with the other stages joins the skill loading instead of idling.
+	int nSkillRoot = startupGraph.AddStage("SkillRoot", []() { SkillInfo::GetInstance()->PrepareSkillRoot(); });
+	int nSkillStageCount = nStartupWorkerCount > 0 ? nStartupWorkerCount : (std::max)(2, (int)std::thread::hardware_concurrency());
+	for (int i = 0; i < nSkillStageCount; ++i)
+		startupGraph.AddStage("SkillInfo#" + std::to_string(i), []() { SkillInfo::GetInstance()->LoadQueuedSkillRoot(); }, { nSkillRoot });
+	int nMobSkill = startupGraph.AddStage("MobSkill", []() {
+		SkillInfo::GetInstance()->LoadMobSkill();
+		SkillInfo::GetInstance()->LoadMCSkill();
+		SkillInfo::GetInstance()->LoadMCGuardian();
+	});
+	int nReward = startupGraph.AddStage("Reward", []() { Reward::LoadReward(); }, { nQuest, nItem });
+	int nReactor = startupGraph.AddStage("ReactorTemplate", []() { ReactorTemplate::Load(); }, { nReward });
+	int nNpc = startupGraph.AddStage("NpcTemplate", []() { NpcTemplate::GetInstance()->Load(); }, { nItem });
+	int nAreaCode = startupGraph.AddStage("AreaCode", []() { FieldMan::GetInstance()->LoadAreaCode(); });
+	startupGraph.AddStage("StandardPDD", []() { CalcDamage::LoadStandardPDD(); });
+	startupGraph.AddStage("PetTemplate", []() { PetTemplate::Load(); }, { nItem });
 
+	//Anything below creates fields, which read every template above.
+	std::vector<int> anFieldDependency = { nItem, nMobSkill, nReward, nReactor, nNpc, nAreaCode };
+	startupGraph.AddStage("FieldSet", []() { FieldMan::GetInstance()->LoadFieldSet(); }, anFieldDependency);
+	startupGraph.AddStage("ContinentMan", []() { ContinentMan::GetInstance()->Init(); }, anFieldDependency);
 	if (pCfgLoader->IntValue("PreRegisterAllField"))
-		FieldMan::GetInstance()->RegisterAllField();
+		startupGraph.AddStage("RegisterAllField", []() { FieldMan::GetInstance()->RegisterAllField(); }, anFieldDependency);
 
-	SkillInfo::GetInstance()->LoadMobSkill();
-	SkillInfo::GetInstance()->LoadMCSkill();
-	SkillInfo::GetInstance()->LoadMCGuardian();
-	SkillInfo::GetInstance()->IterateSkillInfo();
+	startupGraph.Run(nStartupWorkerCount);
+	startupGraph.LogTiming();
+	WzResMan::GetInstance()->LogResidentSize("Startup");
+
+	//Release the parsed WZ data once, every loader is done with it.
+	//From now on the archives are only read by lazy lookups, don't let the kernel read ahead for them.
+	WzResMan::GetInstance()->SetAccessHint(WzMappedFileStream::Access_Random);
+	WzResMan::GetInstance()->RemountAll();
+	WzResMan::GetInstance()->LogResidentSize("Remount");
+	FieldMan::GetInstance()->StartPrefetch(pCfgLoader->IntValue("FieldPrefetchWorkerCount", 0));
 
 	WvsBase::GetInstance<WvsGame>()->Init();
 	WvsBase::GetInstance<WvsGame>()->SetExternalIP(pCfgLoader->StrValue("ExternalIP"));
@@ -106,12 +148,5 @@ void GameApp::InitializeService(int argc, char** argv)
 	WvsLogger::LogFormat("Game server has successfully initialized in %lld us.\n", std::chrono::duration_cast<std::chrono::microseconds>(tInitEnd - tInitStart).count());
 
 	// start the i/o work
-	asio::io_service &io = WvsBase::GetInstance<WvsGame>()->GetIOService();
-	asio::io_service::work work(io);
-
-	for (;;)
-	{
-		std::error_code ec;
-		io.run(ec);
-	}
+	WvsBase::GetInstance<WvsGame>()->RunIOService(pCfgLoader->IntValue("IOThreadCount", 1));
 }
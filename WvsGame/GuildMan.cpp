@@ -121,7 +121,6 @@ void GuildMan::OnLeave(User * pUser)
 
 void GuildMan::Broadcast(OutPacket *oPacket, const std::vector<int>& anMemberID, int nPlusOne)
 {
-	oPacket->GetSharedPacket()->ToggleBroadcasting();
 	if (nPlusOne >= 0)
 	{
 		auto pUser = User::FindUser(nPlusOne);
@@ -326,7 +325,6 @@ void GuildMan::OnCreateNewGuildDone(InPacket * iPacket)
 		OutPacket oPacket;
 		MakeGuildUpdatePacket(&oPacket, pGuild);
 
-		oPacket.GetSharedPacket()->ToggleBroadcasting();
 		for (int i = 0; i < pGuild->anCharacterID.size(); ++i)
 		{
 			auto pUser = User::FindUser(pGuild->anCharacterID[i]);
@@ -1153,8 +1151,6 @@ void GuildMan::RemoveUser(GuildData *pGuild, int nCharacterID)
 #ifdef _WVSCENTER
 void GuildMan::SendToAll(GuildData * pGuild, OutPacket * oPacket)
 {
-	oPacket->GetSharedPacket()->ToggleBroadcasting();
-
 	bool bSrvSent[WvsWorld::MAX_CHANNEL_COUNT]{ 0 };
 	for (auto& nID : pGuild->anCharacterID)
 	{
@@ -11,6 +11,7 @@
 #include "..\Database\GW_ItemSlotBundle.h"
 #include "..\Database\GW_ItemSlotPet.h"
 #include "..\WvsLib\Wz\WzResMan.hpp"
+#include "..\WvsLib\Wz\WzStreamCodec.h"
 #include "..\WvsLib\Random\Rand32.h"
 #include "..\WvsLib\Logger\WvsLogger.h"
 #include "..\WvsLib\Memory\MemoryPoolMan.hpp"
@@ -36,10 +37,13 @@ ItemInfo * ItemInfo::GetInstance()
 
 void ItemInfo::Initialize()
 {
+	auto cacheStat = WzStringCache::GetStat();
 	IterateMapString(nullptr);
+	m_MapString.Build();
 	LoadItemSellPriceByLv();
 	WvsLogger::LogRaw("[ItemInfo::Initialize<IterateItemString>]On iterating all item names....\n");
 	IterateItemString(nullptr);
+	m_ItemString.Build();
 	WvsLogger::LogRaw("[ItemInfo::Initialize<IterateItemString>]Item names are completely loaded.\n");
 
 	static auto& eqpWz = WzResMan::GetInstance()->GetWz(Wz::Character);
@@ -55,8 +59,42 @@ void ItemInfo::Initialize()
 	RegisterSpecificItems();
 	RegisterNoRollbackItem();
 	RegisterSetHalloweenItem();
-
-	WzResMan::GetInstance()->RemountAll();
+	BuildItemTable();
+	WzStringCache::LogStat("ItemInfo::Initialize", cacheStat);
+}
+
+void ItemInfo::BuildItemTable()
+{
+	m_mEquipItem.Build();
+	m_mBundleItem.Build();
+	m_mUpgradeItem.Build();
+	m_mStateChangeItem.Build();
+	m_mPortalScrollItem.Build();
+	m_mMobSummonItem.Build();
+	m_mPetFoodItem.Build();
+	m_mTamingMobFoodItem.Build();
+	m_mBridleItem.Build();
+	m_mSkillLearnItem.Build();
+	m_mPortableChairItem.Build();
+	m_mCashItem.Build();
+	m_mPetSkillChangeItem.Build();
+	m_mStateChangingWeatherItem.Build();
+
+	//Attributes come from the same sources as the former lookups: equips for 1xxxxxx, bundles for the others, none for the cash items (5xxxxxx).
+	for (int nItemID : m_mEquipItem.GetItemIDList())
+		if (GetItemSlotType(nItemID) == 1)
+			m_mHotInfo.Set(nItemID, { (unsigned short)GetEquipItem(nItemID)->abilityStat.nAttribute, 0 });
+	for (int nItemID : m_mBundleItem.GetItemIDList())
+		if (GetItemSlotType(nItemID) != 1)
+		{
+			auto pItem = GetBundleItem(nItemID);
+			m_mHotInfo.Set(nItemID, {
+				(unsigned short)(GetItemSlotType(nItemID) == 5 ? 0 : pItem->abilityStat.nAttribute),
+				(unsigned short)(pItem->nMaxPerSlot > 0xFFFF ? 0xFFFF : pItem->nMaxPerSlot)
+			});
+		}
+	m_mHotInfo.Build();
+	WvsLogger::LogFormat("[ItemInfo::BuildItemTable]Item tables take %llu bytes.\n", GetTableMemoryUsage());
 }
 
 void ItemInfo::LoadItemSellPriceByLv()
@@ -84,7 +122,7 @@ void ItemInfo::IterateMapString(void *dataNode)
 			else
 			{
 				for (auto& strNode : img)
-					m_mMapString[atoi(img.GetName().c_str())][strNode.GetName()] = StringUtility::ConvertUTF8ToSystemEncoding(((std::string)strNode).c_str());
+					m_MapString.Add(atoi(img.GetName().c_str()), strNode.GetName(), StringUtility::ConvertUTF8ToSystemEncoding(((std::string)strNode).c_str()));
 			}
 		}
 	}
@@ -113,7 +151,7 @@ void ItemInfo::IterateItemString(void *dataNode)
 			else
 			{
 				for (auto& strNode : img)
-					m_mItemString[atoi(img.GetName().c_str())][strNode.GetName()] = StringUtility::ConvertUTF8ToSystemEncoding(((std::string)strNode).c_str());
+					m_ItemString.Add(atoi(img.GetName().c_str()), strNode.GetName(), StringUtility::ConvertUTF8ToSystemEncoding(((std::string)strNode).c_str()));
 			}
 		}
 	}
@@ -143,7 +181,7 @@ void ItemInfo::IterateEquipItem(void *dataNode)
 			pNewEquip->nItemID = nItemID;
 			pNewEquip->sItemName = GetItemName(nItemID);
 			RegisterEquipItemInfo(pNewEquip, nItemID, (void*)&(data));
-			m_mEquipItem[nItemID] = pNewEquip;
+			m_mEquipItem.Set(nItemID, pNewEquip);
 		}
 	}
 }
@@ -168,7 +206,7 @@ void ItemInfo::IterateBundleItem()
 				BundleItem* pNewBundle = AllocObj( BundleItem );
 				LoadAbilityStat(pNewBundle->abilityStat, (void*)&infoImg);
 				if (pNewBundle->abilityStat.bCash)
-					m_mCashItem.insert({ nItemID, AllocObj(CashItem) });
+					m_mCashItem.Insert(nItemID, AllocObj(CashItem));
 
 				pNewBundle->nItemID = nItemID;
 				pNewBundle->sItemName = GetItemName(nItemID);
@@ -189,7 +227,7 @@ void ItemInfo::IterateBundleItem()
 					pNewBundle->nMCType = -1;
 
 				pNewBundle->nPAD = infoImg["incPAD"]; //bullet
-				m_mBundleItem[nItemID] = pNewBundle;
+				m_mBundleItem.Set(nItemID, pNewBundle);
 				int nItemCategory = nItemID / 10000;
 				void* pProp = (void*)&item;
 				switch (nItemCategory)
@@ -240,7 +278,7 @@ void ItemInfo::IteratePetItem()
 		int nItemID = atoi(item.GetName().c_str());
 		CashItem *pItem = AllocObj(CashItem);
 		pItem->bIsPet = true;
-		m_mCashItem.insert({ nItemID, pItem });
+		m_mCashItem.Insert(nItemID, pItem);
 	}
 	
 }
@@ -301,7 +339,7 @@ void ItemInfo::RegisterEquipItemInfo(EquipItem * pEqpItem, int nItemID, void * p
 	LoadAbilityStat(pEqpItem->abilityStat, (void*)&infoImg);
 
 	if (pEqpItem->abilityStat.bCash)
-		m_mCashItem.insert({ nItemID, AllocObj(CashItem) });
+		m_mCashItem.Insert(nItemID, AllocObj(CashItem));
 
 	pEqpItem->nItemID = nItemID;
 	pEqpItem->nrSTR = infoImg["reqSTR"];
@@ -336,7 +374,7 @@ void ItemInfo::RegisterUpgradeItem(int nItemID, void * pProp)
 	LoadIncrementStat(pNewUpgradeItem->incStat, (void*)&infoImg);
 	pNewUpgradeItem->nSuccessRate = infoImg["success"];
 	pNewUpgradeItem->nCursedRate = infoImg["cursed"];
-	m_mUpgradeItem[nItemID] = pNewUpgradeItem;
+	m_mUpgradeItem.Set(nItemID, pNewUpgradeItem);
 }
 
 void ItemInfo::RegisterPortalScrollItem(int nItemID, void * pProp)
@@ -346,7 +384,7 @@ void ItemInfo::RegisterPortalScrollItem(int nItemID, void * pProp)
 	auto& specImg = (*((WzIterator*)pProp))["spec"];
 	for (auto& effect : specImg)
 		pNewPortalScrollItem->spec.insert({ effect.GetName(), (int)effect });
-	m_mPortalScrollItem[nItemID] = pNewPortalScrollItem;
+	m_mPortalScrollItem.Set(nItemID, pNewPortalScrollItem);
 }
 
 void ItemInfo::RegisterMobSummonItem(int nItemID, void * pProp)
@@ -358,7 +396,7 @@ void ItemInfo::RegisterMobSummonItem(int nItemID, void * pProp)
 	auto& mobImg = (*((WzIterator*)pProp))["mob"];
 	for (auto& mob : mobImg) 
 		pNewMobSummonItem->lMob.push_back({ atoi(((std::string)mob["id"]).c_str()), (int)(mob["prob"]) });
-	m_mMobSummonItem[nItemID] = pNewMobSummonItem;
+	m_mMobSummonItem.Set(nItemID, pNewMobSummonItem);
 }
 
 void ItemInfo::RegisterPetFoodItem(int nItemID, void * pProp)
@@ -370,7 +408,7 @@ void ItemInfo::RegisterPetFoodItem(int nItemID, void * pProp)
 	for (auto& petID : specImg)
 		if (isdigit(petID.GetName()[0]))
 			pNewFoodItem->ldwPet.push_back((int)petID);
-	m_mPetFoodItem[nItemID] = pNewFoodItem;
+	m_mPetFoodItem.Set(nItemID, pNewFoodItem);
 }
 
 void ItemInfo::RegisterTamingMobFoodItem(int nItemID, void * pProp)
@@ -379,7 +417,7 @@ void ItemInfo::RegisterTamingMobFoodItem(int nItemID, void * pProp)
 	TamingMobFoodItem *pNewTamingMobFoodItem = AllocObj(TamingMobFoodItem);
 	pNewTamingMobFoodItem->nItemID = nItemID;
 	pNewTamingMobFoodItem->niFatigue = specImg["incFatigue"];
-	m_mTamingMobFoodItem[nItemID] = pNewTamingMobFoodItem;
+	m_mTamingMobFoodItem.Set(nItemID, pNewTamingMobFoodItem);
 }
 
 void ItemInfo::RegisterBridleItem(int nItemID, void * pProp)
@@ -394,7 +432,7 @@ void ItemInfo::RegisterBridleItem(int nItemID, void * pProp)
 	pNewBridleItem->nBridleHP = infoImg["mobHP"];
 	pNewBridleItem->nUseDelay = infoImg["useDelay"];
 	pNewBridleItem->dBridlePropChg = (double)infoImg["bridlePropChg"];
-	m_mBridleItem[nItemID] = pNewBridleItem;
+	m_mBridleItem.Set(nItemID, pNewBridleItem);
 }
 
 void ItemInfo::RegisterPortableChairItem(int nItemID, void * pProp)
@@ -405,7 +443,7 @@ void ItemInfo::RegisterPortableChairItem(int nItemID, void * pProp)
 	pNewPortableChairItem->nReqLevel = infoImg["reqLevel"];
 	pNewPortableChairItem->nPortableChairRecoveryRateMP = infoImg["recoveryMP"];
 	pNewPortableChairItem->nPortableChairRecoveryRateHP = infoImg["recoveryHP"];
-	m_mPortableChairItem[nItemID] = pNewPortableChairItem;
+	m_mPortableChairItem.Set(nItemID, pNewPortableChairItem);
 }
 
 void ItemInfo::RegisterSkillLearnItem(int nItemID, void * pProp)
@@ -420,7 +458,7 @@ void ItemInfo::RegisterSkillLearnItem(int nItemID, void * pProp)
 	auto& skillImg = infoImg["skill"];
 	for (auto& skill : skillImg)
 		pNewSkillLearnItem->aSkill.push_back((int)skill);
-	m_mSkillLearnItem[nItemID] = pNewSkillLearnItem;
+	m_mSkillLearnItem.Set(nItemID, pNewSkillLearnItem);
 }
 
 void ItemInfo::RegisterStateChangeItem(int nItemID, void * pProp)
@@ -430,7 +468,7 @@ void ItemInfo::RegisterStateChangeItem(int nItemID, void * pProp)
 	auto& specImg = (*((WzIterator*)pProp))["spec"];
 	for(auto& effect : specImg)
 		pNewStateChangeItem->spec.insert({ effect.GetName(), (int)effect });
-	m_mStateChangeItem[nItemID] = pNewStateChangeItem;
+	m_mStateChangeItem.Set(nItemID, pNewStateChangeItem);
 }
 
 void ItemInfo::RegisterPetSkillChangeItem(int nItemID, void * pProp)
@@ -440,7 +478,7 @@ void ItemInfo::RegisterPetSkillChangeItem(int nItemID, void * pProp)
 	pItem->nItemID = nItemID;
 	pItem->bSet = (int)infoImg["add"] == 1;
 	LoadPetSkillChangeInfo(&infoImg, &pItem->nFlag);
-	m_mPetSkillChangeItem.insert({ nItemID, pItem });
+	m_mPetSkillChangeItem.Insert(nItemID, pItem);
 }
 
 void ItemInfo::RegisterStateChangingWeatherItem(int nItemID, void * pProp)
@@ -450,7 +488,7 @@ void ItemInfo::RegisterStateChangingWeatherItem(int nItemID, void * pProp)
 	pItem->nItemID = nItemID;
 	pItem->nStateChangeItemID = infoImg["stateChangeItem"];
 	pItem->sMsg = GetItemString(nItemID, "msg");
-	m_mStateChangingWeatherItem[nItemID] = pItem;
+	m_mStateChangingWeatherItem.Set(nItemID, pItem);
 }
 
 void ItemInfo::LoadPetSkillChangeInfo(void * pImg, void * pFlag)
@@ -477,86 +515,72 @@ void ItemInfo::LoadPetSkillChangeInfo(void * pImg, void * pFlag)
 
 EquipItem * ItemInfo::GetEquipItem(int nItemID)
 {
-	auto findIter = m_mEquipItem.find(nItemID);
-	return (findIter != m_mEquipItem.end() ? findIter->second : nullptr);
+	return m_mEquipItem.Get(nItemID, nullptr);
 }
 
 StateChangeItem * ItemInfo::GetStateChangeItem(int nItemID)
 {
-	auto findIter = m_mStateChangeItem.find(nItemID);
-	return (findIter != m_mStateChangeItem.end() ? findIter->second : nullptr);
+	return m_mStateChangeItem.Get(nItemID, nullptr);
 }
 
 CashItem * ItemInfo::GetCashItem(int nItemID)
 {
-	auto findIter = m_mCashItem.find(nItemID);
-	return (findIter != m_mCashItem.end() ? findIter->second : nullptr);
+	return m_mCashItem.Get(nItemID, nullptr);
 }
 
 PetSkillChangeItem * ItemInfo::GetPetSkillChangeItem(int nItemID)
 {
-	auto findIter = m_mPetSkillChangeItem.find(nItemID);
-	return (findIter != m_mPetSkillChangeItem.end() ? findIter->second : nullptr);
+	return m_mPetSkillChangeItem.Get(nItemID, nullptr);
 }
 
 StateChangingWeatherItem * ItemInfo::GetStateChangingWeatherItem(int nItemID)
 {
-	auto findIter = m_mStateChangingWeatherItem.find(nItemID);
-	return (findIter != m_mStateChangingWeatherItem.end() ? findIter->second : nullptr);
+	return m_mStateChangingWeatherItem.Get(nItemID, nullptr);
 }
 
 BundleItem * ItemInfo::GetBundleItem(int nItemID)
 {
-	auto findIter = m_mBundleItem.find(nItemID);
-	return (findIter != m_mBundleItem.end() ? findIter->second : nullptr);
+	return m_mBundleItem.Get(nItemID, nullptr);
 }
 
 UpgradeItem * ItemInfo::GetUpgradeItem(int nItemID)
 {
-	auto findIter = m_mUpgradeItem.find(nItemID);
-	return (findIter != m_mUpgradeItem.end() ? findIter->second : nullptr);
+	return m_mUpgradeItem.Get(nItemID, nullptr);
 }
 
 PortalScrollItem * ItemInfo::GetPortalScrollItem(int nItemID)
 {
-	auto findIter = m_mPortalScrollItem.find(nItemID);
-	return (findIter != m_mPortalScrollItem.end() ? findIter->second : nullptr);
+	return m_mPortalScrollItem.Get(nItemID, nullptr);
 }
 
 MobSummonItem * ItemInfo::GetMobSummonItem(int nItemID)
 {
-	auto findIter = m_mMobSummonItem.find(nItemID);
-	return (findIter != m_mMobSummonItem.end() ? findIter->second : nullptr);
+	return m_mMobSummonItem.Get(nItemID, nullptr);
 }
 
 PetFoodItem * ItemInfo::GetPetFoodItem(int nItemID)
 {
-	auto findIter = m_mPetFoodItem.find(nItemID);
-	return (findIter != m_mPetFoodItem.end() ? findIter->second : nullptr);
+	return m_mPetFoodItem.Get(nItemID, nullptr);
 }
 
 TamingMobFoodItem * ItemInfo::GetTamingMobFoodItem(int nItemID)
 {
-	auto findIter = m_mTamingMobFoodItem.find(nItemID);
-	return (findIter != m_mTamingMobFoodItem.end() ? findIter->second : nullptr);
+	return m_mTamingMobFoodItem.Get(nItemID, nullptr);
 }
 
 BridleItem * ItemInfo::GetBridleItem(int nItemID)
 {
-	auto findIter = m_mBridleItem.find(nItemID);
-	return (findIter != m_mBridleItem.end() ? findIter->second : nullptr);
+	return m_mBridleItem.Get(nItemID, nullptr);
 }
 
 SkillLearnItem * ItemInfo::GetSkillLearnItem(int nItemID)
 {
-	auto findIter = m_mSkillLearnItem.find(nItemID);
-	return (findIter != m_mSkillLearnItem.end() ? findIter->second : nullptr);
+	return m_mSkillLearnItem.Get(nItemID, nullptr);
 }
 
 PortableChairItem * ItemInfo::GetPortableChairItem(int nItemID)
 {
-	auto findIter = m_mPortableChairItem.find(nItemID);
-	return (findIter != m_mPortableChairItem.end() ? findIter->second : nullptr);
+	return m_mPortableChairItem.Get(nItemID, nullptr);
 }
 
 int ItemInfo::GetItemSlotType(int nItemID)
@@ -591,20 +615,7 @@ int ItemInfo::ConsumeOnPickup(int nItemID)
 
 bool ItemInfo::ExpireOnLogout(int nItemID)
 {
-	if (nItemID / 1000000 != 5)
-		if (nItemID / 1000000 == 1)
-		{
-			auto pItem = GetEquipItem(nItemID);
-			if (pItem != nullptr)
-				return (pItem->abilityStat.nAttribute & GW_ItemSlotBase::ItemAttribute::eItemAttr_ExpireOnLogout) != 0;
-		}
-		else
-		{
-			auto pItem = GetBundleItem(nItemID);
-			if (pItem != nullptr)
-				return (pItem->abilityStat.nAttribute & GW_ItemSlotBase::ItemAttribute::eItemAttr_ExpireOnLogout) != 0;
-		}
-	return false;
+	return (GetHotAttribute(nItemID) & GW_ItemSlotBase::ItemAttribute::eItemAttr_ExpireOnLogout) != 0;
 }
 
 int ItemInfo::GetBulletPAD(int nItemID)
@@ -627,23 +638,69 @@ long long int ItemInfo::GetItemDateExpire(const std::string & sDate)
 	return (std::mktime(&dt) - lTimeZone) * 10000000 + 116444736000000000;
 }
 
-const std::string & ItemInfo::GetItemString(int nItemID, const std::string & sKey)
+std::string ItemInfo::GetItemString(int nItemID, const std::string & sKey)
 {
-	static std::string strEmpty = "";
-	auto itemResult = m_mItemString.find(nItemID);
-	if (itemResult != m_mItemString.end())
-	{
-		auto strResult = itemResult->second.find(sKey);
-		return (strResult == itemResult->second.end() ? strEmpty : strResult->second);
-	}
-	return strEmpty;
+	auto sValue = m_ItemString.Find(nItemID, sKey);
+	return sValue ? sValue : "";
 }
 
-const std::string & ItemInfo::GetItemName(int nItemID)
+std::string ItemInfo::GetItemName(int nItemID)
 {
 	return GetItemString(nItemID, "name");
 }
 
+int ItemInfo::GetMaxPerSlot(int nItemID)
+{
+	auto pInfo = m_mHotInfo.Find(nItemID);
+	return pInfo ? pInfo->nMaxPerSlot : 0;
+}
+
+int ItemInfo::GetHotAttribute(int nItemID)
+{
+	auto pInfo = m_mHotInfo.Find(nItemID);
+	return pInfo ? pInfo->nAttribute : 0;
+}
+
+std::vector<std::pair<const char*, const std::vector<int>*>> ItemInfo::GetTableItemIDList() const
+{
+	return {
+		{ "EquipItem", &m_mEquipItem.GetItemIDList() },
+		{ "BundleItem", &m_mBundleItem.GetItemIDList() },
+		{ "UpgradeItem", &m_mUpgradeItem.GetItemIDList() },
+		{ "StateChangeItem", &m_mStateChangeItem.GetItemIDList() },
+		{ "PortalScrollItem", &m_mPortalScrollItem.GetItemIDList() },
+		{ "MobSummonItem", &m_mMobSummonItem.GetItemIDList() },
+		{ "PetFoodItem", &m_mPetFoodItem.GetItemIDList() },
+		{ "TamingMobFoodItem", &m_mTamingMobFoodItem.GetItemIDList() },
+		{ "BridleItem", &m_mBridleItem.GetItemIDList() },
+		{ "SkillLearnItem", &m_mSkillLearnItem.GetItemIDList() },
+		{ "PortableChairItem", &m_mPortableChairItem.GetItemIDList() },
+		{ "CashItem", &m_mCashItem.GetItemIDList() },
+		{ "PetSkillChangeItem", &m_mPetSkillChangeItem.GetItemIDList() },
+		{ "StateChangingWeatherItem", &m_mStateChangingWeatherItem.GetItemIDList() },
+	};
+}
+
+const ItemStringTable & ItemInfo::GetItemStringTable() const
+{
+	return m_ItemString;
+}
+
+const ItemStringTable & ItemInfo::GetMapStringTable() const
+{
+	return m_MapString;
+}
+
+unsigned long long ItemInfo::GetTableMemoryUsage() const
+{
+	return m_mEquipItem.GetMemoryUsage() + m_mBundleItem.GetMemoryUsage() + m_mUpgradeItem.GetMemoryUsage() +
+		m_mStateChangeItem.GetMemoryUsage() + m_mPortalScrollItem.GetMemoryUsage() + m_mMobSummonItem.GetMemoryUsage() +
+		m_mPetFoodItem.GetMemoryUsage() + m_mTamingMobFoodItem.GetMemoryUsage() + m_mBridleItem.GetMemoryUsage() +
+		m_mSkillLearnItem.GetMemoryUsage() + m_mPortableChairItem.GetMemoryUsage() + m_mCashItem.GetMemoryUsage() +
+		m_mPetSkillChangeItem.GetMemoryUsage() + m_mStateChangingWeatherItem.GetMemoryUsage() + m_mHotInfo.GetMemoryUsage() +
+		m_ItemString.GetMemoryUsage() + m_MapString.GetMemoryUsage();
+}
+
 bool ItemInfo::IsAbleToEquip(int nGender, int nLevel, int nJob, int nSTR, int nDEX, int nINT, int nLUK, int nPOP, GW_ItemSlotBase * pPetItem, int nItemID)
 {
 	return false;
@@ -651,78 +708,22 @@ bool ItemInfo::IsAbleToEquip(int nGender, int nLevel, int nJob, int nSTR, int nD
 
 bool ItemInfo::IsNotSaleItem(int nItemID)
 {
-	int nTI = GetItemSlotType(nItemID);
-	if (nTI != 5)
-		if (nTI == 1)
-		{
-			auto pItem = GetEquipItem(nItemID);
-			if (pItem != nullptr)
-				return (pItem->abilityStat.nAttribute & GW_ItemSlotBase::ItemAttribute::eItemAttr_NotSale) != 0;
-		}
-		else
-		{
-			auto pItem = GetBundleItem(nItemID);
-			if (pItem != nullptr)
-				return (pItem->abilityStat.nAttribute & GW_ItemSlotBase::ItemAttribute::eItemAttr_NotSale) != 0;
-		}
-	return false;
+	return (GetHotAttribute(nItemID) & GW_ItemSlotBase::ItemAttribute::eItemAttr_NotSale) != 0;
 }
 
 bool ItemInfo::IsOnlyItem(int nItemID)
 {
-	int nTI = GetItemSlotType(nItemID);
-	if (nTI != 5)
-		if (nTI == 1)
-		{
-			auto pItem = GetEquipItem(nItemID);
-			if (pItem != nullptr)
-				return (pItem->abilityStat.nAttribute & GW_ItemSlotBase::ItemAttribute::eItemAttr_Only) != 0;
-		}
-		else
-		{
-			auto pItem = GetBundleItem(nItemID);
-			if (pItem != nullptr)
-				return (pItem->abilityStat.nAttribute & GW_ItemSlotBase::ItemAttribute::eItemAttr_Only) != 0;
-		}
-	return false;
+	return (GetHotAttribute(nItemID) & GW_ItemSlotBase::ItemAttribute::eItemAttr_Only) != 0;
 }
 
 bool ItemInfo::IsTradeBlockItem(int nItemID)
 {
-	int nTI = GetItemSlotType(nItemID);
-	if (nTI != 5)
-		if (nTI == 1)
-		{
-			auto pItem = GetEquipItem(nItemID);
-			if (pItem != nullptr)
-				return (pItem->abilityStat.nAttribute & GW_ItemSlotBase::ItemAttribute::eItemAttr_TradeBlock) != 0;
-		}
-		else
-		{
-			auto pItem = GetBundleItem(nItemID);
-			if (pItem != nullptr)
-				return (pItem->abilityStat.nAttribute & GW_ItemSlotBase::ItemAttribute::eItemAttr_TradeBlock) != 0;
-		}
-	return false;
+	return (GetHotAttribute(nItemID) & GW_ItemSlotBase::ItemAttribute::eItemAttr_TradeBlock) != 0;
 }
 
 bool ItemInfo::IsQuestItem(int nItemID)
 {
-	int nTI = GetItemSlotType(nItemID);
-	if (nTI != 5)
-		if (nTI == 1)
-		{
-			auto pItem = GetEquipItem(nItemID);
-			if (pItem != nullptr)
-				return (pItem->abilityStat.nAttribute & GW_ItemSlotBase::ItemAttribute::eItemAttr_Quest) != 0;
-		}
-		else
-		{
-			auto pItem = GetBundleItem(nItemID);
-			if (pItem != nullptr)
-				return (pItem->abilityStat.nAttribute & GW_ItemSlotBase::ItemAttribute::eItemAttr_Quest) != 0;
-		}
-	return false;
+	return (GetHotAttribute(nItemID) & GW_ItemSlotBase::ItemAttribute::eItemAttr_Quest) != 0;
 }
 
 bool ItemInfo::IsWeapon(int nItemID)
@@ -13,6 +13,7 @@
 #include "CashItem.h"
 #include "PetSkillChangeItem.h"
 #include "StateChangingWeatherItem.h"
+#include "ItemTable.h"
 
 #include <vector>
 
@@ -25,6 +26,13 @@ class ItemInfo
 private:
 	bool m_bInitialized = false;
 
+	//Per item copy of the attributes and the slot size checked on every inventory operation.
+	struct ItemHotInfo
+	{
+		unsigned short nAttribute; //GW_ItemSlotBase::ItemAttribute
+		unsigned short nMaxPerSlot;
+	};
+
 public:
 	enum ItemVariationOption
 	{
@@ -138,8 +146,9 @@ public:
 	bool ExpireOnLogout(int nItemID);
 	int GetBulletPAD(int nItemID);
 	static long long int GetItemDateExpire(const std::string& sDate);
-	const std::string& GetItemString(int nItemID, const std::string& sKey);
-	const std::string& GetItemName(int nItemID);
+	std::string GetItemString(int nItemID, const std::string& sKey);
+	std::string GetItemName(int nItemID);
+	int GetMaxPerSlot(int nItemID);
 	bool IsAbleToEquip(int nGender, int nLevel, int nJob, int nSTR, int nDEX, int nINT, int nLUK, int nPOP, GW_ItemSlotBase* pPetItem, int nItemID);
 	bool IsNotSaleItem(int nItemID);
 	bool IsOnlyItem(int nItemID);
@@ -165,25 +174,34 @@ public:
 #endif
 	GW_ItemSlotBase* GetItemSlot(int nItemID, ItemVariationOption enOption);
 
+	//Used by ItemInfoBench.
+	std::vector<std::pair<const char*, const std::vector<int>*>> GetTableItemIDList() const;
+	const ItemStringTable& GetItemStringTable() const;
+	const ItemStringTable& GetMapStringTable() const;
+	unsigned long long GetTableMemoryUsage() const;
+
 private:
-	std::map<int, EquipItem*> m_mEquipItem;
-	std::map<int, BundleItem*> m_mBundleItem;
-	std::map<int, UpgradeItem*> m_mUpgradeItem;
-	std::map<int, StateChangeItem*> m_mStateChangeItem;
-	std::map<int, PortalScrollItem*> m_mPortalScrollItem;
-	std::map<int, MobSummonItem*> m_mMobSummonItem;
-	std::map<int, PetFoodItem*> m_mPetFoodItem;
-	std::map<int, TamingMobFoodItem*> m_mTamingMobFoodItem;
-	std::map<int, BridleItem*> m_mBridleItem;
-	std::map<int, SkillLearnItem*> m_mSkillLearnItem;
-	std::map<int, PortableChairItem*> m_mPortableChairItem;
-	std::map<int, CashItem*> m_mCashItem;
-	std::map<int, PetSkillChangeItem*> m_mPetSkillChangeItem;
-	std::map<int, StateChangingWeatherItem*> m_mStateChangingWeatherItem;
-
-	std::map<int, std::map<std::string, std::string>> m_mItemString, m_mMapString;
+	ItemTable<EquipItem*> m_mEquipItem;
+	ItemTable<BundleItem*> m_mBundleItem;
+	ItemTable<UpgradeItem*> m_mUpgradeItem;
+	ItemTable<StateChangeItem*> m_mStateChangeItem;
+	ItemTable<PortalScrollItem*> m_mPortalScrollItem;
+	ItemTable<MobSummonItem*> m_mMobSummonItem;
+	ItemTable<PetFoodItem*> m_mPetFoodItem;
+	ItemTable<TamingMobFoodItem*> m_mTamingMobFoodItem;
+	ItemTable<BridleItem*> m_mBridleItem;
+	ItemTable<SkillLearnItem*> m_mSkillLearnItem;
+	ItemTable<PortableChairItem*> m_mPortableChairItem;
+	ItemTable<CashItem*> m_mCashItem;
+	ItemTable<PetSkillChangeItem*> m_mPetSkillChangeItem;
+	ItemTable<StateChangingWeatherItem*> m_mStateChangingWeatherItem;
+	ItemTable<ItemHotInfo> m_mHotInfo;
+
+	ItemStringTable m_ItemString, m_MapString;
 	std::map<int, int> m_mItemSellPriceByLv;
 	
+	void BuildItemTable();
+	int GetHotAttribute(int nItemID);
 	void LoadIncrementStat(BasicIncrementStat& refStat, void *pProp);
 	void LoadAbilityStat(BasicAbilityStat& refStat, void *pProp);
 	int GetVariation(int v, ItemVariationOption enOption);
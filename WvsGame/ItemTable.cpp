@@ -0,0 +1,66 @@
+#include "ItemTable.h"
+
+unsigned int ItemStringTable::GetKey(const std::string & sKey) const
+{
+	for (unsigned int i = 0; i < (unsigned int)m_asKey.size(); ++i)
+		if (m_asKey[i] == sKey)
+			return i;
+	return (unsigned int)m_asKey.size();
+}
+
+void ItemStringTable::Add(int nID, const std::string & sKey, const std::string & sValue)
+{
+	unsigned int nKey = GetKey(sKey);
+	if (nKey == (unsigned int)m_asKey.size())
+		m_asKey.push_back(sKey);
+
+	m_aEntry.push_back({ nID, nKey, (unsigned int)m_aArena.size() });
+	m_aArena.insert(m_aArena.end(), sValue.begin(), sValue.end());
+	m_aArena.push_back(0);
+}
+
+void ItemStringTable::Build()
+{
+	//The last one of the same (ID, key) wins, as it did when the strings were assigned into a map.
+	std::stable_sort(m_aEntry.begin(), m_aEntry.end(), [](const Entry& lhs, const Entry& rhs) {
+		return lhs.nID < rhs.nID || (lhs.nID == rhs.nID && lhs.nKey < rhs.nKey);
+	});
+	int nCount = 0;
+	for (int i = 0; i < (int)m_aEntry.size(); ++i)
+	{
+		if (nCount && m_aEntry[nCount - 1].nID == m_aEntry[i].nID && m_aEntry[nCount - 1].nKey == m_aEntry[i].nKey)
+			--nCount;
+		m_aEntry[nCount++] = m_aEntry[i];
+	}
+	m_aEntry.resize(nCount);
+	m_aEntry.shrink_to_fit();
+	m_aArena.shrink_to_fit();
+}
+
+const char * ItemStringTable::Find(int nID, const std::string & sKey) const
+{
+	unsigned int nKey = GetKey(sKey);
+	if (nKey == (unsigned int)m_asKey.size())
+		return nullptr;
+
+	auto itEntry = std::lower_bound(m_aEntry.begin(), m_aEntry.end(), Entry{ nID, nKey, 0 }, [](const Entry& lhs, const Entry& rhs) {
+		return lhs.nID < rhs.nID || (lhs.nID == rhs.nID && lhs.nKey < rhs.nKey);
+	});
+	if (itEntry == m_aEntry.end() || itEntry->nID != nID || itEntry->nKey != nKey)
+		return nullptr;
+	return m_aArena.data() + itEntry->nOffset;
+}
+
+void ItemStringTable::ForEach(const std::function<void(int, const std::string&, const char*)>& fnVisit) const
+{
+	for (auto& entry : m_aEntry)
+		fnVisit(entry.nID, m_asKey[entry.nKey], m_aArena.data() + entry.nOffset);
+}
+
+unsigned long long ItemStringTable::GetMemoryUsage() const
+{
+	unsigned long long liUsage = m_aArena.capacity() + m_aEntry.capacity() * sizeof(Entry);
+	for (auto& sKey : m_asKey)
+		liUsage += sizeof(std::string) + sKey.capacity();
+	return liUsage;
+}
@@ -0,0 +1,132 @@
+#pragma once
+#include <map>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <functional>
+
+/*
+Item ID -> value table which is filled while ItemInfo is initialized and read-only afterwards.
+Build() moves the entries into a sorted ID array and a parallel value array, the IDs of each category (nItemID / 10000) are contiguous.
+A lookup jumps to the range of its category, and indexes it directly when the category has no gaps (the usual case) or binary searches it otherwise.
+*/
+template<typename T>
+class ItemTable
+{
+	std::map<int, T> m_mPending;
+	std::vector<int> m_anItemID;
+	std::vector<T> m_aValue;
+	std::vector<unsigned int> m_anCategoryBegin; //[nCategory - m_nMinCategory], one extra entry at the end.
+	int m_nMinCategory = 0;
+	bool m_bBuilt = false;
+
+public:
+	//Replaces the existing value, as std::map::operator[] does.
+	void Set(int nItemID, const T& value)
+	{
+		m_mPending[nItemID] = value;
+	}
+
+	//Keeps the existing value, as std::map::insert does.
+	void Insert(int nItemID, const T& value)
+	{
+		m_mPending.insert({ nItemID, value });
+	}
+
+	void Build()
+	{
+		for (auto& prItem : m_mPending)
+		{
+			m_anItemID.push_back(prItem.first);
+			m_aValue.push_back(prItem.second);
+		}
+		m_mPending.clear();
+		m_anItemID.shrink_to_fit();
+		m_aValue.shrink_to_fit();
+
+		m_anCategoryBegin.clear();
+		if (m_anItemID.size())
+		{
+			m_nMinCategory = m_anItemID.front() / 10000;
+			int nCategoryCount = m_anItemID.back() / 10000 - m_nMinCategory + 1;
+			m_anCategoryBegin.resize(nCategoryCount + 1, 0);
+			for (int i = 0, nIdx = 0; i <= nCategoryCount; ++i)
+			{
+				while (nIdx < (int)m_anItemID.size() && m_anItemID[nIdx] / 10000 - m_nMinCategory < i)
+					++nIdx;
+				m_anCategoryBegin[i] = (unsigned int)nIdx;
+			}
+		}
+		m_bBuilt = true;
+	}
+
+	const T* Find(int nItemID) const
+	{
+		if (!m_bBuilt)
+		{
+			auto findIter = m_mPending.find(nItemID);
+			return findIter == m_mPending.end() ? nullptr : &(findIter->second);
+		}
+
+		int nCategory = nItemID / 10000 - m_nMinCategory;
+		if (nItemID < 0 || nCategory < 0 || nCategory + 1 >= (int)m_anCategoryBegin.size())
+			return nullptr;
+		unsigned int nBegin = m_anCategoryBegin[nCategory], nEnd = m_anCategoryBegin[nCategory + 1];
+		if (nBegin == nEnd)
+			return nullptr;
+
+		int nFirstID = m_anItemID[nBegin];
+		if ((unsigned int)(m_anItemID[nEnd - 1] - nFirstID) == nEnd - nBegin - 1)
+		{
+			unsigned int nIdx = nBegin + (unsigned int)(nItemID - nFirstID);
+			return (nItemID >= nFirstID && nIdx < nEnd) ? &m_aValue[nIdx] : nullptr;
+		}
+		auto itID = std::lower_bound(m_anItemID.begin() + nBegin, m_anItemID.begin() + nEnd, nItemID);
+		return (itID != m_anItemID.begin() + nEnd && *itID == nItemID) ? &m_aValue[itID - m_anItemID.begin()] : nullptr;
+	}
+
+	T Get(int nItemID, const T& defaultValue) const
+	{
+		auto pValue = Find(nItemID);
+		return pValue ? *pValue : defaultValue;
+	}
+
+	const std::vector<int>& GetItemIDList() const
+	{
+		return m_anItemID;
+	}
+
+	unsigned long long GetMemoryUsage() const
+	{
+		return m_anItemID.capacity() * sizeof(int) + m_aValue.capacity() * sizeof(T) + m_anCategoryBegin.capacity() * sizeof(unsigned int);
+	}
+};
+
+/*
+String.wz entries (item names, descriptions, map names...) of every ID, stored back to back in one arena.
+The entries are sorted by (ID, key), the few distinct keys are interned.
+*/
+class ItemStringTable
+{
+	struct Entry
+	{
+		int nID;
+		unsigned int nKey, nOffset;
+	};
+
+	std::vector<char> m_aArena;
+	std::vector<Entry> m_aEntry;
+	std::vector<std::string> m_asKey;
+
+	unsigned int GetKey(const std::string& sKey) const;
+
+public:
+	void Add(int nID, const std::string& sKey, const std::string& sValue);
+	void Build();
+
+	//Returns nullptr if there is no such entry.
+	const char* Find(int nID, const std::string& sKey) const;
+	void ForEach(const std::function<void(int, const std::string&, const char*)>& fnVisit) const;
+	unsigned long long GetMemoryUsage() const;
+};
+
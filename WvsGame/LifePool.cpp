@@ -84,6 +84,14 @@ void LifePool::Init(Field* pField, int nFieldID)
 		[StringUtility::LeftPadding(std::to_string(nFieldID), 9, '0')];
 
 	auto& lifeData = mapWz["life"];
+
+	//Let the TemplateLoader threads load the mobs of this field while the spawn points are read.
+	std::vector<int> anMobTemplateID;
+	for (auto& node : lifeData)
+		if ((std::string)node["type"] == "m")
+			anMobTemplateID.push_back(atoi(((std::string)node["id"]).c_str()));
+	MobTemplate::Prewarm(anMobTemplateID);
+
 	for (auto& node : lifeData)
 	{
 		const auto &typeFlag = (std::string)node["type"];
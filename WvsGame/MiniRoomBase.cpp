@@ -69,8 +69,6 @@ int MiniRoomBase::GetMiniRoomSpec() const
 
 void MiniRoomBase::Broadcast(OutPacket * oPacket, User *pExcept)
 {
-	oPacket->GetSharedPacket()->ToggleBroadcasting();
-
 	std::lock_guard<std::recursive_mutex> lock(m_mtxMiniRoomLock);
 	for (int i = 0; i < m_nMaxUsers; ++i)
 	{
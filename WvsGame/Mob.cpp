@@ -895,7 +895,6 @@ void Mob::BroadcastHP()
 	oPacket.Encode2(MobSendPacketType::Mob_OnHPIndicator);
 	oPacket.Encode4(GetFieldObjectID());
 	oPacket.Encode1((char)((GetHP() / (double)GetMobTemplate()->m_liMaxHP) * 100));
-	oPacket.GetSharedPacket()->ToggleBroadcasting();
 
 	for (auto& prInfo : m_damageLog.mInfo)
 	{
@@ -8,7 +8,15 @@
 #include "..\WvsLib\Memory\MemoryPoolMan.hpp"
 #include "..\WvsLib\Wz\WzResMan.hpp"
 
-std::map<int, MobTemplate*>* MobTemplate::m_MobTemplates = new std::map<int, MobTemplate*>();
+TemplateRegistry<MobTemplate> MobTemplate::ms_Registry(
+	[]() {
+		std::vector<int> anTemplateID;
+		for (auto& mobNode : WzResMan::GetInstance()->GetWz(Wz::Mob))
+			anTemplateID.push_back(atoi(mobNode.GetName().c_str()));
+		return anTemplateID;
+	},
+	MobTemplate::RegisterMob
+);
 
 MobTemplate::MobTemplate()
 {
@@ -25,19 +33,20 @@ const std::vector<RewardInfo*>& MobTemplate::GetMobReward()
 
 MobTemplate* MobTemplate::GetMobTemplate(int dwTemplateID)
 {
-	auto iter = m_MobTemplates->find(dwTemplateID);
-	if (iter != m_MobTemplates->end())
-		return (*m_MobTemplates)[dwTemplateID];
+	return ms_Registry.Get(dwTemplateID);
+}
 
-	if (iter == m_MobTemplates->end()) 
-	{
-		RegisterMob(dwTemplateID); 
-		iter = m_MobTemplates->find(dwTemplateID);
-	}
-	return iter == m_MobTemplates->end() ? nullptr : iter->second;
+void MobTemplate::Prewarm(const std::vector<int>& anTemplateID)
+{
+	ms_Registry.Prewarm(anTemplateID);
+}
+
+TemplateRegistryStat MobTemplate::GetRegistryStat()
+{
+	return ms_Registry.GetStat();
 }
 
-void MobTemplate::RegisterMob(int dwTemplateID)
+MobTemplate* MobTemplate::RegisterMob(int dwTemplateID)
 {
 #undef max
 	auto& m_MobWzProperty = WzResMan::GetInstance()->GetWz(Wz::Mob);
@@ -48,7 +57,7 @@ void MobTemplate::RegisterMob(int dwTemplateID)
 		templateID = "0" + templateID;
 	auto& mobNode = (m_MobWzProperty)[templateID];
 	if (mobNode == empty)
-		return;
+		return nullptr;
 
 	auto& info = mobNode["info"];
 	auto pTemplate = AllocObj(MobTemplate);
@@ -136,7 +145,7 @@ void MobTemplate::RegisterMob(int dwTemplateID)
 	for (auto& pInfo : (*pTemplate->m_paMobReward))
 		pTemplate->m_unTotalRewardProb += pInfo->m_unWeight;
 
-	(*m_MobTemplates)[dwTemplateID] = pTemplate;
+	return pTemplate;
 }
 
 int MobTemplate::GetElementAttribute(const std::string& s, int *aElemAttr)
@@ -1,5 +1,6 @@
 #pragma once
 #include "FieldRect.h"
+#include "TemplateRegistry.h"
 #include <iostream>
 #include <vector>
 #include <map>
@@ -9,7 +10,7 @@ class User;
 
 class MobTemplate
 {
-	static std::map<int, MobTemplate*>* m_MobTemplates;
+	static TemplateRegistry<MobTemplate> ms_Registry;
 
 public:
 	const static int MAX_DAMAGED_ELEM_ATTR = 8;
@@ -54,7 +55,9 @@ public:
 	~MobTemplate();
 	const std::vector<RewardInfo*>& GetMobReward();
 	static MobTemplate* GetMobTemplate(int dwTemplateID);
-	static void RegisterMob(int dwTemplateID);
+	static MobTemplate* RegisterMob(int dwTemplateID);
+	static void Prewarm(const std::vector<int>& anTemplateID);
+	static TemplateRegistryStat GetRegistryStat();
 
 	//ElemAttr
 	static int GetElementAttribute(const std::string& s, int *aElemAttr);
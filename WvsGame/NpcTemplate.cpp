@@ -7,6 +7,7 @@
 #include "..\WvsLib\Memory\MemoryPoolMan.hpp"
 
 std::map<int, NpcTemplate*> NpcTemplate::m_mNpcTemplates;
+TemplateRegistry<NpcTemplate> NpcTemplate::ms_Registry;
 
 NpcTemplate::NpcTemplate()
 {
@@ -24,6 +25,7 @@ void NpcTemplate::Load()
 	{
 		RegisterNpc(atoi(refNpc.GetName().c_str()), &refNpc);
 	}
+	ms_Registry.Assign(m_mNpcTemplates);
 }
 
 void NpcTemplate::LoadShop()
@@ -72,10 +74,12 @@ void NpcTemplate::RegisterNpc(int nNpcID, void *pProp)
 
 NpcTemplate* NpcTemplate::GetNpcTemplate(int dwTemplateID)
 {
-	auto findIter = m_mNpcTemplates.find(dwTemplateID);
-	if (findIter == m_mNpcTemplates.end())
-		return nullptr;
-	return findIter->second;
+	return ms_Registry.Get(dwTemplateID);
+}
+
+TemplateRegistryStat NpcTemplate::GetRegistryStat()
+{
+	return ms_Registry.GetStat();
 }
 
 bool NpcTemplate::HasShop() const
@@ -2,6 +2,7 @@
 #include <map>
 #include <vector>
 #include <string>
+#include "TemplateRegistry.h"
 
 struct GW_ItemSlotBase;
 class User;
@@ -34,7 +35,8 @@ public:
 
 private:
 	int m_nTemplateID = 0, m_nTrunkPut = 0;
-	static std::map<int, NpcTemplate*> m_mNpcTemplates;
+	static std::map<int, NpcTemplate*> m_mNpcTemplates; //Filled by Load, then handed over to ms_Registry.
+	static TemplateRegistry<NpcTemplate> ms_Registry;
 	std::vector<ShopItem*> m_aShopItem;
 	std::string m_sScriptName;
 
@@ -49,6 +51,7 @@ public:
 	bool HasShop() const;
 	int GetTrunkCost() const;
 	static NpcTemplate* GetInstance();
+	static TemplateRegistryStat GetRegistryStat();
 	std::vector<ShopItem*>& GetShopItem();
 	void EncodeShop(User *pUser, OutPacket *oPacket);
 	static void EncodeShopItem(User *pUser, ShopItem* pItem, OutPacket *oPacket);
@@ -605,7 +605,6 @@ void PartyMan::Broadcast(OutPacket *oPacket, int * anCharacterID, int nPlusOne)
 {
 	std::lock_guard<std::recursive_mutex> lock(m_mtxPartyLock);
 
-	oPacket->GetSharedPacket()->ToggleBroadcasting();
 	if (nPlusOne != 0)
 	{
 		auto pUser = User::FindUser(nPlusOne);
@@ -939,7 +938,6 @@ void PartyMan::ChangeLevelOrJob(InPacket *iPacket, OutPacket *oPacket)
 
 void PartyMan::SendPacket(OutPacket *oPacket, PartyData *pParty)
 {
-	oPacket->GetSharedPacket()->ToggleBroadcasting();
 	bool bChannelSent[WvsWorld::MAX_CHANNEL_COUNT] { 0 };
 	for (int i = 0; i < MAX_PARTY_MEMBER_COUNT; ++i)
 	{
@@ -7,6 +7,7 @@
 #include "..\WvsLib\String\StringUtility.h"
 
 std::map<int, PetTemplate*> PetTemplate::ms_mTemplate;
+TemplateRegistry<PetTemplate> PetTemplate::ms_Registry;
 
 PetTemplate::PetTemplate()
 {
@@ -22,6 +23,7 @@ void PetTemplate::Load()
 	auto& wzPetFolder = WzResMan::GetInstance()->GetWz(Wz::Item)["Pet"];
 	for (auto& imgPet : wzPetFolder)
 		RegisterPet(atoi(imgPet.GetName().c_str()), &imgPet);
+	ms_Registry.Assign(ms_mTemplate);
 }
 
 void PetTemplate::RegisterPet(int nTemplateID, void * pData)
@@ -135,8 +137,12 @@ void PetTemplate::RegisterPet(int nTemplateID, void * pData)
 
 const PetTemplate * PetTemplate::GetPetTemplate(int nTemplateID)
 {
-	auto findIter = ms_mTemplate.find(nTemplateID);
-	return findIter == ms_mTemplate.end() ? nullptr : findIter->second;
+	return ms_Registry.Get(nTemplateID);
+}
+
+TemplateRegistryStat PetTemplate::GetRegistryStat()
+{
+	return ms_Registry.GetStat();
 }
 
 const PetTemplate * PetTemplate::GetRandEvolPetTemplate() const
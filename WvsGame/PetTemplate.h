@@ -2,6 +2,7 @@
 #include <map>
 #include <vector>
 #include <string>
+#include "TemplateRegistry.h"
 #include "..\WvsLib\Common\CommonDef.h"
 
 class PetTemplate
@@ -76,12 +77,14 @@ public:
 private:
 	PetTemplate();
 	~PetTemplate();
-	static std::map<int, PetTemplate*> ms_mTemplate;
+	static std::map<int, PetTemplate*> ms_mTemplate; //Filled by Load, then handed over to ms_Registry.
+	static TemplateRegistry<PetTemplate> ms_Registry;
 
 public:
 	static void Load();
 	static void RegisterPet(int nTemplateID, void *pData);
 	static const PetTemplate* GetPetTemplate(int nTemplateID);
+	static TemplateRegistryStat GetRegistryStat();
 	const PetTemplate* GetRandEvolPetTemplate() const;
 };
 
@@ -146,3 +146,13 @@ void PortalMap::ResetPortal()
 	for (auto pPortal : m_apPortal)
 		pPortal->SetEnable((pPortal->GetPortalType() == 4 || pPortal->GetPortalType() == 5));
 }
+
+void PortalMap::GetTargetFieldID(std::vector<int>& anFieldID) const
+{
+	for (auto pPortal : m_apPortal)
+	{
+		int nTargetMap = pPortal->GetTargetMap();
+		if (nTargetMap != 999999999 && std::find(anFieldID.begin(), anFieldID.end(), nTargetMap) == anFieldID.end())
+			anFieldID.push_back(nTargetMap);
+	}
+}
@@ -25,5 +25,6 @@ public:
 	Portal* GetRandStartPoint();
 	bool IsPortalNear(const std::list<FieldPoint>& aptRoute, int nXrange);
 	void ResetPortal();
+	void GetTargetFieldID(std::vector<int>& anFieldID) const;
 };
 
@@ -5,6 +5,7 @@
 #include "..\WvsLib\Memory\MemoryPoolMan.hpp"
 
 std::map<int, ReactorTemplate*> ReactorTemplate::m_mReactorTemplate;
+TemplateRegistry<ReactorTemplate> ReactorTemplate::ms_Registry;
 
 ReactorTemplate::ReactorTemplate()
 {
@@ -155,14 +156,17 @@ void ReactorTemplate::Load()
 	auto& ref = WzResMan::GetInstance()->GetWz(Wz::Reactor);
 	for (auto& reactor : ref)
 		RegisterReactor(atoi(reactor.GetName().c_str()), &reactor, &ref);
+	ms_Registry.Assign(m_mReactorTemplate);
 }
 
 ReactorTemplate * ReactorTemplate::GetReactorTemplate(int nTemplateID)
 {
-	auto findIter = m_mReactorTemplate.find(nTemplateID);
-	if (findIter == m_mReactorTemplate.end())
-		return nullptr;
-	return findIter->second;
+	return ms_Registry.Get(nTemplateID);
+}
+
+TemplateRegistryStat ReactorTemplate::GetRegistryStat()
+{
+	return ms_Registry.GetStat();
 }
 
 ReactorTemplate::StateInfo * ReactorTemplate::GetStateInfo(int nState)
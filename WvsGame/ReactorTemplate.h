@@ -4,6 +4,7 @@
 #include <map>
 #include "FieldPoint.h"
 #include "FieldRect.h"
+#include "TemplateRegistry.h"
 #include "..\WvsLib\Common\CommonDef.h"
 
 struct RewardInfo;
@@ -50,7 +51,8 @@ class ReactorTemplate
 	bool m_bRemoveInFieldSet = false;
 
 	ReactorTemplate();
-	static std::map<int, ReactorTemplate*> m_mReactorTemplate;
+	static std::map<int, ReactorTemplate*> m_mReactorTemplate; //Filled by Load, then handed over to ms_Registry.
+	static TemplateRegistry<ReactorTemplate> ms_Registry;
 public:
 
 	static void RegisterReactor(int nTemplateID, void *pImg, void *pRoot);
@@ -58,6 +60,7 @@ public:
 	static void LoadAction(ReactorTemplate* pTemplate, const std::string& sAction);
 	static void Load();
 	static ReactorTemplate* GetReactorTemplate(int nTemplateID);
+	static TemplateRegistryStat GetRegistryStat();
 
 	StateInfo* GetStateInfo(int nState);
 	EventInfo* GetEventInfo(int nState, int nEventIdx);
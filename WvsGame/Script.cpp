@@ -1,4 +1,5 @@
 #include "Script.h"
+#include "ScriptMan.h"
 #include <memory>
 #include "User.h"
 #include "QWUser.h"
@@ -277,9 +278,9 @@ bool Script::IsDone()
 
 bool Script::Init()
 {
-	if (luaL_loadfile(L, m_fileName.c_str())) 
+	if (ScriptMan::GetInstance()->LoadChunk(L, m_fileName)) 
 	{
-		WvsLogger::LogFormat(WvsLogger::LEVEL_ERROR, "Error, Unable to open the specific script: %s.\n", m_fileName.c_str());
+		WvsLogger::LogSubsystem(WvsLogger::SUB_SCRIPT, WvsLogger::SEV_ERROR, "Error, Unable to open the specific script: %s.\n", m_fileName.c_str());
 		OnError();
 		return false;
 	}
@@ -288,7 +289,7 @@ bool Script::Init()
 
 void Script::OnError()
 {
-	WvsLogger::LogFormat(WvsLogger::LEVEL_ERROR, "Script Error: %s\n", lua_tostring(L, -1));
+	WvsLogger::LogSubsystem(WvsLogger::SUB_SCRIPT, WvsLogger::SEV_ERROR, "Script Error: %s\n", lua_tostring(L, -1));
 	lua_pop(L, 1);
 }
 
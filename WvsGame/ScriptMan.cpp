@@ -9,31 +9,71 @@
 #include "ScriptField.h"
 #include "ScriptPortal.h"
 #include <functional>
+#include <fstream>
+#include <thread>
+#include <chrono>
 #include <experimental\filesystem>
 #include "..\WvsLib\Task\AsyncScheduler.h"
 #include "..\WvsLib\Memory\MemoryPoolMan.hpp"
+#include "..\WvsLib\Logger\WvsLogger.h"
 
-const std::string & ScriptMan::SearchScriptNameByFunc(const std::string& sType, const std::string & sFunc)
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <unistd.h>
+#include <sys/inotify.h>
+#endif
+
+namespace fs = std::experimental::filesystem;
+
+static const std::string asScriptType[] =
+{
+	"Npc",
+	"Portal",
+	"Quest"
+};
+
+//Context of a watcher thread, see StartScriptWatcher.
+struct ScriptWatchContext
 {
-	std::lock_guard<std::recursive_mutex> lock(m_mtxLock);
-	static std::string sEmpty = "";
-	auto& mTable = m_mFuncToFile[sType];
-	auto findIter = mTable.find(sFunc);
-	if (findIter == mTable.end())
-		return sEmpty;
+#ifdef _WIN32
+	std::string sType, sDirectory;
+	HANDLE hDirectory = INVALID_HANDLE_VALUE;
+#else
+	int nFD = -1;
+	std::map<int, std::pair<std::string, std::string>> mWatch; //Watch descriptor -> (Type, Directory)
+
+	void AddWatch(const std::string& sType, const std::string& sDirectory)
+	{
+		int nWatch = inotify_add_watch(nFD, sDirectory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_CREATE);
+		if (nWatch >= 0)
+			mWatch[nWatch] = { sType, sDirectory };
+	}
+#endif
+};
+
+std::string ScriptMan::SearchScriptNameByFunc(const std::string& sType, const std::string & sFunc)
+{
+	auto pIndex = std::atomic_load(&m_pFuncIndex);
+	auto findType = pIndex->mFuncToFile.find(sType);
+	if (findType == pIndex->mFuncToFile.end())
+		return "";
+	auto findIter = findType->second.find(sFunc);
+	if (findIter == findType->second.end())
+		return "";
 
 	return findIter->second;
 }
 
 #pragma warning(disable:4503) //Disable warning of exceeded name-length of m_mFuncToFile.
-void ScriptMan::RegisterScriptFunc(const std::string& sType, const std::string & sScriptPath)
+void ScriptMan::RegisterScriptFunc(ScriptFuncIndex& index, const std::string& sType, const std::string & sScriptPath)
 {
-	auto &mFileTable = m_mFileToFunc[sType];
-	auto &mFuncTable = m_mFuncToFile[sType];
+	auto &mFileTable = index.mFileToFunc[sType];
+	auto &mFuncTable = index.mFuncToFile[sType];
 
 	for (auto& prFunc : mFileTable[sScriptPath])
 		mFuncTable.erase(prFunc);
-	mFuncTable.erase(sScriptPath);
+	mFileTable.erase(sScriptPath);
 
 	auto pScript = CreateScript(sScriptPath, { 0, nullptr });
 	if (!pScript)
@@ -74,29 +114,160 @@ void ScriptMan::RegisterScriptFunc(const std::string& sType, const std::string &
 	//FreeObj(pScript);
 }
 
+void ScriptMan::ReloadScripts(const std::set<std::pair<std::string, std::string>>& setScript)
+{
+	if (setScript.empty())
+		return;
+
+	//Reloads are serialized, the searches keep reading the former index until the new one is swapped in.
+	std::lock_guard<std::mutex> lock(m_mtxReload);
+	auto pIndex = std::make_shared<ScriptFuncIndex>(*std::atomic_load(&m_pFuncIndex));
+	for (auto& prScript : setScript)
+		RegisterScriptFunc(*pIndex, prScript.first, prScript.second);
+	std::atomic_store(&m_pFuncIndex, std::shared_ptr<const ScriptFuncIndex>(pIndex));
+	m_liReloadCount += setScript.size();
+}
+
 void ScriptMan::ScriptFileMonitor()
 {
-	static std::string sTable[] =
+	std::set<std::pair<std::string, std::string>> setScript;
+	for (auto& sType : asScriptType)
 	{
-		"Npc",
-		"Portal",
-		"Quest"
-	};
+		for (auto &file : fs::recursive_directory_iterator("./DataSrv/Script/" + sType))
+		{
+			if (fs::is_directory(file.status()))
+				continue;
+			auto fTime = fs::last_write_time(file);
+			auto& fLastTime = m_mFileTime[file.path().string()];
+			if (fTime != fLastTime)
+			{
+				fLastTime = fTime;
+				setScript.insert({ sType, file.path().string() });
+			}
+		}
+	}
+	ReloadScripts(setScript);
+}
 
-	std::lock_guard<std::recursive_mutex> lock(m_mtxLock);
+bool ScriptMan::StartScriptWatcher()
+{
+#ifdef _WIN32
+	std::vector<ScriptWatchContext*> apContext;
+	for (auto& sType : asScriptType)
+	{
+		auto pContext = new ScriptWatchContext;
+		pContext->sType = sType;
+		pContext->sDirectory = "./DataSrv/Script/" + sType;
+		pContext->hDirectory = CreateFileA(
+			pContext->sDirectory.c_str(),
+			FILE_LIST_DIRECTORY,
+			FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+			NULL,
+			OPEN_EXISTING,
+			FILE_FLAG_BACKUP_SEMANTICS,
+			NULL
+		);
+		apContext.push_back(pContext);
+		if (pContext->hDirectory == INVALID_HANDLE_VALUE)
+		{
+			for (auto pOpened : apContext)
+			{
+				if (pOpened->hDirectory != INVALID_HANDLE_VALUE)
+					CloseHandle(pOpened->hDirectory);
+				delete pOpened;
+			}
+			return false;
+		}
+	}
+	for (auto pContext : apContext)
+		std::thread(&ScriptMan::ScriptWatcherThread, this, (void*)pContext).detach();
+	m_sMonitor = "ReadDirectoryChangesW";
+#else
+	auto pContext = new ScriptWatchContext;
+	pContext->nFD = inotify_init1(IN_CLOEXEC);
+	if (pContext->nFD < 0)
+	{
+		delete pContext;
+		return false;
+	}
+	//inotify isn't recursive, every sub directory is watched on its own.
+	for (auto& sType : asScriptType)
+	{
+		pContext->AddWatch(sType, "./DataSrv/Script/" + sType);
+		for (auto &file : fs::recursive_directory_iterator("./DataSrv/Script/" + sType))
+			if (fs::is_directory(file.status()))
+				pContext->AddWatch(sType, file.path().string());
+	}
+	std::thread(&ScriptMan::ScriptWatcherThread, this, (void*)pContext).detach();
+	m_sMonitor = "inotify";
+#endif
+	return true;
+}
 
-	for (auto& sType : sTable)
+void ScriptMan::ScriptWatcherThread(void *pContext)
+{
+	auto pWatch = (ScriptWatchContext*)pContext;
+	while (true)
 	{
-		for (auto &file : std::experimental::filesystem::recursive_directory_iterator("./DataSrv/Script/" + sType))
+		std::set<std::pair<std::string, std::string>> setScript;
+#ifdef _WIN32
+		alignas(DWORD) char aBuffer[16 * 1024];
+		DWORD dwBytes = 0;
+		if (!ReadDirectoryChangesW(pWatch->hDirectory, aBuffer, sizeof(aBuffer), TRUE, FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE, &dwBytes, NULL, NULL))
+			break;
+
+		//The notifications overflowed the buffer, every script of this type is reloaded.
+		if (dwBytes == 0)
+			for (auto &file : fs::recursive_directory_iterator(pWatch->sDirectory))
+				if (!fs::is_directory(file.status()))
+					setScript.insert({ pWatch->sType, file.path().string() });
+
+		for (DWORD dwOffset = 0; dwBytes; )
 		{
-			auto fTime = std::experimental::filesystem::last_write_time(file);
-			if (fTime != m_mFileTime[file.path().string()])
+			auto pInfo = (FILE_NOTIFY_INFORMATION*)(aBuffer + dwOffset);
+			auto fPath = fs::path(pWatch->sDirectory) / std::wstring(pInfo->FileName, pInfo->FileNameLength / sizeof(WCHAR));
+			if (!fs::is_directory(fPath))
+				setScript.insert({ pWatch->sType, fPath.string() });
+			if (!pInfo->NextEntryOffset)
+				break;
+			dwOffset += pInfo->NextEntryOffset;
+		}
+#else
+		alignas(inotify_event) char aBuffer[16 * 1024];
+		auto nRead = read(pWatch->nFD, aBuffer, sizeof(aBuffer));
+		if (nRead <= 0)
+			break;
+
+		for (char *pEvent = aBuffer; pEvent < aBuffer + nRead; pEvent += sizeof(inotify_event) + ((inotify_event*)pEvent)->len)
+		{
+			auto pInfo = (inotify_event*)pEvent;
+			auto findIter = pWatch->mWatch.find(pInfo->wd);
+			if (findIter == pWatch->mWatch.end() || !pInfo->len)
+				continue;
+
+			auto sPath = (fs::path(findIter->second.second) / pInfo->name).string();
+			if (pInfo->mask & IN_ISDIR)
 			{
-				m_mFileTime[file.path().string()] = fTime;
-				RegisterScriptFunc(sType, file.path().string());
+				//Scripts moved in along with a new directory don't raise their own events.
+				if (pInfo->mask & (IN_CREATE | IN_MOVED_TO))
+				{
+					pWatch->AddWatch(findIter->second.first, sPath);
+					for (auto &file : fs::recursive_directory_iterator(sPath))
+						if (fs::is_directory(file.status()))
+							pWatch->AddWatch(findIter->second.first, file.path().string());
+						else
+							setScript.insert({ findIter->second.first, file.path().string() });
+				}
 			}
+			else if (!(pInfo->mask & IN_CREATE)) //Wait for IN_CLOSE_WRITE of a new file.
+				setScript.insert({ findIter->second.first, sPath });
 		}
+#endif
+		//An editor usually saves in several writes, let them settle before reloading.
+		std::this_thread::sleep_for(std::chrono::milliseconds(200));
+		ReloadScripts(setScript);
 	}
+	WvsLogger::LogSubsystem(WvsLogger::SUB_SCRIPT, WvsLogger::SEV_ERROR, "ScriptMan stopped watching the script directory.\n");
 }
 
 ScriptMan *ScriptMan::GetInstance()
@@ -107,28 +278,157 @@ ScriptMan *ScriptMan::GetInstance()
 
 void ScriptMan::RegisterScriptFuncReflector()
 {
-	static std::string sTable[] = 
+	std::set<std::pair<std::string, std::string>> setScript;
+	for (auto& sType : asScriptType)
 	{
-		"Npc",
-		"Portal",
-		"Quest"
-	};
+		for (auto &file : fs::recursive_directory_iterator("./DataSrv/Script/" + sType))
+		{
+			if (fs::is_directory(file.status()))
+				continue;
+			m_mFileTime[file.path().string()] = fs::last_write_time(file);
+			setScript.insert({ sType, file.path().string() });
+		}
+	}
+	ReloadScripts(setScript);
 
-	for (auto sType : sTable)
+	if (!StartScriptWatcher())
+	{
+		m_sMonitor = "Polling";
+		auto pTimer = AsyncScheduler::CreateTask(std::bind(&ScriptMan::ScriptFileMonitor, this), 5000, true);
+		pTimer->Start();
+	}
+	WvsLogger::LogSubsystem(WvsLogger::SUB_SCRIPT, WvsLogger::SEV_INFO, "ScriptMan registered %d script(s), changes are detected by %s.\n", (int)setScript.size(), m_sMonitor);
+}
+
+static int ScriptChunkWriter(lua_State *L, const void *p, size_t sz, void *ud)
+{
+	((std::string*)ud)->append((const char*)p, sz);
+	return 0;
+}
+
+int ScriptMan::LoadChunk(lua_State * L, const std::string & sFile)
+{
+	auto tStart = std::chrono::steady_clock::now();
+	std::string sChunkName = "@" + sFile;
+	std::error_code ec;
+	auto tLastWrite = fs::last_write_time(sFile, ec);
+	if (ec)
 	{
-		for (auto &file : std::experimental::filesystem::recursive_directory_iterator("./DataSrv/Script/" + sType))
+		lua_pushfstring(L, "cannot open %s", sFile.c_str());
+		return LUA_ERRFILE;
+	}
+
+	bool bCompiled = false;
+	std::shared_ptr<const ScriptChunk> pChunk;
+	{
+		std::lock_guard<std::mutex> lock(m_mtxChunk);
+		auto findIter = m_mChunk.find(sFile);
+		if (findIter != m_mChunk.end())
+			pChunk = findIter->second;
+	}
+	if (!pChunk || pChunk->tLastWrite != tLastWrite)
+	{
+		std::ifstream fsSource(sFile, std::ios::binary);
+		std::string sSource((std::istreambuf_iterator<char>(fsSource)), std::istreambuf_iterator<char>());
+		if (!fsSource.good() && !fsSource.eof())
 		{
-			m_mFileTime[file.path().string()] = std::experimental::filesystem::last_write_time(file);
-			RegisterScriptFunc(sType, file.path().string());
+			lua_pushfstring(L, "cannot read %s", sFile.c_str());
+			return LUA_ERRFILE;
 		}
+
+		unsigned long long liSourceHash = 0xCBF29CE484222325ULL;
+		for (auto c : sSource)
+		{
+			liSourceHash ^= (unsigned char)c;
+			liSourceHash *= 0x100000001B3ULL;
+		}
+
+		auto pNewChunk = std::make_shared<ScriptChunk>();
+		pNewChunk->tLastWrite = tLastWrite;
+		pNewChunk->liSourceHash = liSourceHash;
+
+		//Touched without being modified.
+		if (pChunk && pChunk->liSourceHash == liSourceHash)
+			pNewChunk->sByteCode = pChunk->sByteCode;
+		else
+		{
+			//Skip the BOM and the first line comment as luaL_loadfile does, the line numbers are kept.
+			size_t uBegin = sSource.compare(0, 3, "\xEF\xBB\xBF") == 0 ? 3 : 0;
+			if (uBegin < sSource.size() && sSource[uBegin] == '#')
+			{
+				auto uLineEnd = sSource.find('\n', uBegin);
+				uBegin = uLineEnd == std::string::npos ? sSource.size() : uLineEnd;
+			}
+			int nResult = luaL_loadbufferx(L, sSource.data() + uBegin, sSource.size() - uBegin, sChunkName.c_str(), nullptr);
+			if (nResult != LUA_OK)
+				return nResult;
+			lua_dump(L, ScriptChunkWriter, &pNewChunk->sByteCode, 0);
+			lua_pop(L, 1);
+			bCompiled = true;
+		}
+		std::lock_guard<std::mutex> lock(m_mtxChunk);
+		m_mChunk[sFile] = pNewChunk;
+		pChunk = pNewChunk;
+	}
+
+	int nResult = luaL_loadbufferx(L, pChunk->sByteCode.data(), pChunk->sByteCode.size(), sChunkName.c_str(), "b");
+	auto liElapsed = (unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - tStart).count();
+	if (bCompiled)
+	{
+		++m_liChunkCompile;
+		m_liCompileTimeInNs += liElapsed;
+	}
+	else
+	{
+		++m_liChunkHit;
+		m_liHitTimeInNs += liElapsed;
+	}
+	return nResult;
+}
+
+//Replaces the Lua file searcher of require, so the required files share the chunk cache.
+static int ScriptChunkSearcher(lua_State *L)
+{
+	const char *sName = luaL_checkstring(L, 1);
+	lua_getglobal(L, "package");
+	lua_getfield(L, -1, "searchpath");
+	lua_pushvalue(L, 1);
+	lua_getfield(L, -3, "path");
+	lua_call(L, 2, 2);
+	if (lua_isnil(L, -2))
+		return 1; //The message of the paths tried.
+
+	std::string sFile = lua_tostring(L, -2);
+	if (ScriptMan::GetInstance()->LoadChunk(L, sFile) != LUA_OK)
+		return luaL_error(L, "error loading module '%s' from file '%s':\n\t%s", sName, sFile.c_str(), lua_tostring(L, -1));
+	lua_pushstring(L, sFile.c_str());
+	return 2;
+}
+
+ScriptManStat ScriptMan::GetStat()
+{
+	ScriptManStat stat;
+	auto pIndex = std::atomic_load(&m_pFuncIndex);
+	for (auto& prType : pIndex->mFuncToFile)
+		stat.nFuncCount += (int)prType.second.size();
+	{
+		std::lock_guard<std::mutex> lock(m_mtxChunk);
+		stat.nChunkCount = (int)m_mChunk.size();
+		for (auto& prChunk : m_mChunk)
+			stat.liChunkBytes += prChunk.second->sByteCode.size();
 	}
-	auto pTimer = AsyncScheduler::CreateTask(std::bind(&ScriptMan::ScriptFileMonitor, this), 5000, true);
-	pTimer->Start();
+	stat.liChunkHit = m_liChunkHit;
+	stat.liChunkCompile = m_liChunkCompile;
+	stat.liReloadCount = m_liReloadCount;
+	stat.liHitTimeInNs = m_liHitTimeInNs;
+	stat.liCompileTimeInNs = m_liCompileTimeInNs;
+	stat.sMonitor = m_sMonitor;
+	return stat;
 }
 
 Script* ScriptMan::CreateScript(const std::string& sFile, const std::pair<int, Field*>& prParam)
 {
-	if (!std::experimental::filesystem::exists(sFile))
+	if (!fs::exists(sFile))
 		return nullptr;
 
 	static std::vector<void(*)(lua_State*)> aRegFunc = {
@@ -147,6 +447,12 @@ Script* ScriptMan::CreateScript(const std::string& sFile, const std::pair<int, F
 	{
 		pScript->m_pOnPacketInvoker = &(ScriptNPC::OnPacket);
 		luaL_openlibs(pScript->L);
+
+		lua_getglobal(pScript->L, "package");
+		lua_getfield(pScript->L, -1, "searchers");
+		lua_pushcfunction(pScript->L, ScriptChunkSearcher);
+		lua_rawseti(pScript->L, -2, 2);
+		lua_pop(pScript->L, 2);
 		return pScript;
 	}
 	else if (pScript)
@@ -157,4 +463,4 @@ Script* ScriptMan::CreateScript(const std::string& sFile, const std::pair<int, F
 	}
 
 	return pScript;
-}
\ No newline at end of file
+}
@@ -4,7 +4,10 @@
 #include <vector>
 #include <iostream>
 #include <map>
+#include <set>
 #include <mutex>
+#include <memory>
+#include <atomic>
 #include <experimental\filesystem>
 
 #include "Script.h"
@@ -20,25 +23,60 @@
 
 class Field;
 
+struct ScriptManStat
+{
+	int nFuncCount = 0, nChunkCount = 0;
+	unsigned long long liChunkBytes = 0, liChunkHit = 0, liChunkCompile = 0, liReloadCount = 0;
+	unsigned long long liHitTimeInNs = 0, liCompileTimeInNs = 0;
+	const char* sMonitor = "";
+};
+
 class ScriptMan
 {
-	std::recursive_mutex m_mtxLock;
+	//Built aside and swapped in as a whole, readers never wait for a reload.
+	struct ScriptFuncIndex
+	{
+		std::map<std::string, std::map<std::string, std::string>> mFuncToFile;
+		std::map<std::string, std::map<std::string, std::vector<std::string>>> mFileToFunc;
+	};
+
+	//Precompiled chunk (lua_dump) of a script file, recompiled when the file is modified.
+	struct ScriptChunk
+	{
+		std::experimental::filesystem::v1::file_time_type tLastWrite;
+		unsigned long long liSourceHash = 0;
+		std::string sByteCode;
+	};
 
-	std::map<std::string, std::map<std::string, std::string>> m_mFuncToFile;
-	std::map<std::string, std::map<std::string, std::vector<std::string>>> m_mFileToFunc;
+	std::shared_ptr<const ScriptFuncIndex> m_pFuncIndex = std::make_shared<ScriptFuncIndex>();
+	std::mutex m_mtxReload;
+
+	std::mutex m_mtxChunk;
+	std::map<std::string, std::shared_ptr<const ScriptChunk>> m_mChunk;
+	std::atomic<unsigned long long> m_liChunkHit{ 0 }, m_liChunkCompile{ 0 }, m_liReloadCount{ 0 };
+	std::atomic<unsigned long long> m_liHitTimeInNs{ 0 }, m_liCompileTimeInNs{ 0 };
 
 	//This sh_t should be replaced after C++ 17 is officially released.
+	//Only touched by the polling monitor, which is used when the file system can't notify the changes.
 	std::map<std::string, std::experimental::filesystem::v1::file_time_type> m_mFileTime;
+	const char* m_sMonitor = "None";
 
-	void RegisterScriptFunc(const std::string& sType, const std::string& sScriptPath);
+	void RegisterScriptFunc(ScriptFuncIndex& index, const std::string& sType, const std::string& sScriptPath);
+	void ReloadScripts(const std::set<std::pair<std::string, std::string>>& setScript);
 	void ScriptFileMonitor();
+	bool StartScriptWatcher();
+	void ScriptWatcherThread(void *pContext);
 public:
 
 	static ScriptMan* GetInstance();
 	void RegisterScriptFuncReflector();
-	const std::string& SearchScriptNameByFunc(const std::string& sType, const std::string& sFunc);
+	std::string SearchScriptNameByFunc(const std::string& sType, const std::string& sFunc);
+
+	//Pushes the compiled chunk of sFile as luaL_loadfile does, the error message is pushed instead if it fails.
+	int LoadChunk(lua_State* L, const std::string& sFile);
+	ScriptManStat GetStat();
 
 	//GetScript would cause memory leak... currently have no idea.
 	//If "Init" return failed result then memory leak would occur again.
 	Script* CreateScript(const std::string& sFile, const std::pair<int, Field*>& prParam);
-};
\ No newline at end of file
+};
@@ -448,7 +448,7 @@ int ScriptNPC::Debug(lua_State * L)
 {
 	Script* self = (Script*)(L->selfPtr);
 	const char* text = luaL_checkstring(L, 2);
-	WvsLogger::LogFormat(WvsLogger::LEVEL_ERROR, "[Script Debug]%s\n", text);
+	WvsLogger::LogSubsystem(WvsLogger::SUB_SCRIPT, WvsLogger::SEV_DEBUG, "[Script Debug]%s\n", text);
 	return 1;
 }
 
@@ -240,8 +240,11 @@ void SecondaryStat::EncodeForLocal(OutPacket * oPacket, TemporaryStat::TS_Flag &
 			(this->*ms_aEncoder[i])(oPacket, flag);
 	}
 
-	WvsLogger::LogRaw(WvsLogger::LEVEL_INFO, "Encode Local TS : \n");
-	oPacket->Print();
+	if (WvsLogger::ShouldDumpPacket())
+	{
+		WvsLogger::LogRaw(WvsLogger::LEVEL_INFO, "Encode Local TS : \n");
+		oPacket->Print();
+	}
 }
 
 void SecondaryStat::EncodeForRemote(OutPacket * oPacket, TemporaryStat::TS_Flag & flag)
@@ -2,6 +2,7 @@
 #include "..\WvsLib\Logger\WvsLogger.h"
 #include "..\WvsLib\Wz\WzResMan.hpp"
 #include "..\WvsLib\Random\Rand32.h"
+#include "..\WvsLib\Evaluator\Evaluator.h"
 #include "..\Database\GA_Character.hpp"
 #include "..\Database\GW_CharacterStat.h"
 #include "..\Database\GW_CharacterLevel.h"
@@ -32,15 +33,23 @@
 
 #include <thread>
 #include <unordered_map>
-
-auto t1 = std::chrono::high_resolution_clock::now();
+#include <algorithm>
 
 #define CHECK_SKILL_ATTRIBUTE(var, attribute) if(attributeSet.find(#attribute) != attributeSetEnd) (mappingTable[(&(var)) - pAttributeBase]=(std::string)skillCommonImg[#attribute]);
-#define PARSE_SKILLDATA(attribute) ((int)skillCommonImg[#attribute]);
+#define PARSE_SKILLDATA(attribute) ParseSkillData(skillCommonImg[#attribute], d);
+
+//Level nodes usually hold numbers, a string is a formula of the skill level x (e.g. "u(x/2)").
+static int ParseSkillData(WzIterator node, double dLevel)
+{
+	if (node.GetValueType() == WzDelayedVariant::vt_String)
+		return (int)Evaluator::Eval((const std::string&)node, dLevel);
+	return (int)node;
+}
 
 SkillInfo::SkillInfo()
 {
 	m_nOnLoadingSkills = 0;
+	m_nNextSkillRoot = 0;
 }
 
 
@@ -374,14 +383,37 @@ void SkillInfo::LoadMCGuardian()
 	}
 }
 
-void SkillInfo::IterateSkillInfo()
+void SkillInfo::IterateSkillInfo(int nWorkerCount)
 {
-	t1 = std::chrono::high_resolution_clock::now();
+	auto t1 = std::chrono::high_resolution_clock::now();
 	WvsLogger::LogRaw("[SkillInfo::IterateSkillInfo<IterateSkillInfo>]On iterating all skills....\n");
+	PrepareSkillRoot();
+
+	if (nWorkerCount <= 0)
+		nWorkerCount = (std::max)(2, (int)std::thread::hardware_concurrency());
+	nWorkerCount = (std::min)(nWorkerCount, (std::max)(1, m_nRootCount));
+
+	//A single worker loads on the calling thread.
+	if (nWorkerCount == 1)
+		LoadQueuedSkillRoot();
+	else
+	{
+		std::vector<std::thread> aWorker;
+		for (int i = 0; i < nWorkerCount; ++i)
+			aWorker.push_back(std::thread(&SkillInfo::LoadQueuedSkillRoot, this));
+		for (auto& worker : aWorker)
+			worker.join();
+	}
+
+	auto t2 = std::chrono::high_resolution_clock::now();
+	WvsLogger::LogFormat("[SkillInfo::IterateSkillInfo<IterateSkillInfo>]Skill information are completely loaded in %lld us.\n", std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count());
+}
+
+void SkillInfo::PrepareSkillRoot()
+{
 	static auto& skillWz = WzResMan::GetInstance()->GetWz(Wz::Skill);
-	bool continued = false;
-	int nRootID;
-	static std::vector<std::pair<int, std::string>> aRoot;
+	m_aSkillRoot.clear();
+	m_nNextSkillRoot = 0;
 	auto& aChildName = skillWz.EnumerateChildName();
 	for (auto& sName : aChildName)
 	{
@@ -389,24 +421,24 @@ void SkillInfo::IterateSkillInfo()
 			continue;
 
 		++m_nOnLoadingSkills;
-		aRoot.push_back({ atoi(sName.c_str()), sName });
-	}
+		m_aSkillRoot.push_back({ atoi(sName.c_str()), sName });
 
-	m_nRootCount = (int)aRoot.size();
-	for (auto& node : aRoot)
-	{
-		nRootID = node.first;
-		std::thread t(&SkillInfo::LoadSkillRoot, this, nRootID, (node.second));
-		t.detach();
+		//Created up front, the loading threads only insert into their own root.
+		if (m_mSkillByRootID.find(m_aSkillRoot.back().first) == m_mSkillByRootID.end())
+			m_mSkillByRootID.insert({ m_aSkillRoot.back().first, new std::map<int, SkillEntry*>() });
 	}
+	m_nRootCount = (int)m_aSkillRoot.size();
+}
+
+void SkillInfo::LoadQueuedSkillRoot()
+{
+	for (int nIdx = m_nNextSkillRoot++; nIdx < (int)m_aSkillRoot.size(); nIdx = m_nNextSkillRoot++)
+		LoadSkillRoot(m_aSkillRoot[nIdx].first, m_aSkillRoot[nIdx].second);
 }
 
 void SkillInfo::LoadSkillRoot(int nSkillRootID, const std::string& sName)
 {
 	static auto& skillWz = WzResMan::GetInstance()->GetWz(Wz::Skill);
-	auto skillRootIter = m_mSkillByRootID.find(nSkillRootID);
-	if (skillRootIter == m_mSkillByRootID.end()) 
-		m_mSkillByRootID.insert({nSkillRootID, new std::map<int, SkillEntry*>() });
 	auto& skillRootImg = skillWz[sName]["skill"];
 	int nSkillID = 0;
 	for (auto& skillImg : skillRootImg)
@@ -415,12 +447,6 @@ void SkillInfo::LoadSkillRoot(int nSkillRootID, const std::string& sName)
 		LoadSkill(nSkillRootID, nSkillID, (void*)&skillImg);
 	}
 	--m_nOnLoadingSkills;
-	if (m_nOnLoadingSkills == 0 && m_mSkillByRootID.size() >= m_nRootCount) 
-	{
-		auto t2 = std::chrono::high_resolution_clock::now();
-		WzResMan::GetInstance()->RemountAll();
-		WvsLogger::LogFormat("[SkillInfo::IterateSkillInfo<IterateSkillInfo>]Skill information are completely loaded in %lld us.\n", std::chrono::duration_cast<std::chrono::microseconds>(t2 - t1).count());
-	}
 }
 
 SkillEntry * SkillInfo::LoadSkill(int nSkillRootID, int nSkillID, void * pData)
@@ -470,7 +496,7 @@ void SkillInfo::LoadLevelDataByLevelNode(int nSkillID, SkillEntry * pEntry, void
 	{
 		//if(nSkillID > 1000000)
 		//	printf("IterateLevel[%s] : h%d, onLoading = %s\n", skillCommonImg.GetName().c_str(), ++nLevel, ((std::string)skillCommonImg["hs"]).c_str());
-		//d = atof(skillCommonImg.GetName().c_str());
+		d = atof(skillCommonImg.GetName().c_str());
 
 		SkillLevelData* pLevelData = AllocObj(SkillLevelData);
 		pLevelData->m_nAcc = PARSE_SKILLDATA(acc);
@@ -798,17 +824,16 @@ bool SkillInfo::AdjustConsumeForActiveSkill(User * pUser, int nSkillID, int nSLV
 
 int SkillInfo::GetBundleItemMaxPerSlot(int nItemID, GA_Character * pCharacterData)
 {
-	auto pItem = ItemInfo::GetInstance()->GetBundleItem(nItemID);
-	if (pItem != nullptr)
+	//0 if it isn't a bundle item, bundles without slotMax were given 100 when loaded.
+	int result = ItemInfo::GetInstance()->GetMaxPerSlot(nItemID);
+	if (result != 0)
 	{
-		int result = pItem->nMaxPerSlot;
 		if (pCharacterData != nullptr &&  nItemID / 10000 == 207)
 		{
 			//Ƿt
 		}
-		return result == 0 ? 100 : result;
 	}
-	return 0;
+	return result;
 }
 
 int SkillInfo::GetElementAttribute(const char cAttr)
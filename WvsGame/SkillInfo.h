@@ -1,5 +1,7 @@
 #pragma once
 #include <map>
+#include <vector>
+#include <string>
 #include <mutex>
 #include <atomic>
 
@@ -16,6 +18,9 @@ class SkillInfo
 	//How many root img should be processed parallelly
 	int m_nRootCount = 0;
 	std::atomic<int> m_nOnLoadingSkills;
+	//The roots found by PrepareSkillRoot, LoadQueuedSkillRoot takes them in order from m_nNextSkillRoot.
+	std::vector<std::pair<int, std::string>> m_aSkillRoot;
+	std::atomic<int> m_nNextSkillRoot;
 	std::mutex m_mtxSkillResLock;
 	std::map<int, std::map<int, SkillEntry*> *> m_mSkillByRootID;
 	std::map<int, MobSkillEntry*> m_mMobSKill;
@@ -57,7 +62,11 @@ public:
 	void LoadMobSkillLeveData(MobSkillEntry* pEntry, void *pData);
 	void LoadMCSkill();
 	void LoadMCGuardian();
-	void IterateSkillInfo();
+	//Loads the skill roots on nWorkerCount threads (<= 0 means the number of hardware threads) and returns when all are loaded.
+	void IterateSkillInfo(int nWorkerCount = 0);
+	//Queues the skill roots, any number of threads may then call LoadQueuedSkillRoot to load them together.
+	void PrepareSkillRoot();
+	void LoadQueuedSkillRoot();
 	void LoadSkillRoot(int nSkillRootID, const std::string& sName);
 	SkillEntry* LoadSkill(int nSkillRootID, int nSkillID, void* pData);
 	void LoadLevelDataByLevelNode(int nSkillID, SkillEntry* pEntry, void* pData, void *pRoot);
@@ -0,0 +1,62 @@
+#include "TemplateRegistry.h"
+#include "..\WvsLib\Logger\WvsLogger.h"
+#include <thread>
+
+TemplateLoader::TemplateLoader()
+{
+}
+
+TemplateLoader * TemplateLoader::GetInstance()
+{
+	static TemplateLoader *pInstance = new TemplateLoader();
+	return pInstance;
+}
+
+void TemplateLoader::Start(int nWorkerCount)
+{
+	int nExpected = 0;
+	if (nWorkerCount <= 0 || !m_nWorkerCount.compare_exchange_strong(nExpected, nWorkerCount))
+		return;
+	for (int i = 0; i < nWorkerCount; ++i)
+		std::thread(&TemplateLoader::WorkerThread, this).detach();
+	WvsLogger::LogFormat("TemplateLoader started with %d thread(s).\n", nWorkerCount);
+}
+
+bool TemplateLoader::Submit(std::function<void()> fnTask)
+{
+	if (!IsRunning())
+		return false;
+	{
+		std::lock_guard<std::mutex> lock(m_mtxQueue);
+		m_qTask.push_back(std::move(fnTask));
+	}
+	m_cvQueue.notify_one();
+	return true;
+}
+
+bool TemplateLoader::IsRunning() const
+{
+	return m_nWorkerCount > 0;
+}
+
+void TemplateLoader::WorkerThread()
+{
+	while (true)
+	{
+		std::function<void()> fnTask;
+		{
+			std::unique_lock<std::mutex> lock(m_mtxQueue);
+			m_cvQueue.wait(lock, [this]() { return !m_qTask.empty(); });
+			fnTask = std::move(m_qTask.front());
+			m_qTask.pop_front();
+		}
+		try
+		{
+			fnTask();
+		}
+		catch (std::exception& ex)
+		{
+			WvsLogger::LogFormat(WvsLogger::LEVEL_ERROR, "TemplateLoader failed to load a template: %s\n", ex.what());
+		}
+	}
+}
@@ -0,0 +1,223 @@
+#pragma once
+#include <map>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <algorithm>
+#include <functional>
+#include <condition_variable>
+
+/*
+Background threads which load templates ahead of their first use (see TemplateRegistry::Prewarm).
+*/
+class TemplateLoader
+{
+	std::mutex m_mtxQueue;
+	std::condition_variable m_cvQueue;
+	std::deque<std::function<void()>> m_qTask;
+	std::atomic<int> m_nWorkerCount{ 0 };
+
+	TemplateLoader();
+	void WorkerThread();
+
+public:
+	static TemplateLoader* GetInstance();
+
+	//Only the first call takes effect, Submit is refused until then.
+	void Start(int nWorkerCount);
+	bool Submit(std::function<void()> fnTask);
+	bool IsRunning() const;
+};
+
+struct TemplateRegistryStat
+{
+	int nCount = 0, nLoadedCount = 0;
+	unsigned long long liLoadCount = 0, liWaitCount = 0, liPrewarmCount = 0;
+};
+
+/*
+Registry of the templates of one kind, keyed by template ID.
+The set of IDs is fixed when the registry is indexed, each ID owns a slot whose template is published once and never changes.
+Reading a loaded template is a binary search followed by an acquire load, no lock is taken.
+
+Missing templates are loaded by the first caller while concurrent callers of the same ID wait for it.
+Prewarm queues templates on the TemplateLoader threads, a caller which reaches a queued template before the loader does loads it itself.
+*/
+template<typename T>
+class TemplateRegistry
+{
+	enum SlotState : unsigned char
+	{
+		Slot_None,
+		Slot_Queued,
+		Slot_Loading,
+		Slot_Done,
+	};
+
+	struct Slot
+	{
+		std::atomic<T*> pTemplate{ nullptr };
+		std::atomic<unsigned char> nState{ Slot_None };
+	};
+
+	std::once_flag m_flagIndex;
+	std::function<std::vector<int>()> m_fnIndex;
+	std::function<T*(int)> m_fnLoad;
+
+	std::vector<int> m_anID;
+	std::unique_ptr<Slot[]> m_aSlot;
+
+	std::mutex m_mtxWait;
+	std::condition_variable m_cvWait;
+	std::atomic<unsigned long long> m_liLoadCount{ 0 }, m_liWaitCount{ 0 }, m_liPrewarmCount{ 0 };
+
+	void BuildIndex(std::vector<int> anID)
+	{
+		std::sort(anID.begin(), anID.end());
+		anID.erase(std::unique(anID.begin(), anID.end()), anID.end());
+		m_anID = std::move(anID);
+		m_aSlot.reset(new Slot[m_anID.size()]);
+	}
+
+	void EnsureIndex()
+	{
+		std::call_once(m_flagIndex, [this]() { BuildIndex(m_fnIndex ? m_fnIndex() : std::vector<int>()); });
+	}
+
+	Slot* FindSlot(int nID)
+	{
+		EnsureIndex();
+		auto itID = std::lower_bound(m_anID.begin(), m_anID.end(), nID);
+		if (itID == m_anID.end() || *itID != nID)
+			return nullptr;
+		return &m_aSlot[itID - m_anID.begin()];
+	}
+
+	//The caller has moved the slot to Slot_Loading.
+	T* Load(Slot *pSlot, int nID)
+	{
+		T *pTemplate = nullptr;
+		try
+		{
+			pTemplate = m_fnLoad ? m_fnLoad(nID) : nullptr;
+		}
+		catch (...)
+		{
+			//Let the next caller try again.
+			Publish(pSlot, nullptr, Slot_None);
+			throw;
+		}
+		++m_liLoadCount;
+		Publish(pSlot, pTemplate, Slot_Done);
+		return pTemplate;
+	}
+
+	void Publish(Slot *pSlot, T *pTemplate, unsigned char nState)
+	{
+		pSlot->pTemplate.store(pTemplate, std::memory_order_release);
+		{
+			std::lock_guard<std::mutex> lock(m_mtxWait);
+			pSlot->nState.store(nState, std::memory_order_release);
+		}
+		m_cvWait.notify_all();
+	}
+
+public:
+	TemplateRegistry()
+	{
+	}
+
+	//Templates loaded on demand, fnIndex lists every ID that fnLoad can load and is called on the first access.
+	TemplateRegistry(std::function<std::vector<int>()> fnIndex, std::function<T*(int)> fnLoad)
+		: m_fnIndex(fnIndex),
+		  m_fnLoad(fnLoad)
+	{
+	}
+
+	//Templates loaded at startup, the registry takes over the content of mTemplate.
+	//It has to be called before the first Get, which would otherwise fix an empty index.
+	void Assign(std::map<int, T*>& mTemplate)
+	{
+		std::call_once(m_flagIndex, [this, &mTemplate]() {
+			std::vector<int> anID;
+			anID.reserve(mTemplate.size());
+			for (auto& prTemplate : mTemplate)
+				anID.push_back(prTemplate.first);
+			BuildIndex(std::move(anID));
+			for (int i = 0; i < (int)m_anID.size(); ++i)
+			{
+				m_aSlot[i].pTemplate.store(mTemplate[m_anID[i]], std::memory_order_relaxed);
+				m_aSlot[i].nState.store(Slot_Done, std::memory_order_release);
+			}
+		});
+		mTemplate.clear();
+	}
+
+	T* Get(int nID)
+	{
+		auto pSlot = FindSlot(nID);
+		if (!pSlot)
+			return nullptr;
+		if (pSlot->nState.load(std::memory_order_acquire) == Slot_Done)
+			return pSlot->pTemplate.load(std::memory_order_acquire);
+
+		while (true)
+		{
+			unsigned char nState = pSlot->nState.load(std::memory_order_acquire);
+			if (nState == Slot_Done)
+				return pSlot->pTemplate.load(std::memory_order_acquire);
+			if (nState != Slot_Loading)
+			{
+				if (pSlot->nState.compare_exchange_strong(nState, Slot_Loading))
+					return Load(pSlot, nID);
+				continue;
+			}
+			++m_liWaitCount;
+			std::unique_lock<std::mutex> lock(m_mtxWait);
+			m_cvWait.wait(lock, [pSlot]() { return pSlot->nState.load() != Slot_Loading; });
+		}
+	}
+
+	void Prewarm(const std::vector<int>& anID)
+	{
+		if (!TemplateLoader::GetInstance()->IsRunning())
+			return;
+		for (int nID : anID)
+		{
+			auto pSlot = FindSlot(nID);
+			unsigned char nState = Slot_None;
+			if (!pSlot || !pSlot->nState.compare_exchange_strong(nState, Slot_Queued))
+				continue;
+			bool bSubmitted = TemplateLoader::GetInstance()->Submit([this, pSlot, nID]() {
+				unsigned char nState = Slot_Queued;
+				if (pSlot->nState.compare_exchange_strong(nState, Slot_Loading))
+				{
+					++m_liPrewarmCount;
+					Load(pSlot, nID);
+				}
+			});
+			if (!bSubmitted)
+			{
+				nState = Slot_Queued;
+				pSlot->nState.compare_exchange_strong(nState, Slot_None);
+			}
+		}
+	}
+
+	TemplateRegistryStat GetStat()
+	{
+		EnsureIndex();
+		TemplateRegistryStat stat;
+		stat.nCount = (int)m_anID.size();
+		for (int i = 0; i < stat.nCount; ++i)
+			if (m_aSlot[i].nState.load() == Slot_Done)
+				++stat.nLoadedCount;
+		stat.liLoadCount = m_liLoadCount;
+		stat.liWaitCount = m_liWaitCount;
+		stat.liPrewarmCount = m_liPrewarmCount;
+		return stat;
+	}
+};
+
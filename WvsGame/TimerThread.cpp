@@ -1,10 +1,21 @@
 #include "TimerThread.h"
 #include "..\WvsLib\Task\AsyncScheduler.h"
 #include "..\WvsLib\Memory\MemoryPoolMan.hpp"
-#include "..\WvsLib\Random\Rand32.h"
 #include "Field.h"
+#include "..\WvsLib\DateTime\GameDateTime.h"
+#include <algorithm>
+#include <chrono>
 
 std::vector<TimerThread*> TimerThread::m_aTimerPool;
+std::vector<TimerThread::FieldEntry*> TimerThread::m_aFieldEntry;
+std::mutex TimerThread::m_mtxBalance;
+std::atomic<unsigned long long> TimerThread::m_liRoundCount;
+
+TimerThread::FieldEntry::FieldEntry()
+{
+	for (auto& liCount : aHistogram)
+		liCount = 0;
+}
 
 TimerThread::TimerThread()
 {
@@ -16,10 +27,170 @@ TimerThread::~TimerThread()
 }
 
 void TimerThread::Update()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mtxMutex);
+
+		//Costly fields go first so that the short ones can fill the gaps (and be stolen).
+		std::sort(m_aFieldToUpdate.begin(), m_aFieldToUpdate.end(), [](FieldEntry *pLeft, FieldEntry *pRight) {
+			return pLeft->liAvgCost > pRight->liAvgCost;
+		});
+
+		//Fields left from the last tick (if it was overrun) are updated again in this round.
+		m_qRunQueue.clear();
+		for (auto& pEntry : m_aFieldToUpdate)
+		{
+			if (pEntry->pField->IsHibernating() ||
+				(pEntry->pField->GetUserCount() == 0 && ++pEntry->nIdleTick < IDLE_TICK_INTERVAL))
+				continue;
+			pEntry->nIdleTick = 0;
+			m_qRunQueue.push_back(pEntry);
+		}
+		m_nRunQueueSize = (int)m_qRunQueue.size();
+	}
+
+	FieldEntry *pEntry = nullptr;
+	while ((pEntry = PopOwn()) != nullptr)
+		UpdateField(pEntry);
+
+	//Help the busiest TimerThread until every queue is drained.
+	while (true)
+	{
+		TimerThread *pVictim = nullptr;
+		int nMaxQueueSize = 0;
+		for (auto& pTimer : m_aTimerPool)
+			if (pTimer != this && pTimer->m_nRunQueueSize > nMaxQueueSize)
+			{
+				nMaxQueueSize = pTimer->m_nRunQueueSize;
+				pVictim = pTimer;
+			}
+		if (!pVictim)
+			break;
+		if ((pEntry = StealFrom(pVictim)) != nullptr)
+			UpdateField(pEntry);
+	}
+
+	if (m_nIdx == 0 && (++m_liRoundCount % REBALANCE_INTERVAL) == 0)
+		Rebalance();
+}
+
+TimerThread::FieldEntry* TimerThread::PopOwn()
 {
 	std::lock_guard<std::mutex> lock(m_mtxMutex);
-	for (auto& pField : m_aFieldToUpdate)
-		pField->Update();
+	if (m_qRunQueue.empty())
+		return nullptr;
+	auto pEntry = m_qRunQueue.front();
+	m_qRunQueue.pop_front();
+	m_nRunQueueSize = (int)m_qRunQueue.size();
+	return pEntry;
+}
+
+TimerThread::FieldEntry* TimerThread::StealFrom(TimerThread *pVictim)
+{
+	std::lock_guard<std::mutex> lock(pVictim->m_mtxMutex);
+	if (pVictim->m_qRunQueue.empty())
+		return nullptr;
+	auto pEntry = pVictim->m_qRunQueue.back();
+	pVictim->m_qRunQueue.pop_back();
+	pVictim->m_nRunQueueSize = (int)pVictim->m_qRunQueue.size();
+	return pEntry;
+}
+
+void TimerThread::UpdateField(FieldEntry *pEntry)
+{
+	//The same field may be queued by an overrun round and the current one, never update it concurrently.
+	bool bExpected = false;
+	if (!pEntry->bUpdating.compare_exchange_strong(bExpected, true))
+		return;
+
+	auto tBegin = std::chrono::steady_clock::now();
+	try
+	{
+		pEntry->pField->Update();
+	}
+	catch (...)
+	{
+		pEntry->bUpdating = false;
+		throw;
+	}
+	unsigned long long liCost = (unsigned long long)std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - tBegin
+	).count();
+	pEntry->bUpdating = false;
+	if (pEntry->pField->GetUserCount() == 0)
+		pEntry->pField->TryHibernate(GameDateTime::GetTime());
+
+	unsigned long long liAvgCost = pEntry->liAvgCost;
+	pEntry->liAvgCost = pEntry->liTickCount++ == 0 ? liCost : (liAvgCost - liAvgCost / 8 + liCost / 8);
+	if (liCost > pEntry->liMaxCost)
+		pEntry->liMaxCost = liCost;
+
+	int nBucket = 0;
+	for (unsigned long long liScaled = liCost / 16; liScaled && nBucket < HISTOGRAM_SIZE - 1; liScaled >>= 1)
+		++nBucket;
+	++pEntry->aHistogram[nBucket];
+}
+
+unsigned long long TimerThread::GetLoad()
+{
+	unsigned long long liLoad = 0;
+	for (auto& pEntry : m_aFieldToUpdate)
+		if (!pEntry->pField->IsHibernating())
+			liLoad += pEntry->liAvgCost;
+	return liLoad;
+}
+
+void TimerThread::Rebalance()
+{
+	std::lock_guard<std::mutex> balanceLock(m_mtxBalance);
+	if (m_aTimerPool.size() < 2)
+		return;
+
+	//Move a few fields from the most loaded TimerThread to the least loaded one, each move must reduce the gap.
+	for (int nMove = 0; nMove < 4; ++nMove)
+	{
+		TimerThread *pMax = nullptr, *pMin = nullptr;
+		unsigned long long liMaxLoad = 0, liMinLoad = 0;
+		for (auto& pTimer : m_aTimerPool)
+		{
+			std::lock_guard<std::mutex> lock(pTimer->m_mtxMutex);
+			auto liLoad = pTimer->GetLoad();
+			if (!pMax || liLoad > liMaxLoad)
+			{
+				pMax = pTimer;
+				liMaxLoad = liLoad;
+			}
+			if (!pMin || liLoad < liMinLoad)
+			{
+				pMin = pTimer;
+				liMinLoad = liLoad;
+			}
+		}
+		if (pMax == pMin || liMaxLoad - liMinLoad <= liMaxLoad / 4)
+			return;
+
+		std::unique_lock<std::mutex> lockMax(pMax->m_mtxMutex, std::defer_lock), lockMin(pMin->m_mtxMutex, std::defer_lock);
+		std::lock(lockMax, lockMin);
+
+		auto itCandidate = pMax->m_aFieldToUpdate.end();
+		unsigned long long liGap = liMaxLoad - liMinLoad, liBestCost = 0;
+		for (auto it = pMax->m_aFieldToUpdate.begin(); it != pMax->m_aFieldToUpdate.end(); ++it)
+		{
+			unsigned long long liCost = (*it)->liAvgCost;
+			if (liCost > liBestCost && liCost < liGap)
+			{
+				itCandidate = it;
+				liBestCost = liCost;
+			}
+		}
+		if (itCandidate == pMax->m_aFieldToUpdate.end())
+			return;
+
+		auto pEntry = *itCandidate;
+		pMax->m_aFieldToUpdate.erase(itCandidate);
+		pMin->m_aFieldToUpdate.push_back(pEntry);
+		pEntry->pOwner = pMin;
+	}
 }
 
 void TimerThread::RegisterTimerPool(int nTimerCount, int nTick)
@@ -30,23 +201,69 @@ void TimerThread::RegisterTimerPool(int nTimerCount, int nTick)
 	for (int i = 0; i < nTimerCount; ++i)
 	{
 		pThreadTimer = AllocObj(TimerThread);
+		pThreadTimer->m_nIdx = i;
 		pThreadTimer->m_aFieldToUpdate.clear();
 		auto timerBind = std::bind(&(TimerThread::Update), pThreadTimer);
 		pTimer = AsyncScheduler::CreateTask(timerBind, nTick, true);
 		pThreadTimer->m_pTimer = pTimer;
-		pTimer->Start();
 		m_aTimerPool.push_back(pThreadTimer);
 	}
+
+	//Start after the pool is complete since Update() walks m_aTimerPool for stealing.
+	for (auto& pThreadTimer : m_aTimerPool)
+		pThreadTimer->m_pTimer->Start();
 }
 
 void TimerThread::RegisterField(Field * pField)
 {
-	int nIdx = (int) (Rand32::GetInstance()->Random() % m_aTimerPool.size());
-	m_aTimerPool[nIdx]->RegisterFieldImpl(pField);
+	std::lock_guard<std::mutex> balanceLock(m_mtxBalance);
+	auto pEntry = AllocObj(FieldEntry);
+	pEntry->pField = pField;
+	m_aFieldEntry.push_back(pEntry);
+
+	//New fields have no measured cost yet, place them on the least loaded (then least populated) TimerThread.
+	TimerThread *pTarget = nullptr;
+	unsigned long long liMinLoad = 0;
+	size_t nMinCount = 0;
+	for (auto& pTimer : m_aTimerPool)
+	{
+		std::lock_guard<std::mutex> lock(pTimer->m_mtxMutex);
+		auto liLoad = pTimer->GetLoad();
+		if (!pTarget || liLoad < liMinLoad || (liLoad == liMinLoad && pTimer->m_aFieldToUpdate.size() < nMinCount))
+		{
+			pTarget = pTimer;
+			liMinLoad = liLoad;
+			nMinCount = pTimer->m_aFieldToUpdate.size();
+		}
+	}
+	pTarget->RegisterFieldImpl(pEntry);
 }
 
-void TimerThread::RegisterFieldImpl(Field * pField)
+void TimerThread::RegisterFieldImpl(FieldEntry * pEntry)
 {
 	std::lock_guard<std::mutex> lock(m_mtxMutex);
-	m_aFieldToUpdate.push_back(pField);
+	pEntry->pOwner = this;
+	m_aFieldToUpdate.push_back(pEntry);
+}
+
+std::vector<TimerThread::FieldTickStat> TimerThread::GetFieldTickStat()
+{
+	std::lock_guard<std::mutex> balanceLock(m_mtxBalance);
+	std::vector<FieldTickStat> aRet;
+	aRet.reserve(m_aFieldEntry.size());
+	for (auto& pEntry : m_aFieldEntry)
+	{
+		FieldTickStat stat;
+		stat.nFieldID = pEntry->pField->GetFieldID();
+		stat.nUserCount = pEntry->pField->GetUserCount();
+		stat.bHibernating = pEntry->pField->IsHibernating();
+		stat.nOwner = pEntry->pOwner ? pEntry->pOwner->m_nIdx : -1;
+		stat.liTickCount = pEntry->liTickCount;
+		stat.liAvgCost = pEntry->liAvgCost;
+		stat.liMaxCost = pEntry->liMaxCost;
+		for (int i = 0; i < HISTOGRAM_SIZE; ++i)
+			stat.aHistogram[i] = pEntry->aHistogram[i];
+		aRet.push_back(stat);
+	}
+	return aRet;
 }
@@ -1,29 +1,76 @@
 #pragma once
 #include <vector>
+#include <deque>
 #include <mutex>
+#include <atomic>
 #include "..\WvsLib\Common\CommonDef.h"
 
 class Field;
 class AsyncScheduler;
 
+/*
+Field update scheduler.
+Each TimerThread owns a set of fields balanced by their measured update cost, on every tick it queues its fields
+(crowded ones first, empty ones only every IDLE_TICK_INTERVAL ticks and hibernating ones not at all) and drains the queue without holding a lock during Field::Update.
+A TimerThread which finished its own queue steals the remaining fields of the busiest TimerThread.
+*/
 class TimerThread
 {
-	ALLOW_PRIVATE_ALLOC 
+	ALLOW_PRIVATE_ALLOC
+
+public:
+	static const int HISTOGRAM_SIZE = 16; //Bucket i counts ticks taking < 2^i * 16 us, the last one counts the rest.
+	static const int IDLE_TICK_INTERVAL = 5;
+	static const int REBALANCE_INTERVAL = 10;
+
+	struct FieldTickStat
+	{
+		int nFieldID = 0, nUserCount = 0, nOwner = 0;
+		bool bHibernating = false;
+		unsigned long long liTickCount = 0, liAvgCost = 0, liMaxCost = 0;
+		unsigned long long aHistogram[HISTOGRAM_SIZE] = { 0 };
+	};
+
+private:
+	struct FieldEntry
+	{
+		Field *pField = nullptr;
+		TimerThread *pOwner = nullptr;
+		std::atomic<bool> bUpdating{ false };
+		std::atomic<unsigned long long> liAvgCost{ 0 }, liMaxCost{ 0 }, liTickCount{ 0 };
+		std::atomic<unsigned long long> aHistogram[HISTOGRAM_SIZE];
+		unsigned int nIdleTick = 0;
+
+		FieldEntry();
+	};
 
 	static std::vector<TimerThread*> m_aTimerPool;
+	static std::vector<FieldEntry*> m_aFieldEntry;
+	static std::mutex m_mtxBalance;
+	static std::atomic<unsigned long long> m_liRoundCount;
 
+	int m_nIdx = 0;
 	AsyncScheduler* m_pTimer;
-	std::vector<Field*> m_aFieldToUpdate;
+	std::vector<FieldEntry*> m_aFieldToUpdate;
+	std::deque<FieldEntry*> m_qRunQueue;
+	std::atomic<int> m_nRunQueueSize{ 0 };
 	std::mutex m_mtxMutex;
 
 	TimerThread();
 	~TimerThread();
 
 	void Update();
-	void RegisterFieldImpl(Field *pField);
+	void RegisterFieldImpl(FieldEntry *pEntry);
+	unsigned long long GetLoad();
+	FieldEntry* PopOwn();
+	FieldEntry* StealFrom(TimerThread *pVictim);
+	static void UpdateField(FieldEntry *pEntry);
+	static void Rebalance();
+
 public:
 
 	static void RegisterTimerPool(int nTimerCount, int nTick);
 	static void RegisterField(Field *pField);
+	static std::vector<FieldTickStat> GetFieldTickStat();
 };
 
@@ -9,7 +9,6 @@
 #endif 
 
 #ifdef _WVSCENTER
-#include "..\WvsCenter\WvsWorld.h"
 #include "..\Database\TrunkDBAccessor.h"
 #endif
 
@@ -292,7 +291,7 @@ Trunk* Trunk::Load(int nAccountID)
 	return pRet;
 }
 
-void Trunk::MoveSlotToTrunk(int nClientSocketID, int nAccountID, int nCharacterID, InPacket *iPacket)
+void Trunk::MoveSlotToTrunk(int nClientSocketID, int nAccountID, int nCharacterID, InPacket *iPacket, OutPacket *oPacket)
 {
 	int nTI = iPacket->Decode1();
 	ZSharedPtr<GW_ItemSlotBase> pItem = (nTI == GW_ItemSlotBase::EQUIP ?
@@ -320,22 +319,17 @@ void Trunk::MoveSlotToTrunk(int nClientSocketID, int nAccountID, int nCharacterI
 	pItem->Save(-1);
 	TrunkDBAccessor::MoveSlotToTrunk(nAccountID, pItem->liItemSN, nTI);
 
-	OutPacket oPacket;
-	oPacket.Encode2(CenterResultPacketType::TrunkResult);
-	oPacket.Encode4(nClientSocketID);
-	oPacket.Encode4(nCharacterID);
-	oPacket.Encode1(TrunkResult::res_Trunk_MoveSlotToTrunk);
-	oPacket.Encode1(nTI);
-	oPacket.Encode2(nPOS);
-	oPacket.Encode2(nNumber);
-	pItem->RawEncode(&oPacket);
-
-	auto pwUser = WvsWorld::GetInstance()->GetUser(nCharacterID);
-	if (pwUser)
-		pwUser->SendPacket(&oPacket);
+	oPacket->Encode2(CenterResultPacketType::TrunkResult);
+	oPacket->Encode4(nClientSocketID);
+	oPacket->Encode4(nCharacterID);
+	oPacket->Encode1(TrunkResult::res_Trunk_MoveSlotToTrunk);
+	oPacket->Encode1(nTI);
+	oPacket->Encode2(nPOS);
+	oPacket->Encode2(nNumber);
+	pItem->RawEncode(oPacket);
 }
 
-void Trunk::MoveTrunkToSlot(int nClientSocketID, int nAccountID, int nCharacterID, InPacket *iPacket)
+void Trunk::MoveTrunkToSlot(int nClientSocketID, int nAccountID, int nCharacterID, InPacket *iPacket, OutPacket *oPacket)
 {
 	int nTI = iPacket->Decode1();
 	int nPOS = iPacket->Decode1();
@@ -353,20 +347,15 @@ void Trunk::MoveTrunkToSlot(int nClientSocketID, int nAccountID, int nCharacterI
 		pItem->liItemSN = -1;
 
 	TrunkDBAccessor::MoveTrunkToSlot(nAccountID, liItemSN, nTI, bTreatSingly);
-	OutPacket oPacket;
-	oPacket.Encode2(CenterResultPacketType::TrunkResult);
-	oPacket.Encode4(nClientSocketID);
-	oPacket.Encode4(nCharacterID);
-	oPacket.Encode1(TrunkResult::res_Trunk_MoveTrunkToSlot);
-	oPacket.Encode1(nTI);
-	oPacket.Encode1(nPOS);
-
-	auto pwUser = WvsWorld::GetInstance()->GetUser(nCharacterID);
-	if (pwUser)
-		pwUser->SendPacket(&oPacket);
+	oPacket->Encode2(CenterResultPacketType::TrunkResult);
+	oPacket->Encode4(nClientSocketID);
+	oPacket->Encode4(nCharacterID);
+	oPacket->Encode1(TrunkResult::res_Trunk_MoveTrunkToSlot);
+	oPacket->Encode1(nTI);
+	oPacket->Encode1(nPOS);
 }
 
-void Trunk::WithdrawMoney(int nClientSocketID, int nAccountID, int nCharacterID, InPacket * iPacket)
+void Trunk::WithdrawMoney(int nClientSocketID, int nAccountID, int nCharacterID, InPacket *iPacket, OutPacket *oPacket)
 {
 	int nSlotCount = iPacket->Decode1();
 	int nMoney = iPacket->Decode4();
@@ -374,18 +363,13 @@ void Trunk::WithdrawMoney(int nClientSocketID, int nAccountID, int nCharacterID,
 	TrunkDBAccessor::UpdateTrunk(nAccountID, nMoney, nSlotCount);
 	auto prTrunk = TrunkDBAccessor::LoadTrunk(nAccountID);
 
-	OutPacket oPacket;
-	oPacket.Encode2(CenterResultPacketType::TrunkResult);
-	oPacket.Encode4(nClientSocketID);
-	oPacket.Encode4(nCharacterID);
-	oPacket.Encode1(TrunkResult::res_Trunk_WithdrawMoney);
-	oPacket.Encode1(1);
-	oPacket.Encode1(prTrunk.first);
-	oPacket.Encode4(prTrunk.second);
-
-	auto pwUser = WvsWorld::GetInstance()->GetUser(nCharacterID);
-	if (pwUser)
-		pwUser->SendPacket(&oPacket);
+	oPacket->Encode2(CenterResultPacketType::TrunkResult);
+	oPacket->Encode4(nClientSocketID);
+	oPacket->Encode4(nCharacterID);
+	oPacket->Encode1(TrunkResult::res_Trunk_WithdrawMoney);
+	oPacket->Encode1(1);
+	oPacket->Encode1(prTrunk.first);
+	oPacket->Encode4(prTrunk.second);
 }
 
 #endif
\ No newline at end of file
@@ -51,8 +51,8 @@ public:
 	void OnWithdrawMoneyDone(User *pUser, InPacket *iPacket);
 
 	//CENTER
-	void MoveSlotToTrunk(int nClientSocketID, int nAccountID, int nCharacterID, InPacket *iPacket);
-	void MoveTrunkToSlot(int nClientSocketID, int nAccountID, int nCharacterID, InPacket *iPacket);
-	void WithdrawMoney(int nClientSocketID, int nAccountID, int nCharacterID, InPacket *iPacket);
+	void MoveSlotToTrunk(int nClientSocketID, int nAccountID, int nCharacterID, InPacket *iPacket, OutPacket *oPacket);
+	void MoveTrunkToSlot(int nClientSocketID, int nAccountID, int nCharacterID, InPacket *iPacket, OutPacket *oPacket);
+	void WithdrawMoney(int nClientSocketID, int nAccountID, int nCharacterID, InPacket *iPacket, OutPacket *oPacket);
 };
 
@@ -114,6 +114,7 @@ User::User(ClientSocket *pSocket, InPacket *iPacket)
 	pSocket->SetUser(this);
 	m_pCharacterData->nAccountID = iPacket->Decode4();
 	m_pCharacterData->DecodeCharacterData(iPacket, true);
+	m_pCharacterData->ResetCharacterDataDelta();
 	m_pFuncKeyMapped.reset(MakeUnique<GW_FuncKeyMapped>(m_pCharacterData->nCharacterID));
 	m_pFuncKeyMapped->Decode(iPacket);
 
@@ -144,17 +145,32 @@ User::User(ClientSocket *pSocket, InPacket *iPacket)
 void User::EncodeCharacterDataInternal(OutPacket *oPacket)
 {
 	m_pCharacterData->EncodeCharacterData(oPacket, true);
-	m_pFuncKeyMapped->Encode(oPacket, true);
+
+	//The whole key map, the Center hands it to the next server without loading it.
+	m_pFuncKeyMapped->Encode(oPacket);
 }
 
 void User::FlushCharacterData()
 {
 	OutPacket oPacket;
 	oPacket.Encode2(CenterRequestPacketType::FlushCharacterData);
-	EncodeCharacterDataInternal(&oPacket);
+
+	//Only the records changed since the last flush are sent, the migration out still sends (and saves) everything.
+	m_pCharacterData->EncodeCharacterDataDelta(&oPacket);
+	m_pFuncKeyMapped->Encode(&oPacket, true);
+	for (auto& prKey : m_pFuncKeyMapped->m_mKeyMapped)
+		prKey.second.bModified = false;
 	WvsBase::GetInstance<WvsGame>()->GetCenter()->SendPacket(&oPacket);
 }
 
+void User::OnFlushCharacterDataFailed()
+{
+	std::lock_guard<std::recursive_mutex> lock(m_mtxUserLock);
+	m_pCharacterData->ClearCharacterDataDelta();
+	for (auto& prKey : m_pFuncKeyMapped->m_mKeyMapped)
+		prKey.second.bModified = true;
+}
+
 User::~User()
 {
 	std::lock_guard<std::recursive_mutex> lock(m_mtxUserLock);
@@ -3166,7 +3182,7 @@ ZSharedPtr<User> User::FindUserByName(const std::string & strName)
 
 void User::Broadcast(OutPacket *oPacket)
 {
-	std::lock_guard<std::recursive_mutex>(WvsBase::GetInstance<WvsGame>()->GetUserLock());
+	std::lock_guard<std::recursive_mutex> lock(WvsBase::GetInstance<WvsGame>()->GetUserLock());
 	auto& mUser = WvsBase::GetInstance<WvsGame>()->GetConnectedUser();
 	for (auto& prUser : mUser)
 		prUser.second->SendPacket(oPacket);
@@ -4086,7 +4102,6 @@ void User::PostHPToPartyMembers()
 	oPacket.Encode4(GetUserID());
 	oPacket.Encode4((int)QWUser::GetHP(this));
 	oPacket.Encode4((int)m_pCharacterData->mStat->nMaxHP);
-	oPacket.GetSharedPacket()->ToggleBroadcasting();
 
 	auto pParty = PartyMan::GetInstance()->GetPartyByCharID(GetUserID());
 	User *pUser = nullptr;
@@ -195,6 +195,9 @@ public:
 	User(ClientSocket *pSocket, InPacket *iPacket);
 	void EncodeCharacterDataInternal(OutPacket *oPacket);
 	void FlushCharacterData();
+
+	//The Center failed to save a flush, the next one sends the whole character (and key map) again.
+	void OnFlushCharacterDataFailed();
 	~User();
 
 	//Basic Routine
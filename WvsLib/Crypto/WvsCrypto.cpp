@@ -11,8 +11,165 @@
 #include "..\Common\CryptoConstants.hpp"
 #include "..\Common\ServerConstants.hpp"
 
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define WVS_CRYPTO_AESNI_POSSIBLE
+#include <wmmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define WVS_CRYPTO_AESNI_TARGET
+#else
+#include <cpuid.h>
+#define WVS_CRYPTO_AESNI_TARGET __attribute__((target("aes,sse2")))
+#endif
+#endif
+
 namespace WvsCrypto
 {
+	/*
+	The AES key never changes, so the key schedule is expanded once per process (for both the portable and the AES-NI path).
+	The schedule is read-only after construction, so it can be shared among all I/O threads.
+	*/
+	struct AESKeySchedule
+	{
+		aes_encrypt_ctx m_aCtx[1];
+		bool m_bAESNI = false;
+
+#ifdef WVS_CRYPTO_AESNI_POSSIBLE
+		__m128i m_aRoundKey[15];
+
+		static bool HasAESNI()
+		{
+#if defined(_MSC_VER)
+			int aCPUInfo[4];
+			__cpuid(aCPUInfo, 1);
+			return (aCPUInfo[2] & 0x02000000) != 0;
+#else
+			unsigned int a, b, c, d;
+			return __get_cpuid(1, &a, &b, &c, &d) && (c & 0x02000000) != 0;
+#endif
+		}
+
+		WVS_CRYPTO_AESNI_TARGET static __m128i ExpandKeyLow(__m128i t1, __m128i t2)
+		{
+			__m128i t3;
+			t2 = _mm_shuffle_epi32(t2, 0xFF);
+			t3 = _mm_slli_si128(t1, 0x04);
+			t1 = _mm_xor_si128(t1, t3);
+			t3 = _mm_slli_si128(t3, 0x04);
+			t1 = _mm_xor_si128(t1, t3);
+			t3 = _mm_slli_si128(t3, 0x04);
+			t1 = _mm_xor_si128(t1, t3);
+			return _mm_xor_si128(t1, t2);
+		}
+
+		WVS_CRYPTO_AESNI_TARGET static __m128i ExpandKeyHigh(__m128i t1, __m128i t3)
+		{
+			__m128i t2, t4;
+			t4 = _mm_aeskeygenassist_si128(t1, 0x00);
+			t2 = _mm_shuffle_epi32(t4, 0xAA);
+			t4 = _mm_slli_si128(t3, 0x04);
+			t3 = _mm_xor_si128(t3, t4);
+			t4 = _mm_slli_si128(t4, 0x04);
+			t3 = _mm_xor_si128(t3, t4);
+			t4 = _mm_slli_si128(t4, 0x04);
+			t3 = _mm_xor_si128(t3, t4);
+			return _mm_xor_si128(t3, t2);
+		}
+
+		WVS_CRYPTO_AESNI_TARGET void ExpandKeyAESNI(const unsigned char *aKey)
+		{
+			__m128i t1 = _mm_loadu_si128((const __m128i*)aKey);
+			__m128i t3 = _mm_loadu_si128((const __m128i*)(aKey + 16));
+			m_aRoundKey[0] = t1;
+			m_aRoundKey[1] = t3;
+
+			//_mm_aeskeygenassist_si128 requires an immediate rcon.
+#define EXPAND_ROUND_KEY(nIdx, nRcon) \
+			t1 = ExpandKeyLow(t1, _mm_aeskeygenassist_si128(t3, nRcon)); \
+			m_aRoundKey[nIdx] = t1; \
+			if (nIdx + 1 < 15) \
+			{ \
+				t3 = ExpandKeyHigh(t1, t3); \
+				m_aRoundKey[nIdx + 1] = t3; \
+			}
+
+			EXPAND_ROUND_KEY(2, 0x01);
+			EXPAND_ROUND_KEY(4, 0x02);
+			EXPAND_ROUND_KEY(6, 0x04);
+			EXPAND_ROUND_KEY(8, 0x08);
+			EXPAND_ROUND_KEY(10, 0x10);
+			EXPAND_ROUND_KEY(12, 0x20);
+			EXPAND_ROUND_KEY(14, 0x40);
+#undef EXPAND_ROUND_KEY
+		}
+#endif
+
+		AESKeySchedule()
+		{
+			aes_init();
+			aes_encrypt_key256(CryptoConstants::kAesKeys, m_aCtx);
+#ifdef WVS_CRYPTO_AESNI_POSSIBLE
+			if ((m_bAESNI = HasAESNI()))
+				ExpandKeyAESNI(CryptoConstants::kAesKeys);
+#endif
+		}
+	};
+
+	const AESKeySchedule& GetAESKeySchedule()
+	{
+		static AESKeySchedule s_keySchedule;
+		return s_keySchedule;
+	}
+
+	bool IsAESNIEnabled()
+	{
+		return GetAESKeySchedule().m_bAESNI;
+	}
+
+	//OFB mode, the keystream is generated by repeatedly encrypting the IV, then XORed into the buffer.
+	void AESOFBCrypt(const unsigned char *aSrc, unsigned char *aDst, unsigned short nSize, unsigned char *aIV, const AESKeySchedule& keySchedule)
+	{
+		for (unsigned short nPOS = 0; nPOS < nSize; nPOS += 16)
+		{
+			aes_encrypt(aIV, aIV, keySchedule.m_aCtx);
+			unsigned short nBlock = (nSize - nPOS) < 16 ? (nSize - nPOS) : 16;
+			for (unsigned short i = 0; i < nBlock; ++i)
+				aDst[nPOS + i] = aSrc[nPOS + i] ^ aIV[i];
+		}
+	}
+
+#ifdef WVS_CRYPTO_AESNI_POSSIBLE
+	WVS_CRYPTO_AESNI_TARGET void AESOFBCryptAESNI(const unsigned char *aSrc, unsigned char *aDst, unsigned short nSize, unsigned char *aIV, const AESKeySchedule& keySchedule)
+	{
+		const __m128i *aRoundKey = keySchedule.m_aRoundKey;
+		__m128i block = _mm_loadu_si128((const __m128i*)aIV);
+		unsigned short nPOS = 0;
+
+		for (; nPOS + 16 <= nSize; nPOS += 16)
+		{
+			block = _mm_xor_si128(block, aRoundKey[0]);
+			for (int i = 1; i < 14; ++i)
+				block = _mm_aesenc_si128(block, aRoundKey[i]);
+			block = _mm_aesenclast_si128(block, aRoundKey[14]);
+			_mm_storeu_si128(
+				(__m128i*)(aDst + nPOS),
+				_mm_xor_si128(block, _mm_loadu_si128((const __m128i*)(aSrc + nPOS)))
+			);
+		}
+
+		if (nPOS < nSize)
+		{
+			unsigned char aKeyStream[16];
+			block = _mm_xor_si128(block, aRoundKey[0]);
+			for (int i = 1; i < 14; ++i)
+				block = _mm_aesenc_si128(block, aRoundKey[i]);
+			block = _mm_aesenclast_si128(block, aRoundKey[14]);
+			_mm_storeu_si128((__m128i*)aKeyStream, block);
+			for (int i = 0; nPOS < nSize; ++i, ++nPOS)
+				aDst[nPOS] = aSrc[nPOS] ^ aKeyStream[i];
+		}
+	}
+#endif
 
 	unsigned char RrotateRight(unsigned char nVal, unsigned short nShifts)
 	{
@@ -65,25 +222,27 @@ namespace WvsCrypto
 			aBufferOut[i] = aBufferIn[i % 4];
 	}
 
-	void AESCrypt(unsigned char *aBuffer, unsigned char *aIV, unsigned short nSize)
+	void AESCrypt(const unsigned char *aSrc, unsigned char *aDst, unsigned char *aIV, unsigned short nSize)
 	{
 		unsigned char aTempIV[16];
 		unsigned short nPOS = 0, nBlockPOS = 1456, nAmount = 0;
-
-		aes_encrypt_ctx cx[1];
-		aes_init();
+		const AESKeySchedule& keySchedule = GetAESKeySchedule();
 
 		while (nSize > nPOS)
 		{
 			MultiplyBytes(aTempIV, aIV, 4, 4);
-			aes_encrypt_key256(CryptoConstants::kAesKeys, cx);
 
 			if (nSize > (nPOS + nBlockPOS))
 				nAmount = nBlockPOS;
 			else
 				nAmount = nSize - nPOS;
 
-			aes_ofb_crypt(aBuffer + nPOS, aBuffer + nPOS, nAmount, aTempIV, cx);
+#ifdef WVS_CRYPTO_AESNI_POSSIBLE
+			if (keySchedule.m_bAESNI)
+				AESOFBCryptAESNI(aSrc + nPOS, aDst + nPOS, nAmount, aTempIV, keySchedule);
+			else
+#endif
+				AESOFBCrypt(aSrc + nPOS, aDst + nPOS, nAmount, aTempIV, keySchedule);
 			nPOS += nBlockPOS;
 			nBlockPOS = 1460;
 		}
@@ -91,7 +250,7 @@ namespace WvsCrypto
 
 	void Decrypt(unsigned char *aBuffer, unsigned char *aIV, unsigned short nSize)
 	{
-		AESCrypt(aBuffer, aIV, nSize);
+		AESCrypt(aBuffer, aBuffer, aIV, nSize);
 		ShuffleIV(aIV);
 
 		/*unsigned char a;
@@ -170,7 +329,13 @@ namespace WvsCrypto
 			}
 		}*/
 
-		AESCrypt(aBuffer, aIV, nSize);
+		AESCrypt(aBuffer, aBuffer, aIV, nSize);
+		ShuffleIV(aIV);
+	}
+
+	void Encrypt(const unsigned char *aSrc, unsigned char *aDst, unsigned char *aIV, unsigned short nSize)
+	{
+		AESCrypt(aSrc, aDst, aIV, nSize);
 		ShuffleIV(aIV);
 	}
 
@@ -8,6 +8,12 @@ namespace WvsCrypto
 {
 	void Decrypt(unsigned char *buffer, unsigned char *iv, unsigned short size);
 	void Encrypt(unsigned char *buffer, unsigned char *iv, unsigned short size);
+
+	/*Encrypt "src" into "dst" without touching "src", so a broadcast packet can be shared by all recipients.*/
+	void Encrypt(const unsigned char *src, unsigned char *dst, unsigned char *iv, unsigned short size);
 	void InitializeEncryption(unsigned char *buffer, unsigned char *iv, unsigned short size);
 	unsigned short GetPacketLength(unsigned char *buffer);
+
+	/*Return true if the OFB keystream is generated by the AES-NI path (detected at runtime).*/
+	bool IsAESNIEnabled();
 }
@@ -1,4 +1,51 @@
 #include "Evaluator.h"
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+#include <atomic>
+#include <cstdlib>
+#include <cctype>
+
+namespace
+{
+	//A compiled formula reads x from dX, the mutex serializes the evaluations of the same formula.
+	struct CompiledFormula
+	{
+		std::mutex mtx;
+		double dX = 0;
+		bool bValid = false;
+		exprtk::symbol_table<double> symbolTable;
+		exprtk::expression<double> expression;
+	};
+
+	std::shared_mutex mtxFormulaCache;
+	std::unordered_map<std::string, CompiledFormula*> mFormulaCache;
+	std::atomic<unsigned long long> liCompileCount{ 0 }, liHitCount{ 0 }, liLiteralCount{ 0 };
+
+	bool ParseLiteral(const std::string& evalStr, double& dValue)
+	{
+		const char *pBegin = evalStr.c_str();
+		char *pEnd = nullptr;
+		dValue = strtod(pBegin, &pEnd);
+		while (*pEnd && isspace((unsigned char)*pEnd))
+			++pEnd;
+		return *pEnd == 0 && (pEnd != pBegin || evalStr.empty());
+	}
+
+	CompiledFormula* Compile(const std::string& evalStr)
+	{
+		auto pFormula = new CompiledFormula;
+		pFormula->symbolTable.add_variable("x", pFormula->dX);
+		pFormula->symbolTable.add_function("u", ceil);
+		pFormula->symbolTable.add_function("d", floor);
+		pFormula->expression.register_symbol_table(pFormula->symbolTable);
+
+		exprtk::parser<double> parser;
+		pFormula->bValid = parser.compile(evalStr, pFormula->expression);
+		++liCompileCount;
+		return pFormula;
+	}
+}
 
 Evaluator::Evaluator(double& var, const std::string& evalStr)
 {
@@ -21,14 +68,70 @@ double Evaluator::Eval()
 }
 
 double Evaluator::Eval(const std::string & evalStr, const std::string & variableName, double & var)
+{
+	return Eval(evalStr, var);
+}
+
+double Evaluator::Eval(const std::string & evalStr, double dX)
+{
+	double dValue = 0;
+	if (ParseLiteral(evalStr, dValue))
+	{
+		++liLiteralCount;
+		return dValue;
+	}
+
+	CompiledFormula *pFormula = nullptr;
+	{
+		std::shared_lock<std::shared_mutex> lock(mtxFormulaCache);
+		auto findIter = mFormulaCache.find(evalStr);
+		if (findIter != mFormulaCache.end())
+			pFormula = findIter->second;
+	}
+	if (pFormula)
+		++liHitCount;
+	else
+	{
+		//Compiled outside of the lock, the loser of a race on the same formula discards its copy.
+		auto pCompiled = Compile(evalStr);
+		std::unique_lock<std::shared_mutex> lock(mtxFormulaCache);
+		auto prInsert = mFormulaCache.insert({ evalStr, pCompiled });
+		pFormula = prInsert.first->second;
+		if (!prInsert.second)
+			delete pCompiled;
+	}
+
+	if (!pFormula->bValid)
+		return 0;
+	std::lock_guard<std::mutex> lock(pFormula->mtx);
+	pFormula->dX = dX;
+	return pFormula->expression.value();
+}
+
+double Evaluator::EvalUncached(const std::string & evalStr, double dX)
 {
 	exprtk::parser<double> parser;
 	exprtk::expression<double> expression;
 	exprtk::symbol_table<double> symbol_table;
-	symbol_table.add_variable("x", var, false);
+	symbol_table.add_variable("x", dX);
 	symbol_table.add_function("u", ceil);
 	symbol_table.add_function("d", floor);
 
 	expression.register_symbol_table(symbol_table);
-	return parser.compile(evalStr, symbol_table).value();
+	if (!parser.compile(evalStr, expression))
+		return 0;
+	return expression.value();
+}
+
+EvaluatorStat Evaluator::GetStat()
+{
+	EvaluatorStat stat;
+	{
+		std::shared_lock<std::shared_mutex> lock(mtxFormulaCache);
+		stat.liFormulaCount = mFormulaCache.size();
+	}
+	stat.liCompileCount = liCompileCount;
+	stat.liHitCount = liHitCount;
+	stat.liLiteralCount = liLiteralCount;
+	return stat;
 }
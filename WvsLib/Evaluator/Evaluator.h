@@ -3,6 +3,10 @@
 #include <vector>
 #include <string>
 
+struct EvaluatorStat
+{
+	unsigned long long liFormulaCount = 0, liCompileCount = 0, liHitCount = 0, liLiteralCount = 0;
+};
 
 class Evaluator
 {
@@ -19,5 +23,16 @@ public:
 
 	//Recalcuate on a new expression.
 	static double Eval(const std::string& evalStr, const std::string& variableName, double& var);
+
+	/*
+	Evaluates evalStr with x = dX.
+	Numeric literals are parsed directly, any other formula is compiled once and kept in a process-wide cache keyed by its text.
+	Evaluating a cached formula doesn't allocate.
+	*/
+	static double Eval(const std::string& evalStr, double dX);
+
+	//Evaluates by compiling evalStr every time, as Eval did before the cache (for comparison only).
+	static double EvalUncached(const std::string& evalStr, double dX);
+	static EvaluatorStat GetStat();
 };
 
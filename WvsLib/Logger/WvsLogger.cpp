@@ -1,9 +1,12 @@
 #include <cstdarg>
 #include <thread>
+#include <chrono>
 #include "WvsLogger.h"
+#include "WvsPacketTrace.h"
 #include "boost\lockfree\queue.hpp"
 #include "..\String\StringUtility.h"
 #include "..\Memory\ZMemory.h"
+#include "..\Common\ConfigLoader.hpp"
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -47,6 +50,18 @@ void WvsLogger::StartMonitoring()
 
 WvsLogger::WvsLogger()
 {
+	for (auto& nLevel : m_anLogLevel)
+		nLevel = SEV_DEBUG;
+
+	//Packet dumps are the most expensive logs on the I/O path, keep them off unless asked for.
+	m_anLogLevel[SUB_PACKET] = SEV_INFO;
+	m_nPacketDumpSampleRate = 1;
+	m_nPacketDumpRateLimit = 0;
+	m_nPacketDumpCounter = 0;
+	m_liPacketDumpWindow = 0;
+	m_nPacketDumpInWindow = 0;
+	m_liPacketDumpSuppressed = 0;
+
 	setbuf(stdout, NULL);
 	g_qMsgQueue.reserve(MAX_MSG_QUEUE_CAPACITY);
 	new std::thread(&WvsLogger::StartMonitoring);
@@ -65,6 +80,15 @@ void WvsLogger::PushLogImpl(int nConsoleColor, const std::string & strLog)
 	m_cv.notify_all();
 }
 
+void WvsLogger::PushLogImpl(int nConsoleColor, std::string && strLog)
+{
+	WvsLogData* pLogData = AllocObj(WvsLogData);
+	pLogData->m_nConsoleColor = nConsoleColor;
+	pLogData->m_strData = std::move(strLog);
+	g_qMsgQueue.push(pLogData);
+	m_cv.notify_all();
+}
+
 void WvsLogger::LogRaw(int nConsoleColor, const char *sFormat)
 {
 	GetInstance()->PushLogImpl(nConsoleColor, sFormat);
@@ -94,15 +118,137 @@ void WvsLogger::SetForwardFunc(MESSAGE_FORWARD_FUNC pFunc)
 	GetInstance()->m_pForward = pFunc;
 }
 
-WvsLogger::WvsLogData::WvsLogData()
+void WvsLogger::LoadConfig(ConfigLoader *pCfg)
+{
+	for (int i = 0; i < SUB_COUNT; ++i)
+		SetLogLevel(i, pCfg->IntValue(std::string("LogLevel_") + GetSubsystemName(i), GetLogLevel(i)));
+
+	SetPacketDumpPolicy(
+		pCfg->IntValue("PacketDumpSampleRate", 1),
+		pCfg->IntValue("PacketDumpRateLimit", 0)
+	);
+
+	auto sTraceFile = pCfg->StrValue("PacketTraceFile");
+	if (sTraceFile != "")
+		WvsPacketTrace::Open(sTraceFile, pCfg->IntValue("PacketTraceSizeMB", 64));
+}
+
+void WvsLogger::SetLogLevel(int nSubsystem, int nSeverity)
+{
+	if (nSubsystem < 0 || nSubsystem >= SUB_COUNT)
+		return;
+	if (nSeverity < SEV_DEBUG)
+		nSeverity = SEV_DEBUG;
+	else if (nSeverity > SEV_NONE)
+		nSeverity = SEV_NONE;
+	GetInstance()->m_anLogLevel[nSubsystem] = nSeverity;
+}
+
+int WvsLogger::GetLogLevel(int nSubsystem)
+{
+	if (nSubsystem < 0 || nSubsystem >= SUB_COUNT)
+		return SEV_NONE;
+	return GetInstance()->m_anLogLevel[nSubsystem];
+}
+
+int WvsLogger::GetSubsystemByName(const std::string & sName)
+{
+	for (int i = 0; i < SUB_COUNT; ++i)
+		if (sName == GetSubsystemName(i))
+			return i;
+	return -1;
+}
+
+const char * WvsLogger::GetSubsystemName(int nSubsystem)
+{
+	static const char* asName[SUB_COUNT] = { "General", "Net", "Packet", "DB", "Script" };
+	if (nSubsystem < 0 || nSubsystem >= SUB_COUNT)
+		return "Unknown";
+	return asName[nSubsystem];
+}
+
+void WvsLogger::SetPacketDumpPolicy(int nSampleRate, int nRateLimit)
+{
+	auto pInstance = GetInstance();
+	pInstance->m_nPacketDumpSampleRate = nSampleRate < 1 ? 1 : nSampleRate;
+	pInstance->m_nPacketDumpRateLimit = nRateLimit < 0 ? 0 : nRateLimit;
+}
+
+unsigned long long WvsLogger::GetSuppressedPacketDumpCount()
 {
-	time_t rawtime;
-	struct tm * timeinfo;
-	char aBuffer[64];
+	return GetInstance()->m_liPacketDumpSuppressed;
+}
 
-	time(&rawtime);
-	timeinfo = localtime(&rawtime);
+bool WvsLogger::ShouldDumpPacket()
+{
+	if (!IsLevelEnabled(SUB_PACKET, SEV_DEBUG))
+		return false;
+
+	auto pInstance = GetInstance();
+	int nSampleRate = pInstance->m_nPacketDumpSampleRate.load(std::memory_order_relaxed);
+	if (nSampleRate > 1 && (pInstance->m_nPacketDumpCounter++ % (unsigned int)nSampleRate) != 0)
+		return false;
+
+	int nRateLimit = pInstance->m_nPacketDumpRateLimit.load(std::memory_order_relaxed);
+	if (nRateLimit > 0)
+	{
+		long long liNow = std::chrono::duration_cast<std::chrono::seconds>(
+			std::chrono::steady_clock::now().time_since_epoch()
+		).count();
+		long long liWindow = pInstance->m_liPacketDumpWindow.load(std::memory_order_relaxed);
+		if (liWindow != liNow && pInstance->m_liPacketDumpWindow.compare_exchange_strong(liWindow, liNow))
+			pInstance->m_nPacketDumpInWindow = 0;
+		if (++pInstance->m_nPacketDumpInWindow > nRateLimit)
+		{
+			++pInstance->m_liPacketDumpSuppressed;
+			return false;
+		}
+	}
+	return true;
+}
 
-	strftime(aBuffer, sizeof(aBuffer), "%d-%m-%Y %I:%M:%S", timeinfo);
-	m_strDateTime.assign(aBuffer);
+void WvsLogger::LogHex(int nConsoleColor, const char * sPrefix, const unsigned char * pBuffer, unsigned int nSize)
+{
+	static const char acHex[] = "0123456789ABCDEF";
+	size_t nPrefixLen = strlen(sPrefix);
+	std::string sOutput;
+	sOutput.resize(nPrefixLen + nSize * 5 + 1);
+
+	char *pOutput = &sOutput[0];
+	memcpy(pOutput, sPrefix, nPrefixLen);
+	pOutput += nPrefixLen;
+	for (unsigned int i = 0; i < nSize; ++i)
+	{
+		pOutput[0] = '0';
+		pOutput[1] = 'x';
+		pOutput[2] = acHex[pBuffer[i] >> 4];
+		pOutput[3] = acHex[pBuffer[i] & 0x0F];
+		pOutput[4] = ' ';
+		pOutput += 5;
+	}
+	*pOutput = '\n';
+	GetInstance()->PushLogImpl(nConsoleColor, std::move(sOutput));
+}
+
+void WvsLogger::LogPacket(const char * sPrefix, const unsigned char * pBuffer, unsigned int nSize)
+{
+	if (ShouldDumpPacket())
+		LogHex(LEVEL_NORMAL, sPrefix, pBuffer, nSize);
+}
+
+void WvsLogger::LogSubsystem(int nSubsystem, int nSeverity, const char * sFormat, ...)
+{
+	if (!IsLevelEnabled(nSubsystem, nSeverity))
+		return;
+
+	static const int anColor[] = { LEVEL_NORMAL, LEVEL_INFO, LEVEL_WARNING, LEVEL_ERROR };
+	ZUniquePtr<char[]> sFormatted;
+	STRUTILITY_PARSE_VAR_LIST(sFormat, sFormatted);
+	GetInstance()->PushLogImpl(anColor[nSeverity < SEV_NONE ? nSeverity : SEV_ERROR], std::string((char*)sFormatted));
+}
+
+WvsLogger::WvsLogData::WvsLogData()
+{
+	//Only the raw time is recorded here, formatting it (localtime/strftime) is left to whoever displays it.
+	m_tLogTime = time(nullptr);
 }
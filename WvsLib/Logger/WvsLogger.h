@@ -1,9 +1,13 @@
 #pragma once
 #include <mutex>
+#include <atomic>
 #include <string>
+#include <ctime>
 #include <condition_variable>
 #include "..\Common\CommonDef.h"
 
+class ConfigLoader;
+
 class WvsLogger
 {
 public:
@@ -72,16 +76,70 @@ public:
 		LEVEL_INFO = TXT_LIGHT_AQUQ
 	};
 
+	enum LOG_SUBSYSTEM
+	{
+		SUB_GENERAL,
+		SUB_NET,
+		SUB_PACKET,
+		SUB_DB,
+		SUB_SCRIPT,
+		SUB_COUNT
+	};
+
+	enum LOG_SEVERITY
+	{
+		SEV_DEBUG,
+		SEV_INFO,
+		SEV_WARNING,
+		SEV_ERROR,
+		SEV_NONE
+	};
+
 	static const int MAX_MSG_QUEUE_CAPACITY = 1000;
 
 	struct WvsLogData
 	{
-		std::string m_strData, m_strDateTime;
+		std::string m_strData;
+		time_t m_tLogTime = 0;
 		int m_nConsoleColor = LEVEL_NORMAL;
 
 		WvsLogData();
 	};
 
+private:
+	//Runtime log levels, a message is emitted only when its severity >= the level of its subsystem.
+	std::atomic<int> m_anLogLevel[SUB_COUNT];
+
+	//Packet dump policy, dump one of every m_nPacketDumpSampleRate packets and at most m_nPacketDumpRateLimit per second (0 = unlimited).
+	std::atomic<int> m_nPacketDumpSampleRate, m_nPacketDumpRateLimit;
+	std::atomic<unsigned int> m_nPacketDumpCounter;
+	std::atomic<long long> m_liPacketDumpWindow;
+	std::atomic<int> m_nPacketDumpInWindow;
+	std::atomic<unsigned long long> m_liPacketDumpSuppressed;
+
+	void PushLogImpl(int nConsoleColor, std::string&& strLog);
+
+public:
+	static void LoadConfig(ConfigLoader *pCfg);
+	static void SetLogLevel(int nSubsystem, int nSeverity);
+	static int GetLogLevel(int nSubsystem);
+	static int GetSubsystemByName(const std::string& sName);
+	static const char* GetSubsystemName(int nSubsystem);
+	static void SetPacketDumpPolicy(int nSampleRate, int nRateLimit);
+	static unsigned long long GetSuppressedPacketDumpCount();
+
+	inline static bool IsLevelEnabled(int nSubsystem, int nSeverity)
+	{
+		return nSeverity >= GetInstance()->m_anLogLevel[nSubsystem].load(std::memory_order_relaxed);
+	}
+
+	//Cheap gate for packet dumps, nothing is formatted or allocated when it returns false.
+	static bool ShouldDumpPacket();
+
+	static void LogHex(int nConsoleColor, const char *sPrefix, const unsigned char *pBuffer, unsigned int nSize);
+	static void LogPacket(const char *sPrefix, const unsigned char *pBuffer, unsigned int nSize);
+	static void LogSubsystem(int nSubsystem, int nSeverity, const char *sFormat, ...);
+
 	static void LogRaw(const char *sFormat);
 	static void LogRaw(int nConsoleColor, const char *sFormat);
 
@@ -0,0 +1,140 @@
+#include "WvsPacketTrace.h"
+#include "WvsLogger.h"
+#include <chrono>
+#include <cstring>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+std::atomic<bool> WvsPacketTrace::ms_bEnabled(false);
+std::atomic<unsigned long long> WvsPacketTrace::ms_liWriteOffset(0);
+unsigned long long WvsPacketTrace::ms_liMappedSize = 0;
+unsigned char *WvsPacketTrace::ms_pMappedBase = nullptr;
+void *WvsPacketTrace::ms_hFile = nullptr;
+void *WvsPacketTrace::ms_hMap = nullptr;
+int WvsPacketTrace::ms_nFileDescriptor = -1;
+
+bool WvsPacketTrace::Open(const std::string & sFileName, int nSizeInMB)
+{
+	Close();
+	if (nSizeInMB <= 0)
+		return false;
+
+	unsigned long long liSize = (unsigned long long)nSizeInMB * 1024 * 1024;
+#ifdef _WIN32
+	HANDLE hFile = CreateFileA(sFileName.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+	{
+		WvsLogger::LogFormat(WvsLogger::LEVEL_ERROR, "[WvsPacketTrace::Open]Failed to create the trace file %s.\n", sFileName.c_str());
+		return false;
+	}
+	HANDLE hMap = CreateFileMappingA(hFile, NULL, PAGE_READWRITE, (DWORD)(liSize >> 32), (DWORD)(liSize & 0xFFFFFFFF), NULL);
+	void *pBase = hMap ? MapViewOfFile(hMap, FILE_MAP_WRITE, 0, 0, (SIZE_T)liSize) : nullptr;
+	ms_hFile = hFile;
+	ms_hMap = hMap;
+#else
+	int nFD = open(sFileName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (nFD < 0)
+	{
+		WvsLogger::LogFormat(WvsLogger::LEVEL_ERROR, "[WvsPacketTrace::Open]Failed to create the trace file %s.\n", sFileName.c_str());
+		return false;
+	}
+	void *pBase = nullptr;
+	if (ftruncate(nFD, (off_t)liSize) == 0)
+	{
+		pBase = mmap(nullptr, (size_t)liSize, PROT_READ | PROT_WRITE, MAP_SHARED, nFD, 0);
+		if (pBase == MAP_FAILED)
+			pBase = nullptr;
+	}
+	ms_nFileDescriptor = nFD;
+#endif
+	if (!pBase)
+	{
+		WvsLogger::LogFormat(WvsLogger::LEVEL_ERROR, "[WvsPacketTrace::Open]Failed to map the trace file %s.\n", sFileName.c_str());
+		Unmap();
+		return false;
+	}
+	ms_pMappedBase = (unsigned char*)pBase;
+	ms_liMappedSize = liSize;
+
+	TraceFileHeader *pHeader = (TraceFileHeader*)ms_pMappedBase;
+	memcpy(pHeader->m_aMagic, "WVSTRACE", sizeof(pHeader->m_aMagic));
+	pHeader->m_nVersion = 1;
+	pHeader->m_nReserved = 0;
+	pHeader->m_liDataSize = 0;
+	ms_liWriteOffset = sizeof(TraceFileHeader);
+	ms_bEnabled = true;
+
+	WvsLogger::LogFormat(WvsLogger::LEVEL_INFO, "[WvsPacketTrace::Open]Packet trace is written to %s (%d MB).\n", sFileName.c_str(), nSizeInMB);
+	return true;
+}
+
+//Must not race with Trace(), i.e. call it while the I/O service is stopped (or before it runs).
+void WvsPacketTrace::Close()
+{
+	ms_bEnabled = false;
+	if (ms_pMappedBase)
+		((TraceFileHeader*)ms_pMappedBase)->m_liDataSize = GetTracedSize();
+	Unmap();
+}
+
+void WvsPacketTrace::Unmap()
+{
+#ifdef _WIN32
+	if (ms_pMappedBase)
+		UnmapViewOfFile(ms_pMappedBase);
+	if (ms_hMap)
+		CloseHandle((HANDLE)ms_hMap);
+	if (ms_hFile)
+		CloseHandle((HANDLE)ms_hFile);
+	ms_hMap = ms_hFile = nullptr;
+#else
+	if (ms_pMappedBase)
+		munmap(ms_pMappedBase, (size_t)ms_liMappedSize);
+	if (ms_nFileDescriptor >= 0)
+		close(ms_nFileDescriptor);
+	ms_nFileDescriptor = -1;
+#endif
+	ms_pMappedBase = nullptr;
+	ms_liMappedSize = 0;
+}
+
+unsigned long long WvsPacketTrace::GetTracedSize()
+{
+	unsigned long long liOffset = ms_liWriteOffset;
+	if (liOffset > ms_liMappedSize)
+		liOffset = ms_liMappedSize;
+	return liOffset < sizeof(TraceFileHeader) ? 0 : liOffset - sizeof(TraceFileHeader);
+}
+
+void WvsPacketTrace::Trace(unsigned int nSocketID, int nDirection, const unsigned char * pBuffer, unsigned short nSize)
+{
+	if (!IsEnabled())
+		return;
+
+	//Each record reserves its own range with a single fetch_add, so the I/O threads never wait for each other.
+	unsigned long long liRecordSize = (sizeof(TraceRecord) + nSize + 7) & ~7ULL;
+	unsigned long long liOffset = ms_liWriteOffset.fetch_add(liRecordSize);
+	if (liOffset + liRecordSize > ms_liMappedSize)
+	{
+		if (ms_bEnabled.exchange(false))
+			WvsLogger::LogRaw(WvsLogger::LEVEL_WARNING, "[WvsPacketTrace::Trace]Trace file is full, packet tracing is stopped.\n");
+		return;
+	}
+
+	TraceRecord *pRecord = (TraceRecord*)(ms_pMappedBase + liOffset);
+	pRecord->m_liTimestamp = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::system_clock::now().time_since_epoch()
+	).count();
+	pRecord->m_nSocketID = nSocketID;
+	pRecord->m_nOpcode = nSize >= 2 ? *(unsigned short*)pBuffer : 0;
+	pRecord->m_nSize = nSize;
+	pRecord->m_nDirection = (unsigned char)nDirection;
+	memset(pRecord->m_aPadding, 0, sizeof(pRecord->m_aPadding));
+	memcpy(pRecord + 1, pBuffer, nSize);
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <atomic>
+#include <string>
+
+/*
+Binary packet trace sink.
+Every traced packet is appended to a memory-mapped file as a fixed header (TraceRecord) followed by the plain packet bytes,
+so that the I/O threads never format anything. The file starts with a TraceFileHeader, records are 8-byte aligned 
+and a zeroed header marks the end of the trace.
+*/
+class WvsPacketTrace
+{
+public:
+	enum TraceDirection
+	{
+		TRACE_RECV = 0,
+		TRACE_SEND = 1
+	};
+
+#pragma pack(push, 1)
+	struct TraceFileHeader
+	{
+		char m_aMagic[8];
+		unsigned int m_nVersion;
+		unsigned int m_nReserved;
+		unsigned long long m_liDataSize; //Written by Close(), an upper bound once the file got full.
+	};
+
+	struct TraceRecord
+	{
+		long long m_liTimestamp; //Microseconds since epoch.
+		unsigned int m_nSocketID;
+		unsigned short m_nOpcode;
+		unsigned short m_nSize;
+		unsigned char m_nDirection;
+		unsigned char m_aPadding[7];
+	};
+#pragma pack(pop)
+
+private:
+	static std::atomic<bool> ms_bEnabled;
+	static std::atomic<unsigned long long> ms_liWriteOffset;
+	static unsigned long long ms_liMappedSize;
+	static unsigned char *ms_pMappedBase;
+	static void *ms_hFile, *ms_hMap;
+	static int ms_nFileDescriptor;
+
+	static void Unmap();
+
+public:
+	static bool Open(const std::string& sFileName, int nSizeInMB);
+	static void Close();
+	static unsigned long long GetTracedSize();
+
+	inline static bool IsEnabled()
+	{
+		return ms_bEnabled.load(std::memory_order_relaxed);
+	}
+
+	static void Trace(unsigned int nSocketID, int nDirection, const unsigned char *pBuffer, unsigned short nSize);
+};
+
@@ -1,4 +1,50 @@
 #include "MemoryPool.h"
+#include <atomic>
+#include <algorithm>
+
+struct MemoryPoolMan::ThreadCache
+{
+	struct SizeClass
+	{
+		char* aSlot[MAX_CACHE_BATCH * 2];
+		size_t nCount = 0;
+
+		//Only written by the owner thread, atomic for reading the statistics from other threads.
+		std::atomic<unsigned long long> liHit{ 0 }, liMiss{ 0 };
+	};
+
+	//[0] for single object pools, [1] for array pools.
+	SizeClass m_aSizeClass[2][MAX_POOL_NUM];
+
+	ThreadCache()
+	{
+		auto pMan = MemoryPoolMan::GetInstance();
+		std::lock_guard<std::mutex> lock(pMan->m_mtxThreadCache);
+		pMan->m_sThreadCache.insert(this);
+	}
+
+	//Return all cached slots to the global pools when the thread exits.
+	~ThreadCache()
+	{
+		auto pMan = MemoryPoolMan::GetInstance();
+		std::lock_guard<std::mutex> lock(pMan->m_mtxThreadCache);
+		for (int i = 0; i < 2; ++i)
+			for (size_t nPos = 0; nPos < MAX_POOL_NUM; ++nPos)
+			{
+				auto& sizeClass = m_aSizeClass[i][nPos];
+				if (sizeClass.nCount)
+					(i ? pMan->GetArrayPool(nPos) : pMan->GetPool(nPos))->deallocateBatch(sizeClass.aSlot, sizeClass.nCount);
+				pMan->m_aRetiredHit[i][nPos] += sizeClass.liHit;
+				pMan->m_aRetiredMiss[i][nPos] += sizeClass.liMiss;
+			}
+		pMan->m_sThreadCache.erase(this);
+	}
+};
+
+static size_t GetCacheBatchSize(MemoryPool<char> *pPool)
+{
+	return (std::max)((size_t)1, (std::min)((size_t)MemoryPoolMan::MAX_CACHE_BATCH, MemoryPoolMan::MAX_CACHE_BYTES / (size_t)pPool->UnitSize));
+}
 
 MemoryPoolMan::MemoryPoolMan()
 {
@@ -53,3 +99,78 @@ MemoryPool<char>* MemoryPoolMan::GetArrayPool(size_t nPos)
 {
 	return m_apPool[nPos];
 }
+
+
+MemoryPoolMan::ThreadCache& MemoryPoolMan::GetThreadCache()
+{
+	static thread_local ThreadCache s_threadCache;
+	return s_threadCache;
+}
+
+void* MemoryPoolMan::Allocate(size_t nPos, bool bArray)
+{
+	auto& sizeClass = GetThreadCache().m_aSizeClass[bArray ? 1 : 0][nPos];
+	if (sizeClass.nCount == 0)
+	{
+		auto pPool = bArray ? GetArrayPool(nPos) : GetPool(nPos);
+		sizeClass.liMiss.fetch_add(1, std::memory_order_relaxed);
+		sizeClass.nCount = GetCacheBatchSize(pPool);
+		pPool->allocateBatch(sizeClass.aSlot, sizeClass.nCount);
+	}
+	else
+		sizeClass.liHit.fetch_add(1, std::memory_order_relaxed);
+
+	return sizeClass.aSlot[--sizeClass.nCount];
+}
+
+void MemoryPoolMan::Deallocate(size_t nPos, void *p, bool bArray)
+{
+	auto& sizeClass = GetThreadCache().m_aSizeClass[bArray ? 1 : 0][nPos];
+	auto pPool = bArray ? GetArrayPool(nPos) : GetPool(nPos);
+	size_t nBatch = GetCacheBatchSize(pPool);
+
+	//The cache is full, return the oldest batch to the global pool.
+	if (sizeClass.nCount >= nBatch * 2)
+	{
+		pPool->deallocateBatch(sizeClass.aSlot, nBatch);
+		memmove(sizeClass.aSlot, sizeClass.aSlot + nBatch, (sizeClass.nCount - nBatch) * sizeof(char*));
+		sizeClass.nCount -= nBatch;
+	}
+	sizeClass.aSlot[sizeClass.nCount++] = (char*)p;
+}
+
+std::vector<MemoryPoolMan::PoolStat> MemoryPoolMan::GetPoolStat()
+{
+	std::vector<PoolStat> aRet;
+	std::set<MemoryPool<char>*> sVisited;
+	std::lock_guard<std::mutex> lock(m_mtxThreadCache);
+	for (int i = 0; i < 2; ++i)
+		for (size_t nPos = 0; nPos < MAX_POOL_NUM; ++nPos)
+		{
+			//Small size classes share the same pool.
+			auto pPool = i ? GetArrayPool(nPos) : GetPool(nPos);
+			bool bNewPool = sVisited.insert(pPool).second;
+			if (bNewPool)
+			{
+				PoolStat stat = {};
+				stat.bArray = (i == 1);
+				stat.nPos = nPos;
+				stat.nUnitSize = pPool->UnitSize;
+				stat.liLiveBytes = (unsigned long long)pPool->allocatedCount() * pPool->UnitSize;
+				stat.liPeakBytes = (unsigned long long)pPool->peakAllocatedCount() * pPool->UnitSize;
+				aRet.push_back(stat);
+			}
+
+			auto& stat = *std::find_if(aRet.begin(), aRet.end(), [&](const PoolStat& s) {
+				return (s.bArray ? GetArrayPool(s.nPos) : GetPool(s.nPos)) == pPool;
+			});
+			stat.liCacheHit += m_aRetiredHit[i][nPos];
+			stat.liCacheMiss += m_aRetiredMiss[i][nPos];
+			for (auto pCache : m_sThreadCache)
+			{
+				stat.liCacheHit += pCache->m_aSizeClass[i][nPos].liHit.load(std::memory_order_relaxed);
+				stat.liCacheMiss += pCache->m_aSizeClass[i][nPos].liMiss.load(std::memory_order_relaxed);
+			}
+		}
+	return aRet;
+}
\ No newline at end of file
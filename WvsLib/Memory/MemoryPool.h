@@ -73,6 +73,14 @@ public:
 	pointer allocate(size_type n = 1, const_pointer hint = 0);
 	void deallocate(pointer p, size_type n = 1);
 
+	// Allocate/deallocate n slots with a single lock, used for refilling/draining thread caches.
+	void allocateBatch(pointer *aSlot, size_type n);
+	void deallocateBatch(pointer *aSlot, size_type n);
+
+	// Number of slots handed out (including slots held by thread caches) and its peak.
+	size_type allocatedCount();
+	size_type peakAllocatedCount();
+
 	size_type max_size() const noexcept;
 
 	template <class U, class... Args> void construct(U* p, Args&&... args);
@@ -97,7 +105,9 @@ private:
 	slot_pointer_ currentSlot_;
 	slot_pointer_ lastSlot_;
 	slot_pointer_ freeSlots_;
+	size_type allocated_ = 0, peakAllocated_ = 0;
 
+	pointer allocateSlot();
 	size_type padPointer(data_pointer_ p, size_type align) const noexcept;
 
 	//static_assert(BlockSize >= 2 * sizeof(slot_type_), "BlockSize too small.");
@@ -105,6 +115,8 @@ private:
 
 #include "MemoryPool.tcc"
 #include <type_traits>
+#include <set>
+#include <vector>
 
 constexpr size_t GetAlignedPoolPos(const size_t nAlloc)
 {
@@ -123,10 +135,31 @@ public:
 	static const size_t INITIAL_BLOCK_NUM = 128;
 	static const size_t MAX_POOL_NUM = GetAlignedPoolPos(MAX_ALLOC_SIZE) + 1; // extra one for 0~1 byte
 
+	//Each thread caches freed slots per size class, slots are moved from/to the global pools in batches.
+	static const size_t MAX_CACHE_BATCH = 32;
+	static const size_t MAX_CACHE_BYTES = 16384; //Upper bound of bytes moved in one batch.
+
+	struct PoolStat
+	{
+		bool bArray;
+		size_t nPos, nUnitSize;
+		unsigned long long liLiveBytes, liPeakBytes, liCacheHit, liCacheMiss;
+	};
+
 private:
+	struct ThreadCache;
+	friend struct ThreadCache;
+
 	MemoryPool<char>* m_apPool[MAX_POOL_NUM];
 	MemoryPool<char>* m_apArrayPool[MAX_POOL_NUM];
+
+	//Registered thread caches (for statistics) and the counters of exited threads.
+	std::mutex m_mtxThreadCache;
+	std::set<ThreadCache*> m_sThreadCache;
+	unsigned long long m_aRetiredHit[2][MAX_POOL_NUM] = {}, m_aRetiredMiss[2][MAX_POOL_NUM] = {};
+
 	MemoryPoolMan();
+	static ThreadCache& GetThreadCache();
 
 public:
 	static MemoryPoolMan* GetInstance() 
@@ -137,6 +170,12 @@ public:
 
 	MemoryPool<char>* GetPool(size_t nPos);
 	MemoryPool<char>* GetArrayPool(size_t nPos);
+
+	//Allocate/deallocate one slot of size class nPos through the cache of the calling thread.
+	void* Allocate(size_t nPos, bool bArray);
+	void Deallocate(size_t nPos, void *p, bool bArray);
+
+	std::vector<PoolStat> GetPoolStat();
 };
 
 template<typename T>
@@ -159,7 +198,7 @@ public:
 				return pRet;
 			}
 			else
-				pRet = MemoryPoolMan::GetInstance()->GetPool(nAllocPos)->allocate();
+				pRet = MemoryPoolMan::GetInstance()->Allocate(nAllocPos, false);
 
 			if (pRet)
 				*((unsigned char*)pRet) = (unsigned char)nAllocPos;
@@ -173,7 +212,7 @@ public:
 				return nullptr;
 			}
 
-			MemoryPoolMan::GetInstance()->GetPool(nAllocPos)->deallocate((char*)pDel);
+			MemoryPoolMan::GetInstance()->Deallocate(nAllocPos, pDel, false);
 		}
 		return pRet;
 	}
@@ -228,7 +267,7 @@ private:
 				return pRet;
 			}
 			else
-				pRet = MemoryPoolMan::GetInstance()->GetArrayPool(nAllocPos)->allocate();
+				pRet = MemoryPoolMan::GetInstance()->Allocate(nAllocPos, true);
 
 			if (pRet)
 				*((unsigned char*)pRet) = (unsigned char)nAllocPos;
@@ -242,7 +281,7 @@ private:
 				return nullptr;
 			}
 
-			MemoryPoolMan::GetInstance()->GetArrayPool(nAllocPos)->deallocate((char*)pDel);
+			MemoryPoolMan::GetInstance()->Deallocate(nAllocPos, pDel, true);
 		}
 		return pRet;
 	}
@@ -115,6 +115,7 @@ void MemoryPool<T>::release() noexcept
     curr = prev;
   }
   currentBlock_ = freeSlots_ = currentSlot_ = lastSlot_ = nullptr;
+  allocated_ = 0;
 }
 
 template <typename T>
@@ -152,9 +153,10 @@ MemoryPool<T>::allocateBlock()
 
 template <typename T>
 inline typename MemoryPool<T>::pointer
-MemoryPool<T>::allocate(size_type n, const_pointer hint)
+MemoryPool<T>::allocateSlot()
 {
-  std::lock_guard<std::mutex> lock_(m_mtxLock);
+  if (++allocated_ > peakAllocated_)
+    peakAllocated_ = allocated_;
   if (freeSlots_ != nullptr) {
     pointer result = reinterpret_cast<pointer>(freeSlots_);
     freeSlots_ = ((slot_pointer_)((char*)freeSlots_))->next;
@@ -169,6 +171,14 @@ MemoryPool<T>::allocate(size_type n, const_pointer hint)
   }
 }
 
+template <typename T>
+inline typename MemoryPool<T>::pointer
+MemoryPool<T>::allocate(size_type n, const_pointer hint)
+{
+  std::lock_guard<std::mutex> lock_(m_mtxLock);
+  return allocateSlot();
+}
+
 template <typename T>
 inline void
 MemoryPool<T>::deallocate(pointer p, size_type n)
@@ -177,7 +187,45 @@ MemoryPool<T>::deallocate(pointer p, size_type n)
   if (p != nullptr) {
     reinterpret_cast<slot_pointer_>((char*)p)->next = freeSlots_;
     freeSlots_ = reinterpret_cast<slot_pointer_>(p);
+    --allocated_;
+  }
+}
+
+template <typename T>
+inline void
+MemoryPool<T>::allocateBatch(pointer *aSlot, size_type n)
+{
+  std::lock_guard<std::mutex> lock_(m_mtxLock);
+  for (size_type i = 0; i < n; ++i)
+    aSlot[i] = allocateSlot();
+}
+
+template <typename T>
+inline void
+MemoryPool<T>::deallocateBatch(pointer *aSlot, size_type n)
+{
+  std::lock_guard<std::mutex> lock_(m_mtxLock);
+  for (size_type i = 0; i < n; ++i) {
+    reinterpret_cast<slot_pointer_>((char*)aSlot[i])->next = freeSlots_;
+    freeSlots_ = reinterpret_cast<slot_pointer_>(aSlot[i]);
   }
+  allocated_ -= n;
+}
+
+template <typename T>
+inline typename MemoryPool<T>::size_type
+MemoryPool<T>::allocatedCount()
+{
+  std::lock_guard<std::mutex> lock_(m_mtxLock);
+  return allocated_;
+}
+
+template <typename T>
+inline typename MemoryPool<T>::size_type
+MemoryPool<T>::peakAllocatedCount()
+{
+  std::lock_guard<std::mutex> lock_(m_mtxLock);
+  return peakAllocated_;
 }
 
 template <typename T>
@@ -78,17 +78,12 @@ void InPacket::DecodeBuffer(unsigned char* dst, int size)
 
 void InPacket::Print()
 {
-	std::string sOutput;
-	char aBuffer[6] = { 0 };
-	for (int i = 0; i < m_nPacketSize; ++i) 
-	{
-		sprintf_s(aBuffer, "0x%02X ", (int)m_aBuff[i]);
-		sOutput += aBuffer;
-	}
-		//WvsLogger::LogFormat("0x%02X ", (int)aBuff[i]);
-	sOutput += "\n";
-	WvsLogger::LogRaw(sOutput.c_str());
-	//WvsLogger::LogRaw("\n");
+	WvsLogger::LogHex(WvsLogger::LEVEL_NORMAL, "", m_aBuff, m_nPacketSize);
+}
+
+void InPacket::Dump(const char *sPrefix)
+{
+	WvsLogger::LogPacket(sPrefix, m_aBuff, m_nPacketSize);
 }
 
 unsigned char* InPacket::GetPacket() const
@@ -41,4 +41,7 @@ public:
 
 	//Just for debugging purposes.
 	void Print();
+
+	//Dumps the packet only if the packet log level/sampling policy of WvsLogger allows it.
+	void Dump(const char *sPrefix);
 };
\ No newline at end of file
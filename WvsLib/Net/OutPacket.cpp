@@ -3,13 +3,58 @@
 #include "..\Logger\WvsLogger.h"
 #include "..\Memory\MemoryPoolMan.hpp"
 
+std::atomic<unsigned int> OutPacket::ms_anPredictedSize[OutPacket::MAX_PREDICTED_OPCODE];
+std::atomic<unsigned int> OutPacket::ms_anPacketCount[OutPacket::MAX_PREDICTED_OPCODE];
+std::atomic<unsigned int> OutPacket::ms_anExtendCount[OutPacket::MAX_PREDICTED_OPCODE];
+
 void OutPacket::ExtendSize(int nExtendRate = 2)
 {
 	decltype(m_pSharedPacket->m_aBuff) newBuff = AllocArray(unsigned char, (m_pSharedPacket->m_nBuffSize * nExtendRate));
-	memcpy(newBuff, m_pSharedPacket->m_aBuff, m_pSharedPacket->m_nBuffSize);
+	memcpy(newBuff, m_pSharedPacket->m_aBuff, m_pSharedPacket->m_nPacketSize);
 	FreeArray(m_pSharedPacket->m_aBuff);
 	m_pSharedPacket->m_nBuffSize *= nExtendRate;
 	m_pSharedPacket->m_aBuff = newBuff;
+	++m_pSharedPacket->m_nExtendCount;
+}
+
+void OutPacket::EnsureCapacity(unsigned int nSize)
+{
+	if (nSize < m_pSharedPacket->m_nBuffSize)
+		return;
+	int nExtendRate = 2;
+	while (m_pSharedPacket->m_nBuffSize * nExtendRate <= nSize)
+		nExtendRate *= 2;
+	ExtendSize(nExtendRate);
+}
+
+void OutPacket::Reserve(unsigned int nSize)
+{
+	EnsureCapacity(m_pSharedPacket->m_nPacketSize + nSize);
+}
+
+void OutPacket::OnEncodeOpcode(unsigned short nOpcode)
+{
+	m_pSharedPacket->m_nOpcode = nOpcode;
+	if (nOpcode < MAX_PREDICTED_OPCODE)
+	{
+		unsigned int nPredicted = ms_anPredictedSize[nOpcode].load(std::memory_order_relaxed);
+		if (nPredicted + INITIAL_WRITE_INDEX >= m_pSharedPacket->m_nBuffSize)
+		{
+			//Nothing but the this pointer has been written, so it's not counted as an extend.
+			unsigned int nExtendCount = m_pSharedPacket->m_nExtendCount;
+			EnsureCapacity(nPredicted + INITIAL_WRITE_INDEX);
+			m_pSharedPacket->m_nExtendCount = nExtendCount;
+		}
+	}
+}
+
+std::vector<OutPacket::OpcodeStat> OutPacket::GetOpcodeStat()
+{
+	std::vector<OpcodeStat> aRet;
+	for (int i = 0; i < MAX_PREDICTED_OPCODE; ++i)
+		if (ms_anPacketCount[i])
+			aRet.push_back({ i, ms_anPacketCount[i], ms_anExtendCount[i], ms_anPredictedSize[i] });
+	return aRet;
 }
 
 OutPacket::OutPacket()
@@ -18,6 +63,14 @@ OutPacket::OutPacket()
 	(*((long long int*)m_pSharedPacket->m_aBuff)) = (long long int)(m_pSharedPacket);
 }
 
+OutPacket::OutPacket(int nSizeHint)
+{
+	m_pSharedPacket = AllocObjCtor(SharedPacket)(
+		(unsigned int)(nSizeHint > DEFAULT_BUFF_SIZE - INITIAL_WRITE_INDEX ? nSizeHint + INITIAL_WRITE_INDEX + 1 : DEFAULT_BUFF_SIZE)
+	);
+	(*((long long int*)m_pSharedPacket->m_aBuff)) = (long long int)(m_pSharedPacket);
+}
+
 OutPacket::~OutPacket()
 {
 	DecRefCount();
@@ -33,6 +86,8 @@ void OutPacket::Encode1(char value)
 
 void OutPacket::Encode2(short value)
 {
+	if (m_pSharedPacket->m_nPacketSize == INITIAL_WRITE_INDEX)
+		OnEncodeOpcode((unsigned short)value);
 	if (m_pSharedPacket->m_nPacketSize + sizeof(value) >= m_pSharedPacket->m_nBuffSize)
 		ExtendSize();
 	*(decltype(value)*)(m_pSharedPacket->m_aBuff + m_pSharedPacket->m_nPacketSize) = value;
@@ -57,8 +112,7 @@ void OutPacket::Encode8(long long int value)
 
 void OutPacket::EncodeBuffer(unsigned char *buff, int nSize, int nZero)
 {
-	if (m_pSharedPacket->m_nPacketSize + nSize + nZero >= m_pSharedPacket->m_nBuffSize)
-		ExtendSize((int)std::ceil((m_pSharedPacket->m_nPacketSize + nSize + nZero) / m_pSharedPacket->m_nBuffSize) + 1);
+	EnsureCapacity(m_pSharedPacket->m_nPacketSize + nSize + nZero);
 	if (buff == nullptr) 
 	{
 		int nEncode4Count = nSize / 4;
@@ -81,8 +135,7 @@ void OutPacket::EncodeBuffer(unsigned char *buff, int nSize, int nZero)
 void OutPacket::EncodeStr(const std::string &str)
 {
 	Encode2((short)str.size());
-	if (m_pSharedPacket->m_nPacketSize + str.size() >= m_pSharedPacket->m_nBuffSize)
-		ExtendSize();
+	EnsureCapacity(m_pSharedPacket->m_nPacketSize + (unsigned int)str.size());
 	memcpy(m_pSharedPacket->m_aBuff + m_pSharedPacket->m_nPacketSize, str.c_str(), str.size());
 	m_pSharedPacket->m_nPacketSize += (unsigned int)str.size();
 }
@@ -110,10 +163,7 @@ void OutPacket::DecRefCount()
 
 void OutPacket::Print()
 {
-	WvsLogger::LogRaw("OutPacket to bytes (HEX):");
-	for (unsigned int i = 0; i < m_pSharedPacket->m_nPacketSize; ++i)
-		WvsLogger::LogFormat("0x%02X ", (int)m_pSharedPacket->m_aBuff[i]);
-	WvsLogger::LogRaw("\n");
+	WvsLogger::LogHex(WvsLogger::LEVEL_NORMAL, "OutPacket to bytes (HEX):", m_pSharedPacket->m_aBuff, m_pSharedPacket->m_nPacketSize);
 }
 
 OutPacket::SharedPacket * OutPacket::GetSharedPacket()
@@ -144,18 +194,16 @@ OutPacket::SharedPacket::SharedPacket()
 {
 }
 
-OutPacket::SharedPacket::~SharedPacket()
-{
-}
-
-void OutPacket::SharedPacket::ToggleBroadcasting()
+OutPacket::SharedPacket::SharedPacket(unsigned int nBuffSize)
+	: m_aBuff(AllocArray(unsigned char, nBuffSize)),
+	m_nBuffSize(nBuffSize),
+	m_nPacketSize(INITIAL_WRITE_INDEX),
+	m_nRefCount(1)
 {
-	m_bBroadcasting = true;
 }
 
-bool OutPacket::SharedPacket::IsBroadcasting() const
+OutPacket::SharedPacket::~SharedPacket()
 {
-	return m_bBroadcasting;
 }
 
 void OutPacket::SharedPacket::IncRefCount()
@@ -167,9 +215,19 @@ void OutPacket::SharedPacket::DecRefCount()
 {
 	if (--m_nRefCount <= 0)
 	{
+		//Learn the typical size of the opcode: follow larger packets immediately, decay slowly towards smaller ones.
+		if (m_nOpcode >= 0 && m_nOpcode < MAX_PREDICTED_OPCODE)
+		{
+			unsigned int nSize = m_nPacketSize - INITIAL_WRITE_INDEX;
+			unsigned int nPredicted = ms_anPredictedSize[m_nOpcode].load(std::memory_order_relaxed);
+			ms_anPredictedSize[m_nOpcode].store(
+				nSize >= nPredicted ? nSize : nPredicted - (nPredicted - nSize) / 8, 
+				std::memory_order_relaxed
+			);
+			ms_anPacketCount[m_nOpcode].fetch_add(1, std::memory_order_relaxed);
+			ms_anExtendCount[m_nOpcode].fetch_add(m_nExtendCount, std::memory_order_relaxed);
+		}
 		FreeArray(m_aBuff);
-		for (auto p : m_aBroadcasted) 
-			FreeArray((unsigned char*)p);
 		//delete[] aBuff;
 		//MSMemoryPoolMan::GetInstance()->DestructArray(aBuff);
 		//delete this;
@@ -177,7 +235,3 @@ void OutPacket::SharedPacket::DecRefCount()
 	}
 }
 
-void OutPacket::SharedPacket::AttachBroadcastingPacket(void * p)
-{
-	m_aBroadcasted.push_back(p);
-}
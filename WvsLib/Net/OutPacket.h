@@ -12,39 +12,61 @@ public:
 		DEFAULT_BUFF_SIZE = 256,
 		THIS_PTR_OFFSET = 8, //8 bytes are reserved for 64-bit addressing
 		HEADER_OFFSET = 4, //4 bytes are for packet header
-		INITIAL_WRITE_INDEX = THIS_PTR_OFFSET + HEADER_OFFSET;
+		INITIAL_WRITE_INDEX = THIS_PTR_OFFSET + HEADER_OFFSET,
+		MAX_PREDICTED_OPCODE = 0x400; //Opcodes beyond this value are not tracked by the size predictor.
+
+	struct OpcodeStat
+	{
+		int nOpcode;
+		unsigned int nPacketCount, nExtendCount, nPredictedSize;
+	};
 
 	class SharedPacket {
 	private:
 		friend class OutPacket;
 
 		unsigned char* m_aBuff = nullptr;
-		unsigned int m_nBuffSize = 0, m_nPacketSize = INITIAL_WRITE_INDEX;
-		bool m_bBroadcasting = false;
+		unsigned int m_nBuffSize = 0, m_nPacketSize = INITIAL_WRITE_INDEX, m_nExtendCount = 0;
+		int m_nOpcode = -1;
 
 		std::atomic<int> m_nRefCount;
-		std::vector<void*> m_aBroadcasted;
 
 	public:
 		SharedPacket();
+		SharedPacket(unsigned int nBuffSize);
 		~SharedPacket();
 
-		void ToggleBroadcasting();
-		bool IsBroadcasting() const;
-
 		void IncRefCount();
 		void DecRefCount();
-		void AttachBroadcastingPacket(void* p);
 	};
 
 	void ExtendSize(int nExtendRate);
 
+	/*Make sure that at least nSize bytes of payload can be encoded without reallocation.*/
+	void Reserve(unsigned int nSize);
+
+	static std::vector<OpcodeStat> GetOpcodeStat();
+
 private:
 	SharedPacket* m_pSharedPacket;
 
+	/*
+	Learned size of each opcode, the buffer is reserved when the opcode is encoded so that large packets 
+	(e.g. character data, enter-field, shop scanner results) are encoded without reallocation.
+	*/
+	static std::atomic<unsigned int> ms_anPredictedSize[MAX_PREDICTED_OPCODE];
+	static std::atomic<unsigned int> ms_anPacketCount[MAX_PREDICTED_OPCODE];
+	static std::atomic<unsigned int> ms_anExtendCount[MAX_PREDICTED_OPCODE];
+
+	void EnsureCapacity(unsigned int nSize);
+	void OnEncodeOpcode(unsigned short nOpcode);
+
 public:
 
 	OutPacket();
+
+	/*Construct a packet with nSizeHint bytes of payload reserved.*/
+	explicit OutPacket(int nSizeHint);
 	//OutPacket(short nOpcode);
 	~OutPacket();
 
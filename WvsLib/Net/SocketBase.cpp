@@ -10,18 +10,23 @@
 
 #include "..\Crypto\WvsCrypto.hpp"
 #include "..\Logger\WvsLogger.h"
+#include "..\Logger\WvsPacketTrace.h"
 
 std::mutex SocketBase::stSocketRecordMtx;
 std::set<unsigned int> SocketBase::stSocketIDRecord;
+std::atomic<unsigned long long> SocketBase::stProcessedPacketCount{ 0 };
 
 
 SocketBase::SocketBase(asio::io_service& serverService, bool bIsLocalServer)
 	: m_Socket(serverService),
 	m_Resolver(serverService),
+	m_Strand(serverService),
 	m_bIsLocalServer(bIsLocalServer),
 	m_nSocketID(SocketBase::DesignateSocketID()),
 	m_aRecvIV((unsigned char*)AllocArray(char, 16)),
-	m_aSendIV((unsigned char*)AllocArray(char, 16))
+	m_aSendIV((unsigned char*)AllocArray(char, 16)),
+	m_aSendRing(AllocArray(unsigned char, SEND_RING_SIZE)),
+	m_aRecvBuffer(AllocArray(unsigned char, RECV_BUFFER_SIZE))
 {
 }
 
@@ -29,6 +34,11 @@ SocketBase::~SocketBase()
 {
 	FreeArray(m_aRecvIV);
 	FreeArray(m_aSendIV);
+	for (auto& segment : m_qSendSegment)
+		if (!segment.bInRing)
+			FreeArray(segment.pBuffer);
+	FreeArray(m_aSendRing);
+	FreeArray(m_aRecvBuffer);
 }
 
 void SocketBase::SetSocketDisconnectedCallBack(const std::function<void(SocketBase *)>& fObject)
@@ -75,9 +85,9 @@ void SocketBase::Connect(const std::string & strAddr, short nPort)
 	asio::ip::tcp::resolver::query centerSrvQuery(strAddr, std::to_string(nPort));
 
 	m_Resolver.async_resolve(centerSrvQuery,
-		std::bind(&SocketBase::OnResolve, std::dynamic_pointer_cast<SocketBase>(shared_from_this()),
+		m_Strand.wrap(std::bind(&SocketBase::OnResolve, std::dynamic_pointer_cast<SocketBase>(shared_from_this()),
 			std::placeholders::_1,
-			std::placeholders::_2));
+			std::placeholders::_2)));
 }
 
 void SocketBase::OnResolve(const std::error_code & err, asio::ip::tcp::resolver::iterator endpoint_iterator)
@@ -86,8 +96,8 @@ void SocketBase::OnResolve(const std::error_code & err, asio::ip::tcp::resolver:
 	{
 		asio::ip::tcp::endpoint endpoint = *endpoint_iterator;
 		GetSocket().async_connect(endpoint,
-			std::bind(&SocketBase::OnConnectResult, std::static_pointer_cast<SocketBase>(shared_from_this()),
-				std::placeholders::_1, ++endpoint_iterator));
+			m_Strand.wrap(std::bind(&SocketBase::OnConnectResult, std::static_pointer_cast<SocketBase>(shared_from_this()),
+				std::placeholders::_1, ++endpoint_iterator)));
 	}
 	else
 	{
@@ -163,6 +173,11 @@ asio::ip::tcp::socket& SocketBase::GetSocket()
 	return m_Socket;
 }
 
+asio::io_service::strand& SocketBase::GetStrand()
+{
+	return m_Strand;
+}
+
 SocketBase::SocketStatus SocketBase::GetSocketStatus() const
 {
 	return m_eSocketStatus;
@@ -182,109 +197,211 @@ void SocketBase::SendPacket(OutPacket *oPacket, bool bIsHandShakePacket)
 			OnDisconnect();
 		return;
 	}
-	oPacket->IncRefCount();
-
-	auto pBuffer = oPacket->GetPacket();
 
 	/*
-	[+] 19/05/07
-	Since the encrypt function would directly write on passed-buffer, 
-	it is necessary to replicate a buffer for broadcasting.
+	The packet is encrypted from the shared buffer into the send queue of this socket, 
+	the shared buffer is never modified (so it can be broadcasted) and needn't be kept alive until the write completes.
 	*/
-	if (oPacket->GetSharedPacket()->IsBroadcasting()) 
+	unsigned short nPacketSize = (unsigned short)oPacket->GetPacketSize();
+	if (WvsPacketTrace::IsEnabled())
+		WvsPacketTrace::Trace(m_nSocketID, WvsPacketTrace::TRACE_SEND, oPacket->GetPacket(), nPacketSize);
+	if (!bIsHandShakePacket)
 	{
-		pBuffer = AllocArray(unsigned char, oPacket->GetPacketSize() + OutPacket::HEADER_OFFSET) + OutPacket::HEADER_OFFSET;
-		memcpy(pBuffer, oPacket->GetPacket(), oPacket->GetPacketSize());
-		oPacket->GetSharedPacket()->AttachBroadcastingPacket(pBuffer - OutPacket::HEADER_OFFSET);
+		auto pBuffer = AllocSendSegment(nPacketSize + OutPacket::HEADER_OFFSET);
+		WvsCrypto::InitializeEncryption(pBuffer, m_aSendIV, nPacketSize);
+		if (!m_bIsLocalServer)
+			WvsCrypto::Encrypt(oPacket->GetPacket(), pBuffer + OutPacket::HEADER_OFFSET, m_aSendIV, nPacketSize);
+		else
+			memcpy(pBuffer + OutPacket::HEADER_OFFSET, oPacket->GetPacket(), nPacketSize);
 	}
+	else
+		memcpy(AllocSendSegment(nPacketSize), oPacket->GetPacket(), nPacketSize);
 
-	if (!bIsHandShakePacket)
+	FlushSendQueue();
+}
+
+unsigned char* SocketBase::AllocSendSegment(unsigned int nSize)
+{
+	SendSegment segment{ nullptr, 0, nSize, true };
+	if (m_nSendRingSegment == 0)
+		m_nSendRingHead = m_nSendRingTail = 0;
+
+	//Not wrapped: [Head, Tail) is in use, try [Tail, End) first and then [0, Head).
+	if (m_nSendRingSegment == 0 || m_nSendRingTail > m_nSendRingHead)
 	{
-		WvsCrypto::InitializeEncryption(pBuffer - OutPacket::HEADER_OFFSET, m_aSendIV, oPacket->GetPacketSize());
-		if (!m_bIsLocalServer)
-			WvsCrypto::Encrypt(pBuffer, m_aSendIV, oPacket->GetPacketSize());
-		asio::async_write(m_Socket,
-			asio::buffer(pBuffer - OutPacket::HEADER_OFFSET, oPacket->GetPacketSize() + OutPacket::HEADER_OFFSET),
-			std::bind(&SocketBase::OnSendPacketFinished,
-				shared_from_this(), 
-				std::placeholders::_1, 
-				std::placeholders::_2, 
-				pBuffer - (OutPacket::HEADER_OFFSET),
-				oPacket->GetSharedPacket()));
+		if (SEND_RING_SIZE - m_nSendRingTail >= nSize)
+			segment.nOffset = m_nSendRingTail;
+		else if (m_nSendRingHead >= nSize)
+			segment.nOffset = 0;
+		else
+			segment.bInRing = false;
 	}
+	//Wrapped: only [Tail, Head) is available.
+	else if (m_nSendRingHead - m_nSendRingTail < nSize)
+		segment.bInRing = false;
 	else
+		segment.nOffset = m_nSendRingTail;
+
+	if (segment.bInRing)
 	{
-		asio::async_write(m_Socket,
-			asio::buffer(pBuffer, oPacket->GetPacketSize()),
-			std::bind(&SocketBase::OnSendPacketFinished,
-				shared_from_this(), 
-				std::placeholders::_1, 
-				std::placeholders::_2, 
-				pBuffer - (OutPacket::HEADER_OFFSET),
-				oPacket->GetSharedPacket()));
+		segment.pBuffer = m_aSendRing + segment.nOffset;
+		m_nSendRingTail = segment.nOffset + nSize;
+		++m_nSendRingSegment;
 	}
+	else
+		segment.pBuffer = AllocArray(unsigned char, nSize);
+
+	m_qSendSegment.push_back(segment);
+	return segment.pBuffer;
 }
 
-void SocketBase::OnSendPacketFinished(const std::error_code &ec, std::size_t bytes_transferred, unsigned char *buffer, void *pPacket)
+void SocketBase::FlushSendQueue()
 {
-	((OutPacket::SharedPacket*)pPacket)->DecRefCount();
+	if (m_bSending || m_qSendSegment.empty())
+		return;
+
+	//Gather as many pending segments as possible into one write.
+	m_aSendingBuffer.clear();
+	for (auto& segment : m_qSendSegment)
+	{
+		if (m_aSendingBuffer.size() >= MAX_GATHER_SEGMENT)
+			break;
+		m_aSendingBuffer.push_back(asio::buffer(segment.pBuffer, segment.nSize));
+	}
+	m_nSendingSegment = (int)m_aSendingBuffer.size();
+	m_bSending = true;
+
+	//SendPacket may be called by any thread, the write is started on the strand like every other operation of the socket.
+	//m_aSendingBuffer is left alone until OnSendPacketFinished since m_bSending is set.
+	auto pSocket = shared_from_this();
+	m_Strand.dispatch([pSocket]()
+	{
+		asio::async_write(pSocket->m_Socket,
+			pSocket->m_aSendingBuffer,
+			pSocket->m_Strand.wrap(std::bind(&SocketBase::OnSendPacketFinished,
+				pSocket,
+				std::placeholders::_1,
+				std::placeholders::_2)));
+	});
+}
+
+void SocketBase::OnSendPacketFinished(const std::error_code &ec, std::size_t bytes_transferred)
+{
+	std::lock_guard<std::mutex> lock(m_mtxLock);
+	for (int i = 0; i < m_nSendingSegment; ++i)
+	{
+		auto& segment = m_qSendSegment.front();
+		if (segment.bInRing)
+		{
+			m_nSendRingHead = segment.nOffset + segment.nSize;
+			--m_nSendRingSegment;
+		}
+		else
+			FreeArray(segment.pBuffer);
+		m_qSendSegment.pop_front();
+	}
+	m_nSendingSegment = 0;
+	m_bSending = false;
+
+	if (!ec)
+		FlushSendQueue();
 }
 
 void SocketBase::OnWaitingPacket()
 {
-	auto buffer = AllocArray(unsigned char, 4);
-	asio::async_read(m_Socket,
-		asio::buffer(buffer, 4),
-		std::bind(&SocketBase::OnReceive,
-			shared_from_this(), std::placeholders::_1, std::placeholders::_2, buffer));
+	//Move the incomplete packet (if any) to the front of the buffer.
+	if (m_nRecvBegin > 0)
+	{
+		if (m_nRecvEnd > m_nRecvBegin)
+			memmove(m_aRecvBuffer, m_aRecvBuffer + m_nRecvBegin, m_nRecvEnd - m_nRecvBegin);
+		m_nRecvEnd -= m_nRecvBegin;
+		m_nRecvBegin = 0;
+	}
+
+	m_Socket.async_read_some(
+		asio::buffer(m_aRecvBuffer + m_nRecvEnd, m_nRecvBufferSize - m_nRecvEnd),
+		m_Strand.wrap(std::bind(&SocketBase::OnReceive,
+			shared_from_this(), std::placeholders::_1, std::placeholders::_2)));
 }
 
-void SocketBase::OnReceive(const std::error_code &ec, std::size_t bytes_transferred, unsigned char* buffer)
+void SocketBase::OnReceive(const std::error_code &ec, std::size_t bytes_transferred)
 {
-	if (!ec)
+	if (ec)
+	{
+		OnDisconnect();
+		return;
+	}
+
+	m_nRecvEnd += (unsigned int)bytes_transferred;
+	while (m_nRecvEnd - m_nRecvBegin >= OutPacket::HEADER_OFFSET)
 	{
-		unsigned short nPacketLen = WvsCrypto::GetPacketLength(buffer);
+		unsigned char *pHeader = m_aRecvBuffer + m_nRecvBegin;
+		unsigned short nPacketLen = WvsCrypto::GetPacketLength(pHeader);
 		if (nPacketLen < 2 || (!m_bIsLocalServer && nPacketLen > (768 + 1024)))
 		{
 			OnDisconnect();
 			return;
 		}
-		FreeArray(buffer);
-		buffer = AllocArray(unsigned char, nPacketLen);
-		asio::async_read(m_Socket,
-			asio::buffer(buffer, nPacketLen),
-			std::bind(&SocketBase::ProcessPacket,
-				shared_from_this(), std::placeholders::_1, std::placeholders::_2, buffer, nPacketLen));
+
+		//Wait for the rest of the packet.
+		if (m_nRecvEnd - m_nRecvBegin < OutPacket::HEADER_OFFSET + (unsigned int)nPacketLen)
+		{
+			if (OutPacket::HEADER_OFFSET + (unsigned int)nPacketLen > m_nRecvBufferSize)
+				ExtendRecvBuffer(OutPacket::HEADER_OFFSET + nPacketLen);
+			break;
+		}
+
+		m_nRecvBegin += OutPacket::HEADER_OFFSET + nPacketLen;
+		ProcessPacket(pHeader + OutPacket::HEADER_OFFSET, nPacketLen);
+		if (!m_Socket.is_open())
+			return;
 	}
-	else
-		OnDisconnect();
+	if (m_nRecvBegin == m_nRecvEnd)
+		m_nRecvBegin = m_nRecvEnd = 0;
+	OnWaitingPacket();
 }
 
-void SocketBase::ProcessPacket(const std::error_code &ec, std::size_t bytes_transferred, unsigned char* buffer, int nPacketLen)
+void SocketBase::ExtendRecvBuffer(unsigned int nSize)
 {
-	if (!ec)
-	{
-		unsigned short nBytes = static_cast<unsigned short>(bytes_transferred);
+	unsigned int nNewSize = m_nRecvBufferSize;
+	while (nNewSize < nSize)
+		nNewSize = (nNewSize + 2) * 2 - 2;
+
+	auto pNewBuffer = AllocArray(unsigned char, nNewSize);
+	memcpy(pNewBuffer, m_aRecvBuffer + m_nRecvBegin, m_nRecvEnd - m_nRecvBegin);
+	FreeArray(m_aRecvBuffer);
+	m_aRecvBuffer = pNewBuffer;
+	m_nRecvEnd -= m_nRecvBegin;
+	m_nRecvBegin = 0;
+	m_nRecvBufferSize = nNewSize;
+}
 
-		if (!m_bIsLocalServer)
-			WvsCrypto::Decrypt(buffer, m_aRecvIV, nBytes);
-		InPacket iPacket(buffer, nBytes);
-		try 
-		{
-			this->OnPacket(&iPacket);
-		}
-		catch (std::exception& ex) 
-		{
-			iPacket.RestorePacket();
-			WvsLogger::LogFormat("Exceptions Occurred When Processing Packet (nType: %d), Excpetion Message: %s\nPacket Dump:\n", (int)iPacket.Decode2(), ex.what());
-			iPacket.Print();
-		}
-		FreeArray(buffer);
-		OnWaitingPacket();
+void SocketBase::ProcessPacket(unsigned char* buffer, unsigned short nPacketLen)
+{
+	if (!m_bIsLocalServer)
+		WvsCrypto::Decrypt(buffer, m_aRecvIV, nPacketLen);
+	if (WvsPacketTrace::IsEnabled())
+		WvsPacketTrace::Trace(m_nSocketID, WvsPacketTrace::TRACE_RECV, buffer, nPacketLen);
+	InPacket iPacket(buffer, nPacketLen);
+	++stProcessedPacketCount;
+	try 
+	{
+		this->OnPacket(&iPacket);
+	}
+	catch (std::exception& ex) 
+	{
+		iPacket.RestorePacket();
+		WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_ERROR, "Exceptions Occurred When Processing Packet (nType: %d), Excpetion Message: %s\nPacket Dump:\n", (int)iPacket.Decode2(), ex.what());
+		iPacket.Print();
 	}
 }
 
 unsigned int SocketBase::GetSocketID() const
 {
 	return m_nSocketID;
+}
+
+unsigned long long SocketBase::GetProcessedPacketCount()
+{
+	return stProcessedPacketCount;
 }
\ No newline at end of file
@@ -1,6 +1,9 @@
 #pragma once
 #include <set>
 #include <mutex>
+#include <atomic>
+#include <deque>
+#include <vector>
 #include "asio.hpp"
 
 class OutPacket;
@@ -20,6 +23,7 @@ private:
 
 	static std::mutex stSocketRecordMtx;
 	static std::set<unsigned int> stSocketIDRecord;
+	static std::atomic<unsigned long long> stProcessedPacketCount;
 	unsigned char m_nServerType;
 	unsigned int m_nSocketID;
 
@@ -28,9 +32,49 @@ private:
 
 	asio::ip::tcp::socket m_Socket;
 	asio::ip::tcp::resolver m_Resolver;
+
+	//All completion handlers of this socket are dispatched through the strand, 
+	//so packets of one connection are processed in order even if the io_service is run by several threads.
+	asio::io_service::strand m_Strand;
 	std::mutex m_mtxLock;
 
 	unsigned char* m_aRecvIV, *m_aSendIV;
+
+	/*
+	Outgoing packets are encrypted directly from the (shared) OutPacket buffer into the send ring of this socket,
+	so broadcasting a packet costs no extra allocation or copy per recipient.
+	Packets which don't fit in the ring are spilled into a pool-allocated buffer, the queue keeps them in order.
+	*/
+	struct SendSegment
+	{
+		unsigned char *pBuffer;
+		unsigned int nOffset, nSize;
+		bool bInRing;
+	};
+
+	static const unsigned int SEND_RING_SIZE = 0x4000 - 2; //Fits exactly in the 16KB array pool (2 bytes are reserved by the allocator).
+	static const int MAX_GATHER_SEGMENT = 64;
+
+	unsigned char *m_aSendRing = nullptr;
+	unsigned int m_nSendRingHead = 0, m_nSendRingTail = 0, m_nSendRingSegment = 0;
+	std::deque<SendSegment> m_qSendSegment;
+	std::vector<asio::const_buffer> m_aSendingBuffer;
+	int m_nSendingSegment = 0;
+	bool m_bSending = false;
+
+	unsigned char* AllocSendSegment(unsigned int nSize);
+	void FlushSendQueue();
+
+	/*
+	Incoming bytes are read into the receive buffer with a single async_read_some, as many framed packets as available are 
+	decrypted in place and dispatched, InPacket points into the buffer directly.
+	The buffer only grows (local servers only) when a single packet is larger than the buffer.
+	*/
+	static const unsigned int RECV_BUFFER_SIZE = 0x4000 - 2;
+	unsigned char *m_aRecvBuffer = nullptr;
+	unsigned int m_nRecvBufferSize = RECV_BUFFER_SIZE, m_nRecvBegin = 0, m_nRecvEnd = 0;
+
+	void ExtendRecvBuffer(unsigned int nSize);
 	SocketStatus m_eSocketStatus = SocketStatus::eClosed;
 
 	//Note : this flag indicates the role of this socket (true = local server).
@@ -39,10 +83,10 @@ private:
 
 	void EncodeHandShakeInfo(OutPacket *oPacket);
 
-	//Decrease reference counter of given shared packet. 
-	void OnSendPacketFinished(const std::error_code &ec, std::size_t bytes_transferred, unsigned char *buffer, void *pPacket);
-	void OnReceive(const std::error_code &ec, std::size_t bytes_transferred, unsigned char* buffer);
-	void ProcessPacket(const std::error_code &ec, std::size_t bytes_transferred, unsigned char* buffer, int nPacketLen);
+	//Release the segments which have been written and continue with the pending ones.
+	void OnSendPacketFinished(const std::error_code &ec, std::size_t bytes_transferred);
+	void OnReceive(const std::error_code &ec, std::size_t bytes_transferred);
+	void ProcessPacket(unsigned char* buffer, unsigned short nPacketLen);
 	//void(*OnNotifySocketDisconnected)(SocketBase *pSocket);
 	std::function<void(SocketBase *)> m_fSocketDisconnectedCallBack;
 
@@ -60,6 +104,7 @@ public:
 	virtual ~SocketBase();
 
 	asio::ip::tcp::socket& GetSocket();
+	asio::io_service::strand& GetStrand();
 	SocketStatus GetSocketStatus() const;
 	bool CheckSocketStatus(SocketStatus e) const;
 	unsigned int GetSocketID() const;
@@ -72,6 +117,9 @@ public:
 	void OnDisconnect();
 	virtual void OnPacket(InPacket *iPacket) = 0;
 
+	/*Return the number of packets processed by all sockets, for measuring the I/O throughput.*/
+	static unsigned long long GetProcessedPacketCount();
+
 #if defined(_WVSSHOP) || defined(_WVSGAME) || defined(_WVSLOGIN) || defined(_WVSLIB)
 	void Connect(const std::string& strAddr, short nPort);
 	virtual void OnConnected();
@@ -5,6 +5,7 @@
 #include "..\String\StringPool.h"
 
 std::map<unsigned int, SocketBase*> WvsBase::m_mSocketList;
+std::mutex WvsBase::m_mtxSocketList;
 
 WvsBase::WvsBase()
 {
@@ -19,6 +20,11 @@ asio::io_service& WvsBase::GetIOService()
 	return m_IOService;
 }
 
+std::mutex& WvsBase::GetSocketListLock()
+{
+	return m_mtxSocketList;
+}
+
 const std::map<unsigned int, SocketBase*>& WvsBase::GetSocketList() const
 {
 	return m_mSocketList;
@@ -26,6 +32,7 @@ const std::map<unsigned int, SocketBase*>& WvsBase::GetSocketList() const
 
 SocketBase * WvsBase::GetSocket(unsigned int nSocketID)
 {
+	std::lock_guard<std::mutex> lock(m_mtxSocketList);
 	auto findIter = m_mSocketList.find(nSocketID);
 	return findIter == m_mSocketList.end() ? nullptr : findIter->second;
 }
@@ -35,27 +42,63 @@ void WvsBase::Init()
 
 }
 
+void WvsBase::RunIOService(int nThreadCount)
+{
+	if (nThreadCount <= 0)
+		nThreadCount = (int)std::thread::hardware_concurrency();
+	if (nThreadCount <= 0)
+		nThreadCount = 1;
+
+	WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_INFO, "[WvsBase::RunIOService]Running I/O service on %d thread(s).\n", nThreadCount);
+	asio::io_service::work work(m_IOService);
+	auto fIOWorker = [&]()
+	{
+		while (!m_IOService.stopped())
+		{
+			std::error_code ec;
+			m_IOService.run(ec);
+		}
+	};
+
+	for (int i = 1; i < nThreadCount; ++i)
+		m_aIOThread.push_back(std::thread(fIOWorker));
+	fIOWorker();
+
+	for (auto& thread : m_aIOThread)
+		thread.join();
+	m_aIOThread.clear();
+}
+
+int WvsBase::GetIOThreadCount() const
+{
+	return (int)m_aIOThread.size() + 1;
+}
+
 void WvsBase::CreateAcceptor(short nPort)
 {
-	WvsLogger::LogFormat(WvsLogger::LEVEL_INFO, "[WvsBase::CreateAcceptor]WvsApp server instance is successfully initialized and listening on port %d.\n", nPort);
+	WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_INFO, "[WvsBase::CreateAcceptor]WvsApp server instance is successfully initialized and listening on port %d.\n", nPort);
 	asio::ip::tcp::endpoint endpoint(asio::ip::tcp::v4(), nPort);
 	m_pAcceptor = new asio::ip::tcp::acceptor(m_IOService, endpoint);
 }
 
 void WvsBase::OnSocketConnected(SocketBase *pSocket)
 {
+	std::lock_guard<std::mutex> lock(m_mtxSocketList);
 	m_mSocketList.insert({ pSocket->GetSocketID(), pSocket });
 	pSocket->SetSocketDisconnectedCallBack(std::bind(&WvsBase::OnSocketDisconnected, this, std::placeholders::_1));
 }
 
 void WvsBase::OnSocketDisconnected(SocketBase *pSocket)
 {
-	auto findIter = m_mSocketList.find(pSocket->GetSocketID());
-	if (findIter == m_mSocketList.end())
-		return;
-	WvsLogger::LogFormat(WvsLogger::LEVEL_WARNING, "[WvsBase::OnSocketDisconnected]Socket is disconnected from server [Socket ID : %u].\n", pSocket->GetSocketID());
+	{
+		std::lock_guard<std::mutex> lock(m_mtxSocketList);
+		auto findIter = m_mSocketList.find(pSocket->GetSocketID());
+		if (findIter == m_mSocketList.end())
+			return;
+		m_mSocketList.erase(findIter);
+	}
+	WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_WARNING, "[WvsBase::OnSocketDisconnected]Socket is disconnected from server [Socket ID : %u].\n", pSocket->GetSocketID());
 	OnNotifySocketDisconnected(pSocket);
-	m_mSocketList.erase(pSocket->GetSocketID());
 }
 
 void WvsBase::OnNotifySocketDisconnected(SocketBase *pSocket)
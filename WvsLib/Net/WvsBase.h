@@ -1,5 +1,7 @@
 #pragma once
 #include <map>
+#include <vector>
+#include <thread>
 #include "asio.hpp"
 #include "SocketBase.h"
 #include <functional>
@@ -11,12 +13,14 @@ private:
 	asio::io_service m_IOService;
 	asio::ip::tcp::acceptor *m_pAcceptor;
 	static std::map<unsigned int, SocketBase*> m_mSocketList;
+	static std::mutex m_mtxSocketList;
+	std::vector<std::thread> m_aIOThread;
 	int m_nExternalPort = 0, m_aExternalIP[4];
 
 	template<typename SOCKET_TYPE>
 	void OnAccepted(std::shared_ptr<SOCKET_TYPE> pAcceptedSocket, const std::error_code& ec)
 	{
-		WvsLogger::LogFormat(WvsLogger::LEVEL_INFO, "[WvsBase]A new connection is established.\n");
+		WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_INFO, "[WvsBase]A new connection is established.\n");
 		OnSocketConnected((SocketBase*)(pAcceptedSocket.get()));
 		
 		pAcceptedSocket->SetSocketDisconnectedCallBack(std::bind(&WvsBase::OnSocketDisconnected, this, std::placeholders::_1));
@@ -56,11 +60,19 @@ public:
 	virtual void Init();
 	asio::io_service& GetIOService();
 
+	//Run the io_service on nThreadCount threads (including the calling one), nThreadCount <= 0 means one thread per core.
+	//Per-connection ordering is preserved by the strand owned by each SocketBase.
+	//WvsCenter always runs one thread, its handlers share the world state without locking.
+	void RunIOService(int nThreadCount);
+	int GetIOThreadCount() const;
+
 	void SetExternalIP(const std::string& ip);
 	void SetExternalPort(short nPort);
 	int* GetExternalIP() const;
 	short GetExternalPort() const;
 
+	//Lock the socket list before iterating it, since it may be modified by any of the I/O threads.
+	std::mutex& GetSocketListLock();
 	const std::map<unsigned int, SocketBase*>& GetSocketList() const;
 	SocketBase* GetSocket(unsigned int nSocketID);
 
@@ -0,0 +1,33 @@
+#include "AsyncScheduler.h"
+#include "TimerWheel.h"
+
+AsyncScheduler::~AsyncScheduler()
+{
+	//Make sure the wheel no longer refers to this task and that its callback isn't running elsewhere.
+	TimerWheel::GetInstance()->Cancel(this, true);
+}
+
+void AsyncScheduler::Start()
+{
+	m_bTaskDone = false;
+	m_bStarted = true;
+	TimerWheel::GetInstance()->Schedule(this, m_nTimePeriod);
+}
+
+void AsyncScheduler::Pause()
+{
+	m_bTaskDone = true;
+	m_bStarted = false;
+	TimerWheel::GetInstance()->Cancel(this, false);
+}
+
+void AsyncScheduler::Abort()
+{
+	m_bStarted = false;
+	TimerWheel::GetInstance()->Cancel(this, false);
+}
+
+void AsyncScheduler::OnTick()
+{
+	m_bTaskDone = true;
+}
@@ -1,17 +1,37 @@
 #pragma once
-#include <agents.h>
-#include <ppltasks.h>
 #include <functional>
 #include "..\Memory\MemoryPoolMan.hpp"
 
+class TimerWheel;
+
+/*
+A (repeatable) task driven by TimerWheel.
+The scheduler is an intrusive node of the wheel, so Start/Pause/Abort never allocate and are O(1).
+*/
 class AsyncScheduler
 {
+	friend class TimerWheel;
+
 public:
 	unsigned int m_nTimePeriod; //How frequent the timer "tick" (ms unit).
 	bool m_bRepeat, m_bStarted, m_bTaskDone = false;
 
-	Concurrency::timer<int> *m_TimerInstance = nullptr;
-	Concurrency::call<int> *m_TaskCall = nullptr;
+private:
+	enum TaskState
+	{
+		eTask_Idle,
+		eTask_Scheduled,
+		eTask_Queued,
+		eTask_Running
+	};
+
+	std::function<void()> m_fTask;
+
+	//Maintained by TimerWheel under its lock.
+	AsyncScheduler *m_pPrev = nullptr, *m_pNext = nullptr, **m_ppListHead = nullptr;
+	unsigned long long m_liExpire = 0;
+	int m_nState = eTask_Idle;
+	bool m_bRestart = false;
 
 public:
 	AsyncScheduler(unsigned int nTimeInMs, bool bRepeat) :
@@ -20,42 +40,11 @@ public:
 		m_bStarted(false)
 	{}
 
-	~AsyncScheduler()
-	{
-		FreeObj( m_TimerInstance );
-		FreeObj( m_TaskCall );
-	}
+	~AsyncScheduler();
 
-	void Start()
-	{
-		if (!m_bRepeat && m_bTaskDone)
-		{
-			m_TimerInstance = AllocObjCtor(concurrency::timer<int>)(
-				m_nTimePeriod,
-				0,
-				m_TaskCall,
-				m_bRepeat);
-		}
-		m_bTaskDone = false;
-		m_bStarted = true;
-		m_TimerInstance->start();
-	}
-
-	void Pause()
-	{
-		m_bTaskDone = true;
-		m_bStarted = false;
-		m_TimerInstance->pause();
-	}
-
-	void Abort()
-	{
-		if (m_TimerInstance)
-		{
-			m_TimerInstance->stop();
-			m_bStarted = false;
-		}
-	}
+	void Start();
+	void Pause();
+	void Abort();
 
 	bool IsStarted() const
 	{
@@ -67,34 +56,13 @@ public:
 		return m_bTaskDone;
 	}
 
-	void OnTick()
-	{
-		m_bTaskDone = true;
-		if (!m_bRepeat)
-		{
-			m_TimerInstance->stop();
-			FreeObj( m_TimerInstance );
-		}
-	}
+	void OnTick();
 
 	template<typename FUNC_TYPE>
 	static AsyncScheduler* CreateTask(FUNC_TYPE fTask, unsigned int timeInMs, bool repeat)
 	{
 		auto pInstance = AllocObjCtor(AsyncScheduler)(timeInMs, repeat);
-
-		auto pTaskCall = AllocObjCtor(concurrency::call<int>)(
-			[&, pInstance, fTask](int)
-		{
-			fTask();
-			pInstance->OnTick();
-		});
-		pInstance->m_TaskCall = pTaskCall;
-
-		pInstance->m_TimerInstance = AllocObjCtor(concurrency::timer<int>)(
-			pInstance->m_nTimePeriod,
-			0,
-			pTaskCall,
-			pInstance->m_bRepeat);
+		pInstance->m_fTask = fTask;
 		return pInstance;
 	}
 };
@@ -0,0 +1,106 @@
+#include "StartupTaskGraph.h"
+#include "..\Logger\WvsLogger.h"
+#include "..\Exception\WvsException.h"
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
+static long long GetTimeInMicroseconds()
+{
+	return (long long)std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()
+	).count();
+}
+
+int StartupTaskGraph::AddStage(const std::string & sName, const std::function<void()>& fLoader, const std::vector<int>& anDependency)
+{
+	int nIdx = (int)m_aStage.size();
+	m_aStage.push_back(Stage());
+	auto& stage = m_aStage.back();
+	stage.sName = sName;
+	stage.fLoader = fLoader;
+	for (auto nDependency : anDependency)
+	{
+		//Stages may only depend on stages added before them, so the graph can't have cycles.
+		if (nDependency < 0 || nDependency >= nIdx)
+			WvsException::FatalError("[StartupTaskGraph::AddStage]Stage %s depends on an unknown stage %d.", sName.c_str(), nDependency);
+		m_aStage[nDependency].anDependent.push_back(nIdx);
+		++stage.nPendingDependency;
+	}
+	return nIdx;
+}
+
+void StartupTaskGraph::WorkerThread(long long liBaseTime)
+{
+	std::unique_lock<std::mutex> lock(m_mtxLock);
+	while (true)
+	{
+		m_cvReady.wait(lock, [&]() {
+			return !m_anReady.empty() || m_nFinishedCount == (int)m_aStage.size() || (m_pException && m_nRunningCount == 0);
+		});
+		if (m_anReady.empty() || m_pException)
+			break;
+
+		int nIdx = m_anReady.back();
+		m_anReady.pop_back();
+		++m_nRunningCount;
+		auto& stage = m_aStage[nIdx];
+		lock.unlock();
+
+		stage.liBeginTime = GetTimeInMicroseconds() - liBaseTime;
+		std::exception_ptr pException;
+		try
+		{
+			stage.fLoader();
+		}
+		catch (...)
+		{
+			pException = std::current_exception();
+		}
+		stage.liElapsed = GetTimeInMicroseconds() - liBaseTime - stage.liBeginTime;
+
+		lock.lock();
+		--m_nRunningCount;
+		++m_nFinishedCount;
+		if (pException && !m_pException)
+			m_pException = pException;
+		for (auto nDependent : stage.anDependent)
+			if (--m_aStage[nDependent].nPendingDependency == 0)
+				m_anReady.push_back(nDependent);
+		m_cvReady.notify_all();
+	}
+}
+
+void StartupTaskGraph::Run(int nWorkerCount)
+{
+	if (nWorkerCount <= 0)
+		nWorkerCount = (std::max)(2, (int)std::thread::hardware_concurrency());
+	nWorkerCount = (std::min)(nWorkerCount, (std::max)(1, (int)m_aStage.size()));
+
+	//Reverse order so that the stages are popped in the order they were added.
+	for (int i = (int)m_aStage.size() - 1; i >= 0; --i)
+		if (m_aStage[i].nPendingDependency == 0)
+			m_anReady.push_back(i);
+
+	long long liBaseTime = GetTimeInMicroseconds();
+	std::vector<std::thread> aWorker;
+	for (int i = 0; i < nWorkerCount; ++i)
+		aWorker.push_back(std::thread(&StartupTaskGraph::WorkerThread, this, liBaseTime));
+	for (auto& worker : aWorker)
+		worker.join();
+
+	if (m_pException)
+		std::rethrow_exception(m_pException);
+}
+
+void StartupTaskGraph::LogTiming()
+{
+	long long liTotal = 0, liSum = 0;
+	for (auto& stage : m_aStage)
+	{
+		WvsLogger::LogFormat("[StartupTaskGraph]Stage %-28s started at %8lld us, took %8lld us.\n", stage.sName.c_str(), stage.liBeginTime, stage.liElapsed);
+		liTotal = (std::max)(liTotal, stage.liBeginTime + stage.liElapsed);
+		liSum += stage.liElapsed;
+	}
+	WvsLogger::LogFormat("[StartupTaskGraph]%d stages finished in %lld us (%lld us if run sequentially).\n", (int)m_aStage.size(), liTotal, liSum);
+}
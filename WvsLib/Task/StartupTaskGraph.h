@@ -0,0 +1,41 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+/*
+Runs the loaders of a server on a bounded set of threads in dependency order.
+A stage starts once every stage it depends on is finished, Run() returns after all stages are finished (or rethrows the first failure).
+*/
+class StartupTaskGraph
+{
+	struct Stage
+	{
+		std::string sName;
+		std::function<void()> fLoader;
+		std::vector<int> anDependent;
+		int nPendingDependency = 0;
+		long long liBeginTime = 0, liElapsed = 0;
+	};
+
+	std::vector<Stage> m_aStage;
+	std::vector<int> m_anReady;
+	std::mutex m_mtxLock;
+	std::condition_variable m_cvReady;
+	int m_nFinishedCount = 0, m_nRunningCount = 0;
+	std::exception_ptr m_pException;
+
+	void WorkerThread(long long liBaseTime);
+
+public:
+	//Returns the stage index which the later stages use to declare their dependencies.
+	int AddStage(const std::string& sName, const std::function<void()>& fLoader, const std::vector<int>& anDependency = {});
+
+	//nWorkerCount <= 0 means the number of hardware threads.
+	void Run(int nWorkerCount);
+	void LogTiming();
+};
+
@@ -0,0 +1,295 @@
+#include "TimerWheel.h"
+#include "AsyncScheduler.h"
+#include <algorithm>
+#include "..\Logger\WvsLogger.h"
+
+//The task being executed by the current worker thread, used to allow a task to delete itself.
+static thread_local AsyncScheduler *tls_pRunningTask = nullptr;
+static thread_local bool tls_bRunningTaskDestroyed = false;
+
+TimerWheel::TimerWheel()
+{
+	for (auto& pSlot : m_apRootSlot)
+		pSlot = nullptr;
+	for (auto& aLevel : m_apLevelSlot)
+		for (auto& pSlot : aLevel)
+			pSlot = nullptr;
+	m_tBase = std::chrono::steady_clock::now();
+}
+
+TimerWheel::~TimerWheel()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mtxWheelLock);
+		m_bRunning = false;
+	}
+	m_cvReady.notify_all();
+	if (m_tDriver.joinable())
+		m_tDriver.join();
+	for (auto& t : m_aWorker)
+		if (t.joinable())
+			t.join();
+}
+
+TimerWheel * TimerWheel::GetInstance()
+{
+	static TimerWheel* pInstance = new TimerWheel;
+	return pInstance;
+}
+
+void TimerWheel::Initialize(int nWorkerCount)
+{
+	std::call_once(m_flagInit, [&]() {
+		if (nWorkerCount <= 0)
+			nWorkerCount = (std::max)(2, (int)std::thread::hardware_concurrency());
+
+		std::lock_guard<std::mutex> lock(m_mtxWheelLock);
+		m_bRunning = true;
+		for (int i = 0; i < nWorkerCount; ++i)
+			m_aWorker.push_back(std::thread(&TimerWheel::WorkerThread, this));
+		m_tDriver = std::thread(&TimerWheel::DriverThread, this);
+		WvsLogger::LogFormat(WvsLogger::LEVEL_INFO, "[TimerWheel::Initialize]Timer wheel is running with %d worker thread(s).\n", nWorkerCount);
+	});
+}
+
+unsigned long long TimerWheel::GetTickNow() const
+{
+	return (unsigned long long)std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now() - m_tBase
+	).count() / TICK_MS;
+}
+
+void TimerWheel::Link(AsyncScheduler * pTask, AsyncScheduler ** ppListHead)
+{
+	pTask->m_ppListHead = ppListHead;
+	pTask->m_pPrev = nullptr;
+	pTask->m_pNext = *ppListHead;
+	if (*ppListHead)
+		(*ppListHead)->m_pPrev = pTask;
+	*ppListHead = pTask;
+}
+
+void TimerWheel::Unlink(AsyncScheduler * pTask)
+{
+	if (!pTask->m_ppListHead)
+		return;
+	if (pTask->m_pPrev)
+		pTask->m_pPrev->m_pNext = pTask->m_pNext;
+	else
+		*(pTask->m_ppListHead) = pTask->m_pNext;
+	if (pTask->m_pNext)
+		pTask->m_pNext->m_pPrev = pTask->m_pPrev;
+	else if (pTask == m_pReadyTail)
+		m_pReadyTail = pTask->m_pPrev;
+	pTask->m_pPrev = pTask->m_pNext = nullptr;
+	pTask->m_ppListHead = nullptr;
+}
+
+void TimerWheel::Insert(AsyncScheduler * pTask)
+{
+	if (pTask->m_liExpire < m_liCurrentTick)
+		pTask->m_liExpire = m_liCurrentTick;
+
+	unsigned long long liExpire = pTask->m_liExpire, liDelta = liExpire - m_liCurrentTick;
+	if (liDelta < ROOT_SIZE)
+	{
+		Link(pTask, &m_apRootSlot[liExpire & (ROOT_SIZE - 1)]);
+		return;
+	}
+	for (int i = 0; i < LEVEL_COUNT - 1; ++i)
+	{
+		int nShift = ROOT_BITS + i * LEVEL_BITS;
+		if (liDelta < (1ULL << (nShift + LEVEL_BITS)))
+		{
+			Link(pTask, &m_apLevelSlot[i][(liExpire >> nShift) & (LEVEL_SIZE - 1)]);
+			return;
+		}
+	}
+
+	//Beyond the range of the wheel, park it in the farthest slot and it will be re-cascaded from there.
+	int nShift = ROOT_BITS + (LEVEL_COUNT - 2) * LEVEL_BITS;
+	liExpire = m_liCurrentTick + (1ULL << (nShift + LEVEL_BITS)) - 1;
+	Link(pTask, &m_apLevelSlot[LEVEL_COUNT - 2][(liExpire >> nShift) & (LEVEL_SIZE - 1)]);
+}
+
+void TimerWheel::Cascade(int nLevel, int nIdx)
+{
+	AsyncScheduler *pTask = m_apLevelSlot[nLevel][nIdx], *pNext = nullptr;
+	m_apLevelSlot[nLevel][nIdx] = nullptr;
+	while (pTask)
+	{
+		pNext = pTask->m_pNext;
+		pTask->m_pPrev = pTask->m_pNext = nullptr;
+		pTask->m_ppListHead = nullptr;
+		Insert(pTask);
+		pTask = pNext;
+	}
+}
+
+void TimerWheel::Advance()
+{
+	++m_liCurrentTick;
+	int nRootIdx = (int)(m_liCurrentTick & (ROOT_SIZE - 1));
+	if (nRootIdx == 0)
+	{
+		//Cascade from the outermost level so that the lower levels receive their tasks before they are cascaded.
+		for (int i = LEVEL_COUNT - 2; i >= 0; --i)
+		{
+			int nShift = ROOT_BITS + i * LEVEL_BITS;
+			if ((m_liCurrentTick & ((1ULL << nShift) - 1)) == 0)
+				Cascade(i, (int)((m_liCurrentTick >> nShift) & (LEVEL_SIZE - 1)));
+		}
+	}
+
+	AsyncScheduler *pTask = m_apRootSlot[nRootIdx], *pNext = nullptr;
+	m_apRootSlot[nRootIdx] = nullptr;
+	while (pTask)
+	{
+		pNext = pTask->m_pNext;
+		pTask->m_pPrev = pTask->m_pNext = nullptr;
+		pTask->m_ppListHead = nullptr;
+		PushReady(pTask);
+		pTask = pNext;
+	}
+}
+
+void TimerWheel::PushReady(AsyncScheduler * pTask)
+{
+	pTask->m_nState = AsyncScheduler::eTask_Queued;
+	pTask->m_ppListHead = &m_pReadyHead;
+	pTask->m_pNext = nullptr;
+	pTask->m_pPrev = m_pReadyTail;
+	if (m_pReadyTail)
+		m_pReadyTail->m_pNext = pTask;
+	else
+		m_pReadyHead = pTask;
+	m_pReadyTail = pTask;
+}
+
+void TimerWheel::DriverThread()
+{
+	std::unique_lock<std::mutex> lock(m_mtxWheelLock);
+	while (m_bRunning)
+	{
+		auto liTarget = GetTickNow();
+		if (liTarget > m_liCurrentTick + 1)
+			m_liLateTick += liTarget - m_liCurrentTick - 1;
+		while (m_liCurrentTick < liTarget)
+			Advance();
+		if (m_pReadyHead)
+			m_cvReady.notify_all();
+
+		auto tNext = m_tBase + std::chrono::milliseconds((m_liCurrentTick + 1) * TICK_MS);
+		lock.unlock();
+		std::this_thread::sleep_until(tNext);
+		lock.lock();
+	}
+}
+
+void TimerWheel::WorkerThread()
+{
+	std::unique_lock<std::mutex> lock(m_mtxWheelLock);
+	while (m_bRunning)
+	{
+		if (!m_pReadyHead)
+		{
+			m_cvReady.wait(lock);
+			continue;
+		}
+		auto pTask = m_pReadyHead;
+		Unlink(pTask);
+		--m_liPendingCount;
+		++m_liFiredCount;
+		pTask->m_nState = AsyncScheduler::eTask_Running;
+		pTask->m_bRestart = pTask->m_bRepeat;
+		tls_pRunningTask = pTask;
+		tls_bRunningTaskDestroyed = false;
+		lock.unlock();
+
+		try
+		{
+			pTask->m_fTask();
+
+			//The task may have cancelled and deleted itself, the flag is set on this thread by Cancel.
+			if (!tls_bRunningTaskDestroyed)
+				pTask->OnTick();
+		}
+		catch (std::exception& ex)
+		{
+			WvsLogger::LogFormat(WvsLogger::LEVEL_ERROR, "[TimerWheel::WorkerThread]Exception occurred in scheduled task: %s\n", ex.what());
+		}
+
+		lock.lock();
+		tls_pRunningTask = nullptr;
+		if (tls_bRunningTaskDestroyed)
+			continue;
+		if (pTask->m_bRestart)
+		{
+			pTask->m_nState = AsyncScheduler::eTask_Scheduled;
+			pTask->m_liExpire = m_liCurrentTick + (std::max)(1U, (pTask->m_nTimePeriod + TICK_MS - 1) / TICK_MS);
+			Insert(pTask);
+			++m_liPendingCount;
+		}
+		else
+			pTask->m_nState = AsyncScheduler::eTask_Idle;
+		m_cvDone.notify_all();
+	}
+}
+
+void TimerWheel::Schedule(AsyncScheduler * pTask, unsigned int nDelayInMs)
+{
+	Initialize(0);
+	std::lock_guard<std::mutex> lock(m_mtxWheelLock);
+	switch (pTask->m_nState)
+	{
+		case AsyncScheduler::eTask_Running:
+			//Re-inserted by the worker once the current run finishes.
+			pTask->m_bRestart = true;
+			return;
+		case AsyncScheduler::eTask_Scheduled:
+		case AsyncScheduler::eTask_Queued:
+			Unlink(pTask);
+			break;
+		default:
+			++m_liPendingCount;
+	}
+	pTask->m_nState = AsyncScheduler::eTask_Scheduled;
+	pTask->m_liExpire = m_liCurrentTick + (std::max)(1U, (nDelayInMs + TICK_MS - 1) / TICK_MS);
+	Insert(pTask);
+}
+
+void TimerWheel::Cancel(AsyncScheduler * pTask, bool bWaitForRunning)
+{
+	std::unique_lock<std::mutex> lock(m_mtxWheelLock);
+	while (true)
+	{
+		if (pTask->m_nState == AsyncScheduler::eTask_Scheduled ||
+			pTask->m_nState == AsyncScheduler::eTask_Queued)
+		{
+			Unlink(pTask);
+			--m_liPendingCount;
+			pTask->m_nState = AsyncScheduler::eTask_Idle;
+		}
+		else if (pTask->m_nState == AsyncScheduler::eTask_Running)
+		{
+			pTask->m_bRestart = false;
+			if (bWaitForRunning)
+			{
+				if (tls_pRunningTask == pTask)
+					tls_bRunningTaskDestroyed = true;
+				else
+				{
+					m_cvDone.wait(lock);
+					continue;
+				}
+			}
+		}
+		break;
+	}
+}
+
+TimerWheel::TimerStat TimerWheel::GetStat()
+{
+	std::lock_guard<std::mutex> lock(m_mtxWheelLock);
+	return TimerStat{ (int)m_aWorker.size(), m_liPendingCount, m_liFiredCount, m_liCurrentTick, m_liLateTick };
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <condition_variable>
+
+class AsyncScheduler;
+
+/*
+Hierarchical timing wheel which drives every AsyncScheduler.
+One driver thread advances the wheel every TICK_MS and hands due tasks to a fixed set of worker threads.
+The tasks themselves are the list nodes, so scheduling/cancelling is O(1) and a tick allocates nothing.
+
+Level 0 has 256 slots of one tick, the upper levels have 64 slots each covering the whole lower level,
+tasks are cascaded down when the lower level wraps around (10ms * 2^26 ticks ~ 7.7 days, longer delays are re-cascaded).
+*/
+class TimerWheel
+{
+public:
+	static const int TICK_MS = 10;
+	static const int LEVEL_COUNT = 4;
+	static const int ROOT_BITS = 8, LEVEL_BITS = 6;
+	static const int ROOT_SIZE = 1 << ROOT_BITS, LEVEL_SIZE = 1 << LEVEL_BITS;
+
+	struct TimerStat
+	{
+		int nWorkerCount;
+		unsigned long long liPendingCount, liFiredCount, liCurrentTick, liLateTick;
+	};
+
+private:
+	std::mutex m_mtxWheelLock;
+	std::condition_variable m_cvReady, m_cvDone;
+
+	AsyncScheduler *m_apRootSlot[ROOT_SIZE];
+	AsyncScheduler *m_apLevelSlot[LEVEL_COUNT - 1][LEVEL_SIZE];
+	AsyncScheduler *m_pReadyHead = nullptr, *m_pReadyTail = nullptr;
+
+	unsigned long long m_liCurrentTick = 0, m_liPendingCount = 0, m_liFiredCount = 0, m_liLateTick = 0;
+	std::chrono::steady_clock::time_point m_tBase;
+	std::vector<std::thread> m_aWorker;
+	std::thread m_tDriver;
+	std::once_flag m_flagInit;
+	bool m_bRunning = false;
+
+	TimerWheel();
+	~TimerWheel();
+
+	unsigned long long GetTickNow() const;
+	void Link(AsyncScheduler *pTask, AsyncScheduler **ppListHead);
+	void Unlink(AsyncScheduler *pTask);
+	void Insert(AsyncScheduler *pTask);
+	void Cascade(int nLevel, int nIdx);
+	void Advance();
+	void PushReady(AsyncScheduler *pTask);
+	void DriverThread();
+	void WorkerThread();
+
+public:
+	static TimerWheel* GetInstance();
+
+	//Starts the driver and nWorkerCount worker threads, only the first call takes effect (GetInstance calls it with the default).
+	void Initialize(int nWorkerCount);
+
+	void Schedule(AsyncScheduler *pTask, unsigned int nDelayInMs);
+	void Cancel(AsyncScheduler *pTask, bool bWaitForRunning);
+	TimerStat GetStat();
+};
+
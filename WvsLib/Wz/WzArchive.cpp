@@ -21,7 +21,7 @@ WzArchive::WzArchive(const std::wstring& sArchivePath, const std::string& sArchi
 	{
 		//Raw .Img file
 		m_pStream->SetEncrypted(false);
-		m_pTopNameSpace = new (WzNameSpaceProperty)(this, WzNameSpace::WzNameSpaceType::Type_Property, sArchiveName, 0);
+		m_pTopNameSpace = new (WzNameSpaceProperty)(this, WzNameSpace::WzNameSpaceType::Type_Property, m_SymbolTable.Intern(sArchiveName), 0);
 		m_pTopNameSpace->OnGetItem();
 		return;
 	}
@@ -39,7 +39,7 @@ WzArchive::WzArchive(const std::wstring& sArchivePath, const std::string& sArchi
 	m_pStream->Read((char*)&uEncVersion, sizeof(short));
 	std::string sVersion;
 
-	m_pTopNameSpace = new (WzPackage)(this, WzNameSpace::WzNameSpaceType::Type_Directory, sArchiveName, m_pStream->GetPosition());
+	m_pTopNameSpace = new (WzPackage)(this, WzNameSpace::WzNameSpaceType::Type_Directory, m_SymbolTable.Intern(sArchiveName), m_pStream->GetPosition());
 	//Find matched version key.
 	for (unsigned int uVersion = 512; uVersion > 0; --uVersion)
 	{
@@ -106,6 +106,11 @@ WzNameSpace* WzArchive::GetRoot()
 	return m_pTopNameSpace;
 }
 
+WzSymbolTable* WzArchive::GetSymbolTable()
+{
+	return &m_SymbolTable;
+}
+
 std::string WzArchive::DecodeString(WzStreamType *pStream)
 {
 	return m_pCipher->DecodeString(pStream);
@@ -114,4 +119,9 @@ std::string WzArchive::DecodeString(WzStreamType *pStream)
 std::string WzArchive::DecodePropString(WzStreamType *pStream, unsigned int uRootPropPos)
 {
 	return m_pCipher->DecodePropString(pStream, uRootPropPos);
+}
+
+unsigned int WzArchive::DecodePropSymbol(WzStreamType *pStream, unsigned int uRootPropPos)
+{
+	return m_pCipher->DecodePropSymbol(pStream, uRootPropPos, &m_SymbolTable, &m_StringCache);
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 #include "..\Common\CommonDef.h"
 #include "WzMappedFileStream.h"
+#include "WzSymbolTable.h"
+#include "WzStreamCodec.h"
 
 #include <string>
 
@@ -23,6 +25,8 @@ class WzArchive
 	WzStreamType* m_pStream = nullptr;
 	WzNameSpace* m_pTopNameSpace = nullptr;
 	CipherType* m_pCipher = nullptr;
+	WzSymbolTable m_SymbolTable;
+	WzStringCache m_StringCache;
 
 	WzArchive(const std::wstring& sArchivePath, const std::string& sArchiveName, CipherType* pChipher);
 
@@ -36,7 +40,9 @@ public:
 	unsigned long long int GetLength() const;
 	void SetLength(unsigned long long int ulLength);
 	WzNameSpace* GetRoot();
+	WzSymbolTable* GetSymbolTable();
 	std::string DecodeString(WzStreamType *pStream);
 	std::string DecodePropString(WzStreamType *pStream, unsigned int uRootPropPos);
+	unsigned int DecodePropSymbol(WzStreamType *pStream, unsigned int uRootPropPos);
 };
 
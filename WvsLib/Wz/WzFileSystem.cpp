@@ -37,7 +37,10 @@ WzNameSpace *WzFileSystem::TryMount(const filesystem::path& sArchiveName)
 	);
 
 	if (pResult)
+	{
+		pResult->GetStream()->Advise(m_nAccessHint);
 		m_mArchive[sArchiveName] = pResult;
+	}
 	return pResult ? pResult->GetRoot() : nullptr;
 }
 
@@ -50,6 +53,7 @@ void WzFileSystem::Init(const filesystem::path &sPath)
 
 WzNameSpace* WzFileSystem::GetItem(const filesystem::path &sArchiveName)
 {
+	std::lock_guard<std::mutex> lock(m_mtxLock);
 	auto r = m_mArchive.find(sArchiveName);
 	if (r == m_mArchive.end())
 		return TryMount(sArchiveName);
@@ -57,17 +61,34 @@ WzNameSpace* WzFileSystem::GetItem(const filesystem::path &sArchiveName)
 	return r->second->GetRoot();
 }
 
+const filesystem::path& WzFileSystem::GetPath() const
+{
+	return m_sFileSysPath;
+}
+
 void WzFileSystem::Unmount(const filesystem::path& sArchiveName)
 {
+	std::lock_guard<std::mutex> lock(m_mtxLock);
 	auto r = m_mArchive.find(sArchiveName);
 	if (r != m_mArchive.end())
+	{
 		delete (r->second);
-	m_mArchive.erase(r);
+		m_mArchive.erase(r);
+	}
 }
 
 void WzFileSystem::UnmountAll()
 {
+	std::lock_guard<std::mutex> lock(m_mtxLock);
 	for (auto& prChild : m_mArchive)
 		delete(prChild.second);
 	m_mArchive.clear();
 }
+
+void WzFileSystem::SetAccessHint(WzMappedFileStream::AccessHint nHint)
+{
+	std::lock_guard<std::mutex> lock(m_mtxLock);
+	m_nAccessHint = nHint;
+	for (auto& prChild : m_mArchive)
+		prChild.second->GetStream()->Advise(nHint);
+}
@@ -1,7 +1,9 @@
 #pragma once
 #include <string>
 #include <map>
+#include <mutex>
 #include "StandardFileSystem.h"
+#include "WzMappedFileStream.h"
 
 class WzStreamCodec;
 typedef WzStreamCodec CipherType;
@@ -14,6 +16,8 @@ class WzFileSystem
 	filesystem::path m_sFileSysPath;
 	std::map<std::wstring, WzArchive*> m_mArchive;
 	bool m_bInitialized = false;
+	std::mutex m_mtxLock;
+	WzMappedFileStream::AccessHint m_nAccessHint = WzMappedFileStream::Access_Sequential;
 
 	//Get the absolute path of "sPath".
 	const filesystem::path GetAbsPath(const filesystem::path& fPath) const;
@@ -31,7 +35,11 @@ public:
 	void Init(const filesystem::path& sPath);
 
 	WzNameSpace* GetItem(const filesystem::path& sArchiveName);
+	const filesystem::path& GetPath() const;
 	void Unmount(const filesystem::path& sArchiveName);
 	void UnmountAll();
+
+	//Applies to the mounted archives and the ones mounted later.
+	void SetAccessHint(WzMappedFileStream::AccessHint nHint);
 };
 
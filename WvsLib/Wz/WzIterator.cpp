@@ -1,42 +1,73 @@
 #include "WzIterator.h"
+#include "WzSnapshot.h"
+#include "WzArchive.h"
+#include "WzSymbolTable.h"
+#include <cstdlib>
 
 WzIterator::WzIterator()
 {
-	m_pIterNS = nullptr;
 }
 
-WzIterator::WzIterator(WzNameSpace* pNextNS, WzNameSpace::NameSpaceContainerType::iterator& it, WzNameSpace::NameSpaceContainerType::iterator& itEnd)
+WzIterator::WzIterator(WzArchive *pArchive, const WzNameSpace::ChildEntry *pEntry, const WzNameSpace::ChildEntry *pEndEntry)
 {
-	m_pIterNS = pNextNS;
-	m_itNS = it;
-	++m_itNS;
-	m_itEndNS = itEnd;
+	m_pArchive = pArchive;
+	m_pEntry = pEntry;
+	m_pEndEntry = pEndEntry;
+	m_pIterNS = (pEntry->bNested ? pEntry->uValue.pChild : nullptr);
+	if (m_pIterNS)
+		m_pIterNS->OnGetItem();
 }
 
 WzIterator::WzIterator(WzNameSpace *pTopProperty)
 {
 	m_pIterNS = pTopProperty;
-	m_itNS = m_pIterNS->m_mChild.begin();
-	m_itEndNS = m_pIterNS->m_mChild.end();
+	m_pArchive = (pTopProperty ? pTopProperty->GetArchive() : nullptr);
+}
+
+WzIterator::WzIterator(WzSnapshot *pSnapshot, unsigned int nNode, unsigned int nEnd)
+{
+	m_pSnapshot = pSnapshot;
+	m_nSnapNode = nNode;
+	m_nSnapEnd = nEnd;
+}
+
+WzIterator::WzIterator(WzSnapshot *pSnapshot, unsigned int nNode)
+	: WzIterator(nNode == WzSnapshot::INVALID_NODE ? nullptr : pSnapshot, nNode, nNode + 1)
+{
 }
 
 WzIterator::~WzIterator()
 {
 }
 
-WzIterator WzIterator::operator[](const std::string& sName)
+WzNameSpace* WzIterator::GetContainer()
 {
 	if (!m_pIterNS)
-		return end();
+		return nullptr;
+	return (m_pIterNS->GetProperty() ? m_pIterNS->GetProperty() : m_pIterNS);
+}
 
-	auto pNameSpace = (m_pIterNS->GetProperty() ? m_pIterNS->GetProperty() : m_pIterNS);
+WzIterator WzIterator::operator[](const std::string& sName)
+{
+	if (m_pSnapshot)
+	{
+		auto nChild = m_pSnapshot->FindChild(m_nSnapNode, sName.c_str(), (unsigned int)sName.size());
+		if (nChild == WzSnapshot::INVALID_NODE)
+			return end();
 
-	auto findIter = pNameSpace->m_mChild.find(sName);
-	if (findIter == pNameSpace->m_mChild.end())
+		auto pNode = m_pSnapshot->GetNode(m_nSnapNode);
+		return WzIterator(m_pSnapshot, nChild, pNode->nFirstChild + pNode->nChildCount);
+	}
+
+	auto pNameSpace = GetContainer();
+	if (!pNameSpace)
+		return end();
+
+	auto pEntry = pNameSpace->FindChild(sName);
+	if (!pEntry)
 		return end();
 
-	findIter->second->OnGetItem();
-	return WzIterator(findIter->second, findIter, pNameSpace->m_mChild.end());
+	return WzIterator(m_pArchive, pEntry, pNameSpace->m_aChild.data() + pNameSpace->m_aChild.size());
 }
 
 WzIterator WzIterator::operator[](const char* sName)
@@ -46,14 +77,19 @@ WzIterator WzIterator::operator[](const char* sName)
 
 WzIterator WzIterator::begin()
 {
-	auto pProp = (m_pIterNS && m_pIterNS->GetProperty() ? m_pIterNS->GetProperty() : m_pIterNS);
+	if (m_pSnapshot)
+	{
+		auto pNode = m_pSnapshot->GetNode(m_nSnapNode);
+		if (pNode->nChildCount == 0)
+			return end();
+		return WzIterator(m_pSnapshot, pNode->nFirstChild, pNode->nFirstChild + pNode->nChildCount);
+	}
 
-	if (!pProp || pProp->m_mChild.size() == 0)
+	auto pProp = GetContainer();
+	if (!pProp || pProp->m_aChild.size() == 0)
 		return end();
 
-	auto pChild = pProp->m_mChild.begin()->second;
-	pChild->OnGetItem();
-	return WzIterator(pChild, pProp->m_mChild.begin(), pProp->m_mChild.end());
+	return WzIterator(m_pArchive, pProp->m_aChild.data(), pProp->m_aChild.data() + pProp->m_aChild.size());
 }
 
 const WzIterator& WzIterator::end()
@@ -64,13 +100,18 @@ const WzIterator& WzIterator::end()
 
 WzIterator& WzIterator::operator++()
 {
-	if (m_itNS == m_itEndNS)
+	if (m_pSnapshot)
+	{
+		if (++m_nSnapNode >= m_nSnapEnd)
+			*this = end();
+	}
+	else if (!m_pEntry || ++m_pEntry == m_pEndEntry)
 		*this = end();
 	else
 	{
-		m_pIterNS = m_itNS->second;
-		m_pIterNS->OnGetItem();
-		++m_itNS;
+		m_pIterNS = (m_pEntry->bNested ? m_pEntry->uValue.pChild : nullptr);
+		if (m_pIterNS)
+			m_pIterNS->OnGetItem();
 	}
 
 	return *this;
@@ -83,7 +124,12 @@ WzIterator& WzIterator::operator*()
 
 const std::string & WzIterator::GetName()
 {
-	return m_pIterNS->GetName();
+	static std::string sEmpty;
+	if (m_pSnapshot)
+		return m_pSnapshot->GetString(m_pSnapshot->GetNode(m_nSnapNode)->nName);
+	if (m_pEntry)
+		return m_pArchive->GetSymbolTable()->GetSymbol(m_pEntry->nSymbol);
+	return m_pIterNS ? m_pIterNS->GetName() : sEmpty;
 }
 
 bool WzIterator::operator!=(const WzIterator & rhs)
@@ -93,71 +139,84 @@ bool WzIterator::operator!=(const WzIterator & rhs)
 
 bool WzIterator::operator==(const WzIterator & rhs)
 {
-	return (m_pIterNS == rhs.m_pIterNS);
+	return (m_pIterNS == rhs.m_pIterNS &&
+		m_pEntry == rhs.m_pEntry &&
+		m_pSnapshot == rhs.m_pSnapshot &&
+		(!m_pSnapshot || m_nSnapNode == rhs.m_nSnapNode));
 }
 
-WzIterator::operator int()
+int WzIterator::GetScalar(WzDelayedVariant::NumericalVariant& uData, const std::string*& psData)
 {
-	WzProperty* pProp = (m_pIterNS ? m_pIterNS->GetProperty() : nullptr);
-	if (!pProp)
-		return 0;
-
-	auto& m_wzVariant = pProp->GetVariant();
-	if (m_wzVariant.vType == WzDelayedVariant::vt_Filtered_Long ||
-		m_wzVariant.vType == WzDelayedVariant::vt_Filtered_Integer ||
-		m_wzVariant.vType == WzDelayedVariant::vt_Int16)
-		return (int)m_wzVariant.uData.liData;
+	uData.liData = 0;
+	if (m_pSnapshot)
+	{
+		auto pNode = m_pSnapshot->GetNode(m_nSnapNode);
+		if (pNode->nType == WzDelayedVariant::vt_String)
+			psData = &(m_pSnapshot->GetString(pNode->uValue.nString));
+		else
+			uData.liData = pNode->uValue.liData;
+		return pNode->nType;
+	}
 
-	if (m_wzVariant.vType == WzDelayedVariant::vt_String)
-		return atoi(m_wzVariant.sData.c_str());
-	else if (m_wzVariant.vType == WzDelayedVariant::vt_Double64)
-		return (int)m_wzVariant.uData.dData;
-	else if (m_wzVariant.vType == WzDelayedVariant::vt_Float32)
-		return (int)m_wzVariant.uData.fData;
+	if (!m_pEntry || m_pEntry->bNested)
+		return WzDelayedVariant::vt_None;
 
-	return (int)m_wzVariant.uData.liData;
+	if (m_pEntry->nType == WzDelayedVariant::vt_String)
+		psData = &(m_pArchive->GetSymbolTable()->GetSymbol(m_pEntry->uValue.nString));
+	else
+		uData.liData = m_pEntry->uValue.liData;
+	return m_pEntry->nType;
 }
 
-WzIterator::operator unsigned long long()
+WzIterator::operator int()
 {
-	WzProperty* pProp = (m_pIterNS ? m_pIterNS->GetProperty() : nullptr);
-	if (!pProp)
-		return 0;
+	WzDelayedVariant::NumericalVariant uData;
+	const std::string* psData = nullptr;
 
-	auto& m_wzVariant = pProp->GetVariant();
-	if (m_wzVariant.vType == WzDelayedVariant::vt_Filtered_Long ||
-		m_wzVariant.vType == WzDelayedVariant::vt_Filtered_Integer ||
-		m_wzVariant.vType == WzDelayedVariant::vt_Int16)
-		return m_wzVariant.uData.liData;
+	switch (GetScalar(uData, psData))
+	{
+		case WzDelayedVariant::vt_String:
+			return atoi(psData->c_str());
+		case WzDelayedVariant::vt_Double64:
+			return (int)uData.dData;
+		case WzDelayedVariant::vt_Float32:
+			return (int)uData.fData;
+	}
+	return (int)uData.liData;
+}
 
-	if (m_wzVariant.vType == WzDelayedVariant::vt_String)
-		return atoll(m_wzVariant.sData.c_str());
-	else if (m_wzVariant.vType == WzDelayedVariant::vt_Double64)
-		return (unsigned long long)m_wzVariant.uData.dData;
-	else if (m_wzVariant.vType == WzDelayedVariant::vt_Float32)
-		return (unsigned long long)m_wzVariant.uData.fData;
+WzIterator::operator unsigned long long()
+{
+	WzDelayedVariant::NumericalVariant uData;
+	const std::string* psData = nullptr;
 
-	return m_wzVariant.uData.liData;
+	switch (GetScalar(uData, psData))
+	{
+		case WzDelayedVariant::vt_String:
+			return atoll(psData->c_str());
+		case WzDelayedVariant::vt_Double64:
+			return (unsigned long long)uData.dData;
+		case WzDelayedVariant::vt_Float32:
+			return (unsigned long long)uData.fData;
+	}
+	return uData.liData;
 }
 
 WzIterator::operator double()
 {
-	WzProperty* pProp = (m_pIterNS ? m_pIterNS->GetProperty() : nullptr);
-	if (!pProp)
-		return 0;
-
-	auto& m_wzVariant = pProp->GetVariant();
-	if (m_wzVariant.vType == WzDelayedVariant::vt_Double64)
-		return m_wzVariant.uData.dData;
-
-	if (m_wzVariant.vType == WzDelayedVariant::vt_String)
-		return atof(m_wzVariant.sData.c_str());
-	else if (m_wzVariant.vType == WzDelayedVariant::vt_Float32)
-		return (float)m_wzVariant.uData.fData;
-	else if (m_wzVariant.vType != WzDelayedVariant::vt_Float32)
-		return (float)m_wzVariant.uData.liData;
+	WzDelayedVariant::NumericalVariant uData;
+	const std::string* psData = nullptr;
 
-	return 0;
+	switch (GetScalar(uData, psData))
+	{
+		case WzDelayedVariant::vt_Double64:
+			return uData.dData;
+		case WzDelayedVariant::vt_String:
+			return atof(psData->c_str());
+		case WzDelayedVariant::vt_Float32:
+			return uData.fData;
+	}
+	return (double)uData.liData;
 }
 
 WzIterator::operator float()
@@ -168,35 +227,51 @@ WzIterator::operator float()
 WzIterator::operator const std::string&()
 {
 	static std::string sEmpty;
-	WzProperty* pProp = (m_pIterNS ? m_pIterNS->GetProperty() : nullptr);
-	if (!pProp)
-		return sEmpty;
-
-	auto& m_wzVariant = pProp->GetVariant();
-	if (m_wzVariant.vType == WzDelayedVariant::vt_String)
-		return m_wzVariant.sData;
+	WzDelayedVariant::NumericalVariant uData;
+	const std::string* psData = nullptr;
 
-	if (m_wzVariant.sData == "")
+	//Nodes are immutable, formatted numbers are interned so the returned reference stays valid like a string value's.
+	static WzSymbolTable stNumber;
+	std::string sNumber;
+	switch (GetScalar(uData, psData))
 	{
-		if (m_wzVariant.vType == WzDelayedVariant::vt_Filtered_Long ||
-			m_wzVariant.vType == WzDelayedVariant::vt_Filtered_Integer ||
-			m_wzVariant.vType == WzDelayedVariant::vt_Int16)
-			m_wzVariant.sData = std::to_string(m_wzVariant.uData.liData);
-		else if (m_wzVariant.vType == WzDelayedVariant::vt_Float32)
-			m_wzVariant.sData = std::to_string(m_wzVariant.uData.fData);
-		else
-			m_wzVariant.sData = std::to_string(m_wzVariant.uData.dData);
+		case WzDelayedVariant::vt_None:
+			return sEmpty;
+		case WzDelayedVariant::vt_String:
+			return *psData;
+		case WzDelayedVariant::vt_Float32:
+			sNumber = std::to_string(uData.fData);
+			break;
+		case WzDelayedVariant::vt_Double64:
+			sNumber = std::to_string(uData.dData);
+			break;
+		default:
+			sNumber = std::to_string(uData.liData);
 	}
-	return m_wzVariant.sData;
+	return stNumber.GetSymbol(stNumber.Intern(sNumber));
+}
+
+int WzIterator::GetValueType()
+{
+	WzDelayedVariant::NumericalVariant uData;
+	const std::string* psData = nullptr;
+	return GetScalar(uData, psData);
 }
 
 std::vector<std::string> WzIterator::EnumerateChildName()
 {
 	std::vector<std::string> aRet;
-	auto pNameSpace = (m_pIterNS->GetProperty() ? m_pIterNS->GetProperty() : m_pIterNS);
+	if (m_pSnapshot)
+	{
+		auto pNode = m_pSnapshot->GetNode(m_nSnapNode);
+		for (unsigned int i = 0; i < pNode->nChildCount; ++i)
+			aRet.push_back(m_pSnapshot->GetString(m_pSnapshot->GetNode(pNode->nFirstChild + i)->nName));
+		return aRet;
+	}
 
+	auto pNameSpace = GetContainer();
 	if (pNameSpace)
-		for (auto& prChild : pNameSpace->m_mChild)
-			aRet.push_back(prChild.first);
+		for (auto& entry : pNameSpace->m_aChild)
+			aRet.push_back(m_pArchive->GetSymbolTable()->GetSymbol(entry.nSymbol));
 	return aRet;
 }
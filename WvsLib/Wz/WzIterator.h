@@ -3,17 +3,33 @@
 #include "WzProperty.h"
 #include <vector>
 
+class WzSnapshot;
+
 class WzIterator
 {
-	WzNameSpace *m_pIterNS;
+	//Current namespace, nullptr when the iterator is on a scalar (or is end()).
+	WzNameSpace *m_pIterNS = nullptr;
+	WzArchive *m_pArchive = nullptr;
+
+	//Current entry and the end of its siblings, nullptr for the top namespace.
+	const WzNameSpace::ChildEntry *m_pEntry = nullptr, *m_pEndEntry = nullptr;
 
-	WzNameSpace::NameSpaceContainerType::iterator m_itNS, m_itEndNS;
+	//Snapshot mode, m_pIterNS is nullptr and the current node is m_nSnapNode (siblings end at m_nSnapEnd).
+	WzSnapshot *m_pSnapshot = nullptr;
+	unsigned int m_nSnapNode = 0, m_nSnapEnd = 0;
 
 	WzIterator();
-	WzIterator(WzNameSpace *pNextNS, WzNameSpace::NameSpaceContainerType::iterator& it, WzNameSpace::NameSpaceContainerType::iterator& itEnd);
+	WzIterator(WzArchive *pArchive, const WzNameSpace::ChildEntry *pEntry, const WzNameSpace::ChildEntry *pEndEntry);
+	WzIterator(WzSnapshot *pSnapshot, unsigned int nNode, unsigned int nEnd);
+
+	WzNameSpace* GetContainer();
+
+	//Reads the scalar under the iterator whatever the layout is, returns its WzDelayedVariant::VariantType.
+	int GetScalar(WzDelayedVariant::NumericalVariant& uData, const std::string*& psData);
 
 public:
 	WzIterator(WzNameSpace *pTopProperty);
+	WzIterator(WzSnapshot *pSnapshot, unsigned int nNode);
 	~WzIterator();
 
 	WzIterator operator[](const std::string& sName);
@@ -33,6 +49,9 @@ public:
 	operator float();
 	operator const std::string&();
 
+	//WzDelayedVariant::VariantType of the value, vt_None for directories and missing nodes.
+	int GetValueType();
+
 	//For lazy parsing.
 	std::vector<std::string> EnumerateChildName();
 };
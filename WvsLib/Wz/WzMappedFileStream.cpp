@@ -1,34 +1,80 @@
 #include "WzMappedFileStream.h"
+#include "StandardFileSystem.h"
+#include <cstring>
+#include <vector>
+#include <fstream>
+
+#ifdef _WIN32
 #include <Windows.h>
+#include <Psapi.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 WzMappedFileStream::WzMappedFileStream(const std::wstring& sArchivePath)
 {
+	m_bOwner = true;
+#ifdef _WIN32
 	m_hFile = CreateFileW(sArchivePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_ALWAYS, NULL, NULL);
 	if (m_hFile == INVALID_HANDLE_VALUE) throw("Failed to open file");
-	HANDLE hMap = CreateFileMappingA(m_hFile, NULL, PAGE_READONLY, 0, 0, NULL);
-	if (!hMap)
+	LARGE_INTEGER liSize;
+	if (!GetFileSizeEx(m_hFile, &liSize)) throw("Failed to get the file size");
+	m_ulMappedSize = (unsigned long long int)liSize.QuadPart;
+	m_hMap = CreateFileMappingA(m_hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!m_hMap)
 	{
-		MessageBoxA(nullptr, "Failed to create file mapping", "WzMappedFileStream.cpp", 0);  
+		MessageBoxA(nullptr, "Failed to create file mapping", "WzMappedFileStream.cpp", 0);
 		throw("Failed to create file mapping");
 	};
-	m_pFileBase = reinterpret_cast<char *>(MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, 0));
+	m_pFileBase = reinterpret_cast<char *>(MapViewOfFile(m_hMap, FILE_MAP_READ, 0, 0, 0));
 	if (!m_pFileBase) throw("Failed to map view of file");
+#else
+	m_nFileDescriptor = open(filesystem::path(sArchivePath).string().c_str(), O_RDONLY);
+	if (m_nFileDescriptor < 0) throw("Failed to open file");
+	struct stat st;
+	if (fstat(m_nFileDescriptor, &st) != 0 || st.st_size <= 0) throw("Failed to get the file size");
+	m_ulMappedSize = (unsigned long long int)st.st_size;
+	void *pBase = mmap(nullptr, (size_t)m_ulMappedSize, PROT_READ, MAP_SHARED, m_nFileDescriptor, 0);
+	if (pBase == MAP_FAILED) throw("Failed to map view of file");
+	m_pFileBase = reinterpret_cast<char *>(pBase);
+#endif
 	m_pStream = m_pFileBase;
 }
 
 WzMappedFileStream::WzMappedFileStream(const WzMappedFileStream & rhs)
 {
-	m_hFile = nullptr;
+	m_bOwner = false;
 	m_pFileBase = rhs.m_pFileBase;
 	m_pStream = rhs.m_pStream;
 	m_bEncrypted = rhs.m_bEncrypted;
 	m_ulLength = rhs.m_ulLength;
+	m_ulMappedSize = rhs.m_ulMappedSize;
 	m_uStreamPos = rhs.m_uStreamPos;
 }
 
 WzMappedFileStream::~WzMappedFileStream()
 {
-	CloseHandle(m_hFile);
+	if (!m_bOwner)
+		return;
+#ifdef _WIN32
+	if (m_pFileBase)
+		UnmapViewOfFile(m_pFileBase);
+	if (m_hMap)
+		CloseHandle(m_hMap);
+	if (m_hFile && m_hFile != INVALID_HANDLE_VALUE)
+		CloseHandle(m_hFile);
+#else
+	if (m_pFileBase)
+	{
+		Advise(Access_Release);
+		munmap(m_pFileBase, (size_t)m_ulMappedSize);
+	}
+	if (m_nFileDescriptor >= 0)
+		close(m_nFileDescriptor);
+#endif
 }
 
 char * WzMappedFileStream::GetStreamPtr()
@@ -67,9 +113,96 @@ bool WzMappedFileStream::Encrypted() const
 	return m_bEncrypted;
 }
 
+unsigned long long int WzMappedFileStream::GetRemaining() const
+{
+	return m_uStreamPos < m_ulMappedSize ? m_ulMappedSize - m_uStreamPos : 0;
+}
+
 void WzMappedFileStream::Read(char* pBuffer, unsigned int uSize)
 {
-	memcpy(pBuffer, m_pStream, uSize);
+	auto ulRemaining = GetRemaining();
+	if (uSize <= ulRemaining)
+		memcpy(pBuffer, m_pStream, uSize);
+	else
+	{
+		//A corrupted offset (or a wrong version key being tested) points outside of the archive.
+		memcpy(pBuffer, m_pStream, (size_t)ulRemaining);
+		memset(pBuffer + ulRemaining, 0, (size_t)(uSize - ulRemaining));
+	}
 	m_pStream += uSize;
 	m_uStreamPos += uSize;
 }
+
+void WzMappedFileStream::Advise(AccessHint nHint)
+{
+	if (!m_pFileBase || !m_ulMappedSize)
+		return;
+#ifdef _WIN32
+	//There is no read-ahead policy for a view, only the bulk iteration benefits from touching the pages in advance.
+	if (nHint == Access_Sequential)
+	{
+		WIN32_MEMORY_RANGE_ENTRY range;
+		range.VirtualAddress = m_pFileBase;
+		range.NumberOfBytes = (SIZE_T)m_ulMappedSize;
+		PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+	}
+#else
+	int nAdvice = MADV_NORMAL;
+	switch (nHint)
+	{
+		case Access_Sequential:
+			nAdvice = MADV_SEQUENTIAL;
+			break;
+		case Access_Random:
+			nAdvice = MADV_RANDOM;
+			break;
+		case Access_Release:
+			nAdvice = MADV_DONTNEED;
+			break;
+	}
+	madvise(m_pFileBase, (size_t)m_ulMappedSize, nAdvice);
+#endif
+}
+
+unsigned long long int WzMappedFileStream::GetMappedSize() const
+{
+	return m_ulMappedSize;
+}
+
+unsigned long long int WzMappedFileStream::GetResidentSize() const
+{
+	if (!m_pFileBase || !m_ulMappedSize)
+		return 0;
+	unsigned long long int ulResident = 0;
+#ifdef _WIN32
+	SYSTEM_INFO sysInfo;
+	GetSystemInfo(&sysInfo);
+	unsigned long long int ulPageSize = sysInfo.dwPageSize, ulPageCount = (m_ulMappedSize + ulPageSize - 1) / ulPageSize;
+	std::vector<PSAPI_WORKING_SET_EX_INFORMATION> aPage(4096);
+	for (unsigned long long int ulPage = 0; ulPage < ulPageCount; ulPage += aPage.size())
+	{
+		size_t nCount = (size_t)(ulPageCount - ulPage < aPage.size() ? ulPageCount - ulPage : aPage.size());
+		for (size_t i = 0; i < nCount; ++i)
+			aPage[i].VirtualAddress = m_pFileBase + (ulPage + i) * ulPageSize;
+		if (!QueryWorkingSetEx(GetCurrentProcess(), aPage.data(), (DWORD)(nCount * sizeof(PSAPI_WORKING_SET_EX_INFORMATION))))
+			return 0;
+		for (size_t i = 0; i < nCount; ++i)
+			if (aPage[i].VirtualAttributes.Valid)
+				ulResident += ulPageSize;
+	}
+#else
+	//mincore would report the page cache, which outlives the mapping, the Rss of the mapping is what this process holds.
+	std::ifstream smaps("/proc/self/smaps");
+	std::string sLine;
+	bool bInRange = false;
+	while (std::getline(smaps, sLine))
+	{
+		unsigned long long int ulBegin = 0, ulEnd = 0, ulSizeInKB = 0;
+		if (sscanf(sLine.c_str(), "%llx-%llx", &ulBegin, &ulEnd) == 2)
+			bInRange = ulBegin == (unsigned long long int)m_pFileBase;
+		else if (bInRange && sscanf(sLine.c_str(), "Rss: %llu kB", &ulSizeInKB) == 1)
+			return ulSizeInKB * 1024;
+	}
+#endif
+	return ulResident;
+}
@@ -4,12 +4,28 @@
 //Use MappingFile instead of std::fstream
 class WzMappedFileStream
 {
+public:
+	//How the pages of the mapping are going to be touched, see Advise.
+	enum AccessHint
+	{
+		Access_Sequential, //Bulk iteration at startup, read ahead aggressively.
+		Access_Random, //Lazy lookups at runtime, don't read ahead.
+		Access_Release, //The archive is unmounted, drop the resident pages.
+	};
+
+private:
 	bool m_bEncrypted = true;
 
-	void* m_hFile;
-	char* m_pFileBase, *m_pStream;
+	//Copies are cursors over the mapping of the original stream, only the original owns the handles.
+	bool m_bOwner = false;
+#ifdef _WIN32
+	void* m_hFile = nullptr, *m_hMap = nullptr;
+#else
+	int m_nFileDescriptor = -1;
+#endif
+	char* m_pFileBase = nullptr, *m_pStream = nullptr;
 
-	unsigned long long int m_ulLength = 0;
+	unsigned long long int m_ulLength = 0, m_ulMappedSize = 0;
 	unsigned int m_uStreamPos = 0;
 
 public:
@@ -24,8 +40,17 @@ public:
 	void SetLength(unsigned long long int ulLength);
 	void SetEncrypted(bool bEncrypted);
 	bool Encrypted() const;
+
+	//Bytes which can be read from the current position before running off the mapping.
+	unsigned long long int GetRemaining() const;
+
+	//Reading past the end of the mapping yields zeros.
 	void Read(char *pBuffer, unsigned int uSize);
 
+	void Advise(AccessHint nHint);
+	unsigned long long int GetMappedSize() const;
+	unsigned long long int GetResidentSize() const;
+
 	//ZDataFilter::_Read, T can only be int16, int32, int64
 	template<typename T>
 	T ReadFilter()
@@ -1,20 +1,110 @@
 #include "WzNameSpace.h"
+#include "WzArchive.h"
+#include "WzSymbolTable.h"
 #include "..\Memory\MemoryPoolMan.hpp"
+#include <algorithm>
+#include <thread>
 
-WzNameSpace::WzNameSpace(WzArchive *pArchive, WzNameSpaceType nNameSpaceType, const std::string& sName, unsigned int uBeginPos)
+WzNameSpace::WzNameSpace(WzArchive *pArchive, WzNameSpaceType nNameSpaceType, unsigned int nNameSymbol, unsigned int uBeginPos)
 {
 	m_uBeginPos = uBeginPos;
 	m_pArchive = pArchive;
 	m_nNameSpaceType = nNameSpaceType;
-	m_sName = sName;
+	m_nNameSymbol = nNameSymbol;
+}
+
+bool WzNameSpace::BeginParse()
+{
+	unsigned char nState = m_nParseState.load(std::memory_order_acquire);
+	if (nState == Parse_Done)
+		return false;
+
+	if (nState == Parse_None && m_nParseState.compare_exchange_strong(nState, Parse_Running, std::memory_order_acquire))
+		return true;
+
+	while (m_nParseState.load(std::memory_order_acquire) != Parse_Done)
+		std::this_thread::yield();
+	return false;
+}
+
+void WzNameSpace::EndParse()
+{
+	m_nParseState.store(Parse_Done, std::memory_order_release);
+}
+
+void WzNameSpace::AddChild(unsigned int nSymbol, WzNameSpace * pChild)
+{
+	ChildEntry entry;
+	entry.nSymbol = nSymbol;
+	entry.nType = 0;
+	entry.bNested = 1;
+	entry.uValue.pChild = pChild;
+	m_aChild.push_back(entry);
+}
+
+WzNameSpace::ChildEntry& WzNameSpace::AddValue(unsigned int nSymbol)
+{
+	ChildEntry entry;
+	entry.nSymbol = nSymbol;
+	entry.nType = 0;
+	entry.bNested = 0;
+	entry.uValue.liData = 0;
+	m_aChild.push_back(entry);
+	return m_aChild.back();
+}
+
+void WzNameSpace::SortChild()
+{
+	//Symbols are numbered in first-seen order, which changes with the order the loaders run in. Children are ordered by name
+	//instead, as the std::map they replaced and the snapshot are, so iterating them gives the same order in every run.
+	auto pSymbolTable = m_pArchive->GetSymbolTable();
+	std::stable_sort(m_aChild.begin(), m_aChild.end(), [&](const ChildEntry& lhs, const ChildEntry& rhs) {
+		return lhs.nSymbol != rhs.nSymbol && pSymbolTable->GetSymbol(lhs.nSymbol) < pSymbolTable->GetSymbol(rhs.nSymbol);
+	});
+
+	auto itLast = m_aChild.begin();
+	for (auto it = m_aChild.begin(); it != m_aChild.end(); ++it)
+	{
+		if (it != m_aChild.begin() && it->nSymbol == (itLast - 1)->nSymbol)
+		{
+			if (it->bNested)
+				delete (it->uValue.pChild);
+			continue;
+		}
+		*itLast++ = *it;
+	}
+	m_aChild.erase(itLast, m_aChild.end());
+	m_aChild.shrink_to_fit();
+}
+
+const WzNameSpace::ChildEntry* WzNameSpace::FindChild(unsigned int nSymbol) const
+{
+	auto pSymbolTable = m_pArchive->GetSymbolTable();
+	auto& sName = pSymbolTable->GetSymbol(nSymbol);
+	auto findIter = std::lower_bound(m_aChild.begin(), m_aChild.end(), sName, [&](const ChildEntry& entry, const std::string& sName) {
+		return entry.nSymbol != nSymbol && pSymbolTable->GetSymbol(entry.nSymbol) < sName;
+	});
+	if (findIter == m_aChild.end() || findIter->nSymbol != nSymbol)
+		return nullptr;
+	return &(*findIter);
+}
+
+const WzNameSpace::ChildEntry* WzNameSpace::FindChild(const std::string & sName) const
+{
+	if (m_aChild.empty())
+		return nullptr;
+
+	//A name which was never interned can't be a child of anything in this archive.
+	auto nSymbol = m_pArchive->GetSymbolTable()->Find(sName);
+	return nSymbol == WzSymbolTable::INVALID_SYMBOL ? nullptr : FindChild(nSymbol);
 }
 
 WzNameSpace* WzNameSpace::GetItem(const std::string & sName)
 {
-	auto findIter = m_mChild.find(sName);
-	if (findIter == m_mChild.end())
+	auto pEntry = FindChild(sName);
+	if (!pEntry || !pEntry->bNested)
 		return nullptr;
-	auto pResult = findIter->second;
+	auto pResult = pEntry->uValue.pChild;
 	pResult->OnGetItem();
 	return pResult;
 }
@@ -26,7 +116,12 @@ WzProperty* WzNameSpace::GetProperty()
 
 const std::string& WzNameSpace::GetName() const
 {
-	return m_sName;
+	return m_pArchive->GetSymbolTable()->GetSymbol(m_nNameSymbol);
+}
+
+WzArchive* WzNameSpace::GetArchive() const
+{
+	return m_pArchive;
 }
 
 WzNameSpace::WzNameSpaceType WzNameSpace::GetNameSpaceType() const
@@ -34,8 +129,18 @@ WzNameSpace::WzNameSpaceType WzNameSpace::GetNameSpaceType() const
 	return m_nNameSpaceType;
 }
 
+unsigned long long WzNameSpace::GetMemoryUsage() const
+{
+	unsigned long long liUsage = m_aChild.capacity() * sizeof(ChildEntry);
+	for (auto& entry : m_aChild)
+		if (entry.bNested)
+			liUsage += entry.uValue.pChild->GetMemoryUsage();
+	return liUsage;
+}
+
 WzNameSpace::~WzNameSpace()
 {
-	for (auto& prChild : m_mChild)
-		delete (prChild.second);
-}
\ No newline at end of file
+	for (auto& entry : m_aChild)
+		if (entry.bNested)
+			delete (entry.uValue.pChild);
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
-#include <map>
+#include <vector>
+#include <atomic>
 
 class WzArchive;
 class WzProperty;
@@ -8,7 +9,24 @@ class WzNameSpace
 {
 	friend class WzIterator;
 public:
-	typedef std::map<std::string, WzNameSpace*> NameSpaceContainerType;
+	//A child is either a nested namespace (bNested) or a scalar stored inline, nType is the WzDelayedVariant::VariantType of the scalar.
+	struct ChildEntry
+	{
+		unsigned int nSymbol;
+		unsigned short nType;
+		unsigned short bNested;
+		union
+		{
+			WzNameSpace *pChild;
+			long long int liData;
+			double dData;
+			float fData;
+			unsigned int nString; //Symbol of the string value.
+		} uValue;
+	};
+
+	//Sorted by name, see SortChild.
+	typedef std::vector<ChildEntry> NameSpaceContainerType;
 
 	enum WzNameSpaceType
 	{
@@ -17,21 +35,45 @@ public:
 	};
 
 protected:
-	NameSpaceContainerType m_mChild;
+	NameSpaceContainerType m_aChild;
 	WzArchive* m_pArchive = nullptr;
 	WzNameSpaceType m_nNameSpaceType;
 	unsigned int m_uBeginPos = 0;
-	std::string m_sName;
-	bool m_bParsed = false;
+	unsigned int m_nNameSymbol = 0;
+
+	//Loaders may run in parallel, the first thread reaching an unparsed namespace parses it while the others wait.
+	enum ParseState : unsigned char
+	{
+		Parse_None,
+		Parse_Running,
+		Parse_Done
+	};
+	std::atomic<unsigned char> m_nParseState{ Parse_None };
+
+	//Returns true if the caller has to parse this namespace and call EndParse() afterwards.
+	bool BeginParse();
+	void EndParse();
+
+	WzNameSpace(WzArchive *pArchive, WzNameSpaceType nNameSpaceType, unsigned int nNameSymbol, unsigned int uBeginPos);
 
-	WzNameSpace(WzArchive *pArchive, WzNameSpaceType nNameSpaceType, const std::string& sName, unsigned int uBeginPos);
+	void AddChild(unsigned int nSymbol, WzNameSpace *pChild);
+	ChildEntry& AddValue(unsigned int nSymbol);
+
+	//Called once parsing is done, the first of duplicated names is kept (as std::map::insert did).
+	void SortChild();
 
 public:
+	const ChildEntry* FindChild(unsigned int nSymbol) const;
+	const ChildEntry* FindChild(const std::string& sName) const;
 	WzNameSpace* GetItem(const std::string& sName);
 	virtual void OnGetItem() = 0;
 	virtual WzProperty* GetProperty();
 	const std::string& GetName() const;
+	WzArchive* GetArchive() const;
 	WzNameSpaceType GetNameSpaceType() const;
+
+	//Heap bytes held by this namespace and all parsed namespaces under it (symbols excluded).
+	virtual unsigned long long GetMemoryUsage() const;
 	virtual ~WzNameSpace() = 0;
 };
 
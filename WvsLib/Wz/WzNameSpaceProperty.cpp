@@ -8,13 +8,12 @@
 //This actually is "ClipArchive" impl. in official codes.
 void WzNameSpaceProperty::ClipArchive()
 {
-	m_pProperty = new (WzProperty)(m_pArchive, GetName(), m_uBeginPos, m_uBeginPos);
+	m_pProperty = new (WzProperty)(m_pArchive, m_nNameSymbol, m_uBeginPos, m_uBeginPos);
 	m_pProperty->OnGetItem();
-	m_bParsed = true;
 }
 
-WzNameSpaceProperty::WzNameSpaceProperty(WzArchive *pArchive, WzNameSpaceType nNameSpaceType, const std::string& sName, unsigned int uBeginPos)
-	: WzNameSpace(pArchive, nNameSpaceType, sName, uBeginPos)
+WzNameSpaceProperty::WzNameSpaceProperty(WzArchive *pArchive, WzNameSpaceType nNameSpaceType, unsigned int nNameSymbol, unsigned int uBeginPos)
+	: WzNameSpace(pArchive, nNameSpaceType, nNameSymbol, uBeginPos)
 {
 }
 
@@ -31,6 +30,14 @@ WzProperty* WzNameSpaceProperty::GetProperty()
 
 void WzNameSpaceProperty::OnGetItem()
 {
-	if (!m_bParsed)
+	if (BeginParse())
+	{
 		ClipArchive();
+		EndParse();
+	}
+}
+
+unsigned long long WzNameSpaceProperty::GetMemoryUsage() const
+{
+	return sizeof(WzNameSpaceProperty) + (m_pProperty ? m_pProperty->GetMemoryUsage() : 0);
 }
@@ -8,10 +8,11 @@ class WzNameSpaceProperty : public WzNameSpace
 	WzProperty *m_pProperty = nullptr;
 
 public:
-	WzNameSpaceProperty(WzArchive *pArchive, WzNameSpaceType nNameSpaceType, const std::string& sName, unsigned int uBeginPos);
+	WzNameSpaceProperty(WzArchive *pArchive, WzNameSpaceType nNameSpaceType, unsigned int nNameSymbol, unsigned int uBeginPos);
 	~WzNameSpaceProperty();
 	WzProperty* GetProperty();
 	void OnGetItem();
+	unsigned long long GetMemoryUsage() const;
 	void ClipArchive();
 };
 
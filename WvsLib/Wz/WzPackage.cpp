@@ -5,11 +5,12 @@
 #include "WzStreamCodec.h"
 #include "..\Memory\MemoryPoolMan.hpp"
 #include "WzNameSpaceProperty.h"
+#include "WzSymbolTable.h"
 
 #include <iostream>
 
-WzPackage::WzPackage(WzArchive *pArchive, WzNameSpaceType nNameSpaceType, const std::string& sName, unsigned int uBeginPos)
-	: WzNameSpace(pArchive, nNameSpaceType, sName, uBeginPos)
+WzPackage::WzPackage(WzArchive *pArchive, WzNameSpaceType nNameSpaceType, unsigned int nNameSymbol, unsigned int uBeginPos)
+	: WzNameSpace(pArchive, nNameSpaceType, nNameSymbol, uBeginPos)
 {
 }
 
@@ -28,15 +29,23 @@ WzNameSpace* WzPackage::GetItem(const std::string& sName)
 
 void WzPackage::OnGetItem()
 {
-	if (!m_bParsed) 
+	if (BeginParse())
+	{
 		LoadDirectory();
+		EndParse();
+	}
 }
 
 void WzPackage::LoadSubItem()
 {
-	for (auto& prChild : m_mChild)
-		if (prChild.second->GetNameSpaceType() == WzNameSpaceType::Type_Property)
-			prChild.second->OnGetItem();
+	for (auto& entry : m_aChild)
+		if (entry.bNested && entry.uValue.pChild->GetNameSpaceType() == WzNameSpaceType::Type_Property)
+			entry.uValue.pChild->OnGetItem();
+}
+
+unsigned long long WzPackage::GetMemoryUsage() const
+{
+	return sizeof(WzPackage) + WzNameSpace::GetMemoryUsage();
 }
 
 bool WzPackage::LoadDirectory(bool bTestKey)
@@ -81,17 +90,22 @@ bool WzPackage::LoadDirectory(bool bTestKey)
 		if (!bTestKey)
 		{
 			if (nType == WzNameSpaceType::Type_Directory)
-				m_mChild.insert({ sName, new (WzPackage)(m_pArchive, (WzNameSpaceType)nType, sName, uPos) });
+			{
+				auto nSymbol = m_pArchive->GetSymbolTable()->Intern(sName);
+				AddChild(nSymbol, new (WzPackage)(m_pArchive, (WzNameSpaceType)nType, nSymbol, uPos));
+			}
 			else if (nType == WzNameSpaceType::Type_Property) 
 			{
 				//TRIMMED OUT .IMG
 				if (sName.find(".img") != sName.npos)
 					sName = sName.substr(0, sName.length() - 4);
-				m_mChild.insert({ sName, new (WzNameSpaceProperty)(m_pArchive, (WzNameSpaceType)nType, sName, uPos) });
+				auto nSymbol = m_pArchive->GetSymbolTable()->Intern(sName);
+				AddChild(nSymbol, new (WzNameSpaceProperty)(m_pArchive, (WzNameSpaceType)nType, nSymbol, uPos));
 			}
 		}
 	}
-	m_bParsed = true;
+	SortChild();
+	m_nParseState = Parse_Done;
 	return true;
 }
 
@@ -8,12 +8,13 @@ private:
 	unsigned int LoadPos(void *pStream, unsigned int uBegin, unsigned int uKey);
 
 public:
-	WzPackage(WzArchive *pArchive, WzNameSpaceType nNameSpaceType, const std::string& sName, unsigned int uBeginPos);
+	WzPackage(WzArchive *pArchive, WzNameSpaceType nNameSpaceType, unsigned int nNameSymbol, unsigned int uBeginPos);
 	~WzPackage();
 
 	WzNameSpace* GetItem(const std::string& sName);
 	void OnGetItem();
 	bool LoadDirectory(bool bTestKey = false);
 	void LoadSubItem();
+	unsigned long long GetMemoryUsage() const;
 };
 
@@ -11,24 +11,18 @@ class WzArchive;
 class WzProperty : public WzNameSpace
 {
 	ALLOW_PRIVATE_ALLOC
-public:
-	typedef std::map<std::string, WzProperty*> PropContainerType;
 
 private:
 	unsigned int m_uRootPropPos = 0;
-	WzDelayedVariant m_wzVariant;
-
-	//Variant property
-	WzProperty(const std::string& sPropName);
 
 	void DelayParse();
 public:
-	WzProperty(WzArchive *pArchive, const std::string& sPropName, unsigned int uBeginPos, unsigned int uRootPropPos);
+	WzProperty(WzArchive *pArchive, unsigned int nNameSymbol, unsigned int uBeginPos, unsigned int uRootPropPos);
 	~WzProperty();
 
 	void OnGetItem();
-	WzDelayedVariant& GetVariant();
 	WzProperty* GetProperty();
+	unsigned long long GetMemoryUsage() const;
 };
 
 
@@ -1,5 +1,48 @@
 #include "WzResMan.hpp"
+#include "WzArchive.h"
 #include "..\Memory\MemoryPoolMan.hpp"
+#include "..\Logger\WvsLogger.h"
+
+static const char* aArchiveName[] =
+{
+	"./Base.wz",
+	"./Character.wz",
+	"./Effect.wz",
+	"./Etc.wz",
+	"./Item.wz",
+	"./Map.wz",
+	"./Map2.wz",
+	"./Mob.wz",
+	"./Mob2.wz",
+	"./Morph.wz",
+	"./Npc.wz",
+	"./Quest.wz",
+	"./Reactor.wz",
+	"./Skill.wz",
+	"./String.wz",
+	"./TamingMob.wz",
+	"./UI.wz",
+};
+
+//Stand-alone .img files loaded through GetItem.
+static const char* aImgName[] =
+{
+	"./Reward.img",
+	"./ReactorAction.img",
+	"./StandardPDD.img",
+	"./NpcShop.img",
+	"./FieldSet.img",
+	"./Continent.img",
+};
+
+void WzResMan::Init()
+{
+	for (int i = 0; i <= (int)Wz::UI; ++i)
+	{
+		m_anSnapshotRoot[i] = m_pSnapshot ? m_pSnapshot->GetArchiveRoot(aArchiveName[i]) : WzSnapshot::INVALID_NODE;
+		m_aWzNode[i] = (m_anSnapshotRoot[i] == WzSnapshot::INVALID_NODE ? m_FileSystem.GetItem(aArchiveName[i]) : nullptr);
+	}
+}
 
 void WzResMan::RemountAll()
 {
@@ -7,3 +50,66 @@ void WzResMan::RemountAll()
 	//WvsSingleObjectAllocator<WzProperty>::GetInstance()->Release();
 	Init();
 }
+
+unsigned long long WzResMan::GetMemoryUsage(Wz wzTag)
+{
+	auto pNameSpace = m_aWzNode[(int)wzTag];
+	if (!pNameSpace)
+		return 0;
+	return pNameSpace->GetMemoryUsage() + pNameSpace->GetArchive()->GetSymbolTable()->GetMemoryUsage();
+}
+
+bool WzResMan::CompileSnapshot()
+{
+	if (!pCfg || pCfg->StrValue("WzSnapshot") == "")
+		return false;
+
+	//Whole archives are compiled rather than only the properties the loaders read at startup:
+	//most paths are built from IDs at runtime (fields are loaded on demand from
+	//"Map" + std::to_string(nFieldID / 100000000), likewise links, life and quest data), and an
+	//archive found in the snapshot is never mounted, so a missing property would fail instead of
+	//falling back to the .wz file. Unread properties only cost file size; their pages are never
+	//touched and the mapping is shared by every process on the host.
+	std::vector<std::pair<std::string, WzIterator>> aArchive;
+	for (int i = 0; i < (int)Wz::UI; ++i)
+		if (m_aWzNode[i])
+			aArchive.push_back({ aArchiveName[i], WzIterator(m_aWzNode[i]) });
+
+	for (auto& sImgName : aImgName)
+	{
+		auto pImg = m_FileSystem.GetItem(sImgName);
+		if (pImg)
+			aArchive.push_back({ sImgName, WzIterator(pImg) });
+	}
+
+	return WzSnapshot::Compile(pCfg->StrValue("WzSnapshot"), m_FileSystem.GetPath().wstring(), aArchive);
+}
+
+unsigned long long WzResMan::GetMappedSize(Wz wzTag)
+{
+	auto pNameSpace = m_aWzNode[(int)wzTag];
+	return pNameSpace ? pNameSpace->GetArchive()->GetStream()->GetMappedSize() : 0;
+}
+
+unsigned long long WzResMan::GetResidentSize(Wz wzTag)
+{
+	auto pNameSpace = m_aWzNode[(int)wzTag];
+	return pNameSpace ? pNameSpace->GetArchive()->GetStream()->GetResidentSize() : 0;
+}
+
+const char * WzResMan::GetArchiveName(Wz wzTag) const
+{
+	//Without the leading "./".
+	return aArchiveName[(int)wzTag] + 2;
+}
+
+void WzResMan::LogResidentSize(const char * sTag)
+{
+	unsigned long long liMapped = 0, liResident = 0;
+	for (int i = 0; i <= (int)Wz::UI; ++i)
+	{
+		liMapped += GetMappedSize((Wz)i);
+		liResident += GetResidentSize((Wz)i);
+	}
+	WvsLogger::LogFormat("[%s]WZ archives: %llu MB mapped, %llu MB resident.\n", sTag, liMapped >> 20, liResident >> 20);
+}
@@ -2,6 +2,7 @@
 
 #include "WzFileSystem.h"
 #include "WzIterator.h"
+#include "WzSnapshot.h"
 #include "..\Exception\WvsException.h"
 #include "..\Memory\MemoryPoolMan.hpp"
 #include "..\Common\ConfigLoader.hpp"
@@ -37,26 +38,11 @@ private:
 	WzNameSpace* m_aWzNode[(int)Wz::UI + 1];
 	ConfigLoader* pCfg = nullptr;
 
-	void Init()
-	{
-		m_aWzNode[(int)Wz::Base] = m_FileSystem.GetItem("./Base.wz");
-		m_aWzNode[(int)Wz::Character] = m_FileSystem.GetItem("./Character.wz");
-		m_aWzNode[(int)Wz::Effect] = m_FileSystem.GetItem("./Effect.wz");
-		m_aWzNode[(int)Wz::Etc] = m_FileSystem.GetItem("./Etc.wz");
-		m_aWzNode[(int)Wz::Item] = m_FileSystem.GetItem("./Item.wz");
-		m_aWzNode[(int)Wz::Map] = m_FileSystem.GetItem("./Map.wz");
-		m_aWzNode[(int)Wz::Map2] = m_FileSystem.GetItem("./Map2.wz");
-		m_aWzNode[(int)Wz::Mob] = m_FileSystem.GetItem("./Mob.wz");
-		m_aWzNode[(int)Wz::Mob2] = m_FileSystem.GetItem("./Mob2.wz");
-		m_aWzNode[(int)Wz::Morph] = m_FileSystem.GetItem("./Morph.wz");
-		m_aWzNode[(int)Wz::Npc] = m_FileSystem.GetItem("./Npc.wz");
-		m_aWzNode[(int)Wz::Quest] = m_FileSystem.GetItem("./Quest.wz");
-		m_aWzNode[(int)Wz::Reactor] = m_FileSystem.GetItem("./Reactor.wz");
-		m_aWzNode[(int)Wz::Skill] = m_FileSystem.GetItem("./Skill.wz");
-		m_aWzNode[(int)Wz::String] = m_FileSystem.GetItem("./String.wz");
-		m_aWzNode[(int)Wz::TamingMob] = m_FileSystem.GetItem("./TamingMob.wz");
-		m_aWzNode[(int)Wz::UI] = m_FileSystem.GetItem("./UI.wz");
-	}
+	//Archives found in the precompiled snapshot aren't mounted at all, see WzSnapshot.h.
+	WzSnapshot* m_pSnapshot = nullptr;
+	unsigned int m_anSnapshotRoot[(int)Wz::UI + 1];
+
+	void Init();
 
 public:
 
@@ -66,30 +52,62 @@ public:
 		return sWzResMan;
 	}
 
-	void Init(const std::string& sGlobalConfigPath)
+	//bUseSnapshot = false forces every archive to be mounted (required by CompileSnapshot).
+	void Init(const std::string& sGlobalConfigPath, bool bUseSnapshot = true)
 	{
 		pCfg = ConfigLoader::Get(sGlobalConfigPath);
 		if (!pCfg || pCfg->StrValue("DataDir") == "")
 			WvsException::FatalError("[WvsLib -- WzResMan::Init]Unable to find the global config file (the path is specified as GlobalConfig in the application config) which defines the DataDir value.");
 
 		m_FileSystem.Init(pCfg->StrValue("DataDir"));
+		if (bUseSnapshot && pCfg->StrValue("WzSnapshot") != "")
+			m_pSnapshot = WzSnapshot::Load(
+				pCfg->StrValue("WzSnapshot"),
+				m_FileSystem.GetPath().wstring(),
+				pCfg->IntValue("WzSnapshotVerify", 0) != 0
+			);
 		Init();
 	}
 
 	WzIterator GetWz(Wz wzTag)
 	{
+		if (!m_aWzNode[(int)wzTag])
+			return WzIterator(m_pSnapshot, m_anSnapshotRoot[(int)wzTag]);
 		return WzIterator(m_aWzNode[(int)wzTag]);
 	}
 
 	WzIterator GetItem(const std::string& sArchiveName)
 	{
+		if (m_pSnapshot && m_pSnapshot->GetArchiveRoot(sArchiveName) != WzSnapshot::INVALID_NODE)
+			return WzIterator(m_pSnapshot, m_pSnapshot->GetArchiveRoot(sArchiveName));
 		return WzIterator(m_FileSystem.GetItem(sArchiveName));
 	}
 
 	void Unmount(const std::string& sArchiveName)
 	{
+		if (m_pSnapshot && m_pSnapshot->GetArchiveRoot(sArchiveName) != WzSnapshot::INVALID_NODE)
+			return;
 		m_FileSystem.Unmount(sArchiveName);
 	}
 
 	void RemountAll();
+
+	//Sequential while the loaders iterate the archives at startup, random for the lookups afterwards.
+	void SetAccessHint(WzMappedFileStream::AccessHint nHint)
+	{
+		m_FileSystem.SetAccessHint(nHint);
+	}
+
+	//Writes every archive the servers read (UI.wz excluded) to the path specified as WzSnapshot in the global config.
+	//Archives are written whole since the loaders build most property paths at runtime, see the .cpp.
+	bool CompileSnapshot();
+
+	//Heap bytes of the parsed nodes and the symbols of a mounted archive, 0 if it is served by the snapshot.
+	unsigned long long GetMemoryUsage(Wz wzTag);
+
+	//Size of the mapping of a mounted archive and the bytes of it currently in memory, 0 if it is served by the snapshot.
+	unsigned long long GetMappedSize(Wz wzTag);
+	unsigned long long GetResidentSize(Wz wzTag);
+	void LogResidentSize(const char* sTag);
+	const char* GetArchiveName(Wz wzTag) const;
 };
\ No newline at end of file
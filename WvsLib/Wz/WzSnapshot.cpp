@@ -0,0 +1,367 @@
+#include "WzSnapshot.h"
+#include "WzIterator.h"
+#include "StandardFileSystem.h"
+#include "..\Logger\WvsLogger.h"
+#include <fstream>
+#include <deque>
+#include <unordered_map>
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+static const char SNAPSHOT_MAGIC[8] = { 'W', 'V', 'S', 'W', 'Z', 'S', 'N', 'P' };
+
+WzSnapshot::WzSnapshot()
+{
+}
+
+WzSnapshot::~WzSnapshot()
+{
+	if (m_apString)
+	{
+		for (unsigned long long i = 0; i < m_pHeader->liStringCount; ++i)
+			delete m_apString[i].load();
+		delete[] m_apString;
+	}
+	Unmap();
+}
+
+bool WzSnapshot::Map(const std::string & sPath)
+{
+#ifdef _WIN32
+	HANDLE hFile = CreateFileA(sPath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return false;
+	m_hFile = hFile;
+	LARGE_INTEGER liSize;
+	if (!GetFileSizeEx(hFile, &liSize) || liSize.QuadPart < (LONGLONG)sizeof(SnapshotHeader))
+		return false;
+	m_liSize = (unsigned long long)liSize.QuadPart;
+	HANDLE hMap = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!hMap)
+		return false;
+	m_hMap = hMap;
+	m_pBase = (const unsigned char*)MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, 0);
+#else
+	int nFD = open(sPath.c_str(), O_RDONLY);
+	if (nFD < 0)
+		return false;
+	m_nFileDescriptor = nFD;
+	struct stat st;
+	if (fstat(nFD, &st) != 0 || st.st_size < (off_t)sizeof(SnapshotHeader))
+		return false;
+	m_liSize = (unsigned long long)st.st_size;
+	void *pBase = mmap(nullptr, (size_t)m_liSize, PROT_READ, MAP_SHARED, nFD, 0);
+	m_pBase = pBase == MAP_FAILED ? nullptr : (const unsigned char*)pBase;
+#endif
+	return m_pBase != nullptr;
+}
+
+void WzSnapshot::Unmap()
+{
+#ifdef _WIN32
+	if (m_pBase)
+		UnmapViewOfFile(m_pBase);
+	if (m_hMap)
+		CloseHandle((HANDLE)m_hMap);
+	if (m_hFile)
+		CloseHandle((HANDLE)m_hFile);
+	m_hMap = m_hFile = nullptr;
+#else
+	if (m_pBase)
+		munmap((void*)m_pBase, (size_t)m_liSize);
+	if (m_nFileDescriptor >= 0)
+		close(m_nFileDescriptor);
+	m_nFileDescriptor = -1;
+#endif
+	m_pBase = nullptr;
+}
+
+unsigned long long WzSnapshot::Checksum(const unsigned char * pData, unsigned long long liSize)
+{
+	unsigned long long liHash = 0xCBF29CE484222325ULL;
+	for (unsigned long long i = 0; i < liSize; ++i)
+	{
+		liHash ^= pData[i];
+		liHash *= 0x100000001B3ULL;
+	}
+	return liHash;
+}
+
+static bool GetSourceStamp(const std::wstring& sDataDir, const std::string& sArchiveName, unsigned long long& liSize, long long& liTime)
+{
+	filesystem::path fPath(sDataDir + std::wstring(sArchiveName.begin(), sArchiveName.end()));
+	std::error_code ec;
+	if (!filesystem::exists(fPath, ec))
+		return false;
+	liSize = (unsigned long long)filesystem::file_size(fPath, ec);
+	liTime = (long long)filesystem::last_write_time(fPath, ec).time_since_epoch().count();
+	return !ec;
+}
+
+WzSnapshot * WzSnapshot::Load(const std::string & sPath, const std::wstring & sDataDir, bool bVerifyChecksum)
+{
+	auto pSnapshot = new WzSnapshot;
+	const char *sError = nullptr;
+	if (!pSnapshot->Map(sPath))
+		sError = "unable to map the file";
+	else
+	{
+		auto pHeader = (const SnapshotHeader*)pSnapshot->m_pBase;
+		pSnapshot->m_pHeader = pHeader;
+		if (memcmp(pHeader->aMagic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) || pHeader->nVersion != SNAPSHOT_VERSION)
+			sError = "unknown format or version";
+		else if (pHeader->liFileSize != pSnapshot->m_liSize ||
+			pHeader->liStringDataOffset > pSnapshot->m_liSize ||
+			pHeader->liNodeOffset + pHeader->liNodeCount * sizeof(Node) > pSnapshot->m_liSize ||
+			pHeader->liStringIndexOffset + pHeader->liStringCount * sizeof(unsigned int) > pSnapshot->m_liSize)
+			sError = "truncated file";
+		else if (bVerifyChecksum && Checksum(pSnapshot->m_pBase + sizeof(SnapshotHeader), pSnapshot->m_liSize - sizeof(SnapshotHeader)) != pHeader->liChecksum)
+			sError = "checksum mismatch";
+	}
+
+	if (!sError)
+	{
+		auto pHeader = pSnapshot->m_pHeader;
+		auto aArchive = (const ArchiveEntry*)(pSnapshot->m_pBase + pHeader->liArchiveOffset);
+		unsigned long long liSourceSize = 0;
+		long long liSourceTime = 0;
+		for (unsigned int i = 0; i < pHeader->nArchiveCount; ++i)
+		{
+			std::string sName(aArchive[i].aName, strnlen(aArchive[i].aName, sizeof(aArchive[i].aName)));
+			if (GetSourceStamp(sDataDir, sName, liSourceSize, liSourceTime) &&
+				(liSourceSize != aArchive[i].liSourceSize || liSourceTime != aArchive[i].liSourceTime))
+			{
+				sError = "the archives were modified after it was compiled";
+				break;
+			}
+			pSnapshot->m_mArchiveRoot[sName] = aArchive[i].nRootNode;
+		}
+		pSnapshot->m_aNode = (const Node*)(pSnapshot->m_pBase + pHeader->liNodeOffset);
+		pSnapshot->m_anStringOffset = (const unsigned int*)(pSnapshot->m_pBase + pHeader->liStringIndexOffset);
+	}
+
+	if (sError)
+	{
+		WvsLogger::LogFormat(WvsLogger::LEVEL_WARNING, "[WzSnapshot::Load]Snapshot %s is not used: %s.\n", sPath.c_str(), sError);
+		delete pSnapshot;
+		return nullptr;
+	}
+	pSnapshot->m_apString = new std::atomic<std::string*>[(size_t)pSnapshot->m_pHeader->liStringCount]();
+	WvsLogger::LogFormat(WvsLogger::LEVEL_INFO, "[WzSnapshot::Load]Mapped snapshot %s (%llu nodes, %llu strings, %llu bytes).\n",
+		sPath.c_str(), pSnapshot->m_pHeader->liNodeCount, pSnapshot->m_pHeader->liStringCount, pSnapshot->m_liSize);
+	return pSnapshot;
+}
+
+bool WzSnapshot::Compile(const std::string & sPath, const std::wstring & sDataDir, const std::vector<std::pair<std::string, WzIterator>>& aArchive)
+{
+	std::vector<Node> aNode;
+	std::vector<const std::string*> aString;
+	std::unordered_map<std::string, unsigned int> mString;
+	std::vector<ArchiveEntry> aEntry;
+
+	auto fIntern = [&](const std::string& s) {
+		auto prResult = mString.insert({ s, (unsigned int)aString.size() });
+		if (prResult.second)
+			aString.push_back(&(prResult.first->first));
+		return prResult.first->second;
+	};
+
+	//Breadth-first, so that the children of every node are appended contiguously.
+	std::deque<std::pair<WzIterator, unsigned int>> qPending;
+	for (auto& prArchive : aArchive)
+	{
+		ArchiveEntry entry;
+		memset(&entry, 0, sizeof(entry));
+		if (prArchive.first.size() >= sizeof(entry.aName))
+			continue;
+		memcpy(entry.aName, prArchive.first.c_str(), prArchive.first.size());
+		GetSourceStamp(sDataDir, prArchive.first, entry.liSourceSize, entry.liSourceTime);
+		entry.nRootNode = (unsigned int)aNode.size();
+		aEntry.push_back(entry);
+
+		Node root;
+		memset(&root, 0, sizeof(root));
+		root.nName = fIntern(prArchive.first);
+		aNode.push_back(root);
+		qPending.push_back({ prArchive.second, entry.nRootNode });
+	}
+
+	while (!qPending.empty())
+	{
+		auto it = qPending.front().first;
+		unsigned int nIdx = qPending.front().second;
+		qPending.pop_front();
+
+		//Live children are ordered by symbol, the image is searched by name.
+		std::vector<WzIterator> aChild;
+		for (auto& child : it)
+			aChild.push_back(child);
+		std::sort(aChild.begin(), aChild.end(), [](WzIterator& lhs, WzIterator& rhs) {
+			return lhs.GetName() < rhs.GetName();
+		});
+
+		unsigned int nFirstChild = (unsigned int)aNode.size(), nChildCount = 0;
+		for (auto& child : aChild)
+		{
+			Node node;
+			memset(&node, 0, sizeof(node));
+			node.nName = fIntern(child.GetName());
+			node.nType = (unsigned short)child.GetValueType();
+			switch (node.nType)
+			{
+				case WzDelayedVariant::vt_Filtered_Integer:
+				case WzDelayedVariant::vt_Filtered_Long:
+				case WzDelayedVariant::vt_Int16:
+					node.uValue.liData = (long long)(unsigned long long)child;
+					break;
+				case WzDelayedVariant::vt_Float32:
+					node.uValue.fData = (float)child;
+					break;
+				case WzDelayedVariant::vt_Double64:
+					node.uValue.dData = (double)child;
+					break;
+				case WzDelayedVariant::vt_String:
+					node.uValue.nString = fIntern((const std::string&)child);
+					break;
+			}
+			aNode.push_back(node);
+			qPending.push_back({ child, (unsigned int)aNode.size() - 1 });
+			++nChildCount;
+		}
+		aNode[nIdx].nFirstChild = nFirstChild;
+		aNode[nIdx].nChildCount = nChildCount;
+	}
+
+	SnapshotHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.aMagic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+	header.nVersion = SNAPSHOT_VERSION;
+	header.nArchiveCount = (unsigned int)aEntry.size();
+	header.liNodeCount = aNode.size();
+	header.liStringCount = aString.size();
+	header.liArchiveOffset = sizeof(SnapshotHeader);
+	header.liNodeOffset = header.liArchiveOffset + aEntry.size() * sizeof(ArchiveEntry);
+	header.liStringIndexOffset = header.liNodeOffset + aNode.size() * sizeof(Node);
+	header.liStringDataOffset = header.liStringIndexOffset + aString.size() * sizeof(unsigned int);
+
+	std::vector<unsigned int> anStringOffset;
+	anStringOffset.reserve(aString.size());
+	unsigned long long liOffset = header.liStringDataOffset;
+	for (auto& pString : aString)
+	{
+		anStringOffset.push_back((unsigned int)liOffset);
+		liOffset += sizeof(unsigned int) + pString->size() + 1;
+	}
+	if (liOffset > 0xFFFFFFFFULL)
+	{
+		WvsLogger::LogRaw(WvsLogger::LEVEL_ERROR, "[WzSnapshot::Compile]The snapshot exceeds 4GB.\n");
+		return false;
+	}
+	header.liFileSize = liOffset;
+
+	std::ofstream fOut(sPath, std::ios::binary | std::ios::trunc);
+	if (!fOut)
+		return false;
+
+	unsigned long long liChecksum = 0xCBF29CE484222325ULL;
+	auto fWrite = [&](const void *pData, size_t nSize) {
+		auto pBytes = (const unsigned char*)pData;
+		for (size_t i = 0; i < nSize; ++i)
+		{
+			liChecksum ^= pBytes[i];
+			liChecksum *= 0x100000001B3ULL;
+		}
+		fOut.write((const char*)pData, nSize);
+	};
+
+	fOut.write((const char*)&header, sizeof(header));
+	fWrite(aEntry.data(), aEntry.size() * sizeof(ArchiveEntry));
+	fWrite(aNode.data(), aNode.size() * sizeof(Node));
+	fWrite(anStringOffset.data(), anStringOffset.size() * sizeof(unsigned int));
+	for (auto& pString : aString)
+	{
+		unsigned int nLength = (unsigned int)pString->size();
+		fWrite(&nLength, sizeof(nLength));
+		fWrite(pString->c_str(), nLength + 1);
+	}
+
+	header.liChecksum = liChecksum;
+	fOut.seekp(0);
+	fOut.write((const char*)&header, sizeof(header));
+	fOut.close();
+
+	WvsLogger::LogFormat(WvsLogger::LEVEL_INFO, "[WzSnapshot::Compile]Snapshot %s is written (%d archives, %llu nodes, %llu strings, %llu bytes).\n",
+		sPath.c_str(), (int)aEntry.size(), header.liNodeCount, header.liStringCount, header.liFileSize);
+	return !fOut.fail();
+}
+
+unsigned int WzSnapshot::GetArchiveRoot(const std::string & sArchiveName) const
+{
+	auto findIter = m_mArchiveRoot.find(sArchiveName);
+	return findIter == m_mArchiveRoot.end() ? INVALID_NODE : findIter->second;
+}
+
+const WzSnapshot::Node * WzSnapshot::GetNode(unsigned int nIdx) const
+{
+	return m_aNode + nIdx;
+}
+
+const char * WzSnapshot::GetRawString(unsigned int nIdx, unsigned int * pnLength) const
+{
+	auto pString = m_pBase + m_anStringOffset[nIdx];
+	if (pnLength)
+		*pnLength = *(const unsigned int*)pString;
+	return (const char*)(pString + sizeof(unsigned int));
+}
+
+const std::string & WzSnapshot::GetString(unsigned int nIdx)
+{
+	auto pString = m_apString[nIdx].load(std::memory_order_acquire);
+	if (pString)
+		return *pString;
+
+	unsigned int nLength = 0;
+	auto sRaw = GetRawString(nIdx, &nLength);
+	auto pNewString = new std::string(sRaw, nLength);
+	if (m_apString[nIdx].compare_exchange_strong(pString, pNewString))
+		return *pNewString;
+	delete pNewString;
+	return *pString;
+}
+
+unsigned int WzSnapshot::FindChild(unsigned int nParent, const char * sName, unsigned int nLength) const
+{
+	auto pParent = m_aNode + nParent;
+	unsigned int nLow = pParent->nFirstChild, nHigh = pParent->nFirstChild + pParent->nChildCount, nMid = 0, nChildLength = 0;
+	while (nLow < nHigh)
+	{
+		nMid = nLow + (nHigh - nLow) / 2;
+		auto sChildName = GetRawString(m_aNode[nMid].nName, &nChildLength);
+
+		//Same ordering as std::string::compare (unsigned bytes, then length).
+		int nCmp = memcmp(sChildName, sName, nChildLength < nLength ? nChildLength : nLength);
+		if (nCmp == 0)
+			nCmp = nChildLength < nLength ? -1 : (nChildLength > nLength ? 1 : 0);
+		if (nCmp == 0)
+			return nMid;
+		if (nCmp < 0)
+			nLow = nMid + 1;
+		else
+			nHigh = nMid;
+	}
+	return INVALID_NODE;
+}
+
+unsigned long long WzSnapshot::GetSize() const
+{
+	return m_liSize;
+}
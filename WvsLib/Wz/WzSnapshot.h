@@ -0,0 +1,97 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <atomic>
+#include <map>
+
+class WzIterator;
+
+/*
+Precompiled, already decrypted image of the WZ archives (and .img files) the server reads.
+The file is mapped read-only, so channel processes on the same host share its pages and loading it costs page faults only.
+
+Layout (all offsets are from the beginning of the file):
+	SnapshotHeader
+	ArchiveEntry[nArchiveCount]
+	Node[liNodeCount]            children of a node are contiguous and sorted by name (byte-wise)
+	unsigned int[liStringCount]  offsets of the strings
+	string data                  [unsigned int nLength][nLength bytes]['\0']
+*/
+class WzSnapshot
+{
+public:
+	static const unsigned int SNAPSHOT_VERSION = 1;
+	static const unsigned int INVALID_NODE = 0xFFFFFFFF;
+
+#pragma pack(push, 1)
+	struct SnapshotHeader
+	{
+		char aMagic[8];
+		unsigned int nVersion;
+		unsigned int nArchiveCount;
+		unsigned long long liChecksum; //FNV-1a of everything after the header.
+		unsigned long long liFileSize;
+		unsigned long long liNodeCount, liStringCount;
+		unsigned long long liArchiveOffset, liNodeOffset, liStringIndexOffset, liStringDataOffset;
+	};
+
+	struct ArchiveEntry
+	{
+		char aName[64];
+		unsigned int nRootNode;
+		unsigned int nReserved;
+		unsigned long long liSourceSize;
+		long long liSourceTime;
+	};
+
+	struct Node
+	{
+		unsigned int nName;
+		unsigned short nType; //WzDelayedVariant::VariantType
+		unsigned short nReserved;
+		unsigned int nChildCount;
+		unsigned int nFirstChild;
+		union
+		{
+			long long liData;
+			double dData;
+			float fData;
+			unsigned int nString;
+		} uValue;
+	};
+#pragma pack(pop)
+
+private:
+	const unsigned char *m_pBase = nullptr;
+	unsigned long long m_liSize = 0;
+	void *m_hFile = nullptr, *m_hMap = nullptr;
+	int m_nFileDescriptor = -1;
+
+	const SnapshotHeader *m_pHeader = nullptr;
+	const Node *m_aNode = nullptr;
+	const unsigned int *m_anStringOffset = nullptr;
+	std::map<std::string, unsigned int> m_mArchiveRoot;
+
+	//std::string objects are created on demand for APIs returning const std::string&.
+	std::atomic<std::string*> *m_apString = nullptr;
+
+	WzSnapshot();
+	bool Map(const std::string& sPath);
+	void Unmap();
+
+public:
+	~WzSnapshot();
+
+	//Returns nullptr if the file is missing, corrupted, of another version or older than the archives under sDataDir.
+	static WzSnapshot* Load(const std::string& sPath, const std::wstring& sDataDir, bool bVerifyChecksum);
+	static bool Compile(const std::string& sPath, const std::wstring& sDataDir, const std::vector<std::pair<std::string, WzIterator>>& aArchive);
+	static unsigned long long Checksum(const unsigned char *pData, unsigned long long liSize);
+
+	unsigned int GetArchiveRoot(const std::string& sArchiveName) const;
+	const Node* GetNode(unsigned int nIdx) const;
+	const char* GetRawString(unsigned int nIdx, unsigned int *pnLength = nullptr) const;
+	const std::string& GetString(unsigned int nIdx);
+	unsigned int FindChild(unsigned int nParent, const char *sName, unsigned int nLength) const;
+	unsigned long long GetSize() const;
+};
+
@@ -2,10 +2,33 @@
 #include "WzArchive.h"
 #include "WzMappedFileStream.h"
 #include "WzAESKeyGen.h"
+#include "WzSymbolTable.h"
 #include "..\Logger\WvsLogger.h"
 #include <codecvt>
+#include <locale>
+#include <vector>
 #include <intrin.h> //For VS 2017.
 
+std::atomic<unsigned long long> WzStringCache::ms_liHit{ 0 }, WzStringCache::ms_liMiss{ 0 }, WzStringCache::ms_liBytesSaved{ 0 };
+
+WzStringCache::CacheStat WzStringCache::GetStat()
+{
+	return { ms_liHit.load(), ms_liMiss.load(), ms_liBytesSaved.load() };
+}
+
+void WzStringCache::LogStat(const char * sTag, const CacheStat & statBegin)
+{
+	auto statEnd = GetStat();
+	unsigned long long liHit = statEnd.liHit - statBegin.liHit, liMiss = statEnd.liMiss - statBegin.liMiss;
+	WvsLogger::LogFormat("[%s]WZ string cache: %llu hits, %llu misses (hit rate %.2f%%), %.2f KB of decoding saved.\n",
+		sTag,
+		liHit,
+		liMiss,
+		(liHit + liMiss) ? liHit * 100.0 / (liHit + liMiss) : 0.0,
+		(statEnd.liBytesSaved - statBegin.liBytesSaved) / 1024.0
+	);
+}
+
 static unsigned char aBasicKey[4] = { 0xB9, 0x7D, 0x63, 0xE9 };
 static unsigned char aWzFileAESKey_TWMS[4096] = { 0 };
 static unsigned char aWzFileAESKey_Empty[4096] = { 0 };
@@ -72,26 +95,49 @@ void WzStreamCodec::Init()
 	}
 }
 
+//The 16-byte loads of DecodeString would run off the end of the mapping for a string at the very end of the archive,
+//such a string is copied (zero padded) to aTail first.
+static char* GetLoadPtr(WzMappedFileStream *pStream, unsigned int uLoadSize, std::vector<char>& aTail)
+{
+	if (pStream->GetRemaining() >= uLoadSize)
+		return pStream->GetStreamPtr();
+	unsigned int uPos = pStream->GetPosition();
+	aTail.resize(uLoadSize);
+	pStream->Read(aTail.data(), uLoadSize);
+	pStream->SetPosition(uPos);
+	return aTail.data();
+}
+
 std::string WzStreamCodec::DecodeString(WzMappedFileStream *pStream)
 {
-	static std::codecvt_utf8<char16_t> conv;
 	int nLen = 0;
+	std::vector<char> aTail, aHeap;
 
 	pStream->Read((char*)&nLen, 1);
 	char cLen = ((char*)&nLen)[0];
 	if (cLen > 0)
 	{
-		char16_t ws[0x800];
+		char16_t aStack[0x800], *ws = aStack;
 		if (cLen == 127)
 			pStream->Read((char*)&nLen, 4);
 
-		if (nLen > 0x10000)
+		//The string is decoded in whole 8-character blocks, which can't run past the end of the key.
+		if (nLen < 0 || nLen >= (int)(sizeof(aWideWzKey[0]) / sizeof(char16_t)))
+		{
+			pStream->SetPosition(pStream->GetPosition() + (nLen < 0 ? 0 : (unsigned int)nLen * 2));
 			return "";
+		}
+		//Those blocks and the terminator must fit in ws, longer strings are decoded on the heap.
+		if (nLen >= (int)(sizeof(aStack) / sizeof(aStack[0])))
+		{
+			aHeap.resize(((nLen >> 3) + 1) * 16);
+			ws = (char16_t*)aHeap.data();
+		}
 
 		__m128i 
 			*m1 = reinterpret_cast<__m128i *>(ws),
 			//Reading buffer from mapping file.
-			*m2 = reinterpret_cast<__m128i *>(pStream->GetStreamPtr()),
+			*m2 = reinterpret_cast<__m128i *>(GetLoadPtr(pStream, ((nLen >> 3) + 1) * 16, aTail)),
 			*m3 = reinterpret_cast<__m128i *>(aWideWzKey[pStream->Encrypted() ? 1 : 0]);
 
 		for (int i = 0; i <= nLen >> 3; ++i)
@@ -99,23 +145,53 @@ std::string WzStreamCodec::DecodeString(WzMappedFileStream *pStream)
 
 		ws[nLen] = 0;
 		pStream->SetPosition(pStream->GetPosition() + nLen * 2);
-		return std::wstring_convert<std::codecvt_utf8<wchar_t>>().to_bytes((wchar_t*)ws);
+
+		//Most wide strings are plain ASCII, narrow them directly instead of going through codecvt.
+		__m128i nonAscii = _mm_setzero_si128(), highMask = _mm_set1_epi16((short)0xFF80);
+		int nBlock = nLen >> 3;
+		for (int i = 0; i < nBlock; ++i)
+			nonAscii = _mm_or_si128(nonAscii, _mm_and_si128(_mm_loadu_si128(m1 + i), highMask));
+		bool bAscii = _mm_movemask_epi8(_mm_cmpeq_epi16(nonAscii, _mm_setzero_si128())) == 0xFFFF;
+		for (int i = nBlock << 3; bAscii && i < nLen; ++i)
+			bAscii = ws[i] < 0x80;
+
+		if (bAscii)
+		{
+			std::string sRet(nLen, '\0');
+			for (int i = 0; i < nBlock; ++i)
+				_mm_storel_epi64((__m128i*)&sRet[i << 3], _mm_packus_epi16(_mm_loadu_si128(m1 + i), _mm_setzero_si128()));
+			for (int i = nBlock << 3; i < nLen; ++i)
+				sRet[i] = (char)ws[i];
+			return sRet;
+		}
+		static thread_local std::wstring_convert<std::codecvt_utf8_utf16<char16_t>, char16_t> converter;
+		return converter.to_bytes(ws, ws + nLen);
 	}
 	else
 	{
-		char ns[0x1000];
+		char aStack[0x1000], *ns = aStack;
 		if (cLen == -128)
 			pStream->Read((char*)&nLen, 4);
 		else
 			nLen = cLen * -1;
 
-		if (nLen > 0x10000)
+		//The string is decoded in whole 16-character blocks, which can't run past the end of the key.
+		if (nLen < 0 || nLen >= (int)sizeof(aWzKey[0]))
+		{
+			pStream->SetPosition(pStream->GetPosition() + (nLen < 0 ? 0 : (unsigned int)nLen));
 			return "";
+		}
+		//Those blocks and the terminator must fit in ns, longer strings are decoded on the heap.
+		if (nLen >= (int)sizeof(aStack))
+		{
+			aHeap.resize(((nLen >> 4) + 1) * 16);
+			ns = aHeap.data();
+		}
 
 		__m128i 
 			*m1 = reinterpret_cast<__m128i *>(ns),
 			//Reading buffer from mapping file.
-			*m2 = reinterpret_cast<__m128i *>(pStream->GetStreamPtr()),
+			*m2 = reinterpret_cast<__m128i *>(GetLoadPtr(pStream, ((nLen >> 4) + 1) * 16, aTail)),
 			*m3 = reinterpret_cast<__m128i *>(aWzKey[pStream->Encrypted() ? 1 : 0]);
 
 		for (int i = 0; i <= nLen >> 4; ++i)
@@ -153,3 +229,46 @@ std::string WzStreamCodec::DecodePropString(WzStreamType *pStream, unsigned int
 			//WvsException::FatalError("Unknown type of prop string <%d>.", nType);
 	}
 }
+
+unsigned int WzStreamCodec::DecodePropSymbol(WzStreamType *pStream, unsigned int uRootPropPos, WzSymbolTable *pSymbolTable, WzStringCache *pCache)
+{
+	unsigned int nType = 0;
+	pStream->Read((char*)&nType, 1);
+	switch (nType)
+	{
+		case 0x00:
+		case 0x73:
+			return pSymbolTable->Intern(DecodeString(pStream));
+		case 0x01:
+		case 0x1B:
+		{
+			pStream->Read((char*)&nType, 4);
+			unsigned int uStringPos = uRootPropPos + nType;
+			if (pCache)
+			{
+				std::shared_lock<std::shared_mutex> lock(pCache->m_mtxLock);
+				auto findIter = pCache->m_mOffsetSymbol.find(uStringPos);
+				if (findIter != pCache->m_mOffsetSymbol.end())
+				{
+					++WzStringCache::ms_liHit;
+					WzStringCache::ms_liBytesSaved += pSymbolTable->GetSymbol(findIter->second).size();
+					return findIter->second;
+				}
+			}
+
+			unsigned int uCurrentPos = pStream->GetPosition();
+			pStream->SetPosition(uStringPos);
+			unsigned int nSymbol = pSymbolTable->Intern(DecodeString(pStream));
+			pStream->SetPosition(uCurrentPos);
+			if (pCache)
+			{
+				std::unique_lock<std::shared_mutex> lock(pCache->m_mtxLock);
+				pCache->m_mOffsetSymbol.insert({ uStringPos, nSymbol });
+				++WzStringCache::ms_liMiss;
+			}
+			return nSymbol;
+		}
+		default:
+			return pSymbolTable->Intern("");
+	}
+}
@@ -1,8 +1,37 @@
 #pragma once
 #include <string>
+#include <atomic>
+#include <shared_mutex>
+#include <unordered_map>
 
 class WzMappedFileStream;
 class WzArchive;
+class WzSymbolTable;
+
+//Strings referenced by offset are decoded once per archive, later references resolve to the interned symbol.
+class WzStringCache
+{
+	friend class WzStreamCodec;
+
+public:
+	struct CacheStat
+	{
+		unsigned long long liHit, liMiss, liBytesSaved;
+	};
+
+private:
+	std::unordered_map<unsigned int, unsigned int> m_mOffsetSymbol;
+	std::shared_mutex m_mtxLock;
+
+	//Process-wide counters.
+	static std::atomic<unsigned long long> ms_liHit, ms_liMiss, ms_liBytesSaved;
+
+public:
+	static CacheStat GetStat();
+
+	//Logs the hit rate and bytes saved since statBegin (taken by GetStat before the measured work).
+	static void LogStat(const char *sTag, const CacheStat& statBegin);
+};
 
 class WzStreamCodec
 {
@@ -19,5 +48,8 @@ public:
 	void Init();
 	std::string DecodeString(WzMappedFileStream *pStream);
 	std::string DecodePropString(WzMappedFileStream *pStream, unsigned int uRootPropPos);
+
+	//Same as DecodePropString but returns the symbol of the string, pCache may be nullptr.
+	unsigned int DecodePropSymbol(WzMappedFileStream *pStream, unsigned int uRootPropPos, WzSymbolTable *pSymbolTable, WzStringCache *pCache);
 };
 
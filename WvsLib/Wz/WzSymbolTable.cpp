@@ -0,0 +1,69 @@
+#include "WzSymbolTable.h"
+#include "..\Exception\WvsException.h"
+
+WzSymbolTable::WzSymbolTable()
+{
+}
+
+WzSymbolTable::~WzSymbolTable()
+{
+	for (auto& apChunk : m_aapChunk)
+		if (apChunk)
+			delete[] apChunk;
+}
+
+unsigned int WzSymbolTable::Intern(const std::string & sSymbol)
+{
+	{
+		std::shared_lock<std::shared_mutex> lock(m_mtxLock);
+		auto findIter = m_mSymbol.find(sSymbol);
+		if (findIter != m_mSymbol.end())
+			return findIter->second;
+	}
+
+	std::unique_lock<std::shared_mutex> lock(m_mtxLock);
+	unsigned int nSymbol = m_nSymbolCount;
+	auto prResult = m_mSymbol.insert({ sSymbol, nSymbol });
+	if (!prResult.second)
+		return prResult.first->second;
+
+	if ((nSymbol >> CHUNK_BITS) >= MAX_CHUNK)
+		WvsException::FatalError("[WzSymbolTable::Intern]Too many symbols in one archive.");
+
+	auto& apChunk = m_aapChunk[nSymbol >> CHUNK_BITS];
+	if (!apChunk)
+		apChunk = new const std::string*[CHUNK_SIZE];
+
+	//Keys of std::unordered_map never move, even when it rehashes.
+	apChunk[nSymbol & (CHUNK_SIZE - 1)] = &(prResult.first->first);
+	m_liStringBytes += sSymbol.capacity() > 15 ? sSymbol.capacity() + 1 : 0;
+	m_nSymbolCount.store(nSymbol + 1, std::memory_order_release);
+	return nSymbol;
+}
+
+unsigned int WzSymbolTable::Find(const std::string & sSymbol) const
+{
+	std::shared_lock<std::shared_mutex> lock(m_mtxLock);
+	auto findIter = m_mSymbol.find(sSymbol);
+	return findIter == m_mSymbol.end() ? INVALID_SYMBOL : findIter->second;
+}
+
+const std::string & WzSymbolTable::GetSymbol(unsigned int nSymbol) const
+{
+	return *m_aapChunk[nSymbol >> CHUNK_BITS][nSymbol & (CHUNK_SIZE - 1)];
+}
+
+unsigned int WzSymbolTable::GetSymbolCount() const
+{
+	return m_nSymbolCount.load(std::memory_order_acquire);
+}
+
+unsigned long long WzSymbolTable::GetMemoryUsage() const
+{
+	std::shared_lock<std::shared_mutex> lock(m_mtxLock);
+	unsigned long long liChunkCount = (m_nSymbolCount + CHUNK_SIZE - 1) / CHUNK_SIZE;
+	return liChunkCount * CHUNK_SIZE * sizeof(std::string*) +
+		m_mSymbol.bucket_count() * sizeof(void*) +
+		m_mSymbol.size() * (sizeof(std::pair<const std::string, unsigned int>) + sizeof(void*) * 2) +
+		m_liStringBytes;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+
+/*
+Names (and string values) of an archive interned as integer symbols.
+Every distinct string is stored once per archive, nodes only keep its symbol.
+Symbols are kept in fixed-size chunks which never move, so GetSymbol doesn't lock.
+*/
+class WzSymbolTable
+{
+public:
+	static const unsigned int INVALID_SYMBOL = 0xFFFFFFFF;
+	static const unsigned int CHUNK_BITS = 12, CHUNK_SIZE = 1 << CHUNK_BITS, MAX_CHUNK = 4096;
+
+private:
+	std::unordered_map<std::string, unsigned int> m_mSymbol;
+	const std::string** m_aapChunk[MAX_CHUNK] = { nullptr };
+	std::atomic<unsigned int> m_nSymbolCount{ 0 };
+	unsigned long long m_liStringBytes = 0;
+	mutable std::shared_mutex m_mtxLock;
+
+public:
+	WzSymbolTable();
+	~WzSymbolTable();
+
+	unsigned int Intern(const std::string& sSymbol);
+	unsigned int Find(const std::string& sSymbol) const;
+	const std::string& GetSymbol(unsigned int nSymbol) const;
+	unsigned int GetSymbolCount() const;
+	unsigned long long GetMemoryUsage() const;
+};
+
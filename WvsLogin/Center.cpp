@@ -28,7 +28,7 @@ void Center::SetCenterIndex(int idx)
 
 void Center::OnConnected()
 {
-	WvsLogger::LogRaw(WvsLogger::LEVEL_INFO, "[WvsLogin][Center::OnConnect]Successfully connected to center server.\n");
+	WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_INFO, "[WvsLogin][Center::OnConnect]Successfully connected to center server.\n");
 
 	//Encoding handshake packets for Center
 	OutPacket oPacket;
@@ -43,8 +43,7 @@ void Center::OnConnected()
 
 void Center::OnPacket(InPacket *iPacket)
 {
-	WvsLogger::LogRaw("[WvsLogin][Center::OnPacket]Packet received: \n");
-	iPacket->Print();
+	iPacket->Dump("[WvsLogin][Center::OnPacket]Packet received: \n");
 	int nType = (unsigned short)iPacket->Decode2();
 	switch (nType)
 	{
@@ -53,10 +52,10 @@ void Center::OnPacket(InPacket *iPacket)
 			auto nResult = iPacket->Decode1();
 			if (!nResult)
 			{
-				WvsLogger::LogRaw(WvsLogger::LEVEL_ERROR, "[WvsLogin][RegisterCenterAck]Center rejected the connection request, WvsLogin server may not work properly.\n");
+				WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_ERROR, "[WvsLogin][RegisterCenterAck]Center rejected the connection request, WvsLogin server may not work properly.\n");
 				exit(0);
 			}
-			WvsLogger::LogRaw(WvsLogger::LEVEL_INFO, "[WvsLogin][RegisterCenterAck]The connection between local server(WvsCenter) has been authenciated by remote server.\n");
+			WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_INFO, "[WvsLogin][RegisterCenterAck]The connection between local server(WvsCenter) has been authenciated by remote server.\n");
 			OnUpdateWorldInfo(iPacket);
 			WvsBase::GetInstance<WvsLogin>()->RestoreLoginEntry(iPacket);
 			break;
@@ -100,12 +99,12 @@ void Center::OnUpdateWorldInfo(InPacket *iPacket)
 	m_WorldInfo.nEventType = iPacket->Decode1();
 	m_WorldInfo.strWorldDesc = iPacket->DecodeStr();
 	m_WorldInfo.strEventDesc = iPacket->DecodeStr();
-	WvsLogger::LogRaw(WvsLogger::LEVEL_INFO, "[WvsLogin][Center::OnUpdateWorld]World information is updated by remote notification.\n");
+	WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_INFO, "[WvsLogin][Center::OnUpdateWorld]World information is updated by remote notification.\n");
 }
 
 void Center::OnConnectFailed()
 {
-	WvsLogger::LogRaw(WvsLogger::LEVEL_ERROR, "[WvsLogin][Center::OnConnect]Unable to connect to Center Server (Remote service unavailable).\n");
+	WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_ERROR, "[WvsLogin][Center::OnConnect]Unable to connect to Center Server (Remote service unavailable).\n");
 	OnDisconnect();
 }
 
@@ -208,5 +207,5 @@ void Center::OnCheckDuplicatedIDResult(InPacket *iPacket)
 
 void Center::OnNotifyCenterDisconnected(SocketBase * pSocket)
 {
-	WvsLogger::LogRaw("[WvsLogin][Center::OnNotifyCenterDisconnected]Disconnected from WvsCenter (closed by remote server).\n");
+	WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_INFO, "[WvsLogin][Center::OnNotifyCenterDisconnected]Disconnected from WvsCenter (closed by remote server).\n");
 }
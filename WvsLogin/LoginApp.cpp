@@ -33,6 +33,7 @@ void LoginApp::InitializeService(int argc, char** argv)
 		WvsLogger::LogRaw("Please run this program with command line, and given the config file path.\n");
 		exit(-1);
 	}
+	WvsLogger::LoadConfig(pConfigLoader);
 	WvsUnified::InitDB(pConfigLoader);
 	pLoginServer->SetConfigLoader(pConfigLoader);
 	pLoginServer->Init();
@@ -317,7 +317,7 @@ void LoginSocket::OnClientSelectWorld(InPacket *iPacket)
 		m_pLoginEntry->nWorldID = nWorldIndex;
 	}
 	else
-		WvsLogger::LogRaw(WvsLogger::LEVEL_ERROR, "[WvsLogin][LoginSocket::OnClientSelectWorld][~]ȤݹճsuܤsbCenter ServerC\n");
+		WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_ERROR, "[WvsLogin][LoginSocket::OnClientSelectWorld][~]ȤݹճsuܤsbCenter ServerC\n");
 }
 
 void LoginSocket::OnClientSecondPasswdCheck()
@@ -33,7 +33,7 @@ void Center::SetCenterIndex(int idx)
 
 void Center::OnConnected()
 {
-	WvsLogger::LogRaw(WvsLogger::LEVEL_INFO, "[WvsShop][Center::OnConnect]Successfully connected to center server.\n");
+	WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_INFO, "[WvsShop][Center::OnConnect]Successfully connected to center server.\n");
 
 	//VCenter ServeroeHand Shakeʥ]
 	OutPacket oPacket;
@@ -66,8 +66,7 @@ void Center::OnConnected()
 
 void Center::OnPacket(InPacket *iPacket)
 {
-	WvsLogger::LogRaw("[WvsShop][Center::OnPacket]Packet received: ");
-	iPacket->Print();
+	iPacket->Dump("[WvsShop][Center::OnPacket]Packet received: ");
 	int nType = (unsigned short)iPacket->Decode2();
 	switch (nType)
 	{
@@ -75,7 +74,7 @@ void Center::OnPacket(InPacket *iPacket)
 		{
 			if (!iPacket->Decode1())
 				WvsException::FatalError("[WvsShop][RegisterCenterAck]Center rejected the connection request, WvsShop server may not work properly.\n");
-			WvsLogger::LogRaw(WvsLogger::LEVEL_INFO, "[WvsShop][RegisterCenterAck]The connection between local server(WvsCenter) has been authenciated by remote server.\n");
+			WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_INFO, "[WvsShop][RegisterCenterAck]The connection between local server(WvsCenter) has been authenciated by remote server.\n");
 			break;
 		}
 		case CenterResultPacketType::CenterMigrateInResult:
@@ -99,7 +98,7 @@ void Center::OnClosed()
 
 void Center::OnConnectFailed()
 {
-	WvsLogger::LogRaw(WvsLogger::LEVEL_ERROR, "[WvsShop][Center::OnConnect]Unable to connect to Center Server (Remote service unavailable).\n");
+	WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_ERROR, "[WvsShop][Center::OnConnect]Unable to connect to Center Server (Remote service unavailable).\n");
 	OnDisconnect();
 }
 
@@ -110,7 +109,7 @@ const WorldInfo & Center::GetWorldInfo()
 
 void Center::OnNotifyCenterDisconnected(SocketBase * pSocket)
 {
-	WvsLogger::LogRaw("[WvsShop]Disconnected from WvsCenter (closed by remote server).\n");
+	WvsLogger::LogSubsystem(WvsLogger::SUB_NET, WvsLogger::SEV_INFO, "[WvsShop]Disconnected from WvsCenter (closed by remote server).\n");
 }
 
 void Center::OnCenterMigrateInResult(InPacket *iPacket)
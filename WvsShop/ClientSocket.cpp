@@ -25,8 +25,7 @@ void ClientSocket::OnClosed()
 
 void ClientSocket::OnPacket(InPacket *iPacket)
 {
-	iPacket->Print();
-	//printf("\n");
+	iPacket->Dump("[WvsShop][ClientSocket::OnPacket]Received Packet: ");
 	int nType = (unsigned short)iPacket->Decode2();
 	switch (nType)
 	{
@@ -32,6 +32,7 @@ void ShopApp::InitializeService(int argc, char** argv)
 		WvsLogger::LogRaw("Please run this program with command line, and given the config file path.\n");
 		exit(-1);
 	}
+	WvsLogger::LoadConfig(pCfgLoader);
 
 	WzResMan::GetInstance()->Init(pCfgLoader->StrValue("GlobalConfig"));
 	WvsShop *pShopServer = WvsBase::GetInstance<WvsShop>();
@@ -86,7 +86,7 @@ User::~User()
 	oPacket.Encode4(GetUserID());
 	oPacket.Encode4(-1);
 	m_pCharacterData->EncodeCharacterData(&oPacket, true);
-	m_pFuncKeyMapped->Encode(&oPacket, true);
+	m_pFuncKeyMapped->Encode(&oPacket);
 	oPacket.Encode1(m_bTransferChannel ? 
 		CenterMigrationType::eMigrateOut_TransferChannelFromShop : 
 		CenterMigrationType::eMigrateOut_ClientDisconnected